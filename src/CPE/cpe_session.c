@@ -32,6 +32,7 @@
 #include "CPE/public/cpe_dict.h"
 #include "CPE/public/cpe_lang.h"
 #include "OVAL/public/oval_agent_api.h"
+#include "OVAL/results/oval_results_impl.h"
 #include "source/public/oscap_source.h"
 #include "source/oscap_source_priv.h"
 #include "oscap_helpers.h"
@@ -53,6 +54,9 @@ struct cpe_session *cpe_session_new(void)
 	cpe->lang_models = oscap_list_new();
 	cpe->oval_sessions = oscap_htable_new();
 	cpe->applicable_platforms = oscap_htable_new();
+	cpe->platform_results = oscap_htable_new();
+	cpe->item_results = oscap_htable_new();
+	cpe->check_results = oscap_htable_new();
 	cpe->thin_results = false;
 	if (!cpe_session_add_default_cpe(cpe)) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to add default CPE to newly created CPE Session.");
@@ -75,6 +79,9 @@ void cpe_session_free(struct cpe_session *session)
 		oscap_list_free(session->lang_models, (oscap_destruct_func) cpe_lang_model_free);
 		oscap_htable_free(session->oval_sessions, (oscap_destruct_func) _xccdf_policy_destroy_cpe_oval_session);
 		oscap_htable_free(session->applicable_platforms, NULL);
+		oscap_htable_free(session->platform_results, NULL);
+		oscap_htable_free(session->item_results, NULL);
+		oscap_htable_free(session->check_results, NULL);
 		free(session);
 	}
 }
@@ -130,21 +137,67 @@ struct oval_agent_session *cpe_session_lookup_oval_session(struct cpe_session *c
 							OVAL_RESULT_UNKNOWN | OVAL_RESULT_NOT_EVALUATED |
 							OVAL_RESULT_NOT_APPLICABLE | OVAL_RESULT_ERROR,
 							OVAL_DIRECTIVE_CONTENT_THIN);
+			/* only verdicts of definitions are reported, let the evaluation short-circuit */
+			oval_results_model_set_fast_verdict(res_model, true);
 		}
 		oscap_htable_add(cpe->oval_sessions, prefixed_href, session);
 	}
 	return session;
 }
 
+static const bool _applicable = true;
+static const bool _not_applicable = false;
+
+const bool *cpe_session_get_cached_result(struct oscap_htable *cache, const char *key)
+{
+	return (const bool *) oscap_htable_get(cache, key);
+}
+
+void cpe_session_cache_result(struct oscap_htable *cache, const char *key, bool applicable)
+{
+	oscap_htable_add(cache, key, (void *) (applicable ? &_applicable : &_not_applicable));
+}
+
+/* a new dictionary or language model can make more platforms applicable */
+static void cpe_session_forget_applicability(struct cpe_session *session)
+{
+	oscap_htable_free(session->platform_results, NULL);
+	oscap_htable_free(session->item_results, NULL);
+	session->platform_results = oscap_htable_new();
+	session->item_results = oscap_htable_new();
+}
+
+int cpe_session_reset_results(struct cpe_session *session)
+{
+	int ret = 0;
+
+	cpe_session_forget_applicability(session);
+	oscap_htable_free(session->check_results, NULL);
+	session->check_results = oscap_htable_new();
+	oscap_htable_free(session->applicable_platforms, NULL);
+	session->applicable_platforms = oscap_htable_new();
+
+	struct oscap_htable_iterator *it = oscap_htable_iterator_new(session->oval_sessions);
+	while (oscap_htable_iterator_has_more(it)) {
+		struct oval_agent_session *oval_session = oscap_htable_iterator_next_value(it);
+		if (oval_agent_restart_session(oval_session) != 0)
+			ret = -1;
+	}
+	oscap_htable_iterator_free(it);
+	return ret;
+}
+
 bool cpe_session_add_cpe_lang_model_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_lang_model *lang_model = cpe_lang_model_import_source(source);
+	cpe_session_forget_applicability(session);
 	return oscap_list_add(session->lang_models, lang_model);
 }
 
 bool cpe_session_add_cpe_dict_source(struct cpe_session *session, struct oscap_source *source)
 {
 	struct cpe_dict_model *dict = cpe_dict_model_import_source(source);
+	cpe_session_forget_applicability(session);
 	return oscap_list_add(session->dicts, dict);
 }
 
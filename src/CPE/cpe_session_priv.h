@@ -36,6 +36,9 @@ struct cpe_session {
 	struct oscap_list *lang_models;                 ///< All CPE lang models except the one embedded in XCCDF
 	struct oscap_htable *oval_sessions;             ///< Caches CPE OVAL check results
 	struct oscap_htable *applicable_platforms;
+	struct oscap_htable *platform_results;          ///< Caches applicability of platforms [platform -> bool]
+	struct oscap_htable *item_results;              ///< Caches applicability of XCCDF items [item ID -> bool]
+	struct oscap_htable *check_results;             ///< Caches results of CPE checks [href and name -> bool]
 	struct oscap_htable *sources_cache;             ///< Not owned cache [path -> oscap_source]
 	bool thin_results;                              ///< Should OVAL results related to CPE be exported as THIN?
 };
@@ -48,5 +51,19 @@ bool cpe_session_add_cpe_lang_model_source(struct cpe_session *session, struct o
 bool cpe_session_add_cpe_dict_source(struct cpe_session *session, struct oscap_source *source);
 bool cpe_session_add_cpe_autodetect_source(struct cpe_session *session, struct oscap_source *source);
 void cpe_session_set_cache(struct cpe_session *session, struct oscap_htable *sources_cache);
+/**
+ * Forget everything learned about the scanned system, e.g. before another
+ * target is scanned. OVAL sessions keep their definition models.
+ * @returns 0 on success
+ */
+int cpe_session_reset_results(struct cpe_session *session);
+
+/**
+ * Look up a cached applicability.
+ * @param cache one of the caches of the CPE session
+ * @returns NULL if the applicability of the key is not known yet
+ */
+const bool *cpe_session_get_cached_result(struct oscap_htable *cache, const char *key);
+void cpe_session_cache_result(struct oscap_htable *cache, const char *key, bool applicable);
 
 #endif
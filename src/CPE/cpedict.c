@@ -37,12 +37,14 @@
 
 #include "common/list.h"
 #include "common/util.h"
+#include "oscap_helpers.h"
 #include "common/_error.h"
 #include "common/xmlns_priv.h"
 #include "common/elements.h"
 #include "common/xmltext_priv.h"
 #include "source/oscap_source_priv.h"
 #include "source/public/oscap_source.h"
+#include <ctype.h>
 #include <string.h>
 
 #define CPE_DICT_SUPPORTED "2.3"
@@ -108,19 +110,77 @@ bool cpe_name_match_dict(struct cpe_name * cpe, struct cpe_dict_model * dict)
 	return ret;
 }
 
-bool cpe_name_applicable_dict(struct cpe_name *cpe, struct cpe_dict_model *dict, cpe_check_fn cb, void* usr)
+/*
+ * Key of the name index of a dictionary. A name which has the part, vendor
+ * and product can only match the items whose names have the same ones.
+ * Returns NULL for names which can't be looked up in the index.
+ */
+static char *cpe_name_index_key(const struct cpe_name *name)
 {
-	// FIXME: We could match faster by matching per component and storing all
-	//        cpe_dict items in a big tree where leaves contain cpe_items and
-	//        inner nodes are the components.
+	if (name == NULL)
+		return NULL;
+
+	cpe_part_t part = cpe_name_get_part(name);
+	const char *vendor = cpe_name_get_vendor(name);
+	const char *product = cpe_name_get_product(name);
+
+	if (part == CPE_PART_NONE || vendor == NULL || *vendor == '\0' || product == NULL || *product == '\0')
+		return NULL;
+
+	// names are matched case-insensitively
+	char *key = oscap_sprintf("%d:%s:%s", part, vendor, product);
+	for (char *c = key; *c != '\0'; c++)
+		*c = tolower((unsigned char) *c);
+	return key;
+}
 
+static void cpe_dict_model_index_items(struct cpe_dict_model *dict)
+{
+	oscap_htable_free(dict->name_index, (oscap_destruct_func) oscap_list_free0);
+	dict->name_index = oscap_htable_new();
+
+	struct cpe_item_iterator *items = cpe_dict_model_get_items(dict);
+	while (cpe_item_iterator_has_more(items)) {
+		struct cpe_item *item = cpe_item_iterator_next(items);
+		char *key = cpe_name_index_key(cpe_item_get_name(item));
+		if (key == NULL)
+			continue;
+
+		struct oscap_list *bucket = oscap_htable_get(dict->name_index, key);
+		if (bucket == NULL) {
+			bucket = oscap_list_new();
+			oscap_htable_add(dict->name_index, key, bucket);
+		}
+		oscap_list_add(bucket, item);
+		free(key);
+	}
+	cpe_item_iterator_free(items);
+	dict->indexed_count = oscap_list_get_itemcount(dict->items);
+}
+
+bool cpe_name_applicable_dict(struct cpe_name *cpe, struct cpe_dict_model *dict, cpe_check_fn cb, void* usr)
+{
 	__attribute__nonnull__(cpe);
 	__attribute__nonnull__(dict);
 
 	if (cpe == NULL || dict == NULL)
 		return false;
 
-	struct cpe_item_iterator *items = cpe_dict_model_get_items(dict);
+	struct cpe_item_iterator *items;
+	char *key = cpe_name_index_key(cpe);
+	if (key != NULL) {
+		// items may have been removed through an iterator
+		if (dict->name_index == NULL || dict->indexed_count != oscap_list_get_itemcount(dict->items))
+			cpe_dict_model_index_items(dict);
+
+		struct oscap_list *bucket = oscap_htable_get(dict->name_index, key);
+		free(key);
+		if (bucket == NULL)
+			return false;
+		// buckets keep the order of the items in the dictionary
+		items = (struct cpe_item_iterator *) oscap_iterator_new(bucket);
+	} else
+		items = cpe_dict_model_get_items(dict);
 
 	// essentially, we want at least one applicable match so as soon as we find
 	// a match we break and return true
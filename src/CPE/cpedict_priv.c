@@ -150,9 +150,18 @@ OSCAP_ACCESSOR_STRING(cpe_generator, product_name)
 
 OSCAP_GETTER(struct cpe_generator *, cpe_dict_model, generator)
 OSCAP_ACCESSOR_SIMPLE(int, cpe_dict_model, base_version)
-OSCAP_IGETINS_GEN(cpe_item, cpe_dict_model, items, item) OSCAP_ITERATOR_REMOVE_F(cpe_item)
+OSCAP_IGETTER_GEN(cpe_item, cpe_dict_model, items) OSCAP_ITERATOR_REMOVE_F(cpe_item)
 OSCAP_IGETINS_GEN(cpe_vendor, cpe_dict_model, vendors, vendor) OSCAP_ITERATOR_REMOVE_F(cpe_vendor)
 
+bool cpe_dict_model_add_item(struct cpe_dict_model *dict, struct cpe_item *item)
+{
+	// the name index is built again on the next lookup
+	oscap_htable_free(dict->name_index, (oscap_destruct_func) oscap_list_free0);
+	dict->name_index = NULL;
+	oscap_list_add(dict->items, item);
+	return true;
+}
+
 /* ****************************************
  * Component-tree structures
  * ***************************************/
@@ -1315,6 +1324,7 @@ void cpe_dict_model_free(struct cpe_dict_model *dict)
 
 	oscap_list_free(dict->items, (oscap_destruct_func) cpe_item_free);
 	oscap_list_free(dict->vendors, (oscap_destruct_func) cpe_vendor_free);
+	oscap_htable_free(dict->name_index, (oscap_destruct_func) oscap_list_free0);
 	cpe_generator_free(dict->generator);
 	free(dict->origin_file);
 	free(dict);
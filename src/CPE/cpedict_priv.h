@@ -142,6 +142,8 @@ struct cpe_dict_model {		// the main node
 	int base_version;
 	struct cpe_generator *generator;
 	char* origin_file;
+	struct oscap_htable *name_index;	// items by the part, vendor and product of their names, built on demand
+	int indexed_count;		// number of items when the index was built
 };
 
 /** 
@@ -47,6 +47,13 @@ struct oval_probe_session {
         uint32_t      flg;  /**< probe session flags */
 };
 
+/**
+ * Drop the results cached by the running probes for the objects and
+ * states with the given IDs.
+ * @param ids list of the object and state IDs (S-exp strings)
+ */
+int oval_probe_session_evict(oval_probe_session_t *sess, SEXP_t *ids);
+
 #endif /* _OVAL_PROBE_SESSION */
 
 /// @}
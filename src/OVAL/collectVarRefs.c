@@ -28,8 +28,6 @@
 #include "oval_definitions_impl.h"
 #include "adt/oval_string_map_impl.h"
 
-static void _var_collect_var_refs(struct oval_variable *var, struct oval_string_map *vm);
-
 static void _comp_collect_var_refs(struct oval_component *comp, struct oval_string_map *vm)
 {
 	struct oval_object *obj;
@@ -43,7 +41,7 @@ static void _comp_collect_var_refs(struct oval_component *comp, struct oval_stri
 		break;
 	case OVAL_COMPONENT_VARREF:
 		var = oval_component_get_variable(comp);
-		_var_collect_var_refs(var, vm);
+		oval_var_collect_var_refs(var, vm);
 		break;
 	case OVAL_FUNCTION_ARITHMETIC:
 	case OVAL_FUNCTION_BEGIN:
@@ -68,7 +66,7 @@ static void _comp_collect_var_refs(struct oval_component *comp, struct oval_stri
 	}
 }
 
-static void _var_collect_var_refs(struct oval_variable *var, struct oval_string_map *vm)
+void oval_var_collect_var_refs(struct oval_variable *var, struct oval_string_map *vm)
 {
 	char *var_id;
 
@@ -93,7 +91,7 @@ static void _ent_collect_var_refs(struct oval_entity *ent, struct oval_string_ma
 		struct oval_variable *var;
 
 		var = oval_entity_get_variable(ent);
-		_var_collect_var_refs(var, vm);
+		oval_var_collect_var_refs(var, vm);
 	}
 }
 
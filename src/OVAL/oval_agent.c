@@ -32,6 +32,7 @@
 #include <config.h>
 #endif
 
+#include <ctype.h>
 #include <string.h>
 #include <time.h>
 
@@ -44,11 +45,13 @@
 #include "results/oval_results_impl.h"
 #if defined(OVAL_PROBES_ENABLED)
 # include "oval_probe_impl.h"
+# include "common/oscap_status_priv.h"
 #endif
 #include "common/list.h"
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
+#include "oscap_helpers.h"
 #include "oval_agent_xccdf_api.h"
 
 struct oval_agent_session {
@@ -62,6 +65,8 @@ struct oval_agent_session {
 #if defined(OVAL_PROBES_ENABLED)
 	struct oval_results_model    * res_model;
 	oval_probe_session_t  * psess;
+	/* provenance stamps of objects, see oval_agent_load_incremental_state() */
+	struct oval_string_map *stamps;
 #endif
 };
 
@@ -89,6 +94,73 @@ static const struct oval_result_to_xccdf_spec XCCDF_OVAL_RESULTS_MAP[] = {
 	{0, 0, 0}
 };
 
+#if defined(OVAL_PROBES_ENABLED)
+static void _oval_agent_status_schedule_criteria(struct oval_criteria_node *node, struct oval_string_map *visited);
+
+static void _oval_agent_status_schedule_definition(struct oval_definition *def, struct oval_string_map *visited)
+{
+	const char *id = oval_definition_get_id(def);
+
+	if (oval_string_map_get_value(visited, id) != NULL)
+		return;
+	oval_string_map_put(visited, id, def);
+	_oval_agent_status_schedule_criteria(oval_definition_get_criteria(def), visited);
+}
+
+static void _oval_agent_status_schedule_criteria(struct oval_criteria_node *node, struct oval_string_map *visited)
+{
+	struct oval_criteria_node_iterator *it;
+	struct oval_test *test;
+	struct oval_definition *def;
+
+	if (node == NULL)
+		return;
+	switch (oval_criteria_node_get_type(node)) {
+	case OVAL_NODETYPE_CRITERIA:
+		it = oval_criteria_node_get_subnodes(node);
+		while (oval_criteria_node_iterator_has_more(it))
+			_oval_agent_status_schedule_criteria(oval_criteria_node_iterator_next(it), visited);
+		oval_criteria_node_iterator_free(it);
+		break;
+	case OVAL_NODETYPE_CRITERION:
+		test = oval_criteria_node_get_test(node);
+		if (test != NULL && oval_test_get_object(test) != NULL)
+			oscap_status_schedule_object(oval_object_get_id(oval_test_get_object(test)));
+		break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		def = oval_criteria_node_get_definition(node);
+		if (def != NULL)
+			_oval_agent_status_schedule_definition(def, visited);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Objects of the tests of the definition make the total of the reported scan status */
+static void oval_agent_status_schedule(struct oval_definition_model *model, const char *id)
+{
+	struct oval_string_map *visited;
+	struct oval_definition_iterator *it;
+	struct oval_definition *def;
+
+	if (!oscap_status_enabled())
+		return;
+	visited = oval_string_map_new();
+	if (id != NULL) {
+		def = oval_definition_model_get_definition(model, id);
+		if (def != NULL)
+			_oval_agent_status_schedule_definition(def, visited);
+	} else {
+		it = oval_definition_model_get_definitions(model);
+		while (oval_definition_iterator_has_more(it))
+			_oval_agent_status_schedule_definition(oval_definition_iterator_next(it), visited);
+		oval_definition_iterator_free(it);
+	}
+	oval_string_map_free(visited, NULL);
+}
+#endif
+
 oval_agent_session_t * oval_agent_new_session(struct oval_definition_model *model, const char * name) {
 	struct oval_sysinfo *sysinfo;
 	struct oval_generator *generator;
@@ -106,6 +178,7 @@ oval_agent_session_t * oval_agent_new_session(struct oval_definition_model *mode
 	ag_sess->sys_model = oval_syschar_model_new(model);
 #if defined(OVAL_PROBES_ENABLED)
 	ag_sess->psess     = oval_probe_session_new(ag_sess->sys_model);
+	ag_sess->stamps    = NULL;
 #endif
 
 #if defined(OVAL_PROBES_ENABLED)
@@ -177,6 +250,7 @@ int oval_agent_eval_definition(oval_agent_session_t *ag_sess, const char *id)
 	struct oval_result_system *rsystem;
 
 	rsystem = _oval_agent_get_first_result_system(ag_sess);
+	oval_agent_status_schedule(ag_sess->def_model, id);
 	/* eval */
 	ret = oval_result_system_eval_definition(rsystem, id);
 	return ret;
@@ -254,6 +328,102 @@ int oval_agent_reset_session(oval_agent_session_t * ag_sess) {
 	return 0;
 }
 
+int oval_agent_restart_session(oval_agent_session_t *ag_sess)
+{
+	struct oval_sysinfo *sysinfo;
+	struct oval_syschar_model *old_sys_model = ag_sess->sys_model;
+
+	ag_sess->cur_var_model = NULL;
+	oval_definition_model_clear_external_variables(ag_sess->def_model);
+
+	ag_sess->sys_model = oval_syschar_model_new(ag_sess->def_model);
+#if defined(OVAL_PROBES_ENABLED)
+	/* the probes are started again and see the system which is scanned now */
+	oval_probe_session_reinit(ag_sess->psess, ag_sess->sys_model);
+	if (oval_probe_query_sysinfo(ag_sess->psess, &sysinfo) != 0) {
+		oval_syschar_model_free(ag_sess->sys_model);
+		ag_sess->sys_model = old_sys_model;
+		oval_probe_session_reinit(ag_sess->psess, ag_sess->sys_model);
+		return -1;
+	}
+#else
+	sysinfo = oval_sysinfo_new(ag_sess->sys_model);
+#endif
+	oval_syschar_model_set_sysinfo(ag_sess->sys_model, sysinfo);
+	oval_sysinfo_free(sysinfo);
+	ag_sess->sys_models[0] = ag_sess->sys_model;
+
+#if defined(OVAL_PROBES_ENABLED)
+	oval_results_model_reset_systems(ag_sess->res_model, ag_sess->sys_models);
+	/* stamps belong to the system scanned before */
+	if (ag_sess->stamps != NULL) {
+		oval_string_map_free(ag_sess->stamps, free);
+		ag_sess->stamps = NULL;
+	}
+	/* the objects collected from the previous system are going to be collected again */
+	oscap_status_reschedule_objects();
+#endif
+	if (ag_sess->product_name) {
+		struct oval_generator *generator = oval_syschar_model_get_generator(ag_sess->sys_model);
+		oval_generator_set_product_name(generator, ag_sess->product_name);
+	}
+	oval_syschar_model_free(old_sys_model);
+
+	return 0;
+}
+
+#if defined(OVAL_PROBES_ENABLED)
+/* @returns path prefix of the state files of the session in the directory */
+static char *_oval_agent_state_path(oval_agent_session_t *ag_sess, const char *dir)
+{
+	char *name = oscap_strdup(ag_sess->filename != NULL ? ag_sess->filename : "oval");
+	for (char *p = name; *p != '\0'; p++) {
+		if (!isalnum((unsigned char) *p) && *p != '.' && *p != '-' && *p != '_')
+			*p = '_';
+	}
+	char *path = oscap_sprintf("%s/%s", dir, name);
+	free(name);
+	return path;
+}
+#endif
+
+int oval_agent_load_incremental_state(oval_agent_session_t *ag_sess, const char *dir)
+{
+	__attribute__nonnull__(ag_sess);
+
+#if defined(OVAL_PROBES_ENABLED)
+	/* stamp the inputs before anything is collected, so that a change made
+	 * during the scan is noticed by the next one */
+	if (ag_sess->stamps != NULL)
+		oval_string_map_free(ag_sess->stamps, free);
+	ag_sess->stamps = oval_probe_provenance_stamps(ag_sess->def_model);
+
+	char *state = _oval_agent_state_path(ag_sess, dir);
+	int ret = oval_probe_provenance_reuse(ag_sess->sys_model, ag_sess->stamps, state);
+	free(state);
+	return ret;
+#else
+	return 0;
+#endif
+}
+
+int oval_agent_save_incremental_state(oval_agent_session_t *ag_sess, const char *dir)
+{
+	__attribute__nonnull__(ag_sess);
+
+#if defined(OVAL_PROBES_ENABLED)
+	if (ag_sess->stamps == NULL)
+		ag_sess->stamps = oval_probe_provenance_stamps(ag_sess->def_model);
+
+	char *state = _oval_agent_state_path(ag_sess, dir);
+	int ret = oval_probe_provenance_save(ag_sess->sys_model, ag_sess->stamps, state);
+	free(state);
+	return ret;
+#else
+	return 0;
+#endif
+}
+
 int oval_agent_abort_session(oval_agent_session_t *ag_sess)
 {
 	if (ag_sess == NULL) {
@@ -277,6 +447,9 @@ int oval_agent_eval_system(oval_agent_session_t * ag_sess, agent_reporter cb, vo
 	int ret = 0;
 
 	dI("OVAL agent started to evaluate OVAL definitions on your system.");
+#if defined(OVAL_PROBES_ENABLED)
+	oval_agent_status_schedule(ag_sess->def_model, NULL);
+#endif
 	oval_def_it = oval_definition_model_get_definitions(ag_sess->def_model);
 	while (oval_definition_iterator_has_more(oval_def_it)) {
 		oval_def = oval_definition_iterator_next(oval_def_it);
@@ -332,6 +505,8 @@ void oval_agent_destroy_session(oval_agent_session_t * ag_sess) {
 #if defined(OVAL_PROBES_ENABLED)
 		oval_probe_session_destroy(ag_sess->psess);
 		oval_results_model_free(ag_sess->res_model);
+		if (ag_sess->stamps != NULL)
+			oval_string_map_free(ag_sess->stamps, free);
 #endif
 	        free(ag_sess->filename);
 		free(ag_sess);
@@ -420,11 +595,12 @@ static void _oval_agent_resolve_variables_conflict(struct oval_agent_session *se
 	const char *var_name = NULL;
 	struct oscap_stringlist *value_list = NULL;
 	bool conflict = false;
+	struct oval_string_map *changed = oval_string_map_new();
 	struct oscap_htable *dict = _binding_iterator_to_dict(it);
 	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(dict);
 	struct oval_definition_model *def_model =
 			oval_results_model_get_definition_model(oval_agent_get_results_model(session));
-	while (!conflict && oscap_htable_iterator_has_more(hit)) {
+	while (oscap_htable_iterator_has_more(hit)) {
 		oscap_htable_iterator_next_kv(hit, &var_name, (void*) &value_list);
 		struct oval_variable *variable = oval_definition_model_get_variable(def_model, var_name);
 		if (variable != NULL) {
@@ -440,6 +616,7 @@ static void _oval_agent_resolve_variables_conflict(struct oval_agent_session *se
 				// As per OVAL 5.10.1, the Variable Schema does not allow multisets. Therefore,
 				// we will later create new variable model and export multiple variables docs.
 				conflict = true;
+				oval_string_map_put(changed, var_name, variable);
 				// Next, in the results model, there might be already some definitions, tests
 				// states, or objects. These might be dependent on the previous value of the
 				// given variable.
@@ -492,9 +669,16 @@ static void _oval_agent_resolve_variables_conflict(struct oval_agent_session *se
 	oscap_htable_free(dict, (oscap_destruct_func) oscap_stringlist_free);
 
     if (conflict) {
-        /* We have a conflict, clear session and external variables */
-        oval_agent_reset_session(session);
+        /* We have a conflict, start a new variable model and clear external variables.
+         * Only what depends on the changed variables is collected again, the probes
+         * keep running and keep the rest of their caches. */
+        session->cur_var_model = NULL;
+        oval_definition_model_clear_external_variables(def_model);
+#if defined(OVAL_PROBES_ENABLED)
+        oval_probe_hint_variables(session->psess, def_model, changed);
+#endif
     }
+    oval_string_map_free(changed, NULL);
 
     if (!session->cur_var_model) {
 	    session->cur_var_model = oval_variable_model_new();
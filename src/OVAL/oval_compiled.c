@@ -0,0 +1,1012 @@
+/**
+ * @file oval_compiled.c
+ * @brief Compiled (binary) representation of the OVAL Definition model
+ *
+ * The compiled form stores a fully parsed oval_definition_model in a compact
+ * binary file that can be loaded back without any XML processing. See
+ * common/oscap_compiled.h for the header and encoding; the body is:
+ *
+ *   schema, generator, declarations, variables, objects, states,
+ *   tests, definitions
+ *
+ * Every top-level entity is declared up front, so that the records can
+ * refer to each other by id regardless of their order.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "oval_definitions_impl.h"
+#include "adt/oval_collection_impl.h"
+#include "common/util.h"
+#include "common/list.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/oscap_compiled.h"
+#include "oscap_source.h"
+#include "source/oscap_source_priv.h"
+
+#define OVAL_COMPILED_MAGIC "OSCAPOVC"
+#define OVAL_COMPILED_FORMAT 2
+#define OVAL_COMPILED_SUFFIX ".ovalc"
+#define OVAL_CACHE_DIR_ENV "OSCAP_OVAL_CACHE_DIR"
+
+#define _iterator_remaining(it) oval_collection_iterator_remaining((struct oval_iterator *) (it))
+
+/***************************************************************************/
+/* Writer
+ * */
+
+#define _write_uint oscap_compiled_write_uint
+#define _write_int oscap_compiled_write_int
+#define _write_str oscap_compiled_write_str
+
+static void _write_value(struct oscap_compiled_writer *w, struct oval_value *value)
+{
+	_write_uint(w, value != NULL);
+	if (value == NULL)
+		return;
+	_write_uint(w, oval_value_get_datatype(value));
+	_write_str(w, oval_value_get_text(value));
+}
+
+static void _write_string_iterator(struct oscap_compiled_writer *w, struct oval_string_iterator *it)
+{
+	_write_uint(w, _iterator_remaining(it));
+	while (oval_string_iterator_has_more(it))
+		_write_str(w, oval_string_iterator_next(it));
+	oval_string_iterator_free(it);
+}
+
+static void _write_generator(struct oscap_compiled_writer *w, struct oval_generator *generator)
+{
+	_write_str(w, oval_generator_get_product_name(generator));
+	_write_str(w, oval_generator_get_product_version(generator));
+	_write_str(w, oval_generator_get_core_schema_version(generator));
+	_write_str(w, oval_generator_get_timestamp(generator));
+	_write_str(w, oval_generator_get_anyxml(generator));
+
+	size_t count = 0;
+	struct oscap_htable_iterator *sv_itr = oval_generator_get_platform_schema_versions(generator);
+	while (oscap_htable_iterator_has_more(sv_itr)) {
+		oscap_htable_iterator_next(sv_itr);
+		count++;
+	}
+	_write_uint(w, count);
+	oscap_htable_iterator_reset(sv_itr);
+	while (oscap_htable_iterator_has_more(sv_itr)) {
+		const char *platform, *version;
+		oscap_htable_iterator_next_kv(sv_itr, &platform, (void **) &version);
+		_write_str(w, platform);
+		_write_str(w, version);
+	}
+	oscap_htable_iterator_free(sv_itr);
+}
+
+static void _write_entity(struct oscap_compiled_writer *w, struct oval_entity *entity)
+{
+	_write_uint(w, entity != NULL);
+	if (entity == NULL)
+		return;
+	struct oval_variable *variable = oval_entity_get_variable(entity);
+	_write_uint(w, oval_entity_get_type(entity));
+	_write_uint(w, oval_entity_get_datatype(entity));
+	_write_uint(w, oval_entity_get_operation(entity));
+	_write_int(w, oval_entity_get_mask(entity));
+	_write_uint(w, oval_entity_get_varref_type(entity));
+	_write_uint(w, oval_entity_get_xsi_nil(entity));
+	_write_str(w, oval_entity_get_name(entity));
+	_write_str(w, variable ? oval_variable_get_id(variable) : NULL);
+	_write_value(w, oval_entity_get_value(entity));
+}
+
+static void _write_component(struct oscap_compiled_writer *w, struct oval_component *component)
+{
+	_write_uint(w, component != NULL);
+	if (component == NULL)
+		return;
+	oval_component_type_t type = oval_component_get_type(component);
+	_write_uint(w, type);
+	switch (type) {
+	case OVAL_COMPONENT_LITERAL:
+		_write_value(w, oval_component_get_literal_value(component));
+		break;
+	case OVAL_COMPONENT_OBJECTREF: {
+		struct oval_object *object = oval_component_get_object(component);
+		_write_str(w, object ? oval_object_get_id(object) : NULL);
+		_write_str(w, oval_component_get_item_field(component));
+		_write_str(w, oval_component_get_record_field(component));
+	} break;
+	case OVAL_COMPONENT_VARREF: {
+		struct oval_variable *variable = oval_component_get_variable(component);
+		_write_str(w, variable ? oval_variable_get_id(variable) : NULL);
+	} break;
+	default:
+		if (type <= OVAL_COMPONENT_FUNCTION)
+			break;
+		/* getters return neutral values for mismatching function types */
+		_write_uint(w, oval_component_get_arithmetic_operation(component));
+		_write_str(w, oval_component_get_prefix(component));
+		_write_str(w, oval_component_get_suffix(component));
+		_write_str(w, oval_component_get_split_delimiter(component));
+		_write_uint(w, oval_component_get_glob_to_regex_glob_noescape(component));
+		_write_int(w, oval_component_get_substring_start(component));
+		_write_int(w, oval_component_get_substring_length(component));
+		_write_uint(w, oval_component_get_timedif_format_1(component));
+		_write_uint(w, oval_component_get_timedif_format_2(component));
+		_write_str(w, oval_component_get_regex_pattern(component));
+
+		struct oval_component_iterator *subcomps = oval_component_get_function_components(component);
+		_write_uint(w, subcomps ? _iterator_remaining(subcomps) : 0);
+		while (subcomps && oval_component_iterator_has_more(subcomps))
+			_write_component(w, oval_component_iterator_next(subcomps));
+		oval_component_iterator_free(subcomps);
+	}
+}
+
+static void _write_variable(struct oscap_compiled_writer *w, struct oval_variable *variable)
+{
+	oval_variable_type_t type = oval_variable_get_type(variable);
+	_write_str(w, oval_variable_get_comment(variable));
+	_write_int(w, oval_variable_get_version(variable));
+	_write_uint(w, oval_variable_get_deprecated(variable));
+	_write_uint(w, oval_variable_get_datatype(variable));
+
+	switch (type) {
+	case OVAL_VARIABLE_CONSTANT: {
+		struct oval_value_iterator *values = oval_variable_get_values(variable);
+		_write_uint(w, values ? _iterator_remaining(values) : 0);
+		while (values && oval_value_iterator_has_more(values))
+			_write_value(w, oval_value_iterator_next(values));
+		oval_value_iterator_free(values);
+	} break;
+	case OVAL_VARIABLE_EXTERNAL: {
+		struct oval_variable_possible_value_iterator *pvs = oval_variable_get_possible_values2(variable);
+		_write_uint(w, _iterator_remaining(pvs));
+		while (oval_variable_possible_value_iterator_has_more(pvs)) {
+			struct oval_variable_possible_value *pv = oval_variable_possible_value_iterator_next(pvs);
+			_write_str(w, oval_variable_possible_value_get_hint(pv));
+			_write_str(w, oval_variable_possible_value_get_value(pv));
+		}
+		oval_variable_possible_value_iterator_free(pvs);
+
+		struct oval_variable_possible_restriction_iterator *prs = oval_variable_get_possible_restrictions2(variable);
+		_write_uint(w, _iterator_remaining(prs));
+		while (oval_variable_possible_restriction_iterator_has_more(prs)) {
+			struct oval_variable_possible_restriction *pr = oval_variable_possible_restriction_iterator_next(prs);
+			_write_uint(w, oval_variable_possible_restriction_get_operator(pr));
+			_write_str(w, oval_variable_possible_restriction_get_hint(pr));
+			struct oval_variable_restriction_iterator *rs = oval_variable_possible_restriction_get_restrictions2(pr);
+			_write_uint(w, _iterator_remaining(rs));
+			while (oval_variable_restriction_iterator_has_more(rs)) {
+				struct oval_variable_restriction *r = oval_variable_restriction_iterator_next(rs);
+				_write_uint(w, oval_variable_restriction_get_operation(r));
+				_write_str(w, oval_variable_restriction_get_value(r));
+			}
+			oval_variable_restriction_iterator_free(rs);
+		}
+		oval_variable_possible_restriction_iterator_free(prs);
+	} break;
+	case OVAL_VARIABLE_LOCAL:
+		/* values of local variables are computed during evaluation */
+		_write_component(w, oval_variable_get_component(variable));
+		break;
+	default:
+		break;
+	}
+}
+
+static void _write_filter(struct oscap_compiled_writer *w, struct oval_filter *filter)
+{
+	struct oval_state *state = oval_filter_get_state(filter);
+	_write_str(w, state ? oval_state_get_id(state) : NULL);
+	_write_uint(w, oval_filter_get_filter_action(filter));
+}
+
+static void _write_setobject(struct oscap_compiled_writer *w, struct oval_setobject *set)
+{
+	_write_uint(w, set != NULL);
+	if (set == NULL)
+		return;
+	oval_setobject_type_t type = oval_setobject_get_type(set);
+	_write_uint(w, type);
+	_write_uint(w, oval_setobject_get_operation(set));
+	if (type == OVAL_SET_AGGREGATE) {
+		struct oval_setobject_iterator *subsets = oval_setobject_get_subsets(set);
+		_write_uint(w, _iterator_remaining(subsets));
+		while (oval_setobject_iterator_has_more(subsets))
+			_write_setobject(w, oval_setobject_iterator_next(subsets));
+		oval_setobject_iterator_free(subsets);
+	} else if (type == OVAL_SET_COLLECTIVE) {
+		struct oval_object_iterator *objects = oval_setobject_get_objects(set);
+		_write_uint(w, _iterator_remaining(objects));
+		while (oval_object_iterator_has_more(objects))
+			_write_str(w, oval_object_get_id(oval_object_iterator_next(objects)));
+		oval_object_iterator_free(objects);
+
+		struct oval_filter_iterator *filters = oval_setobject_get_filters(set);
+		_write_uint(w, _iterator_remaining(filters));
+		while (oval_filter_iterator_has_more(filters))
+			_write_filter(w, oval_filter_iterator_next(filters));
+		oval_filter_iterator_free(filters);
+	}
+}
+
+static void _write_object(struct oscap_compiled_writer *w, struct oval_object *object)
+{
+	_write_uint(w, oval_object_get_subtype(object));
+	_write_str(w, oval_object_get_comment(object));
+	_write_int(w, oval_object_get_version(object));
+	_write_uint(w, oval_object_get_deprecated(object));
+	_write_string_iterator(w, oval_object_get_notes(object));
+
+	struct oval_object_content_iterator *contents = oval_object_get_object_contents(object);
+	_write_uint(w, _iterator_remaining(contents));
+	while (oval_object_content_iterator_has_more(contents)) {
+		struct oval_object_content *content = oval_object_content_iterator_next(contents);
+		oval_object_content_type_t type = oval_object_content_get_type(content);
+		_write_uint(w, type);
+		_write_str(w, oval_object_content_get_field_name(content));
+		switch (type) {
+		case OVAL_OBJECTCONTENT_ENTITY:
+			_write_entity(w, oval_object_content_get_entity(content));
+			_write_uint(w, oval_object_content_get_varCheck(content));
+			break;
+		case OVAL_OBJECTCONTENT_SET:
+			_write_setobject(w, oval_object_content_get_setobject(content));
+			break;
+		case OVAL_OBJECTCONTENT_FILTER: {
+			struct oval_filter *filter = oval_object_content_get_filter(content);
+			_write_uint(w, filter != NULL);
+			if (filter != NULL)
+				_write_filter(w, filter);
+		} break;
+		default:
+			break;
+		}
+	}
+	oval_object_content_iterator_free(contents);
+
+	struct oval_behavior_iterator *behaviors = oval_object_get_behaviors(object);
+	_write_uint(w, _iterator_remaining(behaviors));
+	while (oval_behavior_iterator_has_more(behaviors)) {
+		struct oval_behavior *behavior = oval_behavior_iterator_next(behaviors);
+		_write_str(w, oval_behavior_get_key(behavior));
+		_write_str(w, oval_behavior_get_value(behavior));
+	}
+	oval_behavior_iterator_free(behaviors);
+}
+
+static void _write_state(struct oscap_compiled_writer *w, struct oval_state *state)
+{
+	_write_uint(w, oval_state_get_subtype(state));
+	_write_str(w, oval_state_get_comment(state));
+	_write_int(w, oval_state_get_version(state));
+	_write_uint(w, oval_state_get_deprecated(state));
+	_write_uint(w, oval_state_get_operator(state));
+	_write_string_iterator(w, oval_state_get_notes(state));
+
+	struct oval_state_content_iterator *contents = oval_state_get_contents(state);
+	_write_uint(w, _iterator_remaining(contents));
+	while (oval_state_content_iterator_has_more(contents)) {
+		struct oval_state_content *content = oval_state_content_iterator_next(contents);
+		_write_entity(w, oval_state_content_get_entity(content));
+		_write_uint(w, oval_state_content_get_ent_check(content));
+		_write_uint(w, oval_state_content_get_var_check(content));
+		_write_uint(w, oval_state_content_get_check_existence(content));
+
+		struct oval_record_field_iterator *rfs = oval_state_content_get_record_fields(content);
+		_write_uint(w, _iterator_remaining(rfs));
+		while (oval_record_field_iterator_has_more(rfs)) {
+			struct oval_record_field *rf = oval_record_field_iterator_next(rfs);
+			struct oval_variable *variable = oval_record_field_get_variable(rf);
+			_write_str(w, oval_record_field_get_name(rf));
+			_write_str(w, oval_record_field_get_value(rf));
+			_write_uint(w, oval_record_field_get_datatype(rf));
+			_write_int(w, oval_record_field_get_mask(rf));
+			_write_uint(w, oval_record_field_get_operation(rf));
+			_write_str(w, variable ? oval_variable_get_id(variable) : NULL);
+			_write_uint(w, oval_record_field_get_var_check(rf));
+			_write_uint(w, oval_record_field_get_ent_check(rf));
+		}
+		oval_record_field_iterator_free(rfs);
+	}
+	oval_state_content_iterator_free(contents);
+}
+
+static void _write_test(struct oscap_compiled_writer *w, struct oval_test *test)
+{
+	struct oval_object *object = oval_test_get_object(test);
+	_write_uint(w, oval_test_get_subtype(test));
+	_write_str(w, oval_test_get_comment(test));
+	_write_int(w, oval_test_get_version(test));
+	_write_uint(w, oval_test_get_deprecated(test));
+	_write_uint(w, oval_test_get_state_operator(test));
+	_write_uint(w, oval_test_get_existence(test));
+	_write_uint(w, oval_test_get_check(test));
+	_write_string_iterator(w, oval_test_get_notes(test));
+	_write_str(w, object ? oval_object_get_id(object) : NULL);
+
+	struct oval_state_iterator *states = oval_test_get_states(test);
+	_write_uint(w, _iterator_remaining(states));
+	while (oval_state_iterator_has_more(states))
+		_write_str(w, oval_state_get_id(oval_state_iterator_next(states)));
+	oval_state_iterator_free(states);
+}
+
+static void _write_criteria_node(struct oscap_compiled_writer *w, struct oval_criteria_node *node)
+{
+	_write_uint(w, node != NULL);
+	if (node == NULL)
+		return;
+	oval_criteria_node_type_t type = oval_criteria_node_get_type(node);
+	_write_uint(w, type);
+	_write_uint(w, oval_criteria_node_get_negate(node));
+	_write_uint(w, oval_criteria_node_get_applicability_check(node));
+	_write_str(w, oval_criteria_node_get_comment(node));
+	switch (type) {
+	case OVAL_NODETYPE_CRITERIA: {
+		_write_uint(w, oval_criteria_node_get_operator(node));
+		struct oval_criteria_node_iterator *subnodes = oval_criteria_node_get_subnodes(node);
+		_write_uint(w, _iterator_remaining(subnodes));
+		while (oval_criteria_node_iterator_has_more(subnodes))
+			_write_criteria_node(w, oval_criteria_node_iterator_next(subnodes));
+		oval_criteria_node_iterator_free(subnodes);
+	} break;
+	case OVAL_NODETYPE_CRITERION: {
+		struct oval_test *test = oval_criteria_node_get_test(node);
+		_write_str(w, test ? oval_test_get_id(test) : NULL);
+	} break;
+	case OVAL_NODETYPE_EXTENDDEF: {
+		struct oval_definition *definition = oval_criteria_node_get_definition(node);
+		_write_str(w, definition ? oval_definition_get_id(definition) : NULL);
+	} break;
+	default:
+		break;
+	}
+}
+
+static void _write_definition(struct oscap_compiled_writer *w, struct oval_definition *definition)
+{
+	_write_int(w, oval_definition_get_version(definition));
+	_write_uint(w, oval_definition_get_class(definition));
+	_write_uint(w, oval_definition_get_deprecated(definition));
+	_write_str(w, oval_definition_get_title(definition));
+	_write_str(w, oval_definition_get_description(definition));
+	_write_str(w, oval_definition_get_anyxml(definition));
+
+	struct oval_affected_iterator *affected = oval_definition_get_affected(definition);
+	_write_uint(w, _iterator_remaining(affected));
+	while (oval_affected_iterator_has_more(affected)) {
+		struct oval_affected *af = oval_affected_iterator_next(affected);
+		_write_uint(w, oval_affected_get_family(af));
+		_write_string_iterator(w, oval_affected_get_platforms(af));
+		_write_string_iterator(w, oval_affected_get_products(af));
+	}
+	oval_affected_iterator_free(affected);
+
+	struct oval_reference_iterator *refs = oval_definition_get_references(definition);
+	_write_uint(w, _iterator_remaining(refs));
+	while (oval_reference_iterator_has_more(refs)) {
+		struct oval_reference *ref = oval_reference_iterator_next(refs);
+		_write_str(w, oval_reference_get_source(ref));
+		_write_str(w, oval_reference_get_id(ref));
+		_write_str(w, oval_reference_get_url(ref));
+	}
+	oval_reference_iterator_free(refs);
+
+	_write_string_iterator(w, oval_definition_get_notes(definition));
+	_write_criteria_node(w, oval_definition_get_criteria(definition));
+}
+
+/* Writes the ids of all items first, followed by the item records */
+#define WRITE_SECTION(w, model, kind, write_body) do { \
+		struct oval_##kind##_iterator *it = oval_definition_model_get_##kind##s(model); \
+		_write_uint(w, _iterator_remaining(it)); \
+		while (oval_##kind##_iterator_has_more(it)) { \
+			struct oval_##kind *item = oval_##kind##_iterator_next(it); \
+			_write_str(w, oval_##kind##_get_id(item)); \
+			write_body(w, item); \
+		} \
+		oval_##kind##_iterator_free(it); \
+	} while (0)
+
+static void _write_declarations(struct oscap_compiled_writer *w, struct oval_definition_model *model)
+{
+	struct oval_variable_iterator *variables = oval_definition_model_get_variables(model);
+	_write_uint(w, _iterator_remaining(variables));
+	while (oval_variable_iterator_has_more(variables)) {
+		struct oval_variable *variable = oval_variable_iterator_next(variables);
+		_write_str(w, oval_variable_get_id(variable));
+		_write_uint(w, oval_variable_get_type(variable));
+	}
+	oval_variable_iterator_free(variables);
+
+#define WRITE_IDS(kind) do { \
+		struct oval_##kind##_iterator *it = oval_definition_model_get_##kind##s(model); \
+		_write_uint(w, _iterator_remaining(it)); \
+		while (oval_##kind##_iterator_has_more(it)) \
+			_write_str(w, oval_##kind##_get_id(oval_##kind##_iterator_next(it))); \
+		oval_##kind##_iterator_free(it); \
+	} while (0)
+
+	WRITE_IDS(object);
+	WRITE_IDS(state);
+	WRITE_IDS(test);
+	WRITE_IDS(definition);
+#undef WRITE_IDS
+}
+
+static int _oval_compiled_write(struct oval_definition_model *model, const unsigned char *digest, size_t source_size, const char *file, bool atomic)
+{
+	struct oscap_compiled_writer *w = oscap_compiled_writer_new();
+	_write_str(w, oval_definition_model_get_schema(model));
+	_write_generator(w, oval_definition_model_get_generator(model));
+	_write_declarations(w, model);
+	WRITE_SECTION(w, model, variable, _write_variable);
+	WRITE_SECTION(w, model, object, _write_object);
+	WRITE_SECTION(w, model, state, _write_state);
+	WRITE_SECTION(w, model, test, _write_test);
+	WRITE_SECTION(w, model, definition, _write_definition);
+
+	int ret = oscap_compiled_writer_save(w, OVAL_COMPILED_MAGIC, OVAL_COMPILED_FORMAT, digest, source_size, file, atomic);
+	oscap_compiled_writer_free(w);
+	return ret;
+}
+
+/***************************************************************************/
+/* Reader
+ * */
+
+struct oval_compiled_reader {
+	struct oscap_compiled_reader in;
+	struct oval_definition_model *model;
+};
+
+static inline uint64_t _read_uint(struct oval_compiled_reader *r)
+{
+	return oscap_compiled_read_uint(&r->in);
+}
+
+static inline int64_t _read_int(struct oval_compiled_reader *r)
+{
+	return oscap_compiled_read_int(&r->in);
+}
+
+static inline bool _read_bool(struct oval_compiled_reader *r)
+{
+	return oscap_compiled_read_bool(&r->in);
+}
+
+static inline size_t _read_count(struct oval_compiled_reader *r)
+{
+	return oscap_compiled_read_count(&r->in);
+}
+
+static inline char *_read_str(struct oval_compiled_reader *r)
+{
+	return (char *) oscap_compiled_read_str(&r->in);
+}
+
+/* Look up a declared item; a reference to an undeclared id means the file is damaged */
+#define DEFINE_READ_REF(kind) \
+static struct oval_##kind *_read_##kind##_ref(struct oval_compiled_reader *r) \
+{ \
+	const char *id = _read_str(r); \
+	if (id == NULL) \
+		return NULL; \
+	struct oval_##kind *item = oval_definition_model_get_##kind(r->model, id); \
+	if (item == NULL) \
+		r->in.failed = true; \
+	return item; \
+}
+
+DEFINE_READ_REF(variable)
+DEFINE_READ_REF(object)
+DEFINE_READ_REF(state)
+DEFINE_READ_REF(test)
+DEFINE_READ_REF(definition)
+
+static struct oval_value *_read_value(struct oval_compiled_reader *r)
+{
+	if (!_read_bool(r))
+		return NULL;
+	oval_datatype_t datatype = _read_uint(r);
+	char *text = _read_str(r);
+	return oval_value_new(datatype, text);
+}
+
+static void _read_generator(struct oval_compiled_reader *r, struct oval_generator *generator)
+{
+	oval_generator_set_product_name(generator, _read_str(r));
+	oval_generator_set_product_version(generator, _read_str(r));
+	oval_generator_set_core_schema_version(generator, _read_str(r));
+	oval_generator_set_timestamp(generator, _read_str(r));
+	oval_generator_set_anyxml(generator, _read_str(r));
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		const char *platform = _read_str(r);
+		const char *version = _read_str(r);
+		if (platform != NULL)
+			oval_generator_add_platform_schema_version(generator, platform, version);
+	}
+}
+
+static struct oval_entity *_read_entity(struct oval_compiled_reader *r)
+{
+	if (!_read_bool(r))
+		return NULL;
+	struct oval_entity *entity = oval_entity_new(r->model);
+	oval_entity_set_type(entity, _read_uint(r));
+	oval_entity_set_datatype(entity, _read_uint(r));
+	oval_entity_set_operation(entity, _read_uint(r));
+	oval_entity_set_mask(entity, _read_int(r));
+	oval_entity_set_varref_type(entity, _read_uint(r));
+	oval_entity_set_xsi_nil(entity, _read_bool(r));
+	oval_entity_set_name(entity, _read_str(r));
+	oval_entity_set_variable(entity, _read_variable_ref(r));
+	oval_entity_set_value(entity, _read_value(r));
+	return entity;
+}
+
+static struct oval_component *_read_component(struct oval_compiled_reader *r, int depth)
+{
+	if (!_read_bool(r))
+		return NULL;
+	oval_component_type_t type = _read_uint(r);
+	struct oval_component *component = NULL;
+	if (depth > 256 || r->in.failed || (component = oval_component_new(r->model, type)) == NULL) {
+		r->in.failed = true;
+		return NULL;
+	}
+	switch (type) {
+	case OVAL_COMPONENT_LITERAL:
+		oval_component_set_literal_value(component, _read_value(r));
+		break;
+	case OVAL_COMPONENT_OBJECTREF:
+		oval_component_set_object(component, _read_object_ref(r));
+		oval_component_set_item_field(component, _read_str(r));
+		oval_component_set_record_field(component, _read_str(r));
+		break;
+	case OVAL_COMPONENT_VARREF:
+		oval_component_set_variable(component, _read_variable_ref(r));
+		break;
+	default:
+		if (type <= OVAL_COMPONENT_FUNCTION)
+			break;
+		oval_component_set_arithmetic_operation(component, _read_uint(r));
+		oval_component_set_prefix(component, _read_str(r));
+		oval_component_set_suffix(component, _read_str(r));
+		oval_component_set_split_delimiter(component, _read_str(r));
+		oval_component_set_glob_to_regex_glob_noescape(component, _read_bool(r));
+		oval_component_set_substring_start(component, _read_int(r));
+		oval_component_set_substring_length(component, _read_int(r));
+		oval_component_set_timedif_format_1(component, _read_uint(r));
+		oval_component_set_timedif_format_2(component, _read_uint(r));
+		oval_component_set_regex_pattern(component, _read_str(r));
+
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++)
+			oval_component_add_function_component(component, _read_component(r, depth + 1));
+	}
+	return component;
+}
+
+static void _read_variable(struct oval_compiled_reader *r, struct oval_variable *variable)
+{
+	oval_variable_set_comment(variable, _read_str(r));
+	oval_variable_set_version(variable, _read_int(r));
+	oval_variable_set_deprecated(variable, _read_bool(r));
+	oval_variable_set_datatype(variable, _read_uint(r));
+
+	switch (oval_variable_get_type(variable)) {
+	case OVAL_VARIABLE_CONSTANT: {
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			struct oval_value *value = _read_value(r);
+			if (value != NULL)
+				oval_variable_add_value(variable, value);
+		}
+	} break;
+	case OVAL_VARIABLE_EXTERNAL: {
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			const char *hint = _read_str(r);
+			const char *value = _read_str(r);
+			oval_variable_add_possible_value(variable, oval_variable_possible_value_new(hint, value));
+		}
+		count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			oval_operator_t operator = _read_uint(r);
+			const char *hint = _read_str(r);
+			struct oval_variable_possible_restriction *pr = oval_variable_possible_restriction_new(operator, hint);
+			size_t rcount = _read_count(r);
+			for (size_t j = 0; j < rcount && !r->in.failed; j++) {
+				oval_operation_t operation = _read_uint(r);
+				const char *value = _read_str(r);
+				oval_variable_possible_restriction_add_restriction(pr, oval_variable_restriction_new(operation, value));
+			}
+			oval_variable_add_possible_restriction(variable, pr);
+		}
+	} break;
+	case OVAL_VARIABLE_LOCAL:
+		oval_variable_set_component(variable, _read_component(r, 0));
+		break;
+	default:
+		break;
+	}
+}
+
+static struct oval_filter *_read_filter(struct oval_compiled_reader *r)
+{
+	struct oval_filter *filter = oval_filter_new(r->model);
+	oval_filter_set_state(filter, _read_state_ref(r));
+	oval_filter_set_filter_action(filter, _read_uint(r));
+	return filter;
+}
+
+static struct oval_setobject *_read_setobject(struct oval_compiled_reader *r, int depth)
+{
+	if (!_read_bool(r))
+		return NULL;
+	if (depth > 256) {
+		r->in.failed = true;
+		return NULL;
+	}
+	struct oval_setobject *set = oval_setobject_new(r->model);
+	oval_setobject_type_t type = _read_uint(r);
+	oval_setobject_set_type(set, type);
+	oval_setobject_set_operation(set, _read_uint(r));
+	if (type == OVAL_SET_AGGREGATE) {
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			struct oval_setobject *subset = _read_setobject(r, depth + 1);
+			if (subset != NULL)
+				oval_setobject_add_subset(set, subset);
+		}
+	} else if (type == OVAL_SET_COLLECTIVE) {
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			struct oval_object *object = _read_object_ref(r);
+			if (object != NULL)
+				oval_setobject_add_object(set, object);
+		}
+		count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++)
+			oval_setobject_add_filter(set, _read_filter(r));
+	}
+	return set;
+}
+
+static void _read_object(struct oval_compiled_reader *r, struct oval_object *object)
+{
+	oval_object_set_subtype(object, _read_uint(r));
+	oval_object_set_comment(object, _read_str(r));
+	oval_object_set_version(object, _read_int(r));
+	oval_object_set_deprecated(object, _read_bool(r));
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++)
+		oval_object_add_note(object, _read_str(r));
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		oval_object_content_type_t type = _read_uint(r);
+		struct oval_object_content *content = oval_object_content_new(r->model, type);
+		if (content == NULL) {
+			r->in.failed = true;
+			break;
+		}
+		oval_object_content_set_field_name(content, _read_str(r));
+		switch (type) {
+		case OVAL_OBJECTCONTENT_ENTITY:
+			oval_object_content_set_entity(content, _read_entity(r));
+			oval_object_content_set_varCheck(content, _read_uint(r));
+			break;
+		case OVAL_OBJECTCONTENT_SET:
+			oval_object_content_set_setobject(content, _read_setobject(r, 0));
+			break;
+		case OVAL_OBJECTCONTENT_FILTER:
+			if (_read_bool(r))
+				oval_object_content_set_filter(content, _read_filter(r));
+			break;
+		default:
+			break;
+		}
+		oval_object_add_object_content(object, content);
+	}
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		struct oval_behavior *behavior = oval_behavior_new(r->model);
+		const char *key = _read_str(r);
+		const char *value = _read_str(r);
+		oval_behavior_set_keyval(behavior, key, value);
+		oval_object_add_behavior(object, behavior);
+	}
+}
+
+static void _read_state(struct oval_compiled_reader *r, struct oval_state *state)
+{
+	oval_state_set_subtype(state, _read_uint(r));
+	oval_state_set_comment(state, _read_str(r));
+	oval_state_set_version(state, _read_int(r));
+	oval_state_set_deprecated(state, _read_bool(r));
+	oval_state_set_operator(state, _read_uint(r));
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++)
+		oval_state_add_note(state, _read_str(r));
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		struct oval_state_content *content = oval_state_content_new(r->model);
+		oval_state_content_set_entity(content, _read_entity(r));
+		oval_state_content_set_entcheck(content, _read_uint(r));
+		oval_state_content_set_varcheck(content, _read_uint(r));
+		oval_state_content_set_check_existence(content, _read_uint(r));
+
+		size_t rcount = _read_count(r);
+		for (size_t j = 0; j < rcount && !r->in.failed; j++) {
+			struct oval_record_field *rf = oval_record_field_new(OVAL_RECORD_FIELD_STATE);
+			oval_record_field_set_name(rf, _read_str(r));
+			oval_record_field_set_value(rf, _read_str(r));
+			oval_record_field_set_datatype(rf, _read_uint(r));
+			oval_record_field_set_mask(rf, _read_int(r));
+			oval_record_field_set_operation(rf, _read_uint(r));
+			oval_record_field_set_variable(rf, _read_variable_ref(r));
+			oval_record_field_set_var_check(rf, _read_uint(r));
+			oval_record_field_set_ent_check(rf, _read_uint(r));
+			oval_state_content_add_record_field(content, rf);
+		}
+		oval_state_add_content(state, content);
+	}
+}
+
+static void _read_test(struct oval_compiled_reader *r, struct oval_test *test)
+{
+	oval_test_set_subtype(test, _read_uint(r));
+	oval_test_set_comment(test, _read_str(r));
+	oval_test_set_version(test, _read_int(r));
+	oval_test_set_deprecated(test, _read_bool(r));
+	oval_test_set_state_operator(test, _read_uint(r));
+	oval_test_set_existence(test, _read_uint(r));
+	oval_test_set_check(test, _read_uint(r));
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++)
+		oval_test_add_note(test, _read_str(r));
+	struct oval_object *object = _read_object_ref(r);
+	if (object != NULL)
+		oval_test_set_object(test, object);
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		struct oval_state *state = _read_state_ref(r);
+		if (state != NULL)
+			oval_test_add_state(test, state);
+	}
+}
+
+static struct oval_criteria_node *_read_criteria_node(struct oval_compiled_reader *r, int depth)
+{
+	if (!_read_bool(r))
+		return NULL;
+	oval_criteria_node_type_t type = _read_uint(r);
+	struct oval_criteria_node *node = NULL;
+	if (depth > 256 || r->in.failed || (node = oval_criteria_node_new(r->model, type)) == NULL) {
+		r->in.failed = true;
+		return NULL;
+	}
+	oval_criteria_node_set_negate(node, _read_bool(r));
+	oval_criteria_node_set_applicability_check(node, _read_bool(r));
+	oval_criteria_node_set_comment(node, _read_str(r));
+	switch (type) {
+	case OVAL_NODETYPE_CRITERIA: {
+		oval_criteria_node_set_operator(node, _read_uint(r));
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->in.failed; i++) {
+			struct oval_criteria_node *subnode = _read_criteria_node(r, depth + 1);
+			if (subnode != NULL)
+				oval_criteria_node_add_subnode(node, subnode);
+		}
+	} break;
+	case OVAL_NODETYPE_CRITERION:
+		oval_criteria_node_set_test(node, _read_test_ref(r));
+		break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		oval_criteria_node_set_definition(node, _read_definition_ref(r));
+		break;
+	default:
+		break;
+	}
+	return node;
+}
+
+static void _read_definition(struct oval_compiled_reader *r, struct oval_definition *definition)
+{
+	oval_definition_set_version(definition, _read_int(r));
+	oval_definition_set_class(definition, _read_uint(r));
+	oval_definition_set_deprecated(definition, _read_bool(r));
+	oval_definition_set_title(definition, _read_str(r));
+	oval_definition_set_description(definition, _read_str(r));
+	oval_definition_set_anyxml(definition, _read_str(r));
+
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		struct oval_affected *affected = oval_affected_new(r->model);
+		oval_affected_set_family(affected, _read_uint(r));
+		size_t pcount = _read_count(r);
+		for (size_t j = 0; j < pcount && !r->in.failed; j++)
+			oval_affected_add_platform(affected, _read_str(r));
+		pcount = _read_count(r);
+		for (size_t j = 0; j < pcount && !r->in.failed; j++)
+			oval_affected_add_product(affected, _read_str(r));
+		oval_definition_add_affected(definition, affected);
+	}
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		struct oval_reference *ref = oval_reference_new(r->model);
+		oval_reference_set_source(ref, _read_str(r));
+		oval_reference_set_id(ref, _read_str(r));
+		oval_reference_set_url(ref, _read_str(r));
+		oval_definition_add_reference(definition, ref);
+	}
+
+	count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++)
+		oval_definition_add_note(definition, oscap_strdup(_read_str(r)));
+
+	oval_definition_set_criteria(definition, _read_criteria_node(r, 0));
+}
+
+static void _read_declarations(struct oval_compiled_reader *r)
+{
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->in.failed; i++) {
+		const char *id = _read_str(r);
+		oval_variable_type_t type = _read_uint(r);
+		if (id == NULL)
+			r->in.failed = true;
+		else
+			oval_definition_model_get_new_variable(r->model, id, type);
+	}
+
+#define READ_IDS(kind) do { \
+		size_t n = _read_count(r); \
+		for (size_t i = 0; i < n && !r->in.failed; i++) { \
+			const char *id = _read_str(r); \
+			if (id == NULL) \
+				r->in.failed = true; \
+			else \
+				oval_definition_model_get_new_##kind(r->model, id); \
+		} \
+	} while (0)
+
+	READ_IDS(object);
+	READ_IDS(state);
+	READ_IDS(test);
+	READ_IDS(definition);
+#undef READ_IDS
+}
+
+#define READ_SECTION(r, kind, read_body) do { \
+		size_t n = _read_count(r); \
+		for (size_t i = 0; i < n && !(r)->in.failed; i++) { \
+			struct oval_##kind *item = _read_##kind##_ref(r); \
+			if (item == NULL) { \
+				(r)->in.failed = true; \
+				break; \
+			} \
+			read_body(r, item); \
+		} \
+	} while (0)
+
+static struct oval_definition_model *_oval_compiled_load(const char *file,
+		const unsigned char *expected_digest, const uint64_t *expected_size, bool quiet)
+{
+	struct oval_compiled_reader r;
+	if (oscap_compiled_reader_open(&r.in, file, OVAL_COMPILED_MAGIC, OVAL_COMPILED_FORMAT,
+			expected_digest, expected_size, quiet) != 0)
+		return NULL;
+
+	r.model = oval_definition_model_new();
+	const char *schema = _read_str(&r);
+	if (schema != NULL)
+		oval_definition_model_set_schema(r.model, schema);
+	_read_generator(&r, oval_definition_model_get_generator(r.model));
+	_read_declarations(&r);
+	READ_SECTION(&r, variable, _read_variable);
+	READ_SECTION(&r, object, _read_object);
+	READ_SECTION(&r, state, _read_state);
+	READ_SECTION(&r, test, _read_test);
+	READ_SECTION(&r, definition, _read_definition);
+
+	if (!oscap_compiled_reader_close(&r.in)) {
+		dW("Compiled OVAL Definition model '%s' is damaged.", file);
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "%s is not a valid compiled OVAL Definition model.", file);
+		oval_definition_model_free(r.model);
+		return NULL;
+	}
+	return r.model;
+}
+
+/***************************************************************************/
+/* Public API and the automatic cache
+ * */
+
+int oval_definition_model_export_compiled(struct oval_definition_model *model, struct oscap_source *source, const char *file)
+{
+	__attribute__nonnull__(model);
+
+	unsigned char digest[OSCAP_DIGEST_SIZE];
+	size_t size = 0;
+	if (source != NULL && oscap_source_get_digest(source, digest, &size) != 0)
+		return -1;
+	return _oval_compiled_write(model, source != NULL ? digest : NULL, size, file, false);
+}
+
+struct oval_definition_model *oval_definition_model_import_compiled(const char *file)
+{
+	return _oval_compiled_load(file, NULL, NULL, false);
+}
+
+static char *_oval_cache_path(struct oscap_source *source, unsigned char *digest, uint64_t *size)
+{
+	return oscap_compiled_cache_path(OVAL_CACHE_DIR_ENV, source, OVAL_COMPILED_FORMAT, OVAL_COMPILED_SUFFIX, digest, size);
+}
+
+struct oval_definition_model *oval_definition_model_cache_load(struct oscap_source *source)
+{
+	unsigned char digest[OSCAP_DIGEST_SIZE];
+	uint64_t size;
+	char *path = _oval_cache_path(source, digest, &size);
+	if (path == NULL)
+		return NULL;
+	struct oval_definition_model *model = _oval_compiled_load(path, digest, &size, true);
+	if (model != NULL)
+		dI("Loaded OVAL Definitions of %s from cache '%s'.", oscap_source_readable_origin(source), path);
+	free(path);
+	return model;
+}
+
+void oval_definition_model_cache_store(struct oval_definition_model *model, struct oscap_source *source)
+{
+	unsigned char digest[OSCAP_DIGEST_SIZE];
+	uint64_t size;
+	char *path = _oval_cache_path(source, digest, &size);
+	if (path == NULL)
+		return;
+
+	if (_oval_compiled_write(model, digest, size, path, true) != 0) {
+		char *err = oscap_err_get_full_error();
+		dW("Could not store OVAL Definitions of %s to cache '%s': %s", oscap_source_readable_origin(source), path, err);
+		free(err);
+	} else {
+		dI("Stored OVAL Definitions of %s to cache '%s'.", oscap_source_readable_origin(source), path);
+	}
+	free(path);
+}
@@ -243,12 +243,18 @@ static inline int _oval_definition_model_merge_source(struct oval_definition_mod
 
 struct oval_definition_model *oval_definition_model_import_source(struct oscap_source *source)
 {
-        struct oval_definition_model *model = oval_definition_model_new();
+	struct oval_definition_model *model = oval_definition_model_cache_load(source);
+	if (model != NULL)
+		return model;
+
+        model = oval_definition_model_new();
 	int ret = _oval_definition_model_merge_source(model, source);
         if (ret == -1 ) {
                 oval_definition_model_free(model);
                 model = NULL;
-        }
+        } else {
+		oval_definition_model_cache_store(model, source);
+	}
 	return model;
 }
 
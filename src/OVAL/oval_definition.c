@@ -319,6 +319,19 @@ void oval_definition_add_note(struct oval_definition *definition, char *note) {
 	oval_collection_add(definition->notes, note);
 }
 
+const char *oval_definition_get_anyxml(struct oval_definition *definition)
+{
+	__attribute__nonnull__(definition);
+	return definition->anyxml;
+}
+
+void oval_definition_set_anyxml(struct oval_definition *definition, const char *anyxml)
+{
+	__attribute__nonnull__(definition);
+	free(definition->anyxml);
+	definition->anyxml = oscap_strdup(anyxml);
+}
+
 static void _oval_definition_title_consumer(char *string, void *user)
 {
 	__attribute__nonnull__(user);
@@ -86,6 +86,8 @@ int oval_reference_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, ova
 
 int oval_definition_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_definition_to_dom(struct oval_definition *, xmlDoc *, xmlNode *);
+const char *oval_definition_get_anyxml(struct oval_definition *);
+void oval_definition_set_anyxml(struct oval_definition *, const char *);
 
 int oval_object_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_object_to_dom(struct oval_object *, xmlDoc *, xmlNode *);
@@ -123,6 +125,8 @@ int oval_behavior_parse_tag(xmlTextReaderPtr, struct oval_parser_context *,
 
 int oval_entity_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, oscap_consumer_func, void *);
 xmlNode *oval_entity_to_dom(struct oval_entity *, xmlDoc *, xmlNode *);
+bool oval_entity_get_xsi_nil(const struct oval_entity *entity);
+void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil);
 
 int oval_record_field_parse_tag(xmlTextReaderPtr, struct oval_parser_context *,
 				oscap_consumer_func, void *, oval_record_field_type_t);
@@ -159,6 +163,9 @@ void oval_message_to_dom(struct oval_message *, xmlDoc *, xmlNode *);
 /* generator */
 int oval_generator_parse_tag(xmlTextReader *, struct oval_parser_context *, void *user);
 xmlNode *oval_generator_to_dom(struct oval_generator *, xmlDocPtr, xmlNode *);
+struct oscap_htable_iterator *oval_generator_get_platform_schema_versions(struct oval_generator *);
+const char *oval_generator_get_anyxml(struct oval_generator *);
+void oval_generator_set_anyxml(struct oval_generator *, const char *);
 
 /* definition_model */
 xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent);
@@ -181,11 +188,20 @@ oval_schema_version_t oval_definition_model_get_core_schema_version(struct oval_
 oval_schema_version_t oval_definition_model_get_platform_schema_version(struct oval_definition_model *model, const char *platform);
 
 struct oval_string_map *oval_definition_model_build_vardef_mapping(struct oval_definition_model *model);
+
+/* compiled model cache, enabled by the OSCAP_OVAL_CACHE_DIR environment variable */
+struct oval_definition_model *oval_definition_model_cache_load(struct oscap_source *source);
+void oval_definition_model_cache_store(struct oval_definition_model *model, struct oscap_source *source);
 struct oval_string_iterator *oval_definition_model_get_definitions_dependent_on_variable(struct oval_definition_model *model, struct oval_variable *variable);
 
 /* variable model */
 struct oval_collection *oval_variable_model_get_values_ref(struct oval_variable_model *, char *);
 int oval_variable_bind_ext_var(struct oval_variable *, struct oval_variable_model *, char *);
 bool oval_variable_contains_value(struct oval_variable *variable, const char* o_value_text);
+/**
+ * Forget the values computed for a local variable, they are computed
+ * again when the variable is next queried. Does nothing for other types.
+ */
+void oval_variable_reset_local_values(struct oval_variable *variable);
 
 #endif
@@ -73,9 +73,6 @@ struct oval_consume_varref_context {
 /* End of variable definitions
  * */
 /***************************************************************************/
-static inline bool oval_entity_get_xsi_nil(const struct oval_entity *entity);
-static inline void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil);
-
 
 bool oval_entity_iterator_has_more(struct oval_entity_iterator *oc_entity)
 {
@@ -131,7 +128,7 @@ int oval_entity_get_mask(struct oval_entity *entity)
 	return entity->mask;
 }
 
-static inline bool oval_entity_get_xsi_nil(const struct oval_entity *entity)
+bool oval_entity_get_xsi_nil(const struct oval_entity *entity)
 {
 	__attribute__nonnull__(entity);
 	return entity->xsi_nil;
@@ -242,7 +239,7 @@ void oval_entity_set_mask(struct oval_entity *entity, int mask)
 	entity->mask = mask;
 }
 
-static inline void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil)
+void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil)
 {
 	__attribute__nonnull__(entity);
 	entity->xsi_nil = xsi_nil;
@@ -174,6 +174,22 @@ void oval_generator_add_platform_schema_version(struct oval_generator *generator
 	oscap_htable_add(generator->platform_schema_versions, platform, oscap_strdup(schema_version));
 }
 
+struct oscap_htable_iterator *oval_generator_get_platform_schema_versions(struct oval_generator *generator)
+{
+	return oscap_htable_iterator_new(generator->platform_schema_versions);
+}
+
+const char *oval_generator_get_anyxml(struct oval_generator *generator)
+{
+	return generator->anyxml;
+}
+
+void oval_generator_set_anyxml(struct oval_generator *generator, const char *anyxml)
+{
+	free(generator->anyxml);
+	generator->anyxml = oscap_strdup(anyxml);
+}
+
 
 xmlNode *oval_generator_to_dom(struct oval_generator *generator, xmlDocPtr doc, xmlNode *parent)
 {
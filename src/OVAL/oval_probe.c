@@ -43,6 +43,8 @@
 #include "common/util.h"
 #include "common/bfind.h"
 #include "common/debug_priv.h"
+#include "common/oscap_timing_priv.h"
+#include "common/oscap_status_priv.h"
 
 #include "_oval_probe_session.h"
 #include "_oval_probe_handler.h"
@@ -94,7 +96,7 @@ static void _syschar_add_bindings(struct oval_syschar *sc, struct oval_string_ma
 	oval_collection_iterator_free(var_itr);
 }
 
-int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *object, int flags, struct oval_syschar **out_syschar)
+static int _oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *object, int flags, struct oval_syschar **out_syschar, bool *cached)
 {
 	char *oid;
 	struct oval_syschar *sysc;
@@ -129,6 +131,7 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
 			if (sc_flg != SYSCHAR_FLAG_UNKNOWN || (flags & OVAL_PDFLAG_NOREPLY)) {
 				if (out_syschar)
 					*out_syschar = sysc;
+				*cached = true;
 				return 0;
 			}
 		}
@@ -167,6 +170,58 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
 	return 0;
 }
 
+static size_t _oval_probe_syschar_item_count(struct oval_syschar *sysc)
+{
+	size_t count = 0;
+	struct oval_sysitem_iterator *it = oval_syschar_get_sysitem(sysc);
+
+	while (oval_sysitem_iterator_has_more(it)) {
+		oval_sysitem_iterator_next(it);
+		count++;
+	}
+	oval_sysitem_iterator_free(it);
+	return count;
+}
+
+int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *object, int flags, struct oval_syschar **out_syschar)
+{
+	struct oscap_timing_sample start;
+	struct oscap_timing_usage usage;
+	struct oscap_status_object status;
+	struct oval_syschar *sysc = NULL;
+	const char *probe;
+	bool cached = false;
+	size_t items;
+	int ret;
+
+	probe = oval_subtype_get_text(oval_object_get_subtype(object));
+	oscap_status_object_begin(&status, oval_object_get_id(object), probe);
+	if (!oscap_timing_enabled()) {
+		ret = _oval_probe_query_object(psess, object, flags, out_syschar, &cached);
+		oscap_status_object_end(&status);
+		return ret;
+	}
+
+	oscap_timing_sample(&start);
+	ret = _oval_probe_query_object(psess, object, flags, &sysc, &cached);
+	oscap_timing_usage_since(&start, &usage);
+	oscap_status_object_end(&status);
+	if (out_syschar)
+		*out_syschar = sysc;
+
+	items = sysc != NULL && !cached ? _oval_probe_syschar_item_count(sysc) : 0;
+	oscap_timing_record_object(oval_object_get_id(object), probe, &usage, items, cached);
+
+	if (sysc != NULL && !cached && oscap_timing_oval_messages()) {
+		char *msg = oscap_sprintf("Collected %zu item(s) by the %s probe in %.3f ms wall time, "
+				"%.3f ms CPU time, %llu bytes read.", items, probe, usage.wall_ms, usage.cpu_ms,
+				(unsigned long long) usage.bytes_read);
+		oval_syschar_add_new_message(sysc, msg, OVAL_MESSAGE_LEVEL_INFO);
+		free(msg);
+	}
+	return ret;
+}
+
 int oval_probe_query_sysinfo(oval_probe_session_t *sess, struct oval_sysinfo **out_sysinfo)
 {
 	struct oval_sysinfo *sysinf;
@@ -929,6 +929,31 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
                 }
                 break;
         }
+	case PROBE_HANDLER_ACT_EVICT:
+	{
+		SEXP_t *ids = va_arg(ap, SEXP_t *);
+
+		va_end(ap);
+
+		if (pext->pdtbl == NULL)
+			return(0);
+		/*
+		 * Objects of one type can be used by probes of other types
+		 * (sets, filters, object components), evict the IDs from the
+		 * cache of every running probe.
+		 */
+		for (size_t i = 0; i < pext->pdtbl->count; ++i) {
+			pd = pext->pdtbl->memb[i];
+
+			if (pd == NULL)
+				continue;
+
+			if ((ret = oval_probe_ext_evict(pext->pdtbl->ctx, pd, pext, ids)) != 0)
+				return(ret);
+		}
+
+		return(0);
+	}
         case PROBE_HANDLER_ACT_FREE:
         case PROBE_HANDLER_ACT_CLOSE:
         default:
@@ -1020,6 +1045,16 @@ int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext)
         return (0);
 }
 
+int oval_probe_ext_evict(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, SEXP_t *ids)
+{
+	SEXP_t *res;
+
+	res = SEAP_cmd_exec(ctx, pd->sd, SEAP_EXEC_RECV, PROBECMD_EVICT, ids, SEAP_CMDTYPE_SYNC, NULL, NULL);
+	SEXP_free(res);
+
+	return (0);
+}
+
 #include <signal.h>
 #include "SEAP/_seap-types.h"
 #include "SEAP/seap-descriptor.h"
@@ -60,6 +60,7 @@ int oval_probe_ext_init(oval_pext_t *pext);
 int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags);
 int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
 int oval_probe_ext_abort(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
+int oval_probe_ext_evict(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, SEXP_t *ids);
 
 int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...);
 int oval_probe_sys_handler(oval_subtype_t type, void *ptr, int act, ...);
@@ -28,6 +28,9 @@
 #include "public/oval_system_characteristics.h"
 #include "oval_system_characteristics_impl.h"
 #include "oval_probe_impl.h"
+#include "oval_definitions_impl.h"
+#include "collectVarRefs_impl.h"
+#include "adt/oval_string_map_impl.h"
 #include "_oval_probe_session.h"
 
 static int _oval_probe_hint_criteria(oval_probe_session_t *sess, struct oval_criteria_node *cnode, int variable_instance_hint);
@@ -99,3 +102,90 @@ int _oval_probe_hint_object(oval_probe_session_t *psess, struct oval_object *obj
 	}
 	return 0;
 }
+
+static bool _oval_probe_refs_changed(struct oval_string_map *refs, struct oval_string_map *changed)
+{
+	bool ret = false;
+	struct oval_string_iterator *it = (struct oval_string_iterator *) oval_string_map_keys(refs);
+	while (!ret && oval_string_iterator_has_more(it)) {
+		if (oval_string_map_get_value(changed, oval_string_iterator_next(it)) != NULL)
+			ret = true;
+	}
+	oval_string_iterator_free(it);
+	return ret;
+}
+
+/**
+ * Invalidates everything collected so far which depends on any of the changed
+ * variables, directly or through local variables, sets, filters and object
+ * components. The collected objects (oval_syschars) get the hint that a new
+ * round of collection is needed, the results the probes have cached for these
+ * objects and for the states are dropped and the values of the affected local
+ * variables are computed again. Everything else stays collected, so that the
+ * objects which don't depend on the variables are not probed again.
+ * @param changed map of the IDs of the variables whose values have changed
+ * @returns 0 on success; -1 on error
+ */
+int oval_probe_hint_variables(oval_probe_session_t *sess, struct oval_definition_model *model, struct oval_string_map *changed)
+{
+	SEXP_t *ids = SEXP_list_new(NULL);
+	struct oval_string_map *refs;
+
+	struct oval_object_iterator *obj_it = oval_definition_model_get_objects(model);
+	while (oval_object_iterator_has_more(obj_it)) {
+		struct oval_object *object = oval_object_iterator_next(obj_it);
+
+		refs = oval_string_map_new();
+		oval_obj_collect_var_refs(object, refs);
+		if (_oval_probe_refs_changed(refs, changed)) {
+			const char *oid = oval_object_get_id(object);
+			struct oval_syschar *syschar = oval_syschar_model_get_syschar(sess->sys_model, oid);
+			if (syschar != NULL) {
+				int instance = oval_syschar_get_variable_instance(syschar);
+				/* the object might have been hinted already by oval_probe_hint_definition */
+				if (oval_syschar_get_variable_instance_hint(syschar) == instance)
+					oval_syschar_set_variable_instance_hint(syschar, instance + 1);
+			}
+			SEXP_t *id = SEXP_string_newf("%s", oid);
+			SEXP_list_add(ids, id);
+			SEXP_free(id);
+		}
+		oval_string_map_free(refs, NULL);
+	}
+	oval_object_iterator_free(obj_it);
+
+	struct oval_state_iterator *ste_it = oval_definition_model_get_states(model);
+	while (oval_state_iterator_has_more(ste_it)) {
+		struct oval_state *state = oval_state_iterator_next(ste_it);
+
+		refs = oval_string_map_new();
+		oval_ste_collect_var_refs(state, refs);
+		if (_oval_probe_refs_changed(refs, changed)) {
+			SEXP_t *id = SEXP_string_newf("%s", oval_state_get_id(state));
+			SEXP_list_add(ids, id);
+			SEXP_free(id);
+		}
+		oval_string_map_free(refs, NULL);
+	}
+	oval_state_iterator_free(ste_it);
+
+	struct oval_variable_iterator *var_it = oval_definition_model_get_variables(model);
+	while (oval_variable_iterator_has_more(var_it)) {
+		struct oval_variable *variable = oval_variable_iterator_next(var_it);
+		if (oval_variable_get_type(variable) != OVAL_VARIABLE_LOCAL)
+			continue;
+
+		refs = oval_string_map_new();
+		oval_var_collect_var_refs(variable, refs);
+		if (_oval_probe_refs_changed(refs, changed))
+			oval_variable_reset_local_values(variable);
+		oval_string_map_free(refs, NULL);
+	}
+	oval_variable_iterator_free(var_it);
+
+	int ret = 0;
+	if (SEXP_list_length(ids) > 0)
+		ret = oval_probe_session_evict(sess, ids);
+	SEXP_free(ids);
+	return ret;
+}
@@ -62,6 +62,26 @@ void oval_probe_tblinit(void);
 const char *oval_subtype_to_str(oval_subtype_t subtype);
 
 int oval_probe_hint_definition(oval_probe_session_t *sess, struct oval_definition *definition, int variable_instance_hint);
+int oval_probe_hint_variables(oval_probe_session_t *sess, struct oval_definition_model *model, struct oval_string_map *changed);
+
+/**
+ * Compute the provenance stamp of an object, it changes whenever the object,
+ * the inputs of its collection or the machine ID of the scanned system change.
+ * @returns stamp to be freed by the caller, or NULL if the object has to be collected on every scan
+ */
+char *oval_probe_provenance_stamp(struct oval_object *object, const char *machine_id);
+/** @returns map of ids of all stamped objects of the model to their stamps */
+struct oval_string_map *oval_probe_provenance_stamps(struct oval_definition_model *model);
+/**
+ * Copy objects with unchanged stamps from the scan saved under the state path into the model.
+ * @returns number of reused objects, -1 if the saved scan can't be read
+ */
+int oval_probe_provenance_reuse(struct oval_syschar_model *model, struct oval_string_map *stamps, const char *state);
+/**
+ * Save the system characteristics and the stamps of the collected objects under the state path.
+ * @returns 0 on success, -1 on error
+ */
+int oval_probe_provenance_save(struct oval_syschar_model *model, struct oval_string_map *stamps, const char *state);
 
 #endif /* OVAL_PROBE_IMPL_H */
 /// @}
@@ -0,0 +1,591 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+/*
+ * Provenance of collected objects for incremental scans.
+ *
+ * Each object whose collection depends only on inputs that can be cheaply
+ * checked gets a stamp. The stamp combines a fingerprint of the object itself
+ * with the stat data of the files the probe reads (or of the package database
+ * for package objects). When the previous scan left a stamp equal to the
+ * current one, the items collected by the previous scan are reused and the
+ * object is not sent to the probe at all.
+ *
+ * Only objects without variable references, sets and filters are stamped,
+ * and only those addressed by an exact path. Everything else, including the
+ * objects backed by /proc or by running services, is always collected again.
+ *
+ * The stamps are SHA-256 digests and include the machine ID of the scanned
+ * system. A previous scan is reused only if it was done on a system with the
+ * same host name and the same network interfaces (names and MAC addresses),
+ * the addresses assigned to the interfaces may change between the scans.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "public/oval_definitions.h"
+#include "public/oval_system_characteristics.h"
+#include "oval_system_characteristics_impl.h"
+#include "oval_definitions_impl.h"
+#include "oval_probe_impl.h"
+#include "adt/oval_string_map_impl.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/util.h"
+#include "common/oscap_acquire.h"
+#include "common/oscap_digest.h"
+#include "oscap_helpers.h"
+#include "source/public/oscap_source.h"
+
+#define PROVENANCE_HEADER "oscap-provenance 2"
+#define PROVENANCE_SYSCHAR_SUFFIX ".syschar.xml"
+#define PROVENANCE_STAMPS_SUFFIX ".provenance"
+
+/* reused items get ids which the probes never generate */
+#define PROVENANCE_ITEM_ID_FORMAT "2%u"
+
+#define PROVENANCE_MACHINE_ID "/etc/machine-id"
+
+static void _digest_str(struct oscap_digest *digest, const char *str)
+{
+	/* the terminating zero separates fields */
+	if (str == NULL)
+		oscap_digest_update(digest, "\x01", 1);
+	else
+		oscap_digest_update(digest, str, strlen(str) + 1);
+}
+
+static void _digest_int(struct oscap_digest *digest, long long value)
+{
+	oscap_digest_update(digest, &value, sizeof(value));
+}
+
+#if !defined(OS_WINDOWS)
+/* the bdb, ndb and sqlite backends in the default locations of %_dbpath */
+static const char *rpmdb_files[] = {
+	"/var/lib/rpm/Packages",
+	"/var/lib/rpm/Packages.db",
+	"/var/lib/rpm/rpmdb.sqlite",
+	"/var/lib/rpm/rpmdb.sqlite-wal",
+	"/usr/lib/sysimage/rpm/Packages",
+	"/usr/lib/sysimage/rpm/Packages.db",
+	"/usr/lib/sysimage/rpm/rpmdb.sqlite",
+	"/usr/lib/sysimage/rpm/rpmdb.sqlite-wal",
+	NULL
+};
+
+static const char *dpkgdb_files[] = {
+	"/var/lib/dpkg/status",
+	NULL
+};
+
+/*
+ * Mix the stat data of the path (and of the target of a symlink) into the digest.
+ * A missing file is an input as well, its appearance must be noticed.
+ * @returns 0 on success, -1 if the path can't be checked
+ */
+static int _stamp_path(struct oscap_digest *digest, const char *prefix, const char *path)
+{
+	char *real_path = oscap_sprintf("%s%s", prefix != NULL ? prefix : "", path);
+	struct stat st[2];
+	int ret = 0;
+
+	_digest_str(digest, path);
+	for (int i = 0; i < 2; i++) {
+		if ((i == 0 ? lstat(real_path, &st[i]) : stat(real_path, &st[i])) != 0) {
+			if (errno != ENOENT && errno != ENOTDIR) {
+				ret = -1;
+				break;
+			}
+			_digest_str(digest, "-");
+			continue;
+		}
+		_digest_int(digest, st[i].st_dev);
+		_digest_int(digest, st[i].st_ino);
+		_digest_int(digest, st[i].st_mode);
+		_digest_int(digest, st[i].st_uid);
+		_digest_int(digest, st[i].st_gid);
+		_digest_int(digest, st[i].st_size);
+		_digest_int(digest, st[i].st_mtim.tv_sec);
+		_digest_int(digest, st[i].st_mtim.tv_nsec);
+		_digest_int(digest, st[i].st_ctim.tv_sec);
+		_digest_int(digest, st[i].st_ctim.tv_nsec);
+	}
+	free(real_path);
+	return ret;
+}
+
+static int _stamp_paths(struct oscap_digest *digest, const char *prefix, const char **paths)
+{
+	for (int i = 0; paths[i] != NULL; i++) {
+		if (_stamp_path(digest, prefix, paths[i]) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * Mix the stat data of the files of a package database into the digest.
+ * When none of them exists, the database is kept elsewhere (e.g. in
+ * a custom %_dbpath of rpm) and its changes could not be noticed.
+ * @returns 0 on success, -1 if the database can't be checked
+ */
+static int _stamp_db_paths(struct oscap_digest *digest, const char *prefix, const char **paths)
+{
+	bool found = false;
+	for (int i = 0; paths[i] != NULL && !found; i++) {
+		char *real_path = oscap_sprintf("%s%s", prefix != NULL ? prefix : "", paths[i]);
+		found = access(real_path, F_OK) == 0;
+		free(real_path);
+	}
+	if (!found) {
+		dI("No package database found among the known files, it can't be stamped.");
+		return -1;
+	}
+	return _stamp_paths(digest, prefix, paths);
+}
+
+/* @returns value of an entity compared for equality, or NULL */
+static const char *_equal_value(struct oval_entity *entity, bool *nil)
+{
+	if (entity == NULL || oval_entity_get_operation(entity) != OVAL_OPERATION_EQUALS)
+		return NULL;
+	if (oval_entity_get_xsi_nil(entity)) {
+		*nil = true;
+		return NULL;
+	}
+	struct oval_value *value = oval_entity_get_value(entity);
+	return value != NULL ? oval_value_get_text(value) : NULL;
+}
+
+/*
+ * Fingerprint the object and find the entities giving its path.
+ * @returns false if the object depends on anything but its own content
+ */
+static bool _fingerprint_object(struct oval_object *object, struct oscap_digest *digest,
+		struct oval_entity **filepath, struct oval_entity **path, struct oval_entity **filename)
+{
+	if (oval_object_get_base_obj(object) != NULL)
+		return false;
+
+	_digest_int(digest, oval_object_get_subtype(object));
+	_digest_int(digest, oval_object_get_version(object));
+
+	bool static_object = true;
+	struct oval_behavior_iterator *behaviors = oval_object_get_behaviors(object);
+	while (oval_behavior_iterator_has_more(behaviors)) {
+		struct oval_behavior *behavior = oval_behavior_iterator_next(behaviors);
+		const char *key = oval_behavior_get_key(behavior);
+		const char *value = oval_behavior_get_value(behavior);
+		/* a recursive search reads more than the stamped path */
+		if (oscap_streq(key, "recurse_direction") && !oscap_streq(value, "none"))
+			static_object = false;
+		_digest_str(digest, key);
+		_digest_str(digest, value);
+	}
+	oval_behavior_iterator_free(behaviors);
+
+	struct oval_object_content_iterator *contents = oval_object_get_object_contents(object);
+	while (static_object && oval_object_content_iterator_has_more(contents)) {
+		struct oval_object_content *content = oval_object_content_iterator_next(contents);
+		if (oval_object_content_get_type(content) != OVAL_OBJECTCONTENT_ENTITY) {
+			static_object = false;
+			break;
+		}
+		struct oval_entity *entity = oval_object_content_get_entity(content);
+		if (oval_entity_get_varref_type(entity) != OVAL_ENTITY_VARREF_NONE) {
+			static_object = false;
+			break;
+		}
+		const char *name = oval_entity_get_name(entity);
+		struct oval_value *value = oval_entity_get_value(entity);
+		_digest_str(digest, name);
+		_digest_int(digest, oval_entity_get_operation(entity));
+		_digest_int(digest, oval_entity_get_datatype(entity));
+		_digest_int(digest, oval_object_content_get_varCheck(content));
+		_digest_int(digest, oval_entity_get_xsi_nil(entity));
+		_digest_str(digest, value != NULL ? oval_value_get_text(value) : NULL);
+
+		if (oscap_streq(name, "filepath"))
+			*filepath = entity;
+		else if (oscap_streq(name, "path"))
+			*path = entity;
+		else if (oscap_streq(name, "filename"))
+			*filename = entity;
+	}
+	oval_object_content_iterator_free(contents);
+
+	return static_object;
+}
+
+/* @returns the machine ID of the scanned system, or NULL if it has none */
+static char *_read_machine_id(const char *prefix)
+{
+	char *path = oscap_sprintf("%s%s", prefix != NULL ? prefix : "", PROVENANCE_MACHINE_ID);
+	FILE *fp = fopen(path, "r");
+	char line[256];
+	char *machine_id = NULL;
+
+	free(path);
+	if (fp == NULL)
+		return NULL;
+	if (fgets(line, sizeof(line), fp) != NULL) {
+		line[strcspn(line, "\n")] = '\0';
+		machine_id = oscap_strdup(line);
+	}
+	fclose(fp);
+	return machine_id;
+}
+
+char *oval_probe_provenance_stamp(struct oval_object *object, const char *machine_id)
+{
+	struct oval_entity *filepath = NULL, *path = NULL, *filename = NULL;
+	const char *prefix = getenv("OSCAP_PROBE_ROOT");
+	unsigned char result[OSCAP_DIGEST_SIZE];
+	int ret = -1;
+
+	struct oscap_digest *digest = oscap_digest_new();
+	if (digest == NULL) {
+		char *err = oscap_err_get_full_error();
+		dW("Object '%s' can't be stamped: %s", oval_object_get_id(object), err);
+		free(err);
+		return NULL;
+	}
+	if (!_fingerprint_object(object, digest, &filepath, &path, &filename)) {
+		oscap_digest_free(digest);
+		return NULL;
+	}
+
+	_digest_str(digest, prefix);
+	_digest_str(digest, machine_id);
+	switch ((int) oval_object_get_subtype(object)) {
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT_54:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT:
+	case OVAL_INDEPENDENT_FILE_HASH:
+	case OVAL_INDEPENDENT_FILE_HASH58:
+	case OVAL_INDEPENDENT_XML_FILE_CONTENT:
+	case OVAL_INDEPENDENT_YAML_FILE_CONTENT:
+	case OVAL_UNIX_FILE:
+	case OVAL_UNIX_FILEEXTENDEDATTRIBUTE: {
+		bool nil = false;
+		const char *value;
+		if ((value = _equal_value(filepath, &nil)) != NULL) {
+			ret = _stamp_path(digest, prefix, value);
+		} else if (filepath == NULL && (value = _equal_value(path, &nil)) != NULL) {
+			const char *name = _equal_value(filename, &nil);
+			if (name != NULL) {
+				char *full_path = oscap_sprintf("%s/%s", value, name);
+				ret = _stamp_path(digest, prefix, full_path);
+				free(full_path);
+			} else if (nil) {
+				/* the object is the directory itself */
+				ret = _stamp_path(digest, prefix, value);
+			}
+		}
+		break;
+	}
+	case OVAL_LINUX_RPM_INFO:
+		ret = _stamp_db_paths(digest, prefix, rpmdb_files);
+		break;
+	case OVAL_LINUX_DPKG_INFO:
+		ret = _stamp_db_paths(digest, prefix, dpkgdb_files);
+		break;
+	default:
+		break;
+	}
+	if (ret != 0) {
+		oscap_digest_free(digest);
+		return NULL;
+	}
+	if (oscap_digest_finish(digest, result) != 0) {
+		char *err = oscap_err_get_full_error();
+		dW("Object '%s' can't be stamped: %s", oval_object_get_id(object), err);
+		free(err);
+		return NULL;
+	}
+
+	char *stamp = malloc(2 * OSCAP_DIGEST_SIZE + 1);
+	for (size_t i = 0; stamp != NULL && i < OSCAP_DIGEST_SIZE; i++)
+		snprintf(stamp + 2 * i, 3, "%02x", result[i]);
+	return stamp;
+}
+#else
+static char *_read_machine_id(const char *prefix)
+{
+	return NULL;
+}
+
+char *oval_probe_provenance_stamp(struct oval_object *object, const char *machine_id)
+{
+	return NULL;
+}
+#endif
+
+struct oval_string_map *oval_probe_provenance_stamps(struct oval_definition_model *model)
+{
+	struct oval_string_map *stamps = oval_string_map_new();
+	char *machine_id = _read_machine_id(getenv("OSCAP_PROBE_ROOT"));
+	struct oval_object_iterator *objects = oval_definition_model_get_objects(model);
+	while (oval_object_iterator_has_more(objects)) {
+		struct oval_object *object = oval_object_iterator_next(objects);
+		char *stamp = oval_probe_provenance_stamp(object, machine_id);
+		if (stamp != NULL)
+			oval_string_map_put(stamps, oval_object_get_id(object), stamp);
+	}
+	oval_object_iterator_free(objects);
+	free(machine_id);
+	return stamps;
+}
+
+/* @returns map of object ids to stamps stored by the previous scan, or NULL */
+static struct oval_string_map *_read_stamps(const char *filename)
+{
+	FILE *fp = fopen(filename, "r");
+	if (fp == NULL)
+		return NULL;
+
+	struct oval_string_map *stamps = NULL;
+	char line[4096];
+	if (fgets(line, sizeof(line), fp) != NULL && strcmp(line, PROVENANCE_HEADER "\n") == 0) {
+		stamps = oval_string_map_new();
+		while (fgets(line, sizeof(line), fp) != NULL) {
+			char *sep = strchr(line, ' ');
+			char *end = strchr(line, '\n');
+			if (sep == NULL || end == NULL)
+				continue;
+			*sep = *end = '\0';
+			oval_string_map_put_string(stamps, line, sep + 1);
+		}
+	} else {
+		dW("Ignoring '%s', it is not a provenance file.", filename);
+	}
+	fclose(fp);
+	return stamps;
+}
+
+static struct oval_sysitem *_reuse_item(struct oval_syschar_model *model, struct oval_sysitem *old_item,
+		struct oval_string_map *renamed, unsigned int *counter)
+{
+	struct oval_sysitem *item = oval_string_map_get_value(renamed, oval_sysitem_get_id(old_item));
+	if (item != NULL)
+		return item;
+
+	char id[32];
+	do {
+		snprintf(id, sizeof(id), PROVENANCE_ITEM_ID_FORMAT, ++(*counter));
+	} while (oval_syschar_model_get_sysitem(model, id) != NULL);
+
+	item = oval_sysitem_clone_as(model, old_item, id);
+	oval_string_map_put(renamed, oval_sysitem_get_id(old_item), item);
+	return item;
+}
+
+static void _reuse_syschar(struct oval_syschar_model *model, struct oval_object *object, struct oval_syschar *old_syschar,
+		struct oval_string_map *renamed, unsigned int *counter)
+{
+	struct oval_syschar *syschar = oval_syschar_new(model, object);
+	oval_syschar_set_flag(syschar, oval_syschar_get_flag(old_syschar));
+
+	struct oval_message_iterator *messages = oval_syschar_get_messages(old_syschar);
+	while (oval_message_iterator_has_more(messages))
+		oval_syschar_add_message(syschar, oval_message_clone(oval_message_iterator_next(messages)));
+	oval_message_iterator_free(messages);
+
+	struct oval_sysitem_iterator *items = oval_syschar_get_sysitem(old_syschar);
+	while (oval_sysitem_iterator_has_more(items)) {
+		struct oval_sysitem *old_item = oval_sysitem_iterator_next(items);
+		oval_syschar_add_sysitem(syschar, _reuse_item(model, old_item, renamed, counter));
+	}
+	oval_sysitem_iterator_free(items);
+}
+
+/*
+ * The machine ID is a part of the stamps, the host name and the interfaces
+ * are compared here. The addresses of the interfaces are not compared,
+ * a DHCP lease must not invalidate the previous scan.
+ */
+static bool _same_system(struct oval_sysinfo *old_info, struct oval_sysinfo *info)
+{
+	if (old_info == NULL || info == NULL ||
+			!oscap_streq(oval_sysinfo_get_primary_host_name(old_info), oval_sysinfo_get_primary_host_name(info)))
+		return false;
+
+	bool same = true;
+	struct oval_sysint_iterator *old_ifs = oval_sysinfo_get_interfaces(old_info);
+	struct oval_sysint_iterator *ifs = oval_sysinfo_get_interfaces(info);
+	while (same && oval_sysint_iterator_has_more(old_ifs) && oval_sysint_iterator_has_more(ifs)) {
+		struct oval_sysint *old_if = oval_sysint_iterator_next(old_ifs);
+		struct oval_sysint *new_if = oval_sysint_iterator_next(ifs);
+		same = oscap_streq(oval_sysint_get_name(old_if), oval_sysint_get_name(new_if)) &&
+			oscap_streq(oval_sysint_get_mac_address(old_if), oval_sysint_get_mac_address(new_if));
+	}
+	if (oval_sysint_iterator_has_more(old_ifs) || oval_sysint_iterator_has_more(ifs))
+		same = false;
+	oval_sysint_iterator_free(old_ifs);
+	oval_sysint_iterator_free(ifs);
+	return same;
+}
+
+static bool _reusable_flag(oval_syschar_collection_flag_t flag)
+{
+	return flag == SYSCHAR_FLAG_COMPLETE || flag == SYSCHAR_FLAG_DOES_NOT_EXIST;
+}
+
+int oval_probe_provenance_reuse(struct oval_syschar_model *model, struct oval_string_map *stamps, const char *state)
+{
+	char *stamps_file = oscap_sprintf("%s%s", state, PROVENANCE_STAMPS_SUFFIX);
+	char *syschar_file = oscap_sprintf("%s%s", state, PROVENANCE_SYSCHAR_SUFFIX);
+	struct oval_string_map *old_stamps = _read_stamps(stamps_file);
+	int reused = 0;
+
+	if (old_stamps == NULL || access(syschar_file, R_OK) != 0) {
+		dI("No previous scan in '%s', all objects will be collected.", state);
+		goto cleanup;
+	}
+
+	/* The objects of the previous scan are not looked up in the definitions being
+	 * evaluated now, the stamps tell which of them are still the same. */
+	struct oval_definition_model *old_def_model = oval_definition_model_new();
+	struct oval_syschar_model *old_model = oval_syschar_model_new(old_def_model);
+	struct oscap_source *source = oscap_source_new_from_file(syschar_file);
+	int ret = oval_syschar_model_import_source(old_model, source);
+	oscap_source_free(source);
+	if (ret != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "Could not load the previous scan from '%s'.", syschar_file);
+		reused = -1;
+		goto free_models;
+	}
+
+	struct oval_sysinfo *old_info = oval_syschar_model_get_sysinfo(old_model);
+	struct oval_sysinfo *info = oval_syschar_model_get_sysinfo(model);
+	if (!_same_system(old_info, info)) {
+		dI("The previous scan in '%s' comes from another system, all objects will be collected.", state);
+		goto free_models;
+	}
+
+	struct oval_definition_model *def_model = oval_syschar_model_get_definition_model(model);
+	struct oval_string_map *renamed = oval_string_map_new();
+	unsigned int counter = 0;
+	struct oval_iterator *ids = oval_string_map_keys(stamps);
+	while (oval_collection_iterator_has_more(ids)) {
+		const char *id = oval_collection_iterator_next(ids);
+		const char *old_stamp = oval_string_map_get_value(old_stamps, id);
+		if (old_stamp == NULL || strcmp(old_stamp, oval_string_map_get_value(stamps, id)) != 0)
+			continue;
+		struct oval_syschar *old_syschar = oval_syschar_model_get_syschar(old_model, id);
+		if (old_syschar == NULL || !_reusable_flag(oval_syschar_get_flag(old_syschar)))
+			continue;
+		if (oval_syschar_model_get_syschar(model, id) != NULL)
+			continue;
+		_reuse_syschar(model, oval_definition_model_get_object(def_model, id), old_syschar, renamed, &counter);
+		reused++;
+	}
+	oval_collection_iterator_free(ids);
+	oval_string_map_free(renamed, NULL);
+	dI("Reusing %d objects collected by the previous scan in '%s'.", reused, state);
+
+free_models:
+	oval_syschar_model_free(old_model);
+	oval_definition_model_free(old_def_model);
+cleanup:
+	if (old_stamps != NULL)
+		oval_string_map_free(old_stamps, free);
+	free(stamps_file);
+	free(syschar_file);
+	return reused;
+}
+
+static int _write_stamps(struct oval_syschar_model *model, struct oval_string_map *stamps, const char *filename)
+{
+	FILE *fp = fopen(filename, "w");
+	if (fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write %s: %s", filename, strerror(errno));
+		return -1;
+	}
+
+	fprintf(fp, "%s\n", PROVENANCE_HEADER);
+	struct oval_iterator *ids = oval_string_map_keys(stamps);
+	while (oval_collection_iterator_has_more(ids)) {
+		const char *id = oval_collection_iterator_next(ids);
+		struct oval_syschar *syschar = oval_syschar_model_get_syschar(model, id);
+		if (syschar != NULL && _reusable_flag(oval_syschar_get_flag(syschar)))
+			fprintf(fp, "%s %s\n", id, (const char *) oval_string_map_get_value(stamps, id));
+	}
+	oval_collection_iterator_free(ids);
+
+	bool failed = ferror(fp) != 0;
+	if (fclose(fp) != 0 || failed) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write %s: %s", filename, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+int oval_probe_provenance_save(struct oval_syschar_model *model, struct oval_string_map *stamps, const char *state)
+{
+	char *state_copy = oscap_strdup(state);
+	char *dir = oscap_dirname(state_copy);
+	char *stamps_file = oscap_sprintf("%s%s", state, PROVENANCE_STAMPS_SUFFIX);
+	char *syschar_file = oscap_sprintf("%s%s", state, PROVENANCE_SYSCHAR_SUFFIX);
+	char *tmp_stamps = oscap_sprintf("%s.tmp", stamps_file);
+	char *tmp_syschar = oscap_sprintf("%s.tmp", syschar_file);
+	int ret = -1;
+
+	if (oscap_acquire_mkdir_p(dir) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not create directory %s: %s", dir, strerror(errno));
+		goto cleanup;
+	}
+	/* Drop the stamps first, a crash in between must not leave stamps
+	 * pointing to system characteristics of another scan. */
+	if (unlink(stamps_file) != 0 && errno != ENOENT) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not remove %s: %s", stamps_file, strerror(errno));
+		goto cleanup;
+	}
+	if (oval_syschar_model_export(model, tmp_syschar) != 1 ||
+			_write_stamps(model, stamps, tmp_stamps) != 0)
+		goto cleanup;
+	if (rename(tmp_syschar, syschar_file) != 0 || rename(tmp_stamps, stamps_file) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not save the scan into %s: %s", state, strerror(errno));
+		goto cleanup;
+	}
+	ret = 0;
+
+cleanup:
+	if (ret != 0) {
+		unlink(tmp_syschar);
+		unlink(tmp_stamps);
+	}
+	free(tmp_stamps);
+	free(tmp_syschar);
+	free(stamps_file);
+	free(syschar_file);
+	free(dir);
+	free(state_copy);
+	return ret;
+}
@@ -192,6 +192,18 @@ int oval_probe_session_reset(oval_probe_session_t *sess, struct oval_syschar_mod
         return(0);
 }
 
+int oval_probe_session_evict(oval_probe_session_t *sess, SEXP_t *ids)
+{
+	oval_ph_t *ph;
+
+	if ((ph = oval_probe_handler_get(sess->ph, OVAL_SUBTYPE_ALL)) == NULL) {
+		dE("No probe handler for OVAL_SUBTYPE_ALL");
+		return (-1);
+	}
+
+	return ph->func(OVAL_SUBTYPE_ALL, ph->uptr, PROBE_HANDLER_ACT_EVICT, ids);
+}
+
 int oval_probe_session_abort(oval_probe_session_t *sess)
 {
 	oval_ph_t *ph;
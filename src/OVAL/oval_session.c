@@ -74,6 +74,9 @@ struct oval_session {
 		char *report;
 	} export;
 
+	/* directory with system characteristics of the previous scan */
+	char *incremental_state;
+
 	struct {
 		/* it's called when there is something invalid in input/output files */
 		xml_reporter xml_fn;
@@ -332,9 +335,23 @@ static int oval_session_setup_agent(struct oval_session *session)
 	free(path_clone);
 
 	oval_agent_set_product_name(session->sess, (char *)oscap_productname);
+
+	if (session->incremental_state != NULL &&
+			oval_agent_load_incremental_state(session->sess, session->incremental_state) < 0) {
+		char *err = oscap_err_get_full_error();
+		dW("All objects will be collected: %s", err);
+		free(err);
+	}
 	return 0;
 }
 
+static int oval_session_save_incremental_state(struct oval_session *session)
+{
+	if (session->incremental_state == NULL)
+		return 0;
+	return oval_agent_save_incremental_state(session->sess, session->incremental_state) == 0 ? 0 : 1;
+}
+
 int oval_session_evaluate_id(struct oval_session *session, const char *id, oval_result_t *result)
 {
 	__attribute__nonnull__(session);
@@ -354,6 +371,9 @@ int oval_session_evaluate_id(struct oval_session *session, const char *id, oval_
 	if (oscap_err()) {
 		return 1;
 	}
+	if (oval_session_save_incremental_state(session) != 0) {
+		return 1;
+	}
 
 	session->res_model = oval_agent_get_results_model(session->sess);
 
@@ -372,6 +392,9 @@ int oval_session_evaluate(struct oval_session *session, agent_reporter fn, void
 	if (oscap_err()) {
 		return 1;
 	}
+	if (oval_session_save_incremental_state(session) != 0) {
+		return 1;
+	}
 
 	session->res_model = oval_agent_get_results_model(session->sess);
 
@@ -451,6 +474,14 @@ void oval_session_set_export_system_characteristics(struct oval_session *session
 	session->export_sys_chars = export;
 }
 
+void oval_session_set_incremental_state(struct oval_session *session, const char *dir)
+{
+	__attribute__nonnull__(session);
+
+	free(session->incremental_state);
+	session->incremental_state = oscap_strdup(dir);
+}
+
 void oval_session_set_remote_resources(struct oval_session *session, bool allowed, download_progress_calllback_t callback)
 {
 	session->fetch_remote_resources = allowed;
@@ -469,6 +500,7 @@ void oval_session_free(struct oval_session *session)
 	free(session->component_id);
 	free(session->export.results);
 	free(session->export.report);
+	free(session->incremental_state);
 	if (session->sess)
 		oval_agent_destroy_session(session->sess);
 	if (session->def_model)
@@ -49,6 +49,8 @@ int oval_sysinfo_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *
 /* sysitem */
 void oval_sysitem_to_dom(struct oval_sysitem *, xmlDoc *, xmlNode *);
 int oval_sysitem_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, void *usr);
+/* clone the item into new_model under a different id */
+struct oval_sysitem *oval_sysitem_clone_as(struct oval_syschar_model *new_model, struct oval_sysitem *old_item, const char *id);
 
 /* syschar */
 void oval_syschar_to_dom(struct oval_syschar *, xmlDoc *, xmlNode *);
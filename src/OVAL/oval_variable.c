@@ -904,6 +904,21 @@ void oval_variable_clear_values(struct oval_variable *variable)
 	}
 }
 
+void oval_variable_reset_local_values(struct oval_variable *variable)
+{
+	__attribute__nonnull__(variable);
+
+	if (variable->type != OVAL_VARIABLE_LOCAL)
+		return;
+
+	oval_variable_LOCAL_t *lvar = (oval_variable_LOCAL_t *) variable;
+	if (lvar->values) {
+		oval_collection_free_items(lvar->values, (oscap_destruct_func) oval_value_free);
+		lvar->values = NULL;
+	}
+	lvar->flag = SYSCHAR_FLAG_UNKNOWN;
+}
+
 static int oval_value_satisfies_possible_restriction(struct oval_value *value, struct oval_variable_possible_restriction *pr)
 {
 	oval_datatype_t datatype = oval_value_get_datatype(value);
@@ -208,6 +208,11 @@ void *rbt_str_rep(rbt_t *rbt, const char *key, void *data)
 }
 
 int rbt_str_del(rbt_t *rbt, const char *key, void **n)
+{
+        return rbt_str_del2(rbt, key, NULL, n);
+}
+
+int rbt_str_del2(rbt_t *rbt, const char *key, char **k, void **n)
 {
         struct rbt_node fake, *save;
         struct rbt_node *h[4];
@@ -226,6 +231,7 @@ int rbt_str_del(rbt_t *rbt, const char *key, void **n)
         }
 
 	if (rbt_node_ptr(rbt->root) == NULL) {
+		rbt_wunlock(rbt);
 		return -1;
 	}
 
@@ -336,10 +342,13 @@ int rbt_str_del(rbt_t *rbt, const char *key, void **n)
                  */
 		if (rbt_node_ptr(fake._chld[RBT_NODE_SR]) != h[0]
 				&& rbt_node_getcolor(h[0]) != RBT_NODE_CR) {
+			rbt_wunlock(rbt);
 			return -1;
 		}
                 if (n != NULL)
                         *n = rbt_str_node(save)->data;
+                if (k != NULL)
+                        *k = rbt_str_node(save)->key;
 
                 rbt_str_node(save)->data = rbt_str_node(h[0])->data;
                 rbt_str_node(save)->key  = rbt_str_node(h[0])->key;
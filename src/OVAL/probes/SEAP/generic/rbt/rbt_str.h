@@ -45,6 +45,8 @@ void rbt_str_free_cb2 (rbt_t *rbt, void (*callback)(struct rbt_str_node *, void
 int rbt_str_add(rbt_t *rbt, char *key, void *data);
 void *rbt_str_rep(rbt_t *rbt, const char *key, void *data);
 int rbt_str_del(rbt_t *rbt, const char *key, void **n);
+/* like rbt_str_del, gives back the key of the deleted node in k as well */
+int rbt_str_del2(rbt_t *rbt, const char *key, char **k, void **n);
 int rbt_str_getnode(rbt_t *rbt, const char *key, struct rbt_str_node **node);
 int rbt_str_get(rbt_t *rbt, const char *key, void **data);
 
@@ -31,6 +31,7 @@
 #include "sch_queue.h"
 #include "seap-descriptor.h"
 #include "common/debug_priv.h"
+#include "common/oscap_status_priv.h"
 #include "../probe/probe_main.h"
 #include "oval_definitions.h"
 
@@ -92,6 +93,7 @@ SEXP_t *sch_queue_recvsexp(SEAP_desc_t *desc)
 	}
 	SEXP_t *sexp = oscap_queue_remove(queue);
 	(*cnt)--;
+	oscap_status_seap_queued(-1);
 	pthread_mutex_unlock(mutex);
 	return sexp;
 }
@@ -119,6 +121,7 @@ ssize_t sch_queue_sendsexp(SEAP_desc_t *desc, SEXP_t *sexp, uint32_t flags)
 	pthread_mutex_lock(mutex);
 	oscap_queue_add(queue, (void *) sexp_list);
 	(*cnt)++;
+	oscap_status_seap_queued(1);
 	pthread_cond_broadcast(cond);
 	pthread_mutex_unlock(mutex);
 	return 0;
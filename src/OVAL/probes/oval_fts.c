@@ -39,6 +39,7 @@
 #include "_probe-api.h"
 #include "probe/entcmp.h"
 #include "debug_priv.h"
+#include "oscap_status_priv.h"
 #include "oval_fts.h"
 #if defined(OS_SOLARIS)
 #include "fts_sun.h"
@@ -953,6 +954,7 @@ static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 		fts_ent = fts_read(ofts->ofts_match_path_fts);
 		if (fts_ent == NULL)
 			return NULL;
+		oscap_status_set_path(fts_ent->fts_path);
 		switch (fts_ent->fts_info) {
 		case FTS_DP:
 			continue;
@@ -1107,6 +1109,7 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 
 				return NULL;
 			}
+			oscap_status_set_path(fts_ent->fts_path);
 
 			switch (fts_ent->fts_info) {
 			case FTS_DP:
@@ -1238,6 +1241,7 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 				fts_ent = fts_read(ofts->ofts_recurse_path_fts);
 				if (fts_ent == NULL)
 					break;
+				oscap_status_set_path(fts_ent->fts_path);
 
 				/*
 				   it would be more accurate to obtain the device
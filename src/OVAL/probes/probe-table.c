@@ -256,10 +256,10 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_LINUX_DPKG_INFO, dpkginfo_probe_init, dpkginfo_probe_main, dpkginfo_probe_fini, dpkginfo_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_LINUX_IFLISTENERS
-	{OVAL_LINUX_IFLISTENERS, NULL, iflisteners_probe_main, NULL, NULL},
+	{OVAL_LINUX_IFLISTENERS, iflisteners_probe_init, iflisteners_probe_main, iflisteners_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_LINUX_INETLISTENINGSERVERS
-	{OVAL_LINUX_INET_LISTENING_SERVERS, NULL, inetlisteningservers_probe_main, NULL, NULL},
+	{OVAL_LINUX_INET_LISTENING_SERVERS, inetlisteningservers_probe_init, inetlisteningservers_probe_main, inetlisteningservers_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_LINUX_PARTITION
 	{OVAL_LINUX_PARTITION, partition_probe_init, partition_probe_main, NULL, NULL},
@@ -283,10 +283,10 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_LINUX_SELINUXSECURITYCONTEXT, NULL, selinuxsecuritycontext_probe_main, NULL, selinuxsecuritycontext_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_LINUX_SYSTEMDUNITDEPENDENCY
-	{OVAL_LINUX_SYSTEMDUNITDEPENDENCY, NULL, systemdunitdependency_probe_main, NULL, NULL},
+	{OVAL_LINUX_SYSTEMDUNITDEPENDENCY, systemdunitdependency_probe_init, systemdunitdependency_probe_main, systemdunitdependency_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_LINUX_SYSTEMDUNITPROPERTY
-	{OVAL_LINUX_SYSTEMDUNITPROPERTY, NULL, systemdunitproperty_probe_main, NULL, NULL},
+	{OVAL_LINUX_SYSTEMDUNITPROPERTY, systemdunitproperty_probe_init, systemdunitproperty_probe_main, systemdunitproperty_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_SOLARIS_ISAINFO
 	{OVAL_SOLARIS_ISAINFO, NULL, isainfo_probe_main, NULL, NULL},
@@ -313,7 +313,7 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_UNIX_PROCESS, NULL, process_probe_main, NULL, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_PROCESS58
-	{OVAL_UNIX_PROCESS58, NULL, process58_probe_main, NULL, NULL},
+	{OVAL_UNIX_PROCESS58, process58_probe_init, process58_probe_main, process58_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_ROUTINGTABLE
 	{OVAL_UNIX_ROUTINGTABLE, NULL, routingtable_probe_main, NULL, NULL},
@@ -328,7 +328,7 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_UNIX_SYMLINK, NULL, symlink_probe_main, NULL, symlink_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_SYSCTL
-	{OVAL_UNIX_SYSCTL, NULL, sysctl_probe_main, NULL, NULL},
+	{OVAL_UNIX_SYSCTL, sysctl_probe_init, sysctl_probe_main, sysctl_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_UNAME
 	{OVAL_UNIX_UNAME, NULL, uname_probe_main, NULL, NULL},
@@ -35,6 +35,7 @@
 #include "probe-api.h"
 #include "common/debug_priv.h"
 #include "common/memusage.h"
+#include "common/oscap_status_priv.h"
 
 #include "probe.h"
 #include "icache.h"
@@ -216,6 +217,7 @@ static void *probe_icache_worker(void *arg)
 #endif
                 --cache->queue_cnt;
 		++cache->queue_beg;
+		oscap_status_icache_queued(-1);
 
 		if (cache->queue_beg == cache->queue_max)
 			cache->queue_beg = 0;
@@ -364,6 +366,7 @@ retry:
 
                 ++cache->queue_cnt;
 		++cache->queue_end;
+		oscap_status_icache_queued(1);
 
                 if (cache->queue_end == cache->queue_max)
                         cache->queue_end = 0;
@@ -582,6 +585,7 @@ int probe_item_collect(struct probe_ctx *ctx, SEXP_t *item)
                 SEXP_free(item);
                 return (-1);
         }
+	oscap_status_item_collected();
 
         return (0);
 }
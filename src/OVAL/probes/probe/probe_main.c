@@ -91,6 +91,24 @@ static SEXP_t *probe_reset(SEXP_t *arg0, void *arg1)
         return(NULL);
 }
 
+static SEXP_t *probe_evict(SEXP_t *arg0, void *arg1)
+{
+	probe_t *probe = (probe_t *)arg1;
+	SEXP_t *id;
+
+	/*
+	 * Drop the cached results of the objects & states whose IDs were
+	 * sent by the library, e.g. because a variable they depend on got
+	 * a new value. The rest of the cache stays valid.
+	 */
+	SEXP_list_foreach(id, arg0) {
+		if (probe_rcache_sexp_del(probe->rcache, id) == 0)
+			dD("Evicted a cached result");
+	}
+
+	return(NULL);
+}
+
 static int probe_opthandler_varref(int option, int op, va_list args)
 {
 	bool  o_switch;
@@ -206,6 +224,9 @@ void *probe_common_main(void *arg)
 	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_RESET, 0, &probe_reset) != 0)
 		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
 
+	if (SEAP_cmd_register(probe.SEAP_ctx, PROBECMD_EVICT, SEAP_CMDREG_USEARG, &probe_evict, &probe) != 0)
+		fail(errno, "SEAP_cmd_register", __LINE__ - 1);
+
 	/*
 	 * Initialize result & name caching
 	 */
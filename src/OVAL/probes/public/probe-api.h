@@ -439,6 +439,7 @@ OSCAP_API void probe_tfc54behaviors_canonicalize(SEXP_t **behaviors);
 #define PROBECMD_STE_FETCH 1 /**< State fetch command code */
 #define PROBECMD_OBJ_EVAL  2 /**< Object eval command code */
 #define PROBECMD_RESET     3 /**< Reset command code */
+#define PROBECMD_EVICT     4 /**< Cache eviction command code */
 
 typedef struct probe_ctx probe_ctx;
 
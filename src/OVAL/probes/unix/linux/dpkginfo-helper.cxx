@@ -5,7 +5,13 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <new>
 #include <stdlib.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include <apt-pkg/init.h>
 #include <apt-pkg/error.h>
@@ -20,127 +26,217 @@
 
 using namespace std;
 
-static int _init_done = 0;
-static pkgCache *cgCache = NULL;
-static MMap *dpkg_mmap = NULL;
+struct dpkginfo_package {
+        string name;
+        string arch;
+        string epoch;
+        string release;
+        string version;
+        string evr;
+};
 
-static int opencache (void) {
-        if (pkgInitConfig (*_config) == false) return 0;
-        if (pkgInitSystem (*_config, _system) == false) return 0;
+static bool dpkginfo_package_less(const dpkginfo_package &a, const dpkginfo_package &b)
+{
+        return a.name < b.name;
+}
 
-        const char* root = getenv("OSCAP_PROBE_ROOT");
-        string pkgCacheRoot(root != NULL ? root : "");
+static bool dpkginfo_reply_less(const dpkginfo_reply_t &a, const char *name)
+{
+        return strcmp(a.name, name) < 0;
+}
 
-        FileFd *fd = new FileFd (pkgCacheRoot + _config->FindFile ("Dir::Cache::pkgcache"),
-                        FileFd::ReadOnly);
+struct dpkginfo_index {
+        int refs;
+        /* identity of the pkgcache file the index was read from */
+        string path;
+        dev_t dev;
+        ino_t ino;
+        off_t size;
+        time_t mtime;
+        vector<dpkginfo_package> packages;
+        vector<dpkginfo_reply_t> replies; /* sorted by name, point to packages */
+};
 
-        dpkg_mmap = new MMap (*fd, MMap::Public|MMap::ReadOnly);
-        if (_error->PendingError () == true) {
-                _error->DumpErrors ();
-                return 0;
-        }
-
-        cgCache = new pkgCache (dpkg_mmap);
-        if (0 == cgCache) return 0;
-        if (_error->PendingError () == true) {
-                _error->DumpErrors ();
-                return 0;
-        }
+/*
+ * The index is kept after the probe is finished, the next scan uses
+ * it again unless the APT cache changed in the meantime.
+ */
+static pthread_mutex_t dpkginfo_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct dpkginfo_index *dpkginfo_index_current = NULL;
 
-        return 1;
+static void dpkginfo_index_unref(struct dpkginfo_index *index)
+{
+        if (index != NULL && --index->refs == 0)
+                delete index;
 }
 
-struct dpkginfo_reply_t * dpkginfo_get_by_name(const char *name, int *err)
-{
-        pkgCache &cache = *cgCache;
-        pkgRecords Recs (cache);
-        struct dpkginfo_reply_t *reply = NULL;
-
-        // Locate the package
-        pkgCache::PkgIterator Pkg = cache.FindPkg(name);
-        if (Pkg.end() == true) {
-                /* not found, clear error flag */
-                if (err) *err = 0;
-                return NULL;
+static struct dpkginfo_index_guard {
+        ~dpkginfo_index_guard() {
+                dpkginfo_index_unref(dpkginfo_index_current);
+                dpkginfo_index_current = NULL;
         }
+} dpkginfo_index_guard;
 
-        pkgCache::VerIterator V1 = Pkg.CurrentVer();
-        if (V1.end() == true) {
-                /* not installed, clear error flag */
-                /* FIXME this should be different that not found */
-                if (err) *err = 0;
-                return NULL;
-        }
-        pkgRecords::Parser &P = Recs.Lookup(V1.FileList());
+static string pkgcache_path (void) {
+        const char* root = getenv("OSCAP_PROBE_ROOT");
+        string pkgCacheRoot(root != NULL ? root : "");
 
+        return pkgCacheRoot + _config->FindFile ("Dir::Cache::pkgcache");
+}
+
+static void split_evr(const string &evr, dpkginfo_package &pkg)
+{
         /* split epoch, version and release */
-        string evr = V1.VerStr();
-        string epoch, version, release;
         string::size_type version_start = 0, version_stop;
         string::size_type pos;
-        string evr_str;
 
         pos = evr.find_first_of(":");
         if (pos != string::npos) {
-                epoch = evr.substr(0, pos);
+                pkg.epoch = evr.substr(0, pos);
                 version_start = pos+1;
         } else
         {
-		    epoch = "0";
+		    pkg.epoch = "0";
         }
 
         pos = evr.find_first_of("-");
         if (pos != string::npos) {
-                version = evr.substr(version_start, pos-version_start);
+                pkg.version = evr.substr(version_start, pos-version_start);
                 version_stop = pos+1;
-                release = evr.substr(version_stop, evr.length()-version_stop);
-                evr_str = epoch + ":" + version + "-" + release;
+                pkg.release = evr.substr(version_stop, evr.length()-version_stop);
+                pkg.evr = pkg.epoch + ":" + pkg.version + "-" + pkg.release;
+        } else { /* no release number, probably a native package */
+                pkg.version = evr.substr(version_start, evr.length()-version_start);
+                pkg.release = "";
+                pkg.evr = pkg.epoch + ":" + pkg.version;
+        }
+}
 
+static int readcache (struct dpkginfo_index *index) {
+        FileFd fd (index->path, FileFd::ReadOnly);
 
-        } else { /* no release number, probably a native package */
-                version = evr.substr(version_start, evr.length()-version_start);
-                release = "";
-                evr_str = epoch + ":" + version;
+        MMap dpkg_mmap (fd, MMap::Public|MMap::ReadOnly);
+        if (_error->PendingError () == true) {
+                _error->DumpErrors ();
+                return 0;
         }
 
-        reply = new(struct dpkginfo_reply_t);
-        memset(reply, 0, sizeof(struct dpkginfo_reply_t));
-        reply->name = strdup(Pkg.Name());
-        reply->arch = strdup(V1.Arch());
-        reply->epoch = strdup(epoch.c_str());
-        reply->release = strdup(release.c_str());
-        reply->version = strdup(version.c_str());
-        reply->evr = strdup(evr_str.c_str());
+        pkgCache cache (&dpkg_mmap);
+        if (_error->PendingError () == true) {
+                _error->DumpErrors ();
+                return 0;
+        }
 
-        return reply;
-}
+        for (pkgCache::PkgIterator Pkg = cache.PkgBegin(); Pkg.end() == false; ++Pkg) {
+                pkgCache::VerIterator V1 = Pkg.CurrentVer();
+                if (V1.end() == true) {
+                        /* not installed */
+                        continue;
+                }
 
-void dpkginfo_free_reply(struct dpkginfo_reply_t *reply)
-{
-        if (reply) {
-                free(reply->name);
-                delete reply;
+                dpkginfo_package pkg;
+                pkg.name = Pkg.Name();
+                pkg.arch = V1.Arch();
+                split_evr(V1.VerStr(), pkg);
+                index->packages.push_back(pkg);
         }
+
+        stable_sort(index->packages.begin(), index->packages.end(), dpkginfo_package_less);
+
+        /* the strings don't move anymore */
+        index->replies.resize(index->packages.size());
+        for (size_t i = 0; i < index->packages.size(); ++i) {
+                dpkginfo_package &pkg = index->packages[i];
+                dpkginfo_reply_t &reply = index->replies[i];
+
+                reply.name = pkg.name.c_str();
+                reply.arch = pkg.arch.c_str();
+                reply.epoch = pkg.epoch.c_str();
+                reply.release = pkg.release.c_str();
+                reply.version = pkg.version.c_str();
+                reply.evr = pkg.evr.c_str();
+        }
+
+        return 1;
 }
 
-int dpkginfo_init()
+struct dpkginfo_index *dpkginfo_index_get(void)
 {
-        if (_init_done == 0)
-                if (opencache() != 1) {
-                        return -1;
+        struct dpkginfo_index *index = NULL;
+        struct stat st;
+
+        pthread_mutex_lock(&dpkginfo_index_mutex);
+
+        if (pkgInitConfig (*_config) == false || pkgInitSystem (*_config, _system) == false)
+                goto out;
+
+        {
+                string path = pkgcache_path();
+                if (stat(path.c_str(), &st) != 0)
+                        goto out;
+
+                index = dpkginfo_index_current;
+                if (index != NULL && index->path == path &&
+                    index->dev == st.st_dev && index->ino == st.st_ino &&
+                    index->size == st.st_size && index->mtime == st.st_mtime) {
+                        ++index->refs;
+                        goto out;
+                }
+
+                index = new (nothrow) dpkginfo_index();
+                if (index == NULL)
+                        goto out;
+                index->refs = 1;
+                index->dev = st.st_dev;
+                index->ino = st.st_ino;
+                index->size = st.st_size;
+                index->mtime = st.st_mtime;
+
+                /* the callers are C code, an exception must not get to them */
+                int ret;
+                try {
+                        index->path = path;
+                        ret = readcache(index);
+                } catch (const bad_alloc &) {
+                        ret = 0;
+                }
+                if (ret != 1) {
+                        delete index;
+                        index = NULL;
+                        goto out;
                 }
 
-        return 0;
+                /* one reference is kept for the next scans */
+                dpkginfo_index_unref(dpkginfo_index_current);
+                dpkginfo_index_current = index;
+                ++index->refs;
+        }
+out:
+        pthread_mutex_unlock(&dpkginfo_index_mutex);
+        return index;
 }
 
-int dpkginfo_fini()
+void dpkginfo_index_release(struct dpkginfo_index *index)
 {
-        delete cgCache;
-        cgCache = NULL;
+        pthread_mutex_lock(&dpkginfo_index_mutex);
+        dpkginfo_index_unref(index);
+        pthread_mutex_unlock(&dpkginfo_index_mutex);
+}
 
-        delete dpkg_mmap;
-        dpkg_mmap = NULL;
+const struct dpkginfo_reply_t *dpkginfo_index_find(const struct dpkginfo_index *index, const char *name, size_t *count)
+{
+        vector<dpkginfo_reply_t>::const_iterator first, last;
 
-        return 0;
+        first = lower_bound(index->replies.begin(), index->replies.end(), name, dpkginfo_reply_less);
+        for (last = first; last != index->replies.end() && strcmp(last->name, name) == 0; ++last)
+                ;
+
+        *count = last - first;
+        return *count > 0 ? &*first : NULL;
 }
 
+const struct dpkginfo_reply_t *dpkginfo_index_get_all(const struct dpkginfo_index *index, size_t *count)
+{
+        *count = index->replies.size();
+        return *count > 0 ? &index->replies[0] : NULL;
+}
@@ -22,25 +22,42 @@
 #ifndef __DPKGINFO_HELPER__
 #define __DPKGINFO_HELPER__
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct dpkginfo_reply_t {
-        char *name;
-        char *arch;
-        char *epoch;
-        char *release;
-        char *version;
-        char *evr;
+        const char *name;
+        const char *arch;
+        const char *epoch;
+        const char *release;
+        const char *version;
+        const char *evr;
 };
 
-int dpkginfo_init();
-int dpkginfo_fini();
+struct dpkginfo_index;
 
-struct dpkginfo_reply_t * dpkginfo_get_by_name(const char *name, int *err);
+/*
+ * Get the index of installed packages. The APT cache is read only if it
+ * changed since the index was read last time, an unchanged index is
+ * shared by the scans. Returns NULL if the cache can't be read.
+ */
+struct dpkginfo_index *dpkginfo_index_get(void);
 
-void dpkginfo_free_reply(struct dpkginfo_reply_t *reply);
+void dpkginfo_index_release(struct dpkginfo_index *index);
+
+/*
+ * Find the installed packages of the given name (one per architecture).
+ * Returns the first of count consecutive packages, NULL if there is none.
+ */
+const struct dpkginfo_reply_t *dpkginfo_index_find(const struct dpkginfo_index *index, const char *name, size_t *count);
+
+/*
+ * Get all the installed packages, sorted by name.
+ */
+const struct dpkginfo_reply_t *dpkginfo_index_get_all(const struct dpkginfo_index *index, size_t *count);
 
 #ifdef __cplusplus
 }
@@ -46,6 +46,7 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
@@ -58,18 +59,18 @@
 #include "public/oval_schema_version.h"
 
 #include <probe/probe.h>
+#include "probe/entcmp.h"
 
 #include "dpkginfo-helper.h"
 
 #include "dpkginfo_probe.h"
 
 struct dpkginfo_global {
-        int init_done;
-        pthread_mutex_t mutex;
+        struct dpkginfo_index *index;
 };
 
 static struct dpkginfo_global g_dpkg = {
-        .init_done = -1,
+        .index = NULL,
 };
 
 int dpkginfo_probe_offline_mode_supported(void) {
@@ -78,11 +79,9 @@ int dpkginfo_probe_offline_mode_supported(void) {
 
 void *dpkginfo_probe_init(void)
 {
-        pthread_mutex_init (&(g_dpkg.mutex), NULL);
-
-        g_dpkg.init_done = dpkginfo_init();
-        if (g_dpkg.init_done < 0) {
-                dE("dpkginfo_init has failed.");
+        g_dpkg.index = dpkginfo_index_get();
+        if (g_dpkg.index == NULL) {
+                dE("dpkginfo_index_get has failed.");
         }
 
         return ((void *)&g_dpkg);
@@ -92,24 +91,41 @@ void dpkginfo_probe_fini (void *ptr)
 {
         struct dpkginfo_global *d = (struct dpkginfo_global *)ptr;
 
-        dpkginfo_fini();
-        pthread_mutex_destroy (&(d->mutex));
+        if (d->index != NULL) {
+                dpkginfo_index_release(d->index);
+                d->index = NULL;
+        }
 
         return;
 }
 
+/*
+ * Only the packages of the name can match an object which asks for a
+ * single name, the others have to be compared with the name entity.
+ */
+static const struct dpkginfo_reply_t *find_packages(struct dpkginfo_index *index, SEXP_t *ent, const char *name, size_t *count)
+{
+        if (probe_ent_getoperation(ent, OVAL_OPERATION_EQUALS) == OVAL_OPERATION_EQUALS &&
+            !probe_ent_attrexists(ent, "var_ref"))
+                return dpkginfo_index_find(index, name, count);
+
+        return dpkginfo_index_get_all(index, count);
+}
+
 int dpkginfo_probe_main (probe_ctx *ctx, void *arg)
 {
 	SEXP_t *val, *item, *ent, *obj;
         char *request_st = NULL;
-        struct dpkginfo_reply_t *dpkginfo_reply = NULL;
-        int errflag;
+        const struct dpkginfo_reply_t *dpkginfo_reply;
+        size_t count, i;
 
 	if (arg == NULL) {
 		return PROBE_EINIT;
 	}
 
-        if (g_dpkg.init_done < 0) {
+        struct dpkginfo_global *d = (struct dpkginfo_global *)arg;
+
+        if (d->index == NULL) {
                 probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_UNKNOWN);
                 return 0;
         }
@@ -133,6 +149,7 @@ int dpkginfo_probe_main (probe_ctx *ctx, void *arg)
         SEXP_free (val);
 
         if (request_st == NULL) {
+                SEXP_free (ent);
                 switch (errno) {
                 case EINVAL:
                         dD("%s: invalid value type", "name");
@@ -147,32 +164,12 @@ int dpkginfo_probe_main (probe_ctx *ctx, void *arg)
                 }
         }
 
-        /* get info from debian apt cache */
-        pthread_mutex_lock (&(g_dpkg.mutex));
-        dpkginfo_reply = dpkginfo_get_by_name(request_st, &errflag);
-        pthread_mutex_unlock (&(g_dpkg.mutex));
+        /* get info from the index of the debian apt cache */
+        dpkginfo_reply = find_packages(d->index, ent, request_st, &count);
 
         if (dpkginfo_reply == NULL) {
-                switch (errflag) {
-		case 0: /* Not found */
-		{
-			dD("Package \"%s\" not found.", request_st);
-			break;
-		}
-		case -1: /* Error */
-		{
-			dD("dpkginfo_get_by_name failed.");
-			item = probe_item_create(OVAL_LINUX_DPKG_INFO, NULL,
-					"name", OVAL_DATATYPE_STRING, request_st,
-					NULL);
-			probe_item_setstatus (item, SYSCHAR_STATUS_ERROR);
-			probe_item_collect(ctx, item);
-			break;
-		}
-                }
+                dD("Package \"%s\" not found.", request_st);
         } else { /* Ok */
-                int i;
-                int num_items = 1; /* FIXME */
 		oval_datatype_t evr_string_type;
 		oval_schema_version_t oval_version = probe_obj_get_platform_schema_version(obj);
 		if (oval_schema_version_cmp(oval_version, OVAL_SCHEMA_VERSION(5.11.1)) >= 0) {
@@ -181,20 +178,27 @@ int dpkginfo_probe_main (probe_ctx *ctx, void *arg)
 			evr_string_type = OVAL_DATATYPE_EVR_STRING;
 		}
 
-                for (i = 0; i < num_items; ++i) {
-                        dD("%s: element found version %s", dpkginfo_reply->name, dpkginfo_reply->evr);
+                for (i = 0; i < count; ++i) {
+                        SEXP_t *name = SEXP_string_newf("%s", dpkginfo_reply[i].name);
+
+                        if (probe_entobj_cmp(ent, name) != OVAL_RESULT_TRUE) {
+                                SEXP_free(name);
+                                continue;
+                        }
+
+                        dD("%s: element found version %s", dpkginfo_reply[i].name, dpkginfo_reply[i].evr);
                         item = probe_item_create (OVAL_LINUX_DPKG_INFO, NULL,
-                                        "name", OVAL_DATATYPE_STRING, dpkginfo_reply->name,
-                                        "arch", OVAL_DATATYPE_STRING, dpkginfo_reply->arch,
-                                        "epoch", OVAL_DATATYPE_STRING, dpkginfo_reply->epoch,
-                                        "release", OVAL_DATATYPE_STRING, dpkginfo_reply->release,
-                                        "version", OVAL_DATATYPE_STRING, dpkginfo_reply->version,
-					"evr", evr_string_type, dpkginfo_reply->evr,
+                                        "name", OVAL_DATATYPE_SEXP, name,
+                                        "arch", OVAL_DATATYPE_STRING, dpkginfo_reply[i].arch,
+                                        "epoch", OVAL_DATATYPE_STRING, dpkginfo_reply[i].epoch,
+                                        "release", OVAL_DATATYPE_STRING, dpkginfo_reply[i].release,
+                                        "version", OVAL_DATATYPE_STRING, dpkginfo_reply[i].version,
+					"evr", evr_string_type, dpkginfo_reply[i].evr,
                                         NULL);
+                        SEXP_free(name);
 
-			probe_item_collect(ctx, item);
-
-                        dpkginfo_free_reply(dpkginfo_reply);
+			if (probe_item_collect(ctx, item) == 2)
+				break;
                 }
         }
 
@@ -62,6 +62,7 @@
 
 #include "iflisteners-proto.h"
 #include "iflisteners_probe.h"
+#include "../proc-snapshot.h"
 
 /* Convenience structure for the results being reported */
 struct result_info {
@@ -70,246 +71,26 @@ struct result_info {
 	const char *hw_address;
 };
 
-/* This structure is used to store information from scanning all runnning
- * processes. It will be used later to augment server info */
-typedef struct _lnode {
-  pid_t pid;            // process ID
-  uid_t uid;            // effective user ID
-  char *cmd;            // command run by user
-  unsigned long inode;  // inode of socket
-  struct _lnode* next;  // Next node pointer
-} lnode;
-
-/* This is the linked list head. Only data elements go here. */
-typedef struct {
-  lnode *head;          // List head
-  lnode *cur;           // Pointer to current node
-} llist;
-
 struct interface_t {
   char interface_name[255];
   char hw_address[255];
 };
 
-/* Local data */
-static int perm_warn = 0;
-
-/* Function prototypes */
-static inline lnode *list_get_cur(llist *l) { return l->cur; }
-static void list_create(llist *l);
-static void list_append(llist *l, lnode *node);
-static void list_clear(llist* l);
-static lnode *list_find_inode(llist *l, unsigned long i);
-
-
-static void list_create(llist *l)
-{
-	l->head = NULL;
-	l->cur = NULL;
-}
-
-static void list_append(llist *l, lnode *node)
-{
-	lnode* newnode;
-
-	if (node == NULL || l == NULL)
-		return;
-
-	newnode = malloc(sizeof(lnode));
-	if (newnode == NULL)
-		return;
-
-	newnode->pid = node->pid;
-	newnode->uid = node->uid;
-	newnode->inode = node->inode;
-	// Take custody of the memory
-	newnode->cmd = node->cmd;
-	newnode->next = NULL;
-
-	// if we are at top, fix this up
-	if (l->head == NULL)
-		l->head = newnode;
-	else	// Otherwise add pointer to newnode
-		l->cur->next = newnode;
-
-	// make newnode current
-	l->cur = newnode;
-}
-
-static void list_clear(llist* l)
-{
-	lnode* nextnode;
-	register lnode* cur;
-
-	cur = l->head;
-	while (cur) {
-		nextnode=cur->next;
-		free(cur->cmd);
-		free(cur);
-		cur=nextnode;
-	}
-	l->head = NULL;
-	l->cur = NULL;
-}
-
-static lnode *list_find_inode(llist *l, unsigned long i)
-{
-        register lnode* cur;
-
-	cur = l->head;	/* start at the beginning */
-	while (cur) {
-		if (cur->inode == i) {
-			l->cur = cur;
-			return cur;
-		} else
-			cur = cur->next;
-	}
-	return NULL;
-}
-
-static int collect_process_info(llist *l)
-{
-	DIR *d, *f;
-	struct dirent *ent;
-
-	d = opendir("/proc");
-	if (d == NULL)
-		return 1;
-
-	while (( ent = readdir(d) )) {
-		FILE *sf;
-		int pid, ppid;
-		char buf[100];
-		char *tmp, cmd[16], state, *text = NULL;
-		int fd, len, euid = 0;
-
-		// Skip non-process dir entries
-		if(*ent->d_name<'0' || *ent->d_name>'9')
-			continue;
-		errno = 0;
-		pid = strtol(ent->d_name, NULL, 10);
-		if (errno)
-			continue;
-
-		// Parse up the stat file for the proc
-		snprintf(buf, 32, "/proc/%d/stat", pid);
-		fd = open(buf, O_RDONLY, 0);
-		if (fd < 0)
-			continue;
-		len = read(fd, buf, sizeof buf - 1);
-		close(fd);
-		if (len < 40)
-			continue;
-		buf[len] = 0;
-		tmp = strrchr(buf, ')');
-		if (tmp)
-			*tmp = 0;
-		else
-			continue;
-		memset(cmd, 0, sizeof(cmd));
-		sscanf(buf, "%d (%15c", &ppid, cmd);
-		sscanf(tmp+2, "%c %d", &state, &ppid);
-
-		// Skip kthreads
-		if (pid == 2 || ppid == 2)
-			continue;
-
-		// Get the effective uid
-		snprintf(buf, 32, "/proc/%d/status", pid);
-		sf = fopen(buf, "rt");
-		if (sf) {
-			int line = 0;
-			__fsetlocking(sf, FSETLOCKING_BYCALLER);
-			while (fgets(buf, sizeof(buf), sf)) {
-				if (line == 0) {
-					line++;
-					continue;
-				}
-				if (memcmp(buf, "Uid:", 4) == 0) {
-					int id;
-					sscanf(buf, "Uid: %d %d",
-						&id, &euid);
-					break;
-				}
-			}
-			fclose(sf);
-		}
-
-		// Now lets get the inodes each process has open
-		snprintf(buf, 32, "/proc/%d/fd", pid);
-		f = opendir(buf);
-		if (f == NULL) {
-			if (errno == EACCES && perm_warn == 0) {
-				/* Need DAC_OVERRIDE permission */
-				perm_warn = 1;
-			}
-			// Process might have ended or something - ignore it
-			free(text);
-			continue;
-		}
-		// For each file in the fd dir...
-		while (( ent = readdir(f) )) {
-			char line[PATH_MAX], ln[PATH_MAX], *s, *e;
-			unsigned long inode;
-			lnode node;
-			int lnlen;
-
-			if (ent->d_name[0] == '.')
-				continue;
-			snprintf(ln, PATH_MAX, "%s/%s", buf, ent->d_name);
-			if ((lnlen = readlink(ln, line, sizeof(line)-1)) < 0)
-				continue;
-			line[lnlen] = 0;
-
-			// Only look at the socket entries
-			if (memcmp(line, "socket:", 7) == 0) {
-				// Type 1 sockets
-				s = strchr(line+7, '[');
-				if (s == NULL)
-					continue;
-				s++;
-				e = strchr(s, ']');
-				if (e == NULL)
-					continue;
-				*e = 0;
-			} else if (memcmp(line, "[0000]:", 7) == 0) {
-				// Type 2 sockets
-				s = line + 8;
-			} else
-				continue;
-			errno = 0;
-			inode = strtoul(s, NULL, 10);
-			if (errno)
-				continue;
-			node.pid = pid;
-			node.uid = euid;
-			node.cmd = strdup(cmd);
-			node.inode = inode;
-			// We make one entry for each socket inode
-			list_append(l, &node);
-		}
-		closedir(f);
-		free(text);
-	}
-	closedir(d);
-	return 0;
-}
-
-static void report_finding(struct result_info *res, llist *l, probe_ctx *ctx, oval_schema_version_t over)
+static void report_finding(struct result_info *res, const struct proc_process *n, probe_ctx *ctx, oval_schema_version_t over)
 {
         SEXP_t *item, *user_id;
-	lnode *n = list_get_cur(l);
+	uid_t uid = n->euid != -1 ? n->euid : 0;
 
 	if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10)) < 0)
-		user_id = SEXP_string_newf("%d", n->uid);
+		user_id = SEXP_string_newf("%d", uid);
 	else
-		user_id = SEXP_number_newi_64((int64_t)n->uid);
+		user_id = SEXP_number_newi_64((int64_t)uid);
 
 	item = probe_item_create(OVAL_LINUX_IFLISTENERS, NULL,
                                  "interface_name",       OVAL_DATATYPE_STRING,  res->interface_name,
                                  "protocol",             OVAL_DATATYPE_STRING,  res->protocol,
                                  "hw_address",           OVAL_DATATYPE_STRING,  res->hw_address,
-                                 "program_name",         OVAL_DATATYPE_STRING,  n->cmd,
+                                 "program_name",         OVAL_DATATYPE_STRING,  n->comm,
                                  "pid",                  OVAL_DATATYPE_INTEGER, (int64_t)n->pid,
 				 "user_id",              OVAL_DATATYPE_SEXP, user_id,
                                  NULL);
@@ -374,7 +155,7 @@ static int get_interface(const int ent_ifindex, struct interface_t *interface) {
 	return 0;
 }
 
-static int read_packet(llist *l, probe_ctx *ctx, oval_schema_version_t over, SEXP_t *interface_name_ent)
+static int read_packet(struct proc_snapshot *snapshot, probe_ctx *ctx, oval_schema_version_t over, SEXP_t *interface_name_ent)
 {
 	int line = 0;
 	FILE *f;
@@ -385,6 +166,7 @@ static int read_packet(llist *l, probe_ctx *ctx, oval_schema_version_t over, SEX
 	unsigned long inode;
 	unsigned rmem, uid, proto_num;
 	struct interface_t interface;
+	const struct proc_process *process;
 
 
 	f = fopen("/proc/net/packet", "rt");
@@ -405,7 +187,8 @@ static int read_packet(llist *l, probe_ctx *ctx, oval_schema_version_t over, SEX
 			"%p %d %d %04x %d %d %u %u %lu\n",
 			&s, &refcnt, &sk_type, &proto_num, &ifindex, &running, &rmem, &uid, &inode
 		);
-		if (list_find_inode(l, inode) && get_interface(ifindex, &interface)) {
+		process = proc_snapshot_find_socket(snapshot, inode);
+		if (process != NULL && get_interface(ifindex, &interface)) {
 			struct result_info r;
 			SEXP_t *r0;
 			dI("Have interface_name: %s, hw_address: %s",
@@ -421,20 +204,36 @@ static int read_packet(llist *l, probe_ctx *ctx, oval_schema_version_t over, SEX
 			r.interface_name = interface.interface_name;
 			r.protocol = oscap_enum_to_string(ProtocolType, proto_num);
 			r.hw_address = interface.hw_address;
-			report_finding(&r, l, ctx, over);
+			report_finding(&r, process, ctx, over);
 		}
 	}
 	fclose(f);
 	return 0;
 }
 
+/* Processes are looked up by the inodes of their sockets in the process
+ * snapshot of the scan, the snapshot is shared with the other process probes. */
+void *iflisteners_probe_init(void)
+{
+	return proc_snapshot_acquire();
+}
+
+void iflisteners_probe_fini(void *arg)
+{
+	proc_snapshot_release(arg);
+}
+
 int iflisteners_probe_main(probe_ctx *ctx, void *arg)
 {
         SEXP_t *object;
 	int err;
-	llist ll;
+	size_t count;
+	struct proc_snapshot *snapshot = arg;
 	oval_schema_version_t over;
 
+	if (snapshot == NULL)
+		return PROBE_ENOMEM;
+
         object = probe_ctx_getobject(ctx);
         over   = probe_obj_get_platform_schema_version(object);
 
@@ -445,8 +244,8 @@ int iflisteners_probe_main(probe_ctx *ctx, void *arg)
 	}
 
 	// Now start collecting the info
-	list_create(&ll);
-	if (collect_process_info(&ll) || perm_warn) {
+	if (proc_snapshot_get_processes(snapshot, PROC_SNAPSHOT_SOCKETS, &count) == NULL ||
+	    proc_snapshot_sockets_denied(snapshot)) {
 		SEXP_t *msg;
 
 		msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_ERROR, "Permission error.");
@@ -458,9 +257,7 @@ int iflisteners_probe_main(probe_ctx *ctx, void *arg)
 		goto cleanup;
 	}
 
-	read_packet(&ll, ctx, over, interface_name_ent);
-
-	list_clear(&ll);
+	read_packet(snapshot, ctx, over, interface_name_ent);
 
 	err = 0;
  cleanup:
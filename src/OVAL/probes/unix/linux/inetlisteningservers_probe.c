@@ -54,17 +54,22 @@
 #include <stdio.h>
 #include <stdio_ext.h>
 #include <errno.h>
-#include <dirent.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <unistd.h>
 #include <arpa/inet.h>
 #include <regex.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
 
 #include "_seap.h"
 #include "probe-api.h"
 #include "probe/entcmp.h"
 #include "common/debug_priv.h"
 #include "inetlisteningservers_probe.h"
+#include "../proc-snapshot.h"
 
 /* This structure contains the information OVAL is asking or requesting */
 struct server_info {
@@ -73,6 +78,12 @@ struct server_info {
 	SEXP_t *local_port_ent;
 };
 
+/* TCP_LISTEN of the kernel, the state as listed in /proc/net/tcp */
+#define TCP_STATE_LISTEN 0x0A
+
+/* Size of the buffer for the replies of the sock_diag netlink interface */
+#define SOCK_DIAG_BUFSIZE 32768
+
 /* Convenience structure for the results being reported */
 struct result_info {
 	const char *proto;
@@ -82,228 +93,6 @@ struct result_info {
 	unsigned rport;
 };
 
-/* This structure is used to store information from scanning all runnning
- * processes. It will be used later to augment server info */
-typedef struct _lnode {
-  pid_t pid;            // process ID
-  uid_t uid;            // effective user ID
-  char *cmd;            // command run by user
-  unsigned long inode;  // inode of socket
-  struct _lnode* next;  // Next node pointer
-} lnode;
-
-/* This is the linked list head. Only data elements go here. */
-typedef struct {
-  lnode *head;          // List head
-  lnode *cur;           // Pointer to current node
-} llist;
-
-/* Function prototypes */
-static inline lnode *list_get_cur(llist *l) { return l->cur; }
-static void list_create(llist *l);
-static void list_append(llist *l, lnode *node);
-static void list_clear(llist* l);
-static lnode *list_find_inode(llist *l, unsigned long i);
-
-
-static void list_create(llist *l)
-{
-	l->head = NULL;
-	l->cur = NULL;
-}
-
-static void list_append(llist *l, lnode *node)
-{
-	lnode* newnode;
-
-	if (node == NULL || l == NULL)
-		return;
-
-	newnode = malloc(sizeof(lnode));
-	if (newnode == NULL)
-		return;
-
-	newnode->pid = node->pid;
-	newnode->uid = node->uid;
-	newnode->inode = node->inode;
-	// Take custody of the memory
-	newnode->cmd = node->cmd;
-	newnode->next = NULL;
-
-	// if we are at top, fix this up
-	if (l->head == NULL)
-		l->head = newnode;
-	else	// Otherwise add pointer to newnode
-		l->cur->next = newnode;
-
-	// make newnode current
-	l->cur = newnode;
-}
-
-static void list_clear(llist* l)
-{
-	lnode* nextnode;
-	register lnode* cur;
-
-	cur = l->head;
-	while (cur) {
-		nextnode=cur->next;
-		free(cur->cmd);
-		free(cur);
-		cur=nextnode;
-	}
-	l->head = NULL;
-	l->cur = NULL;
-}
-
-static lnode *list_find_inode(llist *l, unsigned long i)
-{
-        register lnode* cur;
-
-       	cur = l->head;	/* start at the beginning */
-	while (cur) {
-		if (cur->inode == i) {
-			l->cur = cur;
-			return cur;
-		} else
-			cur = cur->next;
-	}
-	return NULL;
-}
-
-static int collect_process_info(llist *l)
-{
-	DIR *d, *f;
-	struct dirent *ent;
-
-	d = opendir("/proc");
-	if (d == NULL)
-		return 1;
-
-	while (( ent = readdir(d) )) {
-		FILE *sf;
-		int pid, ppid;
-		char buf[100];
-		char *tmp, cmd[16], state, *text = NULL;
-		int fd, len, euid = 0;
-
-		// Skip non-process dir entries
-		if(*ent->d_name<'0' || *ent->d_name>'9')
-			continue;
-		errno = 0;
-		pid = strtol(ent->d_name, NULL, 10);
-		if (errno)
-			continue;
-
-		// Parse up the stat file for the proc
-		snprintf(buf, 32, "/proc/%d/stat", pid);
-		fd = open(buf, O_RDONLY, 0);
-		if (fd < 0)
-			continue;
-		len = read(fd, buf, sizeof buf - 1);
-		close(fd);
-		if (len < 40)
-			continue;
-		buf[len] = 0;
-		tmp = strrchr(buf, ')');
-		if (tmp)
-			*tmp = 0;
-		else
-			continue;
-		memset(cmd, 0, sizeof(cmd));
-		sscanf(buf, "%d (%15c", &ppid, cmd);
-		sscanf(tmp+2, "%c %d", &state, &ppid);
-
-		// Skip kthreads
-		if (pid == 2 || ppid == 2)
-			continue;
-
-		// Get the effective uid
-		snprintf(buf, 32, "/proc/%d/status", pid);
-		sf = fopen(buf, "rt");
-		if (sf) {
-			int line = 0;
-			__fsetlocking(sf, FSETLOCKING_BYCALLER);
-			while (fgets(buf, sizeof(buf), sf)) {
-				if (line == 0) {
-					line++;
-					continue;
-				}
-				if (memcmp(buf, "Uid:", 4) == 0) {
-					int id;
-					sscanf(buf, "Uid: %d %d",
-						&id, &euid);
-					break;
-				}
-			}
-			fclose(sf);
-		}
-
-		// Now lets get the inodes each process has open
-		snprintf(buf, 32, "/proc/%d/fd", pid);
-		f = opendir(buf);
-		if (f == NULL) {
-			// Process might have ended or we don;t have access - ignore it
-			free(text);
-			continue;
-		}
-		// For each file in the fd dir...
-		while (( ent = readdir(f) )) {
-			char line[256], *s, *e;
-			unsigned long inode;
-			lnode node;
-			int lnlen;
-
-			if (ent->d_name[0] == '.')
-				continue;
-			int pathname_len = snprintf(NULL, 0, "%s/%s", buf, ent->d_name);
-			if (pathname_len < 0) {
-				continue;
-			}
-			pathname_len++; // +1 for terminating '\0'
-			char *pathname = malloc(pathname_len);
-			snprintf(pathname, pathname_len, "%s/%s", buf, ent->d_name);
-			lnlen = readlink(pathname, line, sizeof(line) - 1);
-			free(pathname);
-			if (lnlen < 0) {
-				continue;
-			}
-			line[lnlen] = 0;
-
-			// Only look at the socket entries
-			if (memcmp(line, "socket:", 7) == 0) {
-				// Type 1 sockets
-				s = strchr(line+7, '[');
-				if (s == NULL)
-					continue;
-				s++;
-				e = strchr(s, ']');
-				if (e == NULL)
-					continue;
-				*e = 0;
-			} else if (memcmp(line, "[0000]:", 7) == 0) {
-				// Type 2 sockets
-				s = line + 8;
-			} else
-				continue;
-			errno = 0;
-			inode = strtoul(s, NULL, 10);
-			if (errno)
-				continue;
-			node.pid = pid;
-			node.uid = euid;
-			node.cmd = strdup(cmd);
-			node.inode = inode;
-			// We make one entry for each socket inode
-			list_append(l, &node);
-		}
-		closedir(f);
-		free(text);
-	}
-	closedir(d);
-	return 0;
-}
-
 static int eval_data(const char *type, const char *local_address,
 	unsigned int local_port, struct server_info *req)
 {
@@ -333,15 +122,10 @@ static int eval_data(const char *type, const char *local_address,
 	return 1;
 }
 
-static void report_finding(struct result_info *res, llist *l, probe_ctx *ctx)
+static void report_finding(struct result_info *res, const struct proc_process *n, probe_ctx *ctx)
 {
         SEXP_t *item;
         SEXP_t se_lport_mem, se_rport_mem, se_lfull_mem, se_ffull_mem, *se_uid_mem = NULL;
-	lnode *n = NULL;
-
-	if (l) {
-		n = list_get_cur(l);
-	}
 
 	if (n) {
                 item = probe_item_create(OVAL_LINUX_INET_LISTENING_SERVER, NULL,
@@ -350,13 +134,13 @@ static void report_finding(struct result_info *res, llist *l, probe_ctx *ctx)
 				 "local_port",           OVAL_DATATYPE_SEXP, SEXP_number_newu_64_r(&se_lport_mem, res->lport),
                                  "local_full_address",   OVAL_DATATYPE_SEXP,    SEXP_string_newf_r(&se_lfull_mem,
                                                                                                    "%s:%u", res->laddr, res->lport),
-                                 "program_name",         OVAL_DATATYPE_STRING,  n->cmd,
+                                 "program_name",         OVAL_DATATYPE_STRING,  n->comm,
                                  "foreign_address",      OVAL_DATATYPE_STRING,  res->raddr,
 				 "foreign_port",         OVAL_DATATYPE_SEXP, SEXP_number_newu_64_r(&se_rport_mem, res->rport),
                                  "foreign_full_address", OVAL_DATATYPE_SEXP,    SEXP_string_newf_r(&se_ffull_mem,
                                                                                                    "%s:%u", res->raddr, res->rport),
                                  "pid",                  OVAL_DATATYPE_INTEGER, (int64_t)n->pid,
-				 "user_id",              OVAL_DATATYPE_SEXP, se_uid_mem = SEXP_number_newu_64(n->uid),
+				 "user_id",              OVAL_DATATYPE_SEXP, se_uid_mem = SEXP_number_newu_64(n->euid != -1 ? n->euid : 0),
                                  NULL);
 	} else {
                 item = probe_item_create(OVAL_LINUX_INET_LISTENING_SERVER, NULL,
@@ -397,7 +181,7 @@ static void addr_convert(const char *src, char *dest, int size)
 }
 
 
-static int read_tcp(const char *proc, const char *type, llist *l, probe_ctx *ctx, struct server_info *req)
+static int read_tcp(const char *proc, const char *type, struct proc_snapshot *snapshot, probe_ctx *ctx, struct server_info *req)
 {
 	int line = 0;
 	FILE *f;
@@ -430,6 +214,8 @@ static int read_tcp(const char *proc, const char *type, llist *l, probe_ctx *ctx
 		char src[NI_MAXHOST], dest[NI_MAXHOST];
 		addr_convert(local_addr, src, NI_MAXHOST);
 		addr_convert(rem_addr, dest, NI_MAXHOST);
+		if (state != TCP_STATE_LISTEN)
+			continue;
 		dI("Have tcp port: %s:%u", src, local_port);
 		if (eval_data(type, src, local_port, req)) {
 			struct result_info r;
@@ -438,18 +224,14 @@ static int read_tcp(const char *proc, const char *type, llist *l, probe_ctx *ctx
 			r.lport = local_port;
 			r.raddr = dest;
 			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
-			}
+			report_finding(&r, proc_snapshot_find_socket(snapshot, inode), ctx);
 		}
 	}
 	fclose(f);
 	return 0;
 }
 
-static int read_udp(const char *proc, const char *type, llist *l, probe_ctx *ctx, struct server_info *req)
+static int read_udp(const char *proc, const char *type, struct proc_snapshot *snapshot, probe_ctx *ctx, struct server_info *req)
 {
 	int line = 0;
 	FILE *f;
@@ -489,18 +271,14 @@ static int read_udp(const char *proc, const char *type, llist *l, probe_ctx *ctx
 			r.lport = local_port;
 			r.raddr = dest;
 			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
-			}
+			report_finding(&r, proc_snapshot_find_socket(snapshot, inode), ctx);
 		}
 	}
 	fclose(f);
 	return 0;
 }
 
-static int read_raw(const char *proc, const char *type, llist *l, probe_ctx *ctx, struct server_info *req)
+static int read_raw(const char *proc, const char *type, struct proc_snapshot *snapshot, probe_ctx *ctx, struct server_info *req)
 {
 	int line = 0;
 	FILE *f;
@@ -540,22 +318,204 @@ static int read_raw(const char *proc, const char *type, llist *l, probe_ctx *ctx
 			r.lport = local_port;
 			r.raddr = dest;
 			r.rport = rem_port;
-			if (list_find_inode(l, inode)) {
-				report_finding(&r, l, ctx);
-			} else {
-				report_finding(&r, NULL, ctx);
-			}
+			report_finding(&r, proc_snapshot_find_socket(snapshot, inode), ctx);
 		}
 	}
 	fclose(f);
 	return 0;
 }
 
+/* Whether the sockets of the given protocol can match the object at all */
+static int protocol_requested(const char *type, struct server_info *req)
+{
+	SEXP_t *r0;
+	int ret;
+
+	r0 = SEXP_string_newf("%s", type);
+	ret = probe_entobj_cmp(req->protocol_ent, r0) == OVAL_RESULT_TRUE;
+	SEXP_free(r0);
+
+	return ret;
+}
+
+/*
+ * An object which asks for a single port lets the kernel skip the sockets
+ * bound to the other ports.
+ */
+static int get_requested_port(struct server_info *req, uint16_t *port)
+{
+	SEXP_t *val;
+	int ret = 0;
+
+	if (probe_ent_getoperation(req->local_port_ent, OVAL_OPERATION_EQUALS) != OVAL_OPERATION_EQUALS ||
+	    probe_ent_attrexists(req->local_port_ent, "var_ref"))
+		return 0;
+
+	val = probe_ent_getval(req->local_port_ent);
+	if (val != NULL && SEXP_numberp(val)) {
+		uint64_t n = SEXP_number_getu_64(val);
+
+		if (n <= UINT16_MAX) {
+			*port = n;
+			ret = 1;
+		}
+	}
+	SEXP_free(val);
+
+	return ret;
+}
+
+static void report_sock_diag(const struct inet_diag_msg *diag, const char *type,
+	struct proc_snapshot *snapshot, probe_ctx *ctx, struct server_info *req)
+{
+	char src[INET6_ADDRSTRLEN], dest[INET6_ADDRSTRLEN];
+	unsigned local_port;
+
+	if (inet_ntop(diag->idiag_family, diag->id.idiag_src, src, sizeof(src)) == NULL ||
+	    inet_ntop(diag->idiag_family, diag->id.idiag_dst, dest, sizeof(dest)) == NULL)
+		return;
+
+	local_port = ntohs(diag->id.idiag_sport);
+	dI("Have %s port: %s:%u", type, src, local_port);
+	if (eval_data(type, src, local_port, req)) {
+		struct result_info r;
+		r.proto = type;
+		r.laddr = src;
+		r.lport = local_port;
+		r.raddr = dest;
+		r.rport = ntohs(diag->id.idiag_dport);
+		report_finding(&r, proc_snapshot_find_socket(snapshot, diag->idiag_inode), ctx);
+	}
+}
+
+/*
+ * Dump the sockets of the given family and protocol which are in one of the
+ * states through the sock_diag netlink interface. The kernel sends binary
+ * records of the matching sockets only, which is much cheaper than parsing
+ * /proc/net on systems with many connections.
+ * Returns -1 if the kernel can't answer the request and nothing has been
+ * reported, the caller reads /proc/net instead then.
+ */
+static int read_sock_diag(int family, int protocol, uint32_t states, const char *type,
+	struct proc_snapshot *snapshot, probe_ctx *ctx, struct server_info *req)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct inet_diag_req_v2 r;
+		struct nlattr bc_attr;
+		struct inet_diag_bc_op bc[4];
+	} msg;
+	struct sockaddr_nl nladdr;
+	struct nlmsghdr *nlh;
+	uint16_t port;
+	int fd, ret = -1, reported = 0;
+	char *buf = NULL;
+
+	fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+	if (fd < 0) {
+		dD("Can't open sock_diag netlink socket: %s", strerror(errno));
+		return -1;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	msg.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(msg.r));
+	msg.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+	msg.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	msg.nlh.nlmsg_seq = 1;
+	msg.r.sdiag_family = family;
+	msg.r.sdiag_protocol = protocol;
+	msg.r.idiag_states = states;
+
+	if (get_requested_port(req, &port)) {
+		/* port <= sport <= port, jumping past the end rejects the socket */
+		msg.bc[0] = (struct inet_diag_bc_op){ INET_DIAG_BC_S_GE, 8, sizeof(msg.bc) + 4 };
+		msg.bc[1] = (struct inet_diag_bc_op){ 0, 0, port };
+		msg.bc[2] = (struct inet_diag_bc_op){ INET_DIAG_BC_S_LE, 8, 2 * sizeof(msg.bc[0]) + 4 };
+		msg.bc[3] = (struct inet_diag_bc_op){ 0, 0, port };
+		msg.bc_attr.nla_type = INET_DIAG_REQ_BYTECODE;
+		msg.bc_attr.nla_len = NLA_HDRLEN + sizeof(msg.bc);
+		msg.nlh.nlmsg_len += NLA_ALIGN(msg.bc_attr.nla_len);
+	}
+
+	memset(&nladdr, 0, sizeof(nladdr));
+	nladdr.nl_family = AF_NETLINK;
+	if (sendto(fd, &msg, msg.nlh.nlmsg_len, 0, (struct sockaddr *)&nladdr, sizeof(nladdr)) < 0) {
+		dD("Can't send sock_diag request: %s", strerror(errno));
+		goto cleanup;
+	}
+
+	buf = malloc(SOCK_DIAG_BUFSIZE);
+	if (buf == NULL)
+		goto cleanup;
+	for (;;) {
+		ssize_t len = recv(fd, buf, SOCK_DIAG_BUFSIZE, 0);
+
+		if (len < 0) {
+			if (errno == EINTR)
+				continue;
+			dD("Can't receive sock_diag reply: %s", strerror(errno));
+			goto cleanup;
+		}
+		if (len == 0)
+			goto cleanup;
+
+		for (nlh = (struct nlmsghdr *)buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_type == NLMSG_DONE) {
+				if (nlh->nlmsg_len >= NLMSG_LENGTH(sizeof(int)) && *(int *)NLMSG_DATA(nlh) < 0) {
+					dD("sock_diag dump failed: %s", strerror(-*(int *)NLMSG_DATA(nlh)));
+					goto cleanup;
+				}
+				ret = 0;
+				goto cleanup;
+			}
+			if (nlh->nlmsg_type == NLMSG_ERROR) {
+				const struct nlmsgerr *err = NLMSG_DATA(nlh);
+
+				dD("sock_diag request failed: %s", strerror(-err->error));
+				goto cleanup;
+			}
+			if (nlh->nlmsg_type != SOCK_DIAG_BY_FAMILY ||
+			    nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct inet_diag_msg)))
+				continue;
+
+			report_sock_diag(NLMSG_DATA(nlh), type, snapshot, ctx, req);
+			reported = 1;
+		}
+	}
+
+cleanup:
+	/* don't let the caller report the sockets again from /proc/net */
+	if (ret != 0 && reported) {
+		dW("The list of %s sockets received from the kernel is incomplete.", type);
+		ret = 1;
+	}
+	free(buf);
+	close(fd);
+
+	return ret;
+}
+
+/* Processes are looked up by the inodes of their sockets in the process
+ * snapshot of the scan, the snapshot is shared with the other process probes. */
+void *inetlisteningservers_probe_init(void)
+{
+	return proc_snapshot_acquire();
+}
+
+void inetlisteningservers_probe_fini(void *arg)
+{
+	proc_snapshot_release(arg);
+}
+
 int inetlisteningservers_probe_main(probe_ctx *ctx, void *arg)
 {
         SEXP_t *object;
 	int err;
-	llist ll;
+	size_t count;
+	struct proc_snapshot *snapshot = arg;
+
+	if (snapshot == NULL)
+		return PROBE_ENOMEM;
 
         object = probe_ctx_getobject(ctx);
 	struct server_info *req = malloc(sizeof(struct server_info));
@@ -578,8 +538,7 @@ int inetlisteningservers_probe_main(probe_ctx *ctx, void *arg)
 	}
 
 	// Now start collecting the info
-	list_create(&ll);
-	if (collect_process_info(&ll)) {
+	if (proc_snapshot_get_processes(snapshot, PROC_SNAPSHOT_SOCKETS, &count) == NULL) {
 		SEXP_t *msg;
 
 		msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_ERROR, "Permission error.");
@@ -591,20 +550,28 @@ int inetlisteningservers_probe_main(probe_ctx *ctx, void *arg)
 		goto cleanup;
 	}
 
-	// Now we check the tcp socket list...
-	read_tcp("/proc/net/tcp", "tcp", &ll, ctx, req);
-	read_tcp("/proc/net/tcp6", "tcp", &ll, ctx, req);
-
-	// Next udp sockets...
-	read_udp("/proc/net/udp", "udp", &ll, ctx, req);
-	read_udp("/proc/net/udp6", "udp", &ll, ctx, req);
-
-	// Next, raw sockets...not exactly part of standard yet. They
-	// can be used to send datagrams, so we will pretend they are udp
-	read_raw("/proc/net/raw", "udp", &ll, ctx, req);
-	read_raw("/proc/net/raw6", "udp", &ll, ctx, req);
+	// Now we check the tcp socket list, only the listening sockets are
+	// reported. The kernel is asked for them first, /proc/net is read
+	// when sock_diag is not available.
+	if (protocol_requested("tcp", req)) {
+		if (read_sock_diag(AF_INET, IPPROTO_TCP, 1 << TCP_STATE_LISTEN, "tcp", snapshot, ctx, req) < 0)
+			read_tcp("/proc/net/tcp", "tcp", snapshot, ctx, req);
+		if (read_sock_diag(AF_INET6, IPPROTO_TCP, 1 << TCP_STATE_LISTEN, "tcp", snapshot, ctx, req) < 0)
+			read_tcp("/proc/net/tcp6", "tcp", snapshot, ctx, req);
+	}
 
-	list_clear(&ll);
+	if (protocol_requested("udp", req)) {
+		// Next udp sockets, they have no listening state...
+		if (read_sock_diag(AF_INET, IPPROTO_UDP, UINT32_MAX, "udp", snapshot, ctx, req) < 0)
+			read_udp("/proc/net/udp", "udp", snapshot, ctx, req);
+		if (read_sock_diag(AF_INET6, IPPROTO_UDP, UINT32_MAX, "udp", snapshot, ctx, req) < 0)
+			read_udp("/proc/net/udp6", "udp", snapshot, ctx, req);
+
+		// Next, raw sockets...not exactly part of standard yet. They
+		// can be used to send datagrams, so we will pretend they are udp
+		read_raw("/proc/net/raw", "udp", snapshot, ctx, req);
+		read_raw("/proc/net/raw6", "udp", snapshot, ctx, req);
+	}
 
 	err = 0;
  cleanup:
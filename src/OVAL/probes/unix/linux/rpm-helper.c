@@ -24,6 +24,13 @@
 #include <config.h>
 #endif
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <regex.h>
+
+#include "common/list.h"
+
 #ifdef RPM46_FOUND
 int rpmErrorCb (rpmlogRec rec, rpmlogCallbackData data)
 {
@@ -51,3 +58,155 @@ void rpmLibsPreload()
 	const char* rcfiles = "";
 	rpmReadConfigFiles(rcfiles, NULL);
 }
+
+static const char g_keyid_regex_string[] = "Key ID [a-fA-F0-9]{16}";
+
+struct rpm_package_index {
+	struct rpm_package *packages; /* sorted by name */
+	size_t count;
+	struct oscap_htable *names;   /* name -> first package of that name */
+};
+
+static void rpm_package_init(struct rpm_package *pkg, Header h, regex_t *keyid_regex)
+{
+	errmsg_t rpmerr;
+	char *str, *sid;
+	char *epoch_override = NULL;
+	size_t len;
+	regmatch_t keyid_match[1];
+
+	pkg->name = headerFormat(h, "%{NAME}", &rpmerr);
+	pkg->arch = headerFormat(h, "%{ARCH}", &rpmerr);
+	pkg->epoch = headerFormat(h, "%{EPOCH}", &rpmerr);
+	pkg->release = headerFormat(h, "%{RELEASE}", &rpmerr);
+	pkg->version = headerFormat(h, "%{VERSION}", &rpmerr);
+	epoch_override = oscap_streq(pkg->epoch, "(none)") ? "0" : pkg->epoch;
+	snprintf(pkg->extended_name, 1024, "%s-%s:%s-%s.%s", pkg->name, epoch_override, pkg->version, pkg->release, pkg->arch);
+
+	len = strlen(epoch_override) + strlen(pkg->release) + strlen(pkg->version) + 2;
+	pkg->evr = malloc(len + 1);
+	snprintf(pkg->evr, len + 1, "%s:%s-%s", epoch_override, pkg->version, pkg->release);
+
+	str = headerFormat(h, "%|SIGGPG?{%{SIGGPG:pgpsig}}:{%{SIGPGP:pgpsig}}|", &rpmerr);
+
+	if (regexec(keyid_regex, str, 1, keyid_match, 0) != 0) {
+		sid = NULL;
+		dD("Failed to extract the Key ID value: regex=\"%s\", string=\"%s\"",
+		   g_keyid_regex_string, str);
+	} else if (keyid_match[0].rm_so < 0 || keyid_match[0].rm_eo < 0) {
+		sid = NULL;
+	} else {
+		size_t keyid_start = keyid_match[0].rm_so + strlen("Key ID ");
+		size_t keyid_length = keyid_match[0].rm_eo - keyid_start;
+		sid = str + keyid_start;
+		sid[keyid_length] = '\0';
+	}
+
+	pkg->signature_keyid = strdup(sid != NULL ? sid : "0");
+	free(str);
+}
+
+static void rpm_package_clear(struct rpm_package *pkg)
+{
+	free(pkg->name);
+	free(pkg->arch);
+	free(pkg->epoch);
+	free(pkg->release);
+	free(pkg->version);
+	free(pkg->evr);
+	free(pkg->signature_keyid);
+}
+
+static int rpm_package_cmp(const void *a, const void *b)
+{
+	return strcmp(((const struct rpm_package *) a)->name, ((const struct rpm_package *) b)->name);
+}
+
+struct rpm_package_index *rpm_package_index_new(rpmts ts)
+{
+	regex_t keyid_regex;
+	if (regcomp(&keyid_regex, g_keyid_regex_string, REG_EXTENDED) != 0) {
+		dE("regcomp(%s) failed.", g_keyid_regex_string);
+		return NULL;
+	}
+
+	struct rpm_package_index *index = calloc(1, sizeof(struct rpm_package_index));
+	if (index == NULL) {
+		dE("Failed to allocate the package index.");
+		regfree(&keyid_regex);
+		return NULL;
+	}
+	size_t size = 0;
+
+	rpmdbMatchIterator match = rpmtsInitIterator(ts, RPMDBI_PACKAGES, NULL, 0);
+	if (match != NULL) {
+		Header pkgh;
+		while ((pkgh = rpmdbNextIterator(match)) != NULL) {
+			if (index->count == size) {
+				size_t new_size = size ? 2 * size : 512;
+				struct rpm_package *packages = realloc(index->packages, new_size * sizeof(struct rpm_package));
+				if (packages == NULL) {
+					dE("Failed to allocate the package index of %zu packages.", new_size);
+					rpmdbFreeIterator(match);
+					regfree(&keyid_regex);
+					rpm_package_index_free(index);
+					return NULL;
+				}
+				index->packages = packages;
+				size = new_size;
+			}
+			rpm_package_init(&index->packages[index->count++], pkgh, &keyid_regex);
+		}
+		rpmdbFreeIterator(match);
+	}
+	regfree(&keyid_regex);
+
+	if (index->count > 0)
+		qsort(index->packages, index->count, sizeof(struct rpm_package), rpm_package_cmp);
+
+	/* packages of the same name are adjacent, the table points to the first one */
+	index->names = oscap_htable_new();
+	for (size_t i = 0; i < index->count; ++i)
+		oscap_htable_add(index->names, index->packages[i].name, &index->packages[i]);
+
+	dI("Indexed %zu installed packages.", index->count);
+	return index;
+}
+
+void rpm_package_index_free(struct rpm_package_index *index)
+{
+	if (index == NULL)
+		return;
+
+	for (size_t i = 0; i < index->count; ++i)
+		rpm_package_clear(&index->packages[i]);
+	free(index->packages);
+	oscap_htable_free0(index->names);
+	free(index);
+}
+
+const struct rpm_package *rpm_package_index_find(const struct rpm_package_index *index, const char *name, size_t *count)
+{
+	const struct rpm_package *first = oscap_htable_get(index->names, name);
+	const struct rpm_package *end = index->packages + index->count;
+
+	*count = 0;
+	for (const struct rpm_package *pkg = first; pkg != NULL && pkg < end && strcmp(pkg->name, name) == 0; ++pkg)
+		++(*count);
+
+	return first;
+}
+
+const struct rpm_package *rpm_package_index_get_all(const struct rpm_package_index *index, size_t *count)
+{
+	*count = index->count;
+	return index->packages;
+}
+
+struct rpm_package_index *rpm_probe_global_get_index(struct rpm_probe_global *g_rpm)
+{
+	if (g_rpm->index == NULL)
+		g_rpm->index = rpm_package_index_new(g_rpm->rpmts);
+
+	return g_rpm->index;
+}
@@ -37,9 +37,26 @@
 #include "common/debug_priv.h"
 #include "pthread.h"
 
+struct rpm_package_index;
+
 struct rpm_probe_global {
 	rpmts rpmts;
 	pthread_mutex_t mutex;
+	struct rpm_package_index *index; /**< read on demand, see rpm_probe_global_get_index() */
+};
+
+/**
+ * Installed package as recorded in the package index
+ */
+struct rpm_package {
+	char *name;
+	char *arch;
+	char *epoch;
+	char *release;
+	char *version;
+	char *evr;             /**< epoch:version-release, "(none)" epoch is 0 */
+	char *signature_keyid; /**< "0" if the package is not signed */
+	char extended_name[1024];
 };
 
 #ifndef HAVE_HEADERFORMAT
@@ -92,6 +109,36 @@ int rpmVerifyFile(const rpmts ts, const rpmfi fi,
                 rpmVerifyAttrs * res, rpmVerifyAttrs omitMask);
 #endif
 
+/**
+ * Read the installed packages from the rpmdb into an in-memory index.
+ * Packages are looked up by name in a hash table, the header data is
+ * formatted only once.
+ * @return NULL if the index could not be created
+ */
+struct rpm_package_index *rpm_package_index_new(rpmts ts);
+
+void rpm_package_index_free(struct rpm_package_index *index);
+
+/**
+ * Find the packages of the given name
+ * @param count set to the number of packages found
+ * @return first of count consecutive packages, NULL if there is none
+ */
+const struct rpm_package *rpm_package_index_find(const struct rpm_package_index *index, const char *name, size_t *count);
+
+/**
+ * Get all the installed packages
+ * @param count set to the number of packages
+ */
+const struct rpm_package *rpm_package_index_get_all(const struct rpm_package_index *index, size_t *count);
+
+/**
+ * Get the package index of the probe. It is created on the first call
+ * and shared by all the objects of the session. The caller has to hold
+ * the mutex of the probe global.
+ */
+struct rpm_package_index *rpm_probe_global_get_index(struct rpm_probe_global *g_rpm);
+
 /**
  * Preload libraries required by rpm
  * It destroy error callback!
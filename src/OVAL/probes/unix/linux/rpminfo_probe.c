@@ -57,7 +57,6 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
-#include <regex.h>
 
 /* RPM headers */
 #include "rpm-helper.h"
@@ -77,197 +76,46 @@ struct rpminfo_req {
         oval_operation_t op;
 };
 
-struct rpminfo_rep {
-        char *name;
-        char *arch;
-        char *epoch;
-        char *release;
-        char *version;
-        char *evr;
-        char *signature_keyid;
-	char extended_name[1024];
-};
-
 #define RPMINFO_LOCK	RPM_MUTEX_LOCK(&g_rpm->mutex)
 
 #define RPMINFO_UNLOCK	RPM_MUTEX_UNLOCK(&g_rpm->mutex)
 
-static const char g_keyid_regex_string[] = "Key ID [a-fA-F0-9]{16}";
-
-static void __rpminfo_rep_free (struct rpminfo_rep *ptr)
-{
-        free (ptr->name);
-        free (ptr->arch);
-        free (ptr->epoch);
-        free (ptr->release);
-        free (ptr->version);
-        free (ptr->evr);
-        free (ptr->signature_keyid);
-}
-
-static void pkgh2rep(Header h, struct rpminfo_rep *r, regex_t *keyid_regex)
-{
-        errmsg_t rpmerr;
-        char *str, *sid;
-	char *epoch_override = NULL;
-        size_t len;
-	regmatch_t keyid_match[1];
-
-	if (h == NULL || r == NULL) {
-		return;
-	}
-
-        r->name = headerFormat (h, "%{NAME}", &rpmerr);
-        r->arch = headerFormat (h, "%{ARCH}", &rpmerr);
-        r->epoch = headerFormat (h, "%{EPOCH}", &rpmerr);
-        r->release = headerFormat (h, "%{RELEASE}", &rpmerr);
-        r->version = headerFormat (h, "%{VERSION}", &rpmerr);
-	epoch_override = oscap_streq(r->epoch, "(none)") ? "0" : r->epoch;
-	snprintf(r->extended_name, 1024, "%s-%s:%s-%s.%s", r->name, epoch_override, r->version, r->release, r->arch);
-
-	len = (strlen(epoch_override) +
-               strlen (r->release) +
-               strlen (r->version) + 2);
-
-        str = malloc (sizeof (char) * (len + 1));
-        snprintf (str, len + 1, "%s:%s-%s",
-		epoch_override,
-                  r->version,
-                  r->release);
-
-        r->evr = str;
-
-        str = headerFormat (h, "%|SIGGPG?{%{SIGGPG:pgpsig}}:{%{SIGPGP:pgpsig}}|", &rpmerr);
-
-	if (regexec(keyid_regex, str, 1, keyid_match, 0) != 0) {
-		sid = NULL;
-		dD("Failed to extract the Key ID value: regex=\"%s\", string=\"%s\"",
-		   g_keyid_regex_string, str);
-	} else {
-		size_t keyid_start, keyid_length;
-
-		if (keyid_match[0].rm_so < 0 || keyid_match[0].rm_eo < 0)
-			sid = NULL;
-		else {
-			keyid_start = keyid_match[0].rm_so + strlen("Key ID ");
-			keyid_length = keyid_match[0].rm_eo - keyid_start;
-			sid = str + keyid_start;
-			sid[keyid_length] = '\0';
-		}
-	}
-
-        r->signature_keyid = strdup(sid != NULL ? sid : "0");
-        free (str);
-}
-
 /*
  * req - Structure containing the name of the package.
- * rep - Pointer to rpminfo_rep structure pointer. An
- *       array of rpminfo_rep structures will be allocated
- *       here.
+ * packages - Set to the first of the candidate packages, the
+ *            candidates are still to be compared with the object.
  *
- * The return value on error is -1. Otherwise the number of
- * rpminfo_rep structures allocated in *rep is returned.
+ * The packages are looked up in the package index which is read
+ * from the rpmdb only once per session. The return value on error
+ * is -1. Otherwise the number of candidate packages is returned.
  */
-static int get_rpminfo(struct rpminfo_req *req, struct rpminfo_rep **rep, struct rpm_probe_global *g_rpm)
+static int get_rpminfo(struct rpminfo_req *req, const struct rpm_package **packages, struct rpm_probe_global *g_rpm)
 {
-	rpmdbMatchIterator match;
-	Header pkgh;
-	int ret = 0, i;
-	regex_t keyid_regex;
-
-	if (regcomp(&keyid_regex, g_keyid_regex_string, REG_EXTENDED) != 0) {
-		dE("regcomp(%s) failed.", g_keyid_regex_string);
-		return -1;
-	}
+	struct rpm_package_index *index;
+	size_t count = 0;
 
-        RPMINFO_LOCK;
+	RPMINFO_LOCK;
+	index = rpm_probe_global_get_index(g_rpm);
+	RPMINFO_UNLOCK;
 
-        ret = -1;
-
-        switch (req->op) {
-        case OVAL_OPERATION_EQUALS:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMTAG_NAME, (const void *)req->name, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                ret = rpmdbGetIteratorCount (match);
+	if (index == NULL)
+		return -1;
 
-                break;
+	switch (req->op) {
+	case OVAL_OPERATION_EQUALS:
+		*packages = rpm_package_index_find(index, req->name, &count);
+		break;
 	case OVAL_OPERATION_NOT_EQUAL:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_GLOB, "*") != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
-        case OVAL_OPERATION_PATTERN_MATCH:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_REGEX,
-                                        (const char *)req->name) != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
-        default:
-                /* not supported */
-                ret = -1;
-                goto ret;
-        }
-
-        if (ret != -1) {
-                /*
-                 * We can allocate all memory needed now because we know the number
-                 * of results.
-                 */
-                (*rep) = realloc (*rep, sizeof (struct rpminfo_rep) * ret);
-
-                for (i = 0; i < ret; ++i) {
-                        pkgh = rpmdbNextIterator (match);
-
-                        if (pkgh != NULL)
-			pkgh2rep(pkgh, (*rep) + i, &keyid_regex);
-                        else {
-                                /* XXX: emit warning */
-                                break;
-                        }
-                }
-        } else {
-                ret = 0;
-
-                while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-                        (*rep) = realloc (*rep, sizeof (struct rpminfo_rep) * ++ret);
-			if (*rep == NULL) {
-					return -1;
-			}
-			pkgh2rep(pkgh, (*rep) + (ret - 1), &keyid_regex);
-                }
-        }
-
-	match = rpmdbFreeIterator (match);
-ret:
-        RPMINFO_UNLOCK;
+	case OVAL_OPERATION_PATTERN_MATCH:
+		/* names are matched by probe_entobj_cmp() */
+		*packages = rpm_package_index_get_all(index, &count);
+		break;
+	default:
+		/* not supported */
+		return -1;
+	}
 
-	regfree(&keyid_regex);
-        return (ret);
+	return (int) count;
 }
 
 int rpminfo_probe_offline_mode_supported()
@@ -281,6 +129,7 @@ void *rpminfo_probe_init(void)
 	rpmlogSetCallback(rpmErrorCb, NULL);
 #endif
 	struct rpm_probe_global *g_rpm = malloc(sizeof(struct rpm_probe_global));
+	g_rpm->index = NULL;
 	if (rpmReadConfigFiles ((const char *)NULL, (const char *)NULL) != 0) {
 		dD("rpmReadConfigFiles failed: %u, %s.", errno, strerror (errno));
 		g_rpm->rpmts = NULL;
@@ -309,6 +158,7 @@ void rpminfo_probe_fini (void *ptr)
 	if (r->rpmts == NULL)
 		return;
 
+        rpm_package_index_free(r->index);
         rpmtsFree(r->rpmts);
         pthread_mutex_destroy (&(r->mutex));
 
@@ -316,7 +166,7 @@ void rpminfo_probe_fini (void *ptr)
         return;
 }
 
-static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct rpm_probe_global *g_rpm)
+static int collect_rpm_files(SEXP_t *item, const struct rpm_package *rep, struct rpm_probe_global *g_rpm)
 {
 	SEXP_t *value;
 	rpmdbMatchIterator ts;
@@ -325,8 +175,11 @@ static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct
 	rpmTag tag[2] = { RPMTAG_BASENAMES, RPMTAG_DIRNAMES };
 	int i, ret = 0;
 
+	RPMINFO_LOCK;
+
 	ts = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
 	if (ts == NULL) {
+		RPMINFO_UNLOCK;
 		return -1;
 	}
 
@@ -378,6 +231,7 @@ static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct
 	}
 cleanup:
 	ts = rpmdbFreeIterator(ts);
+	RPMINFO_UNLOCK;
 	return ret;
 }
 
@@ -388,7 +242,7 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 	int rpmret, i;
 
         struct rpminfo_req request_st;
-        struct rpminfo_rep *reply_st;
+        const struct rpm_package *reply_st;
 
 	// arg is NULL if regex compilation failed
 	if (arg == NULL) {
@@ -471,7 +325,7 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 
         reply_st  = NULL;
 
-        /* get info from RPM db */
+        /* get info from the package index */
 	switch (rpmret = get_rpminfo(&request_st, &reply_st, g_rpm)) {
         case 0: /* Not found */
                 dI("Package \"%s\" not found.", request_st.name);
@@ -542,15 +396,13 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 
 
 				SEXP_free(name);
-                                __rpminfo_rep_free (&(reply_st[i]));
 
 				if (probe_item_collect(ctx, item) < 0) {
 					SEXP_free(ent);
+					free(request_st.name);
 					return PROBE_EUNKNOWN;
 				}
                         }
-
-                        free (reply_st);
                 }
         }
 
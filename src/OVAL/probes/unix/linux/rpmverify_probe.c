@@ -236,6 +236,7 @@ void *rpmverify_probe_init(void)
         }
 	struct rpm_probe_global *g_rpm = malloc(sizeof(struct rpm_probe_global));
 	g_rpm->rpmts = rpmtsCreate();
+	g_rpm->index = NULL;
 
 	pthread_mutex_init(&(g_rpm->mutex), NULL);
         return ((void *)g_rpm);
@@ -254,6 +255,7 @@ void rpmverify_probe_fini(void *ptr)
 	if (r == NULL)
 		return;
 
+	rpm_package_index_free(r->index);
 	rpmtsFree(r->rpmts);
 	pthread_mutex_destroy (&(r->mutex));
 	free(r);
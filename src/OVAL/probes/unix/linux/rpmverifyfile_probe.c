@@ -34,6 +34,7 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
@@ -41,6 +42,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
 #include <pcre.h>
 
 #include "rpm-helper.h"
@@ -123,6 +125,258 @@ static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_ta
 	return ret;
 }
 
+#define RPMVERIFY_BATCH_SIZE  4096
+#define RPMVERIFY_MAX_THREADS 8
+
+/* Package of the files being verified */
+struct rpmverify_pkg {
+	char *name;
+	char *epoch;
+	char *version;
+	char *release;
+	char *arch;
+	char extended_name[1024];
+	struct rpmverify_pkg *next;
+};
+
+/* File selected to be verified */
+struct rpmverify_job {
+	struct rpmverify_pkg *pkg;
+	char *file;
+	rpmfileAttrs fflags;
+	rpmVerifyAttrs vflags;
+#ifdef HAVE_RPMFILESVERIFY
+	rpmfiles files; /**< NULL if the file has been verified already */
+	int fx;
+	dev_t dev;
+	ino_t ino;
+#endif
+};
+
+/*
+ * Files are verified in batches. The files of a batch are verified by
+ * a pool of threads in the order of their inodes, then they are reported
+ * in the order in which they were selected.
+ */
+struct rpmverify_batch {
+	struct rpmverify_job *jobs;
+	size_t count;
+	size_t size;
+	struct rpmverify_pkg *pkgs;
+	rpmVerifyAttrs omit;
+	int threads;
+#ifdef HAVE_RPMFILESVERIFY
+	struct rpmverify_job **queue; /**< jobs sorted by device and inode */
+	size_t next;                  /**< first job of the queue not taken by a worker */
+	pthread_mutex_t lock;
+#endif
+};
+
+static int rpmverify_thread_count(void)
+{
+#ifdef HAVE_RPMFILESVERIFY
+	const char *threads_str = getenv("OSCAP_RPMVERIFYFILE_THREADS");
+	long threads;
+
+	if (threads_str != NULL) {
+		if (sscanf(threads_str, "%ld", &threads) != 1) {
+			dW("Invalid value of OSCAP_RPMVERIFYFILE_THREADS: '%s'", threads_str);
+			threads = 1;
+		}
+	} else {
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+		if (threads > RPMVERIFY_MAX_THREADS)
+			threads = RPMVERIFY_MAX_THREADS;
+	}
+
+	return threads > 1 ? (int) threads : 1;
+#else
+	/* files can be verified only through an iterator */
+	return 1;
+#endif
+}
+
+static bool rpmverify_ent_matches(SEXP_t *ent, const char *value)
+{
+	SEXP_t *val;
+	bool matches;
+
+	if (ent == NULL)
+		return true;
+
+	val = probe_entval_from_cstr(probe_ent_getdatatype(ent), value, strlen(value));
+	if (val == NULL)
+		return true;
+
+	matches = (probe_entobj_cmp(ent, val) == OVAL_RESULT_TRUE);
+	SEXP_free(val);
+	return matches;
+}
+
+static void rpmverify_pkg_free(struct rpmverify_pkg *pkg)
+{
+	free(pkg->name);
+	free(pkg->epoch);
+	free(pkg->version);
+	free(pkg->release);
+	free(pkg->arch);
+	free(pkg);
+}
+
+static struct rpmverify_job *rpmverify_batch_add(struct rpmverify_batch *batch, struct rpmverify_pkg *pkg)
+{
+	struct rpmverify_job *job;
+
+	if (batch->count == batch->size) {
+		size_t size = batch->size ? 2 * batch->size : 64;
+		job = realloc(batch->jobs, size * sizeof(struct rpmverify_job));
+		if (job == NULL)
+			return NULL;
+		batch->jobs = job;
+		batch->size = size;
+	}
+
+	job = &batch->jobs[batch->count++];
+	memset(job, 0, sizeof(struct rpmverify_job));
+	job->pkg = pkg;
+	return job;
+}
+
+static void rpmverify_batch_clear(struct rpmverify_batch *batch)
+{
+	for (size_t i = 0; i < batch->count; ++i) {
+		free(batch->jobs[i].file);
+#ifdef HAVE_RPMFILESVERIFY
+		if (batch->jobs[i].files != NULL)
+			rpmfilesFree(batch->jobs[i].files);
+#endif
+	}
+	batch->count = 0;
+
+	while (batch->pkgs != NULL) {
+		struct rpmverify_pkg *next = batch->pkgs->next;
+		rpmverify_pkg_free(batch->pkgs);
+		batch->pkgs = next;
+	}
+}
+
+#ifdef HAVE_RPMFILESVERIFY
+static int rpmverify_job_cmp(const void *a, const void *b)
+{
+	const struct rpmverify_job *job_a = *(struct rpmverify_job * const *) a;
+	const struct rpmverify_job *job_b = *(struct rpmverify_job * const *) b;
+
+	if (job_a->dev != job_b->dev)
+		return job_a->dev < job_b->dev ? -1 : 1;
+	if (job_a->ino != job_b->ino)
+		return job_a->ino < job_b->ino ? -1 : 1;
+	return 0;
+}
+
+static void *rpmverify_worker(void *arg)
+{
+	struct rpmverify_batch *batch = arg;
+	struct rpmverify_job *job;
+
+	for (;;) {
+		pthread_mutex_lock(&batch->lock);
+		job = batch->next < batch->count ? batch->queue[batch->next++] : NULL;
+		pthread_mutex_unlock(&batch->lock);
+
+		if (job == NULL)
+			return NULL;
+
+		/*
+		 * User and group names are resolved by librpm using a cache
+		 * which is not thread safe, they are verified afterwards.
+		 */
+		job->vflags = rpmfilesVerify(job->files, job->fx,
+				batch->omit | RPMVERIFY_USER | RPMVERIFY_GROUP);
+	}
+}
+
+static int rpmverify_batch_verify(struct rpmverify_batch *batch)
+{
+	const rpmVerifyAttrs ug_flags = RPMVERIFY_USER | RPMVERIFY_GROUP;
+	pthread_t threads[RPMVERIFY_MAX_THREADS];
+	int threads_count = 0, i;
+	size_t j;
+
+	if (batch->count == 0 || batch->jobs[0].files == NULL)
+		return 0;
+
+	struct rpmverify_job **queue = realloc(batch->queue, batch->count * sizeof(struct rpmverify_job *));
+	if (queue == NULL)
+		return -1;
+	batch->queue = queue;
+	for (j = 0; j < batch->count; ++j)
+		queue[j] = &batch->jobs[j];
+	qsort(queue, batch->count, sizeof(struct rpmverify_job *), rpmverify_job_cmp);
+	batch->next = 0;
+
+	/* the calling thread is one of the workers */
+	for (i = 1; i < batch->threads && i <= RPMVERIFY_MAX_THREADS && (size_t) i < batch->count; ++i) {
+		if (pthread_create(&threads[threads_count], NULL, rpmverify_worker, batch) != 0) {
+			dW("Can't start a rpmverifyfile worker thread: %s", strerror(errno));
+			break;
+		}
+		++threads_count;
+	}
+	rpmverify_worker(batch);
+	for (i = 0; i < threads_count; ++i)
+		pthread_join(threads[i], NULL);
+
+	for (j = 0; j < batch->count; ++j) {
+		struct rpmverify_job *job = &batch->jobs[j];
+
+		if (job->vflags & RPMVERIFY_LSTATFAIL) {
+			job->vflags = RPMVERIFY_FAILURES;
+		} else if ((batch->omit & ug_flags) != ug_flags) {
+			rpmVerifyAttrs ug_vflags = rpmfilesVerify(job->files, job->fx, batch->omit | ~ug_flags);
+			if (ug_vflags & RPMVERIFY_LSTATFAIL)
+				job->vflags = RPMVERIFY_FAILURES;
+			else
+				job->vflags |= ug_vflags & ug_flags;
+		}
+	}
+
+	return 0;
+}
+#else
+static int rpmverify_batch_verify(struct rpmverify_batch *batch)
+{
+	/* files have been verified while they were selected */
+	return 0;
+}
+#endif
+
+/* returns 1 if the callback asked to stop the collection */
+static int rpmverify_batch_report(probe_ctx *ctx, struct rpmverify_batch *batch,
+		int (*callback)(probe_ctx *, struct rpmverify_res *))
+{
+	struct rpmverify_res res;
+
+	for (size_t i = 0; i < batch->count; ++i) {
+		struct rpmverify_job *job = &batch->jobs[i];
+
+		res.name = job->pkg->name;
+		res.epoch = job->pkg->epoch;
+		res.version = job->pkg->version;
+		res.release = job->pkg->release;
+		res.arch = job->pkg->arch;
+		strcpy(res.extended_name, job->pkg->extended_name);
+		res.file = job->file;
+		res.vflags = job->vflags;
+		res.oflags = batch->omit;
+		res.fflags = job->fflags;
+
+		if (callback(ctx, &res) != 0)
+			return 1;
+	}
+
+	return 0;
+}
+
 static int rpmverify_collect(probe_ctx *ctx,
 			     const char *file, oval_operation_t file_op,
 			     SEXP_t *name_ent, SEXP_t *epoch_ent, SEXP_t *version_ent, SEXP_t *release_ent, SEXP_t *arch_ent,
@@ -130,12 +384,16 @@ static int rpmverify_collect(probe_ctx *ctx,
 		int (*callback)(probe_ctx *, struct rpmverify_res *),
 		struct rpm_probe_global *g_rpm)
 {
-	rpmdbMatchIterator match;
+	rpmdbMatchIterator match = NULL;
 	rpmVerifyAttrs omit = (rpmVerifyAttrs)(flags & RPMVERIFY_RPMATTRMASK);
 	Header pkgh;
 	pcre *re = NULL;
 	int  ret = -1;
 	char *file_realpath = NULL;
+	struct rpmverify_batch batch = {
+		.omit = omit,
+		.threads = rpmverify_thread_count(),
+	};
 
 	/* pre-compile regex if needed */
 	if (file_op == OVAL_OPERATION_PATTERN_MATCH) {
@@ -151,6 +409,9 @@ static int rpmverify_collect(probe_ctx *ctx,
 	}
 
 	RPMVERIFY_LOCK;
+#ifdef HAVE_RPMFILESVERIFY
+	pthread_mutex_init(&batch.lock, NULL);
+#endif
 
 	if (file != NULL && file_op == OVAL_OPERATION_EQUALS) {
 		/*
@@ -189,53 +450,48 @@ static int rpmverify_collect(probe_ctx *ctx,
 	}
 
 	if (RPMTAG_BASENAMES == 0 || RPMTAG_DIRNAMES == 0) {
-		return -1;
+		ret = -1;
+		goto ret;
 	}
 
 	file_realpath = oscap_realpath(file, NULL);
 
 	while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-		SEXP_t *ent;
 		rpmfi  fi;
 		rpmTag tag[2] = { RPMTAG_BASENAMES, RPMTAG_DIRNAMES };
-		struct rpmverify_res res;
+		struct rpmverify_pkg *pkg;
+		struct rpmverify_job *job;
 		errmsg_t rpmerr;
 		int i;
 		const char *current_file;
 		char *current_file_realpath;
+		char *res_file;
 
-		/*
-+SEXP_t *probe_ent_from_cstr(const char *name, oval_datatype_t type,
-+                            const char *value, size_t vallen)
-		 */
-
-#define COMPARE_ENT(XXX) \
-		if (XXX ## _ent != NULL) { \
-			ent = probe_entval_from_cstr( \
-				probe_ent_getdatatype(XXX ## _ent), res.XXX, strlen(res.XXX) \
-			); \
-			if (ent != NULL && probe_entobj_cmp(XXX ## _ent, ent) != OVAL_RESULT_TRUE) { \
-				SEXP_free(ent); \
-				continue; \
-			} \
-			SEXP_free(ent); \
+		pkg = calloc(1, sizeof(struct rpmverify_pkg));
+		if (pkg == NULL) {
+			ret = -1;
+			goto ret;
+		}
+		pkg->name = headerFormat(pkgh, "%{NAME}", &rpmerr);
+		pkg->epoch = headerFormat(pkgh, "%{EPOCH}", &rpmerr);
+		pkg->version = headerFormat(pkgh, "%{VERSION}", &rpmerr);
+		pkg->release = headerFormat(pkgh, "%{RELEASE}", &rpmerr);
+		pkg->arch = headerFormat(pkgh, "%{ARCH}", &rpmerr);
+
+		if (!rpmverify_ent_matches(name_ent, pkg->name) ||
+		    !rpmverify_ent_matches(epoch_ent, pkg->epoch) ||
+		    !rpmverify_ent_matches(version_ent, pkg->version) ||
+		    !rpmverify_ent_matches(release_ent, pkg->release) ||
+		    !rpmverify_ent_matches(arch_ent, pkg->arch)) {
+			rpmverify_pkg_free(pkg);
+			continue;
 		}
 
-		res.name = headerFormat(pkgh, "%{NAME}", &rpmerr);
-		COMPARE_ENT(name);
-
-		res.epoch = headerFormat(pkgh, "%{EPOCH}", &rpmerr);
-		COMPARE_ENT(epoch);
-
-		res.version = headerFormat(pkgh, "%{VERSION}", &rpmerr);
-		COMPARE_ENT(version);
-		res.release = headerFormat(pkgh, "%{RELEASE}", &rpmerr);
-		COMPARE_ENT(release);
-		res.arch = headerFormat(pkgh, "%{ARCH}", &rpmerr);
-		COMPARE_ENT(arch);
-		snprintf(res.extended_name, 1024, "%s-%s:%s-%s.%s", res.name,
-			oscap_streq(res.epoch, "(none)") ? "0" : res.epoch,
-			res.version, res.release, res.arch);
+		snprintf(pkg->extended_name, 1024, "%s-%s:%s-%s.%s", pkg->name,
+			oscap_streq(pkg->epoch, "(none)") ? "0" : pkg->epoch,
+			pkg->version, pkg->release, pkg->arch);
+		pkg->next = batch.pkgs;
+		batch.pkgs = pkg;
 
 		/*
 		 * Inspect package files & directories
@@ -243,84 +499,127 @@ static int rpmverify_collect(probe_ctx *ctx,
 		for (i = 0; i < 2; ++i) {
 			fi = rpmfiNew(g_rpm->rpmts, pkgh, tag[i], 1);
 
-		  while (rpmfiNext(fi) != -1) {
-				current_file = rpmfiFN(fi);
-				current_file_realpath = oscap_realpath(current_file, NULL);
-		    res.fflags = rpmfiFFlags(fi);
-		    res.oflags = omit;
+			while (rpmfiNext(fi) != -1) {
+				rpmfileAttrs fflags = rpmfiFFlags(fi);
 
-		    if (((res.fflags & RPMFILE_CONFIG) && (flags & RPMVERIFY_SKIP_CONFIG)) ||
-					((res.fflags & RPMFILE_GHOST)  && (flags & RPMVERIFY_SKIP_GHOST))) {
-					free(current_file_realpath);
+				if (((fflags & RPMFILE_CONFIG) && (flags & RPMVERIFY_SKIP_CONFIG)) ||
+				    ((fflags & RPMFILE_GHOST)  && (flags & RPMVERIFY_SKIP_GHOST)))
 					continue;
-				}
 
-		    switch(file_op) {
-		    case OVAL_OPERATION_EQUALS:
+				current_file = rpmfiFN(fi);
+				current_file_realpath = oscap_realpath(current_file, NULL);
+
+				switch(file_op) {
+				case OVAL_OPERATION_EQUALS:
 					if (strcmp(current_file, file) != 0 &&
-							current_file_realpath && file_realpath &&
-							strcmp(current_file_realpath, file_realpath) != 0) {
+					    current_file_realpath && file_realpath &&
+					    strcmp(current_file_realpath, file_realpath) != 0) {
 						free(current_file_realpath);
 						continue;
 					}
-					res.file = oscap_strdup(file);
-		      break;
-		    case OVAL_OPERATION_NOT_EQUAL:
+					res_file = oscap_strdup(file);
+					break;
+				case OVAL_OPERATION_NOT_EQUAL:
 					if (strcmp(current_file, file) == 0 ||
-							(current_file_realpath && file_realpath &&
-							strcmp(current_file_realpath, file_realpath) == 0)) {
+					    (current_file_realpath && file_realpath &&
+					     strcmp(current_file_realpath, file_realpath) == 0)) {
 						free(current_file_realpath);
 						continue;
 					}
-					res.file = current_file_realpath ? current_file_realpath : strdup(current_file);
-		      break;
-		    case OVAL_OPERATION_PATTERN_MATCH:
+					res_file = current_file_realpath ? current_file_realpath : strdup(current_file);
+					current_file_realpath = NULL;
+					break;
+				case OVAL_OPERATION_PATTERN_MATCH:
 					ret = pcre_exec(re, NULL, current_file, strlen(current_file), 0, 0, NULL, 0);
 
-		      switch(ret) {
-		      case 0: /* match */
-						res.file = strdup(current_file);
-			break;
-		      case -1:
-			/* mismatch */
-						free(current_file_realpath);
-			continue;
-		      default:
-			dE("pcre_exec() failed!");
-			ret = -1;
+					switch(ret) {
+					case 0: /* match */
+						res_file = strdup(current_file);
+						break;
+					case -1:
+						/* mismatch */
 						free(current_file_realpath);
-			goto ret;
-		      }
-		      break;
-		    default:
-		      /* unsupported operation */
-		      dE("Operation \"%d\" on `filepath' not supported", file_op);
-		      ret = -1;
+						continue;
+					default:
+						dE("pcre_exec() failed!");
+						ret = -1;
 						free(current_file_realpath);
-		      goto ret;
-		    }
-
-			if (rpmVerifyFile(g_rpm->rpmts, fi, &res.vflags, omit) != 0)
-		      res.vflags = RPMVERIFY_FAILURES;
+						rpmfiFree(fi);
+						goto ret;
+					}
+					break;
+				default:
+					/* unsupported operation */
+					dE("Operation \"%d\" on `filepath' not supported", file_op);
+					ret = -1;
+					free(current_file_realpath);
+					rpmfiFree(fi);
+					goto ret;
+				}
+				free(current_file_realpath);
+
+				job = rpmverify_batch_add(&batch, pkg);
+				if (job == NULL) {
+					free(res_file);
+					ret = -1;
+					rpmfiFree(fi);
+					goto ret;
+				}
+				job->file = res_file;
+				job->fflags = fflags;
+
+#ifdef HAVE_RPMFILESVERIFY
+				if (batch.threads > 1) {
+					struct stat st;
+
+					/* verified later by the workers */
+					job->files = rpmfilesLink(rpmfiFiles(fi));
+					job->fx = rpmfiFX(fi);
+					if (lstat(current_file, &st) == 0) {
+						job->dev = st.st_dev;
+						job->ino = st.st_ino;
+					}
+					continue;
+				}
+#endif
+				if (rpmVerifyFile(g_rpm->rpmts, fi, &job->vflags, omit) != 0)
+					job->vflags = RPMVERIFY_FAILURES;
+			}
 
-		    if (callback(ctx, &res) != 0) {
-			    ret = 0;
-					free(res.file);
-			    goto ret;
-		    }
-			free(res.file);
-		  }
+			rpmfiFree(fi);
+		}
 
-		  rpmfiFree(fi);
+		if (batch.count >= RPMVERIFY_BATCH_SIZE) {
+			if (rpmverify_batch_verify(&batch) != 0) {
+				ret = -1;
+				goto ret;
+			}
+			if (rpmverify_batch_report(ctx, &batch, callback) != 0) {
+				ret = 0;
+				goto ret;
+			}
+			rpmverify_batch_clear(&batch);
 		}
 	}
 
-	match = rpmdbFreeIterator (match);
-	ret   = 0;
+	ret = 0;
+	if (rpmverify_batch_verify(&batch) != 0)
+		ret = -1;
+	else
+		rpmverify_batch_report(ctx, &batch, callback);
 ret:
+	if (match != NULL)
+		rpmdbFreeIterator(match);
 	if (re != NULL)
 		pcre_free(re);
 
+	rpmverify_batch_clear(&batch);
+	free(batch.jobs);
+#ifdef HAVE_RPMFILESVERIFY
+	free(batch.queue);
+	pthread_mutex_destroy(&batch.lock);
+#endif
+
 	RPMVERIFY_UNLOCK;
 	free(file_realpath);
 	return (ret);
@@ -344,6 +643,7 @@ void *rpmverifyfile_probe_init(void)
 
 	struct rpm_probe_global *g_rpm = malloc(sizeof(struct rpm_probe_global));
 	g_rpm->rpmts = rpmtsCreate();
+	g_rpm->index = NULL;
 
 	pthread_mutex_init(&(g_rpm->mutex), NULL);
 
@@ -363,6 +663,7 @@ void rpmverifyfile_probe_fini(void *ptr)
 	if (r == NULL)
 		return;
 
+	rpm_package_index_free(r->index);
 	rpmtsFree(r->rpmts);
 	pthread_mutex_destroy (&(r->mutex));
 	free(r);
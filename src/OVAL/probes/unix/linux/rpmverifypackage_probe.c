@@ -114,36 +114,36 @@ static struct poptOption optionsTable[] = {
 
 #define CHROOT_PATH() probe_chroot_get_path(&g_rpm->chr)
 
-/* modify passed-in iterator to test also given entity */
-static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_tag) {
-	oval_operation_t ent_op;
-	char ent_str[1024] = "";
-	int ret = 0;
-
-	if (ent) {
-		ent_op = probe_ent_getoperation(ent, OVAL_OPERATION_EQUALS);
-		PROBE_ENT_STRVAL(ent, ent_str, sizeof ent_str, /* void */, strcpy(ent_str, ""););
-		if (rpm_tag == RPMTAG_EPOCH && strcmp(ent_str, "(none)") == 0) {
-			return ret;
-		}
+/* test the value of the package with the object entity, if it is given */
+static bool package_matches(SEXP_t *ent, const char *value)
+{
+	bool matches;
+	SEXP_t *val;
 
-		switch (ent_op) {
-		case OVAL_OPERATION_EQUALS:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_STRCMP, ent_str) != 0)
-				ret = -1;
+	if (ent == NULL)
+		return true;
 
-			break;
-		case OVAL_OPERATION_PATTERN_MATCH:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_REGEX,
-						(const char *)ent_str) != 0)
-				ret = -1;
+	val = probe_entval_from_cstr(probe_ent_getdatatype(ent), value, strlen(value));
+	if (val == NULL)
+		return true;
+	matches = (probe_entobj_cmp(ent, val) == OVAL_RESULT_TRUE);
+	SEXP_free(val);
 
-			break;
-		default:
-			ret = 0;
-		}
+	return matches;
+}
+
+/* candidates for the name entity, the packages are looked up in the package index */
+static const struct rpm_package *find_packages(struct rpm_package_index *index, SEXP_t *name_ent, size_t *count)
+{
+	char name[1024] = "";
+
+	if (name_ent != NULL && probe_ent_getoperation(name_ent, OVAL_OPERATION_EQUALS) == OVAL_OPERATION_EQUALS &&
+	    !probe_ent_attrexists(name_ent, "var_ref")) {
+		PROBE_ENT_STRVAL(name_ent, name, sizeof name, /* void */, strcpy(name, ""););
+		return rpm_package_index_find(index, name, count);
 	}
-	return ret;
+
+	return rpm_package_index_get_all(index, count);
 }
 
 static int rpmverify_collect(probe_ctx *ctx,
@@ -152,8 +152,9 @@ static int rpmverify_collect(probe_ctx *ctx,
 			int (*callback)(probe_ctx *, struct rpmverify_res *),
 			struct verifypackage_global *g_rpm)
 {
-	rpmdbMatchIterator match;
-	Header pkgh;
+	struct rpm_package_index *index;
+	const struct rpm_package *packages;
+	size_t count, p;
 	int  ret = -1;
 	unsigned int i, j, rpmcli_argc = 0;
 	const char * rpmcli_argv[10];
@@ -162,73 +163,38 @@ static int rpmverify_collect(probe_ctx *ctx,
 
 	RPMVERIFY_LOCK;
 
-	match = rpmtsInitIterator (g_rpm->rpm.rpmts, RPMDBI_PACKAGES, NULL, 0);
-	if (match == NULL) {
-		ret = 0;
-		goto ret;
-	}
-
-	if ((ret = adjust_filter(match, name_ent, RPMTAG_NAME)) == -1) {
-		dE("can't adjust filter with name");
-		goto ret;
-	}
-	if ((ret = adjust_filter(match, epoch_ent, RPMTAG_EPOCH)) == -1) {
-		dE("can't adjust filter with epoch");
-		goto ret;
-	}
-	if ((ret = adjust_filter(match, version_ent, RPMTAG_VERSION)) == -1) {
-		dE("can't adjust filter with version");
-		goto ret;
-	}
-	if ((ret = adjust_filter(match, release_ent, RPMTAG_RELEASE)) == -1) {
-		dE("can't adjust filter with version");
-		goto ret;
-	}
-	if ((ret = adjust_filter(match, arch_ent, RPMTAG_ARCH)) == -1) {
-		dE("can't adjust filter with version");
+	index = rpm_probe_global_get_index(&g_rpm->rpm);
+	if (index == NULL) {
+		dE("can't read the installed packages");
 		goto ret;
 	}
 
 	if (RPMTAG_BASENAMES == 0 || RPMTAG_DIRNAMES == 0) {
-		return -1;
+		goto ret;
 	}
 
 	rpmcli_argv[0] = "probe_rpmverifypackage";
 	rpmcli_argv[1] = "--quiet";
 	rpmcli_argv[2] = "--nofiles";
 
-	while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-		SEXP_t *ent;
+	packages = find_packages(index, name_ent, &count);
+	for (p = 0; p < count; ++p) {
+		const struct rpm_package *pkg = &packages[p];
 		struct rpmverify_res res;
-		errmsg_t rpmerr;
-
-#define COMPARE_ENT(XXX) \
-		if (XXX ## _ent != NULL) { \
-			ent = probe_entval_from_cstr( \
-				probe_ent_getdatatype(XXX ## _ent), res.XXX, strlen(res.XXX) \
-			); \
-			if (ent != NULL && probe_entobj_cmp(XXX ## _ent, ent) != OVAL_RESULT_TRUE) { \
-				SEXP_free(ent); \
-				continue; \
-			} \
-			SEXP_free(ent); \
-		}
-
-		res.name = headerFormat(pkgh, "%{NAME}", &rpmerr);
-		COMPARE_ENT(name);
 
-		res.epoch = headerFormat(pkgh, "%{EPOCH}", &rpmerr);
-		COMPARE_ENT(epoch);
+		if (!package_matches(name_ent, pkg->name) ||
+		    !package_matches(epoch_ent, pkg->epoch) ||
+		    !package_matches(version_ent, pkg->version) ||
+		    !package_matches(release_ent, pkg->release) ||
+		    !package_matches(arch_ent, pkg->arch))
+			continue;
 
-		res.version = headerFormat(pkgh, "%{VERSION}", &rpmerr);
-		COMPARE_ENT(version);
-		res.release = headerFormat(pkgh, "%{RELEASE}", &rpmerr);
-		COMPARE_ENT(release);
-		res.arch = headerFormat(pkgh, "%{ARCH}", &rpmerr);
-		COMPARE_ENT(arch);
-		snprintf(res.extended_name, 1024, "%s-%s:%s-%s.%s", res.name,
-			oscap_streq(res.epoch, "(none)") ? "0" : res.epoch,
-			res.version, res.release, res.arch);
+		res.name = pkg->name;
+		res.epoch = pkg->epoch;
+		res.version = pkg->version;
+		res.release = pkg->release;
+		res.arch = pkg->arch;
+		strcpy(res.extended_name, pkg->extended_name);
 
 		/*
 		 * Verify package
@@ -296,14 +262,8 @@ static int rpmverify_collect(probe_ctx *ctx,
 			ret = 1;
 			goto ret;
 		}
-		free(res.name);
-		free(res.epoch);
-		free(res.version);
-		free(res.release);
-		free(res.arch);
 	}
 
-	match = rpmdbFreeIterator (match);
 	ret   = 0;
 ret:
 	RPMVERIFY_UNLOCK;
@@ -345,6 +305,7 @@ void *rpmverifypackage_probe_init(void)
 	}
 
 	g_rpm->rpm.rpmts = rpmtsCreate();
+	g_rpm->rpm.index = NULL;
 
 	if (CHROOT_IS_SET()) {
 		CHROOT_LEAVE();
@@ -380,6 +341,7 @@ void rpmverifypackage_probe_fini(void *ptr)
 	if (r->rpm.rpmts == NULL)
 		return;
 
+	rpm_package_index_free(r->rpm.index);
 	rpmtsFree(r->rpm.rpmts);
 	pthread_mutex_destroy (&(r->rpm.mutex));
 
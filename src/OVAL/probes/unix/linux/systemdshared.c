@@ -0,0 +1,682 @@
+/**
+ * @file   systemdshared.c
+ * @brief  functionality shared between systemdunitproperty and systemdunitdependency tests
+ * @author
+ */
+
+/*
+ * Copyright 2014 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * Authors:
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dbus/dbus.h>
+#include "common/debug_priv.h"
+#include "common/list.h"
+#include "oscap_helpers.h"
+#include "systemdshared.h"
+
+/* maximum number of D-Bus calls waiting for a reply at once */
+#define SYSTEMD_MAX_PENDING 64
+
+// Old versions of libdbus API don't have DBusBasicValue and DBus8ByteStruct
+// as a public typedefs.
+// These two typedefs were copied from libdbus 1.8 branch, see
+// http://cgit.freedesktop.org/dbus/dbus/tree/dbus/dbus-types.h?h=dbus-1.8#n137
+typedef struct
+{
+	dbus_uint32_t first32;
+	dbus_uint32_t second32;
+} _DBus8ByteStruct;
+
+typedef union
+{
+	unsigned char bytes[8]; /**< as 8 individual bytes */
+	dbus_int16_t  i16;   /**< as int16 */
+	dbus_uint16_t u16;   /**< as int16 */
+	dbus_int32_t  i32;   /**< as int32 */
+	dbus_uint32_t u32;   /**< as int32 */
+	dbus_bool_t   bool_val; /**< as boolean */
+#ifdef DBUS_HAVE_INT64
+	dbus_int64_t  i64;   /**< as int64 */
+	dbus_uint64_t u64;   /**< as int64 */
+#endif
+	_DBus8ByteStruct eight; /**< as 8-byte struct */
+	double dbl;          /**< as double */
+	unsigned char byt;   /**< as byte */
+	char *str;           /**< as char* (string, object path or signature) */
+	int fd;              /**< as Unix file descriptor */
+} _DBusBasicValue;
+
+static int get_all_systemd_units(DBusConnection* conn, int(*callback)(const char *, void *), void *cbarg)
+{
+	DBusMessage *msg = NULL;
+	DBusPendingCall *pending = NULL;
+	char ret = 1;
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		"/org/freedesktop/systemd1",
+		"org.freedesktop.systemd1.Manager",
+		"ListUnits"
+	);
+	if (msg == NULL) {
+		dD("Failed to create dbus_message via dbus_message_new_method_call!");
+		goto cleanup;
+	}
+
+	DBusMessageIter args, unit_iter;
+
+	// the args should be empty for this call
+	dbus_message_iter_init_append(msg, &args);
+
+	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
+		dD("Failed to send message via dbus!");
+		goto cleanup;
+	}
+	if (pending == NULL) {
+		dD("Invalid dbus pending call!");
+		goto cleanup;
+	}
+
+	dbus_connection_flush(conn);
+	dbus_message_unref(msg); msg = NULL;
+
+	dbus_pending_call_block(pending);
+	msg = dbus_pending_call_steal_reply(pending);
+	if (msg == NULL) {
+		dD("Failed to steal dbus pending call reply.");
+		goto cleanup;
+	}
+	dbus_pending_call_unref(pending); pending = NULL;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dD("Failed to initialize iterator over received dbus message.");
+		goto cleanup;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY) {
+		dD("Expected array of structs in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		goto cleanup;
+	}
+
+	dbus_message_iter_recurse(&args, &unit_iter);
+	do {
+		if (dbus_message_iter_get_arg_type(&unit_iter) != DBUS_TYPE_STRUCT) {
+			dD("Expected unit struct as elements in returned array. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_iter)));
+			goto cleanup;
+		}
+
+		DBusMessageIter unit_name;
+		dbus_message_iter_recurse(&unit_iter, &unit_name);
+
+		if (dbus_message_iter_get_arg_type(&unit_name) != DBUS_TYPE_STRING) {
+			dD("Expected string as the first element in the unit struct. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&unit_name)));
+			goto cleanup;
+		}
+
+		_DBusBasicValue value;
+		dbus_message_iter_get_basic(&unit_name, &value);
+		char *unit_name_s = oscap_strdup(value.str);
+		int cbret = callback(unit_name_s, cbarg);
+		free(unit_name_s);
+		if (cbret != 0) {
+			goto cleanup;
+		}
+	}
+	while (dbus_message_iter_next(&unit_iter));
+
+	dbus_message_unref(msg); msg = NULL;
+
+	ret = 0;
+
+cleanup:
+	if (pending != NULL)
+		dbus_pending_call_unref(pending);
+
+	if (msg != NULL)
+		dbus_message_unref(msg);
+
+	return ret;
+}
+
+static char *dbus_value_to_string(DBusMessageIter *iter)
+{
+	const int arg_type = dbus_message_iter_get_arg_type(iter);
+	if (dbus_type_is_basic(arg_type)) {
+		_DBusBasicValue value;
+		dbus_message_iter_get_basic(iter, &value);
+
+		switch (arg_type)
+		{
+			case DBUS_TYPE_BYTE:
+				return oscap_sprintf("%c", value.byt);
+
+			case DBUS_TYPE_BOOLEAN:
+				return oscap_strdup(value.bool_val ? "true" : "false");
+
+			case DBUS_TYPE_INT16:
+				return oscap_sprintf("%i", value.i16);
+
+			case DBUS_TYPE_UINT16:
+				return oscap_sprintf("%u", value.u16);
+
+			case DBUS_TYPE_INT32:
+				return oscap_sprintf("%i", value.i32);
+
+			case DBUS_TYPE_UINT32:
+				return oscap_sprintf("%u", value.u32);
+
+#ifdef DBUS_HAVE_INT64
+			case DBUS_TYPE_INT64:
+				return oscap_sprintf("%lli", value.i64);
+
+			case DBUS_TYPE_UINT64:
+				return oscap_sprintf("%llu", value.u64);
+#endif
+
+			case DBUS_TYPE_DOUBLE:
+				return oscap_sprintf("%g", value.dbl);
+
+			case DBUS_TYPE_STRING:
+			case DBUS_TYPE_OBJECT_PATH:
+			case DBUS_TYPE_SIGNATURE:
+				return oscap_strdup(value.str);
+
+			// non-basic types
+			//case DBUS_TYPE_ARRAY:
+			//case DBUS_TYPE_STRUCT:
+			//case DBUS_TYPE_DICT_ENTRY:
+			//case DBUS_TYPE_VARIANT:
+
+			//case DBUS_TYPE_UNIX_FD:
+			//	return oscap_sprintf("%i", value.fd);
+
+			default:
+				dD("Encountered unknown dbus basic type!");
+				return oscap_strdup("error, unknown basic type!");
+		}
+	}
+	else if (arg_type == DBUS_TYPE_ARRAY) {
+		DBusMessageIter array;
+		dbus_message_iter_recurse(iter, &array);
+
+		char *ret = NULL;
+		do {
+			char *element = dbus_value_to_string(&array);
+
+			if (element == NULL)
+				continue;
+
+			char *old_ret = ret;
+			if (old_ret == NULL)
+				ret = oscap_sprintf("%s", element);
+			else
+				ret = oscap_sprintf("%s, %s", old_ret, element);
+
+			free(old_ret);
+			free(element);
+		}
+		while (dbus_message_iter_next(&array));
+
+		return ret;
+	}/*
+	else if (arg_type == DBUS_TYPE_VARIANT) {
+		DBusMessageIter inner;
+		dbus_message_iter_recurse(iter, &inner);
+		return dbus_value_to_string(&inner);
+	}*/
+
+	return NULL;
+}
+
+static DBusConnection *connect_dbus(void)
+{
+	DBusConnection *conn = NULL;
+
+	DBusError err;
+	dbus_error_init(&err);
+
+	conn = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+	if (dbus_error_is_set(&err)) {
+		dD("Failed to get DBUS_BUS_SYSTEM connection - %s", err.message);
+		goto cleanup;
+	}
+	if (conn == NULL) {
+		dD("DBusConnection == NULL!");
+		goto cleanup;
+	}
+
+	dbus_bus_register(conn, &err);
+	if (dbus_error_is_set(&err)) {
+		dD("Failed to register on dbus - %s", err.message);
+		goto cleanup;
+	}
+
+cleanup:
+	dbus_error_free(&err);
+
+	return conn;
+}
+
+struct systemd_units {
+	int refs;
+	pthread_mutex_t lock;
+	DBusConnection *conn;
+	bool connect_failed;
+	char **names;          /**< units listed by ListUnits, NULL until listed */
+	size_t name_count;
+	struct oscap_htable *units; /**< unit name -> struct systemd_unit */
+};
+
+/* units of the current scan, see systemd_units_acquire() */
+static pthread_mutex_t systemd_units_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct systemd_units *systemd_units_current = NULL;
+
+static DBusMessage *new_load_unit_call(const struct systemd_unit *unit)
+{
+	DBusMessage *msg;
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		"/org/freedesktop/systemd1",
+		"org.freedesktop.systemd1.Manager",
+		// LoadUnit is similar to GetUnit except it will load the unit file
+		// if it hasn't been loaded yet.
+		"LoadUnit"
+	);
+	if (msg == NULL) {
+		dD("Failed to create dbus_message via dbus_message_new_method_call!");
+		return NULL;
+	}
+
+	if (!dbus_message_append_args(msg, DBUS_TYPE_STRING, &unit->name, DBUS_TYPE_INVALID)) {
+		dD("Failed to append unit '%s' string parameter to dbus message!", unit->name);
+		dbus_message_unref(msg);
+		return NULL;
+	}
+
+	return msg;
+}
+
+static void read_load_unit_reply(struct systemd_unit *unit, DBusMessage *msg)
+{
+	DBusMessageIter args;
+	_DBusBasicValue path;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dD("Failed to initialize iterator over received dbus message.");
+		return;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_OBJECT_PATH) {
+		dD("Expected object path argument in reply for unit '%s'. Instead received: %s.", unit->name, dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		return;
+	}
+
+	dbus_message_iter_get_basic(&args, &path);
+	unit->path = oscap_strdup(path.str);
+}
+
+static DBusMessage *new_get_all_call(const struct systemd_unit *unit)
+{
+	DBusMessage *msg;
+	const char *interface = "org.freedesktop.systemd1.Unit";
+
+	msg = dbus_message_new_method_call(
+		"org.freedesktop.systemd1",
+		unit->path,
+		"org.freedesktop.DBus.Properties",
+		"GetAll"
+	);
+	if (msg == NULL) {
+		dD("Failed to create dbus_message via dbus_message_new_method_call!");
+		return NULL;
+	}
+
+	if (!dbus_message_append_args(msg, DBUS_TYPE_STRING, &interface, DBUS_TYPE_INVALID)) {
+		dD("Failed to append interface '%s' string parameter to dbus message!", interface);
+		dbus_message_unref(msg);
+		return NULL;
+	}
+
+	return msg;
+}
+
+/* The property takes the value, it's freed if it can't be added */
+static int add_property_value(struct systemd_unit_property *property, char *value)
+{
+	char **values = realloc(property->values, (property->value_count + 1) * sizeof(char *));
+	if (values == NULL) {
+		dE("Failed to allocate memory for a value of property '%s'.", property->name);
+		free(value);
+		return -1;
+	}
+	property->values = values;
+	property->values[property->value_count++] = value;
+	return 0;
+}
+
+static void read_get_all_reply(struct systemd_unit *unit, DBusMessage *msg)
+{
+	DBusMessageIter args, property_iter;
+
+	if (!dbus_message_iter_init(msg, &args)) {
+		dD("Failed to initialize iterator over received dbus message.");
+		return;
+	}
+
+	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY || dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
+		dD("Expected array of dict_entry argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
+		return;
+	}
+
+	dbus_message_iter_recurse(&args, &property_iter);
+	while (dbus_message_iter_get_arg_type(&property_iter) == DBUS_TYPE_DICT_ENTRY) {
+		DBusMessageIter dict_entry, value_variant;
+		_DBusBasicValue value;
+		dbus_message_iter_recurse(&property_iter, &dict_entry);
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
+			dD("Expected string as key in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			return;
+		}
+		dbus_message_iter_get_basic(&dict_entry, &value);
+
+		if (dbus_message_iter_next(&dict_entry) == false) {
+			dW("Expected another field in dict_entry.");
+			return;
+		}
+
+		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
+			dD("Expected variant as value in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
+			return;
+		}
+
+		struct systemd_unit_property *properties = realloc(unit->properties, (unit->property_count + 1) * sizeof(struct systemd_unit_property));
+		if (properties == NULL) {
+			dE("Failed to allocate memory for the properties of unit '%s'.", unit->name);
+			return;
+		}
+		unit->properties = properties;
+		struct systemd_unit_property *property = &unit->properties[unit->property_count++];
+		property->name = oscap_strdup(value.str);
+		property->values = NULL;
+		property->value_count = 0;
+
+		dbus_message_iter_recurse(&dict_entry, &value_variant);
+		// DBUS_TYPE_ARRAY is a special case, each element is one value
+		if (dbus_message_iter_get_arg_type(&value_variant) == DBUS_TYPE_ARRAY) {
+			DBusMessageIter array;
+			dbus_message_iter_recurse(&value_variant, &array);
+
+			do {
+				char *element = dbus_value_to_string(&array);
+				if (element == NULL)
+					continue;
+
+				if (add_property_value(property, element) != 0)
+					return;
+			}
+			while (dbus_message_iter_next(&array));
+		}
+		else {
+			if (add_property_value(property, dbus_value_to_string(&value_variant)) != 0)
+				return;
+		}
+
+		dbus_message_iter_next(&property_iter);
+	}
+}
+
+/*
+ * Call a method for each of the units without waiting for the replies of
+ * the previous calls, at most SYSTEMD_MAX_PENDING calls are in flight.
+ * The replies are handled in the order of the units.
+ */
+static void call_pipelined(DBusConnection *conn, struct systemd_unit **units, size_t count,
+		DBusMessage *(*new_call)(const struct systemd_unit *),
+		void (*read_reply)(struct systemd_unit *, DBusMessage *))
+{
+	DBusPendingCall *pending[SYSTEMD_MAX_PENDING];
+	size_t sent = 0, received = 0;
+
+	while (received < count) {
+		while (sent < count && sent - received < SYSTEMD_MAX_PENDING) {
+			DBusMessage *msg = new_call(units[sent]);
+			DBusPendingCall *call = NULL;
+
+			if (msg != NULL) {
+				if (!dbus_connection_send_with_reply(conn, msg, &call, -1)) {
+					dD("Failed to send message via dbus!");
+					call = NULL;
+				}
+				dbus_message_unref(msg);
+			}
+			pending[sent++ % SYSTEMD_MAX_PENDING] = call;
+		}
+		dbus_connection_flush(conn);
+
+		DBusPendingCall *call = pending[received % SYSTEMD_MAX_PENDING];
+		if (call != NULL) {
+			dbus_pending_call_block(call);
+			DBusMessage *msg = dbus_pending_call_steal_reply(call);
+			dbus_pending_call_unref(call);
+
+			if (msg == NULL) {
+				dD("Failed to steal dbus pending call reply.");
+			} else {
+				if (dbus_message_get_type(msg) == DBUS_MESSAGE_TYPE_ERROR)
+					dD("D-Bus call for unit '%s' failed: %s", units[received]->name, dbus_message_get_error_name(msg));
+				else
+					read_reply(units[received], msg);
+				dbus_message_unref(msg);
+			}
+		}
+		++received;
+	}
+}
+
+static void systemd_unit_free(void *ptr)
+{
+	struct systemd_unit *unit = ptr;
+
+	for (size_t i = 0; i < unit->property_count; ++i) {
+		for (size_t j = 0; j < unit->properties[i].value_count; ++j)
+			free(unit->properties[i].values[j]);
+		free(unit->properties[i].values);
+		free(unit->properties[i].name);
+	}
+	free(unit->properties);
+	free(unit->path);
+	free(unit->name);
+	free(unit);
+}
+
+/* the caller holds units->lock */
+static DBusConnection *systemd_units_connect(struct systemd_units *units)
+{
+	if (units->conn == NULL && !units->connect_failed) {
+		units->conn = connect_dbus();
+		units->connect_failed = units->conn == NULL;
+	}
+	return units->conn;
+}
+
+struct systemd_units *systemd_units_acquire(void)
+{
+	struct systemd_units *units;
+
+	pthread_mutex_lock(&systemd_units_lock);
+	units = systemd_units_current;
+	if (units == NULL) {
+		/* the probes of a scan use the connection from several threads */
+		dbus_threads_init_default();
+
+		/* nothing is asked for until a probe needs the units */
+		units = calloc(1, sizeof(struct systemd_units));
+		if (units == NULL) {
+			pthread_mutex_unlock(&systemd_units_lock);
+			dE("Failed to allocate the systemd units.");
+			return NULL;
+		}
+		pthread_mutex_init(&units->lock, NULL);
+		units->units = oscap_htable_new();
+		systemd_units_current = units;
+	}
+	++units->refs;
+	pthread_mutex_unlock(&systemd_units_lock);
+
+	return units;
+}
+
+void systemd_units_release(struct systemd_units *units)
+{
+	if (units == NULL)
+		return;
+
+	pthread_mutex_lock(&systemd_units_lock);
+	if (--units->refs == 0) {
+		if (systemd_units_current == units)
+			systemd_units_current = NULL;
+
+		// Connections retrieved via dbus_bus_get shall not be closed,
+		// these connections are shared.
+		if (units->conn != NULL)
+			dbus_connection_unref(units->conn);
+		clear_unit_names(units);
+		oscap_htable_free(units->units, systemd_unit_free);
+		pthread_mutex_destroy(&units->lock);
+		free(units);
+	}
+	pthread_mutex_unlock(&systemd_units_lock);
+}
+
+static int add_unit_name(const char *unit, void *arg)
+{
+	struct systemd_units *units = arg;
+
+	char **names = realloc(units->names, (units->name_count + 1) * sizeof(char *));
+	if (names == NULL) {
+		dE("Failed to allocate memory for %zu systemd unit names.", units->name_count + 1);
+		return -1;
+	}
+	units->names = names;
+	units->names[units->name_count++] = oscap_strdup(unit);
+	return 0;
+}
+
+static void clear_unit_names(struct systemd_units *units)
+{
+	for (size_t i = 0; i < units->name_count; ++i)
+		free(units->names[i]);
+	free(units->names);
+	units->names = NULL;
+	units->name_count = 0;
+}
+
+const char **systemd_units_list(struct systemd_units *units, size_t *count)
+{
+	const char **names = NULL;
+
+	pthread_mutex_lock(&units->lock);
+	if (systemd_units_connect(units) != NULL) {
+		if (units->names == NULL && get_all_systemd_units(units->conn, add_unit_name, units) != 0) {
+			dD("Failed to list systemd units.");
+			/* a partial list would be taken for all the units */
+			clear_unit_names(units);
+		}
+
+		names = (const char **)units->names;
+		*count = units->name_count;
+	}
+	pthread_mutex_unlock(&units->lock);
+
+	return names;
+}
+
+int systemd_units_load(struct systemd_units *units, const char **names, size_t count, const struct systemd_unit **found)
+{
+	struct systemd_unit **todo;
+	size_t todo_count = 0;
+	int ret = 0;
+
+	pthread_mutex_lock(&units->lock);
+	if (systemd_units_connect(units) == NULL) {
+		pthread_mutex_unlock(&units->lock);
+		return -1;
+	}
+
+	todo = malloc(count * sizeof(struct systemd_unit *));
+	if (todo == NULL && count > 0) {
+		dE("Failed to allocate memory for %zu systemd units.", count);
+		pthread_mutex_unlock(&units->lock);
+		return -1;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		struct systemd_unit *unit = oscap_htable_get(units->units, names[i]);
+
+		if (unit == NULL) {
+			unit = calloc(1, sizeof(struct systemd_unit));
+			if (unit == NULL) {
+				/* the units added to the cache so far are still loaded */
+				dE("Failed to allocate systemd unit '%s'.", names[i]);
+				ret = -1;
+				break;
+			}
+			unit->name = oscap_strdup(names[i]);
+			oscap_htable_add(units->units, unit->name, unit);
+			todo[todo_count++] = unit;
+		}
+		found[i] = unit;
+	}
+
+	if (todo_count > 0) {
+		call_pipelined(units->conn, todo, todo_count, new_load_unit_call, read_load_unit_reply);
+
+		/* only the loaded units have properties */
+		size_t loaded = 0;
+		for (size_t i = 0; i < todo_count; ++i) {
+			if (todo[i]->path != NULL)
+				todo[loaded++] = todo[i];
+		}
+		call_pipelined(units->conn, todo, loaded, new_get_all_call, read_get_all_reply);
+	}
+	free(todo);
+	pthread_mutex_unlock(&units->lock);
+
+	return ret;
+}
+
+const struct systemd_unit_property *systemd_unit_get_property(const struct systemd_unit *unit, const char *name)
+{
+	for (size_t i = 0; i < unit->property_count; ++i) {
+		if (strcmp(unit->properties[i].name, name) == 0)
+			return &unit->properties[i];
+	}
+	return NULL;
+}
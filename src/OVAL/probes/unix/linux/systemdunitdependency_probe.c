@@ -35,92 +35,10 @@
 #include "systemdshared.h"
 #include "common/list.h"
 #include <string.h>
+#include "common/util.h"
 #include "systemdunitdependency_probe.h"
 
-static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit, SEXP_t *item, struct oscap_htable *visited_units);
-
-static char *get_property_by_unit_path(DBusConnection *conn, const char *unit_path, const char *property)
-{
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-	char *ret = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"Get"
-	);
-	if (msg == NULL) {
-		dD("Failed to create dbus_message via dbus_message_new_method_call!");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, value_iter;
-
-	const char *interface = "org.freedesktop.systemd1.Unit";
-
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dD("Failed to append interface '%s' string parameter to dbus message!", interface);
-		goto cleanup;
-	}
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &property)) {
-		dD("Failed to append property '%s' string parameter to dbus message!", property);
-		goto cleanup;
-	}
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dD("Failed to send message via dbus!");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dD("Invalid dbus pending call!");
-		goto cleanup;
-	}
-
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
-
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dD("Failed to steal dbus pending call reply.");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
-
-	if (!dbus_message_iter_init(msg, &args)) {
-		dD("Failed to initialize iterator over received dbus message.");
-		goto cleanup;
-	}
-
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_VARIANT)
-	{
-		dD("Expected variant argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
-
-	dbus_message_iter_recurse(&args, &value_iter);
-	ret = dbus_value_to_string(&value_iter);
-
-	dbus_message_unref(msg); msg = NULL;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
-
-	if (msg != NULL)
-		dbus_message_unref(msg);
-
-	return ret;
-}
-
-struct unit_callback_vars {
-	DBusConnection *dbus_conn;
-	probe_ctx *ctx;
-	SEXP_t *unit_entity;
-};
+static void get_all_dependencies_by_unit(struct systemd_units *units, const char *unit, SEXP_t *item, struct oscap_htable *visited_units);
 
 static bool is_unit_name_a_target(const char *unit)
 {
@@ -149,27 +67,39 @@ static int add_unit_dependency(const char *dependency, SEXP_t *item, struct osca
 	return 0;
 }
 
-static void process_unit_property(const char *property, DBusConnection *conn, const char *path, SEXP_t *item, struct oscap_htable *visited_units)
+static void process_unit_property(const char *property, struct systemd_units *units, const struct systemd_unit *unit, SEXP_t *item, struct oscap_htable *visited_units)
 {
-	char *values_s = get_property_by_unit_path(conn, path, property);
-	if (values_s) {
-		char **values = oscap_split(values_s, ", ");
-		for (int i = 0; values[i] != NULL; ++i) {
-			if (oscap_strcmp(values[i], "") == 0) {
-				continue;
-			}
-
-			if (add_unit_dependency(values[i], item, visited_units) == 0) {
-				get_all_dependencies_by_unit(conn, values[i], item, visited_units);
-			}
+	const struct systemd_unit_property *values = systemd_unit_get_property(unit, property);
+	if (values == NULL)
+		return;
+
+	// Load the dependencies which are recursed into all at once
+	const char **targets = malloc(values->value_count * sizeof(char *));
+	const struct systemd_unit **found = malloc(values->value_count * sizeof(struct systemd_unit *));
+	size_t target_count = 0;
+	for (size_t i = 0; i < values->value_count; ++i) {
+		if (is_unit_name_a_target(values->values[i]) && oscap_htable_get(visited_units, values->values[i]) == NULL)
+			targets[target_count++] = values->values[i];
+	}
+	systemd_units_load(units, targets, target_count, found);
+	free(found);
+	free(targets);
+
+	for (size_t i = 0; i < values->value_count; ++i) {
+		if (values->values[i] == NULL || oscap_strcmp(values->values[i], "") == 0) {
+			continue;
+		}
+
+		if (add_unit_dependency(values->values[i], item, visited_units) == 0) {
+			get_all_dependencies_by_unit(units, values->values[i], item, visited_units);
 		}
-		free(values);
 	}
-	free(values_s);
 }
 
-static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit, SEXP_t *item, struct oscap_htable *visited_units)
+static void get_all_dependencies_by_unit(struct systemd_units *units, const char *unit, SEXP_t *item, struct oscap_htable *visited_units)
 {
+	const struct systemd_unit *loaded = NULL;
+
 	if (!unit || strcmp(unit, "(null)") == 0)
 		return;
 
@@ -177,43 +107,36 @@ static void get_all_dependencies_by_unit(DBusConnection *conn, const char *unit,
 	if (!is_unit_name_a_target(unit))
 		return;
 
-	char *path = get_path_by_unit(conn, unit);
-
-	process_unit_property("Requires", conn, path, item, visited_units);
-	process_unit_property("Wants", conn, path, item, visited_units);
+	if (systemd_units_load(units, &unit, 1, &loaded) != 0 || loaded->path == NULL)
+		return;
 
-	free(path);
+	process_unit_property("Requires", units, loaded, item, visited_units);
+	process_unit_property("Wants", units, loaded, item, visited_units);
 }
 
-static int unit_callback(const char *unit, void *cbarg)
+/* The units and their properties are cached for the whole scan, they are
+ * shared with the systemdunitproperty probe. */
+void *systemdunitdependency_probe_init(void)
 {
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-	SEXP_t *se_unit = SEXP_string_new(unit, strlen(unit));
-
-	if (probe_entobj_cmp(vars->unit_entity, se_unit) != OVAL_RESULT_TRUE) {
-		/* Do nothing, continue with the next unit */
-		SEXP_free(se_unit);
-		return 0;
-	}
-
-	SEXP_t *item = probe_item_create(OVAL_LINUX_SYSTEMDUNITDEPENDENCY, NULL,
-					 "unit", OVAL_DATATYPE_SEXP, se_unit,
-					 NULL);
-
-	struct oscap_htable *visited_units = oscap_htable_new();
-	get_all_dependencies_by_unit(vars->dbus_conn, unit, item, visited_units);
-	oscap_htable_free(visited_units, NULL);
-
-	probe_item_collect(vars->ctx, item);
-	SEXP_free(se_unit);
+	return systemd_units_acquire();
+}
 
-	return 0;
+void systemdunitdependency_probe_fini(void *probe_arg)
+{
+	systemd_units_release(probe_arg);
 }
 
 int systemdunitdependency_probe_main(probe_ctx *ctx, void *probe_arg)
 {
 	SEXP_t *unit_entity, *probe_in;
 	oval_schema_version_t oval_version;
+	struct systemd_units *units = probe_arg;
+	const char **names, **matching, **targets;
+	const struct systemd_unit **found;
+	size_t count, matching_count = 0, target_count = 0;
+
+	if (units == NULL)
+		return PROBE_ENOMEM;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_platform_schema_version(probe_in);
@@ -223,14 +146,8 @@ int systemdunitdependency_probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
-
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
-
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
+	names = systemd_units_list(units, &count);
+	if (names == NULL) {
 		SEXP_t *msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_INFO, "DBus connection failed, could not identify systemd units.");
 		probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
 		probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
@@ -240,17 +157,41 @@ int systemdunitdependency_probe_main(probe_ctx *ctx, void *probe_arg)
 
 	unit_entity = probe_obj_getent(probe_in, "unit", 1);
 
-	struct unit_callback_vars vars;
+	matching = malloc(count * sizeof(char *));
+	targets = malloc(count * sizeof(char *));
+	for (size_t i = 0; i < count; ++i) {
+		SEXP_t *se_unit = SEXP_string_new(names[i], strlen(names[i]));
+
+		if (probe_entobj_cmp(unit_entity, se_unit) == OVAL_RESULT_TRUE) {
+			matching[matching_count++] = names[i];
+			if (is_unit_name_a_target(names[i]))
+				targets[target_count++] = names[i];
+		}
+		SEXP_free(se_unit);
+	}
+
+	// Only the targets have dependencies, load them all at once
+	found = malloc(target_count * sizeof(struct systemd_unit *));
+	systemd_units_load(units, targets, target_count, found);
+	free(found);
+	free(targets);
 
-	vars.dbus_conn = dbus_conn;
-	vars.ctx = ctx;
-	vars.unit_entity = unit_entity;
+	for (size_t i = 0; i < matching_count; ++i) {
+		SEXP_t *se_unit = SEXP_string_new(matching[i], strlen(matching[i]));
+		SEXP_t *item = probe_item_create(OVAL_LINUX_SYSTEMDUNITDEPENDENCY, NULL,
+						 "unit", OVAL_DATATYPE_SEXP, se_unit,
+						 NULL);
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+		struct oscap_htable *visited_units = oscap_htable_new();
+		get_all_dependencies_by_unit(units, matching[i], item, visited_units);
+		oscap_htable_free(visited_units, NULL);
 
+		probe_item_collect(ctx, item);
+		SEXP_free(se_unit);
+	}
+
+	free(matching);
 	SEXP_free(unit_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
 
-        return 0;
+	return 0;
 }
@@ -25,6 +25,8 @@
 
 #include "probe-api.h"
 
+void *systemdunitdependency_probe_init(void);
 int systemdunitdependency_probe_main(probe_ctx *ctx, void *arg);
+void systemdunitdependency_probe_fini(void *arg);
 
 #endif /* OPENSCAP_SYSTEMDUNITDEPENDENCY_PROBE_H */
@@ -36,226 +36,69 @@
 #include "systemdshared.h"
 #include "systemdunitproperty_probe.h"
 
-static int get_all_properties_by_unit_path(DBusConnection *conn, const char *unit_path, int(*callback)(const char *name, const char *value, void *arg), void *cbarg)
+/*
+ * Collect an item for each property of the unit which matches the object,
+ * each element of an array property is one value of the item.
+ */
+static void collect_unit_properties(probe_ctx *ctx, const struct systemd_unit *unit, SEXP_t *property_entity)
 {
-	int ret = 1;
-	DBusMessage *msg = NULL;
-	DBusPendingCall *pending = NULL;
-
-	msg = dbus_message_new_method_call(
-		"org.freedesktop.systemd1",
-		unit_path,
-		"org.freedesktop.DBus.Properties",
-		"GetAll"
-	);
-	if (msg == NULL) {
-		dD("Failed to create dbus_message via dbus_message_new_method_call!");
-		goto cleanup;
-	}
-
-	DBusMessageIter args, property_iter;
+	SEXP_t *se_unit = SEXP_string_new(unit->name, strlen(unit->name));
 
-	const char *interface = "org.freedesktop.systemd1.Unit";
+	for (size_t i = 0; i < unit->property_count; ++i) {
+		const struct systemd_unit_property *property = &unit->properties[i];
 
-	dbus_message_iter_init_append(msg, &args);
-	if (!dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &interface)) {
-		dD("Failed to append interface '%s' string parameter to dbus message!", interface);
-		goto cleanup;
-	}
-
-	if (!dbus_connection_send_with_reply(conn, msg, &pending, -1)) {
-		dD("Failed to send message via dbus!");
-		goto cleanup;
-	}
-	if (pending == NULL) {
-		dD("Invalid dbus pending call!");
-		goto cleanup;
-	}
+		if (property->value_count == 0)
+			continue;
 
-	dbus_connection_flush(conn);
-	dbus_message_unref(msg); msg = NULL;
+		SEXP_t *se_property = SEXP_string_new(property->name, strlen(property->name));
 
-	dbus_pending_call_block(pending);
-	msg = dbus_pending_call_steal_reply(pending);
-	if (msg == NULL) {
-		dD("Failed to steal dbus pending call reply.");
-		goto cleanup;
-	}
-	dbus_pending_call_unref(pending); pending = NULL;
-
-	if (!dbus_message_iter_init(msg, &args)) {
-		dD("Failed to initialize iterator over received dbus message.");
-		goto cleanup;
-	}
-
-	if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY && dbus_message_iter_get_element_type(&args) != DBUS_TYPE_DICT_ENTRY) {
-		dD("Expected array of dict_entry argument in reply. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&args)));
-		goto cleanup;
-	}
-
-	dbus_message_iter_recurse(&args, &property_iter);
-	do {
-		DBusMessageIter dict_entry, value_variant;
-		dbus_message_iter_recurse(&property_iter, &dict_entry);
-
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_STRING) {
-			dD("Expected string as key in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			goto cleanup;
+		if (probe_entobj_cmp(property_entity, se_property) != OVAL_RESULT_TRUE) {
+			SEXP_free(se_property);
+			continue;
 		}
 
-		_DBusBasicValue value;
-		dbus_message_iter_get_basic(&dict_entry, &value);
-		char *property_name = oscap_strdup(value.str);
-
-		if (dbus_message_iter_next(&dict_entry) == false) {
-			dW("Expected another field in dict_entry.");
-			free(property_name);
-			goto cleanup;
-		}
-
-		if (dbus_message_iter_get_arg_type(&dict_entry) != DBUS_TYPE_VARIANT) {
-			dD("Expected variant as value in dict_entry. Instead received: %s.", dbus_message_type_to_string(dbus_message_iter_get_arg_type(&dict_entry)));
-			free(property_name);
-			goto cleanup;
-		}
-
-		dbus_message_iter_recurse(&dict_entry, &value_variant);
-
-		int cbret = 0;
-		const int arg_type = dbus_message_iter_get_arg_type(&value_variant);
-		// DBUS_TYPE_ARRAY is a special case, we report each element as one value entry
-		if (arg_type == DBUS_TYPE_ARRAY) {
-			DBusMessageIter array;
-			dbus_message_iter_recurse(&value_variant, &array);
-
-			do {
-				char *element = dbus_value_to_string(&array);
-				if (element == NULL)
-					continue;
-
-				const int elementcbret = callback(property_name, element, cbarg);
-				if (elementcbret > cbret)
-					cbret = elementcbret;
-
-				free(element);
-			}
-			while (dbus_message_iter_next(&array));
-		}
-		else {
-			char *property_value = dbus_value_to_string(&value_variant);
-			cbret = callback(property_name, property_value, cbarg);
-			free(property_value);
-		}
-
-		free(property_name);
-		if (cbret != 0) {
-			goto cleanup;
-		}
-	}
-	while (dbus_message_iter_next(&property_iter));
-
-	dbus_message_unref(msg); msg = NULL;
-	ret = 0;
-
-cleanup:
-	if (pending != NULL)
-		dbus_pending_call_unref(pending);
-
-	if (msg != NULL)
-		dbus_message_unref(msg);
+		SEXP_t *item = probe_item_create(OVAL_LINUX_SYSTEMDUNITPROPERTY, NULL,
+						 "unit", OVAL_DATATYPE_SEXP, se_unit,
+						 "property", OVAL_DATATYPE_SEXP, se_property,
+						 "value", OVAL_DATATYPE_STRING, property->values[0],
+						 NULL);
 
-	return ret;
-}
-
-struct unit_callback_vars {
-	DBusConnection *dbus_conn;
-	probe_ctx *ctx;
-	SEXP_t *unit_entity;
-	SEXP_t *property_entity;
-	SEXP_t *se_unit;
-	SEXP_t *se_property;
-	SEXP_t *item;
-};
-
-static int property_callback(const char *property, const char *value, void *cbarg)
-{
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-
-	if (vars->se_property != NULL) {
-		//
-		// Compare the previously matched entity to the current one
-		// If they are the same, continue to fill the current item
-		// with property values. If not, collect the item and create
-		// a new one for the current property.
-		//
-		if (SEXP_strcmp(vars->se_property, property) == 0) {
-			SEXP_t *se_value = SEXP_string_new(value, strlen(value));
-			probe_item_ent_add(vars->item, "value", NULL, se_value);
+		for (size_t j = 1; j < property->value_count; ++j) {
+			SEXP_t *se_value = SEXP_string_new(property->values[j], strlen(property->values[j]));
+			probe_item_ent_add(item, "value", NULL, se_value);
 			SEXP_free(se_value);
-			return 0;
-		} else {
-			probe_item_collect(vars->ctx, vars->item);
-			vars->item = NULL;
-			SEXP_free(vars->se_property);
-			vars->se_property = NULL;
 		}
-	}
 
-	SEXP_t *se_property = SEXP_string_new(property, strlen(property));
-
-	if (probe_entobj_cmp(vars->property_entity, se_property) != OVAL_RESULT_TRUE) {
+		probe_item_collect(ctx, item);
 		SEXP_free(se_property);
-		return 0;
 	}
 
-	vars->se_property = se_property;
-	vars->item = probe_item_create(OVAL_LINUX_SYSTEMDUNITPROPERTY, NULL,
-				       "unit", OVAL_DATATYPE_SEXP, vars->se_unit,
-				       "property", OVAL_DATATYPE_SEXP, vars->se_property,
-				       "value", OVAL_DATATYPE_STRING, value,
-				       NULL);
-	return 0;
+	SEXP_free(se_unit);
 }
 
-static int unit_callback(const char *unit, void *cbarg)
+/* The units and their properties are cached for the whole scan, they are
+ * shared with the systemdunitdependency probe. */
+void *systemdunitproperty_probe_init(void)
 {
-	struct unit_callback_vars *vars = (struct unit_callback_vars *)cbarg;
-	SEXP_t *se_unit = SEXP_string_new(unit, strlen(unit));
-
-	if (probe_entobj_cmp(vars->unit_entity, se_unit) != OVAL_RESULT_TRUE) {
-		/* Do nothing, continue with the next unit */
-		SEXP_free(se_unit);
-		return 0;
-	}
-
-	vars->se_unit = se_unit;
-	vars->se_property = NULL;
-	vars->item = NULL;
-
-	char *unit_path = get_path_by_unit(vars->dbus_conn, unit);
-
-	if (unit_path == NULL) {
-		return 1;
-	}
-
-	get_all_properties_by_unit_path(vars->dbus_conn, unit_path,
-					property_callback, vars);
-
-	if (vars->item != NULL) {
-		probe_item_collect(vars->ctx, vars->item);
-		vars->item = NULL;
-		SEXP_free(vars->se_property);
-		vars->se_property = NULL;
-	}
+	return systemd_units_acquire();
+}
 
-	SEXP_free(se_unit);
-	return 0;
+void systemdunitproperty_probe_fini(void *probe_arg)
+{
+	systemd_units_release(probe_arg);
 }
 
 int systemdunitproperty_probe_main(probe_ctx *ctx, void *probe_arg)
 {
 	SEXP_t *unit_entity, *probe_in, *property_entity;
 	oval_schema_version_t oval_version;
+	struct systemd_units *units = probe_arg;
+	const char **names, **matching;
+	const struct systemd_unit **found;
+	size_t count, matching_count = 0;
+
+	if (units == NULL)
+		return PROBE_ENOMEM;
 
 	probe_in = probe_ctx_getobject(ctx);
 	oval_version = probe_obj_get_platform_schema_version(probe_in);
@@ -265,14 +108,8 @@ int systemdunitproperty_probe_main(probe_ctx *ctx, void *probe_arg)
 		return PROBE_EOPNOTSUPP;
 	}
 
-	DBusError dbus_error;
-	DBusConnection *dbus_conn;
-
-	dbus_error_init(&dbus_error);
-	dbus_conn = connect_dbus();
-
-	if (dbus_conn == NULL) {
-		dbus_error_free(&dbus_error);
+	names = systemd_units_list(units, &count);
+	if (names == NULL) {
 		SEXP_t *msg = probe_msg_creat(OVAL_MESSAGE_LEVEL_INFO, "DBus connection failed, could not identify systemd units.");
 		probe_cobj_set_flag(probe_ctx_getresult(ctx), SYSCHAR_FLAG_ERROR);
 		probe_cobj_add_msg(probe_ctx_getresult(ctx), msg);
@@ -283,19 +120,28 @@ int systemdunitproperty_probe_main(probe_ctx *ctx, void *probe_arg)
 	unit_entity = probe_obj_getent(probe_in, "unit", 1);
 	property_entity = probe_obj_getent(probe_in, "property", 1);
 
-	struct unit_callback_vars vars;
+	matching = malloc(count * sizeof(char *));
+	for (size_t i = 0; i < count; ++i) {
+		SEXP_t *se_unit = SEXP_string_new(names[i], strlen(names[i]));
 
-	vars.dbus_conn = dbus_conn;
-	vars.ctx = ctx;
-	vars.unit_entity = unit_entity;
-	vars.property_entity = property_entity;
+		if (probe_entobj_cmp(unit_entity, se_unit) == OVAL_RESULT_TRUE)
+			matching[matching_count++] = names[i];
+		SEXP_free(se_unit);
+	}
 
-	get_all_systemd_units(dbus_conn, unit_callback, &vars);
+	found = malloc(matching_count * sizeof(struct systemd_unit *));
+	if (systemd_units_load(units, matching, matching_count, found) == 0) {
+		for (size_t i = 0; i < matching_count; ++i) {
+			if (found[i]->path == NULL)
+				continue;
+			collect_unit_properties(ctx, found[i], property_entity);
+		}
+	}
 
+	free(found);
+	free(matching);
 	SEXP_free(unit_entity);
 	SEXP_free(property_entity);
-	dbus_error_free(&dbus_error);
-	disconnect_dbus(dbus_conn);
 
 	return 0;
 }
@@ -0,0 +1,548 @@
+/**
+ * @file   proc-snapshot.c
+ * @brief  snapshot of the running processes shared by the process probes
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#if defined(OS_LINUX)
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <errno.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "common/debug_priv.h"
+#include "common/oscap_buffer.h"
+#include "proc-snapshot.h"
+
+#define CHUNK_SIZE 1024
+
+/* processes are read in parallel only if there is enough of them */
+#define PROC_SNAPSHOT_PARALLEL_MIN 256
+#define PROC_SNAPSHOT_MAX_THREADS  4
+#define PROC_SNAPSHOT_BATCH        32
+
+struct proc_socket {
+	unsigned long inode;
+	size_t order;                       /**< order in which the socket was found */
+	const struct proc_process *process;
+};
+
+struct proc_snapshot {
+	int refs;
+	pthread_mutex_t lock;
+	int parts;                          /**< PROC_SNAPSHOT_* parts read so far */
+	bool read;                          /**< the processes have been read */
+	bool sockets_denied;
+	struct proc_process *processes;
+	size_t count;
+	struct proc_socket *sockets;        /**< sorted by inode */
+	size_t socket_count;
+};
+
+/* snapshot of the current scan, see proc_snapshot_acquire() */
+static pthread_mutex_t proc_snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct proc_snapshot *proc_snapshot_current = NULL;
+
+/* one pass over all the processes done by a pool of threads */
+struct proc_snapshot_pass {
+	struct proc_snapshot *snapshot;
+	void (*read_fn)(struct proc_snapshot_pass *pass, struct proc_process *process);
+	pthread_mutex_t lock;
+	size_t next;
+};
+
+static void *proc_snapshot_worker(void *arg)
+{
+	struct proc_snapshot_pass *pass = arg;
+	struct proc_snapshot *snapshot = pass->snapshot;
+
+	for (;;) {
+		size_t first, last;
+
+		pthread_mutex_lock(&pass->lock);
+		first = pass->next;
+		pass->next = first + PROC_SNAPSHOT_BATCH < snapshot->count ?
+			first + PROC_SNAPSHOT_BATCH : snapshot->count;
+		last = pass->next;
+		pthread_mutex_unlock(&pass->lock);
+
+		if (first == last)
+			return NULL;
+
+		for (size_t i = first; i < last; ++i)
+			pass->read_fn(pass, &snapshot->processes[i]);
+	}
+}
+
+static void proc_snapshot_run(struct proc_snapshot *snapshot,
+		void (*read_fn)(struct proc_snapshot_pass *, struct proc_process *))
+{
+	struct proc_snapshot_pass pass = {
+		.snapshot = snapshot,
+		.read_fn = read_fn,
+		.next = 0,
+	};
+	pthread_t threads[PROC_SNAPSHOT_MAX_THREADS];
+	int threads_count = 0, threads_max = 1;
+
+	if (snapshot->count >= PROC_SNAPSHOT_PARALLEL_MIN) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads_max = cpus > PROC_SNAPSHOT_MAX_THREADS ? PROC_SNAPSHOT_MAX_THREADS : (int) cpus;
+	}
+
+	pthread_mutex_init(&pass.lock, NULL);
+	/* the calling thread is one of the workers */
+	while (threads_count < threads_max - 1) {
+		if (pthread_create(&threads[threads_count], NULL, proc_snapshot_worker, &pass) != 0)
+			break;
+		++threads_count;
+	}
+	proc_snapshot_worker(&pass);
+	for (int i = 0; i < threads_count; ++i)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&pass.lock);
+}
+
+/* returns false if the process is gone or if it's a kernel thread */
+static bool proc_process_read_stat(struct proc_process *process)
+{
+	char buf[256], *tmp;
+	int fd, len, ppid;
+
+	snprintf(buf, 32, "/proc/%d/stat", process->pid);
+	fd = open(buf, O_RDONLY, 0);
+	if (fd < 0)
+		return false;
+	len = read(fd, buf, sizeof buf - 1);
+	close(fd);
+	if (len < 40)
+		return false;
+	buf[len] = 0;
+	tmp = strrchr(buf, ')');
+	if (tmp)
+		*tmp = 0;
+	else
+		return false;
+
+	unsigned flags;
+	unsigned long minflt, cminflt, majflt, cmajflt;
+	long cutime, cstime, cnice, nthreads, itrealvalue;
+	int pgrp, tpgid;
+
+	memset(process->comm, 0, sizeof(process->comm));
+	sscanf(buf, "%d (%15c", &ppid, process->comm);
+	sscanf(tmp+2,	"%c %d %d %d %d %d "
+			"%u %lu %lu %lu %lu "
+			"%lu %lu %lu %ld %ld "
+			"%ld %ld %ld %llu",
+		&process->state, &process->ppid, &pgrp, &process->session, &process->tty_nr, &tpgid,
+		&flags, &minflt, &cminflt, &majflt, &cmajflt,
+		&process->utime, &process->stime, &cutime, &cstime, &process->priority,
+		&cnice, &nthreads, &itrealvalue, &process->start
+	);
+
+	// Skip kthreads
+	return process->pid != 2 && process->ppid != 2;
+}
+
+static void proc_process_read_uids(struct proc_process *process)
+{
+	char buf[100];
+	FILE *sf;
+
+	process->ruid = -1;
+	process->euid = -1;
+	process->loginuid = -1;
+
+	snprintf(buf, sizeof(buf), "/proc/%d/status", process->pid);
+	sf = fopen(buf, "rt");
+	if (sf) {
+		int line = 0;
+		__fsetlocking(sf, FSETLOCKING_BYCALLER);
+		while (fgets(buf, sizeof(buf), sf)) {
+			if (line == 0) {
+				line++;
+				continue;
+			}
+			if (memcmp(buf, "Uid:", 4) == 0) {
+				sscanf(buf, "Uid: %d %d", &process->ruid, &process->euid);
+				break;
+			}
+		}
+		fclose(sf);
+	}
+
+	snprintf(buf, sizeof(buf), "/proc/%d/loginuid", process->pid);
+	sf = fopen(buf, "rt");
+	if (sf) {
+		if (fscanf(sf, "%u", &process->loginuid) < 1) {
+			dW("fscanf failed from %s", buf);
+		}
+		fclose(sf);
+	}
+}
+
+static void proc_snapshot_read_process(struct proc_snapshot_pass *pass, struct proc_process *process)
+{
+	if (!proc_process_read_stat(process)) {
+		/* dropped when the snapshot is compacted */
+		process->pid = 0;
+		return;
+	}
+	proc_process_read_uids(process);
+}
+
+/*
+ * Parse /proc/%d/cmdline file, program and arguments are separated by
+ * spaces and non-printable characters are replaced with '.' like "ps" does.
+ */
+static void proc_snapshot_read_cmdline(struct proc_snapshot_pass *pass, struct proc_process *process)
+{
+	char path[32];
+	int fd;
+
+	if (process->state == 'Z')
+		return;
+
+	snprintf(path, sizeof(path), "/proc/%d/cmdline", process->pid);
+	fd = open(path, O_RDONLY, 0);
+	if (fd < 0)
+		return;
+
+	struct oscap_buffer *buffer = oscap_buffer_new();
+	for (;;) {
+		char chunk[CHUNK_SIZE];
+		// Read data, store to buffer
+		ssize_t read_size = read(fd, chunk, CHUNK_SIZE);
+		if (read_size < 0) {
+			close(fd);
+			oscap_buffer_free(buffer);
+			return;
+		}
+		oscap_buffer_append_binary_data(buffer, chunk, read_size);
+
+		// If reach end of file, then end the loop
+		if (CHUNK_SIZE != read_size) {
+			break;
+		}
+	}
+	close(fd);
+
+	int length = oscap_buffer_get_length(buffer);
+	char *buffer_mem = oscap_buffer_get_raw(buffer);
+
+	if (length > 0) {
+		// Skip multiple trailing zeros
+		int i = length - 1;
+		while ( (i > 0) && (buffer_mem[i] == '\0') ) {
+			--i;
+		}
+
+		// Program and args are separated by '\0'
+		// Replace them with spaces ' '
+		while( i >= 0 ){
+			char chr = buffer_mem[i];
+			if ( ( chr == '\0') || ( chr == '\n' ) ) {
+				buffer_mem[i] = ' ';
+			} else if ( !isprint(chr) ) {
+				buffer_mem[i] = '.';
+			}
+			--i;
+		}
+		process->cmdline = oscap_buffer_bequeath(buffer);
+	} else {
+		oscap_buffer_free(buffer);
+	}
+}
+
+static void proc_snapshot_read_sockets(struct proc_snapshot_pass *pass, struct proc_process *process)
+{
+	char buf[32];
+	struct dirent *ent;
+	DIR *f;
+	size_t size = 0;
+
+	// Now lets get the inodes each process has open
+	snprintf(buf, sizeof(buf), "/proc/%d/fd", process->pid);
+	f = opendir(buf);
+	if (f == NULL) {
+		if (errno == EACCES) {
+			/* Need DAC_OVERRIDE permission */
+			pthread_mutex_lock(&pass->lock);
+			pass->snapshot->sockets_denied = true;
+			pthread_mutex_unlock(&pass->lock);
+		}
+		// Process might have ended or something - ignore it
+		return;
+	}
+	// For each file in the fd dir...
+	while (( ent = readdir(f) )) {
+		char line[PATH_MAX], ln[PATH_MAX], *s, *e;
+		unsigned long inode;
+		int lnlen;
+
+		if (ent->d_name[0] == '.')
+			continue;
+		snprintf(ln, PATH_MAX, "%s/%s", buf, ent->d_name);
+		if ((lnlen = readlink(ln, line, sizeof(line)-1)) < 0)
+			continue;
+		line[lnlen] = 0;
+
+		// Only look at the socket entries
+		if (memcmp(line, "socket:", 7) == 0) {
+			// Type 1 sockets
+			s = strchr(line+7, '[');
+			if (s == NULL)
+				continue;
+			s++;
+			e = strchr(s, ']');
+			if (e == NULL)
+				continue;
+			*e = 0;
+		} else if (memcmp(line, "[0000]:", 7) == 0) {
+			// Type 2 sockets
+			s = line + 8;
+		} else
+			continue;
+		errno = 0;
+		inode = strtoul(s, NULL, 10);
+		if (errno)
+			continue;
+
+		if (process->socket_count == size) {
+			size = size ? 2 * size : 8;
+			unsigned long *sockets = realloc(process->sockets, size * sizeof(unsigned long));
+			if (sockets == NULL)
+				break;
+			process->sockets = sockets;
+		}
+		process->sockets[process->socket_count++] = inode;
+	}
+	closedir(f);
+}
+
+static int proc_socket_cmp(const void *a, const void *b)
+{
+	const struct proc_socket *socket_a = a, *socket_b = b;
+
+	if (socket_a->inode != socket_b->inode)
+		return socket_a->inode < socket_b->inode ? -1 : 1;
+	if (socket_a->order != socket_b->order)
+		return socket_a->order < socket_b->order ? -1 : 1;
+	return 0;
+}
+
+static int proc_snapshot_read(struct proc_snapshot *snapshot)
+{
+	struct dirent *ent;
+	size_t size = 0, i, j;
+	DIR *d;
+
+	d = opendir("/proc");
+	if (d == NULL)
+		return -1;
+
+	// Scan the directories
+	while (( ent = readdir(d) )) {
+		pid_t pid;
+
+		// Skip non-process dir entries
+		if(*ent->d_name<'0' || *ent->d_name>'9')
+			continue;
+		errno = 0;
+		pid = strtol(ent->d_name, NULL, 10);
+		if (errno || pid == 2) // skip err & kthreads
+			continue;
+
+		if (snapshot->count == size) {
+			size = size ? 2 * size : 512;
+			struct proc_process *processes = realloc(snapshot->processes, size * sizeof(struct proc_process));
+			if (processes == NULL) {
+				closedir(d);
+				return -1;
+			}
+			snapshot->processes = processes;
+		}
+		memset(&snapshot->processes[snapshot->count], 0, sizeof(struct proc_process));
+		snapshot->processes[snapshot->count++].pid = pid;
+	}
+	closedir(d);
+
+	proc_snapshot_run(snapshot, proc_snapshot_read_process);
+
+	/* drop processes which ended in the meantime and kernel threads */
+	for (i = 0, j = 0; i < snapshot->count; ++i) {
+		if (snapshot->processes[i].pid != 0)
+			snapshot->processes[j++] = snapshot->processes[i];
+	}
+	snapshot->count = j;
+	dI("Process snapshot has %zu processes.", snapshot->count);
+
+	return snapshot->count > 0 ? 0 : -1;
+}
+
+static int proc_snapshot_index_sockets(struct proc_snapshot *snapshot)
+{
+	size_t count = 0, i, j;
+
+	proc_snapshot_run(snapshot, proc_snapshot_read_sockets);
+
+	for (i = 0; i < snapshot->count; ++i)
+		count += snapshot->processes[i].socket_count;
+
+	if (count == 0)
+		return 0;
+
+	snapshot->sockets = malloc(count * sizeof(struct proc_socket));
+	if (snapshot->sockets == NULL)
+		return -1;
+
+	for (i = 0; i < snapshot->count; ++i) {
+		const struct proc_process *process = &snapshot->processes[i];
+		for (j = 0; j < process->socket_count; ++j) {
+			struct proc_socket *socket = &snapshot->sockets[snapshot->socket_count];
+			socket->inode = process->sockets[j];
+			socket->order = snapshot->socket_count++;
+			socket->process = process;
+		}
+	}
+	qsort(snapshot->sockets, snapshot->socket_count, sizeof(struct proc_socket), proc_socket_cmp);
+
+	return 0;
+}
+
+static void proc_snapshot_free(struct proc_snapshot *snapshot)
+{
+	for (size_t i = 0; i < snapshot->count; ++i) {
+		free(snapshot->processes[i].cmdline);
+		free(snapshot->processes[i].sockets);
+	}
+	free(snapshot->processes);
+	free(snapshot->sockets);
+	pthread_mutex_destroy(&snapshot->lock);
+	free(snapshot);
+}
+
+struct proc_snapshot *proc_snapshot_acquire(void)
+{
+	struct proc_snapshot *snapshot;
+
+	pthread_mutex_lock(&proc_snapshot_lock);
+	snapshot = proc_snapshot_current;
+	if (snapshot == NULL) {
+		/* nothing is read until a probe asks for the processes */
+		snapshot = calloc(1, sizeof(struct proc_snapshot));
+		if (snapshot == NULL) {
+			pthread_mutex_unlock(&proc_snapshot_lock);
+			dE("Failed to allocate the snapshot of processes.");
+			return NULL;
+		}
+		pthread_mutex_init(&snapshot->lock, NULL);
+		proc_snapshot_current = snapshot;
+	}
+	++snapshot->refs;
+	pthread_mutex_unlock(&proc_snapshot_lock);
+
+	return snapshot;
+}
+
+void proc_snapshot_release(struct proc_snapshot *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	pthread_mutex_lock(&proc_snapshot_lock);
+	if (--snapshot->refs == 0) {
+		if (proc_snapshot_current == snapshot)
+			proc_snapshot_current = NULL;
+		proc_snapshot_free(snapshot);
+	}
+	pthread_mutex_unlock(&proc_snapshot_lock);
+}
+
+const struct proc_process *proc_snapshot_get_processes(struct proc_snapshot *snapshot, int parts, size_t *count)
+{
+	const struct proc_process *processes = NULL;
+
+	pthread_mutex_lock(&snapshot->lock);
+
+	if (!snapshot->read) {
+		snapshot->read = true;
+		if (proc_snapshot_read(snapshot) != 0)
+			snapshot->count = 0;
+	}
+	if (snapshot->count == 0)
+		goto out;
+
+	if ((parts & PROC_SNAPSHOT_CMDLINE) && !(snapshot->parts & PROC_SNAPSHOT_CMDLINE)) {
+		proc_snapshot_run(snapshot, proc_snapshot_read_cmdline);
+		snapshot->parts |= PROC_SNAPSHOT_CMDLINE;
+	}
+	if ((parts & PROC_SNAPSHOT_SOCKETS) && !(snapshot->parts & PROC_SNAPSHOT_SOCKETS)) {
+		if (proc_snapshot_index_sockets(snapshot) != 0)
+			goto out;
+		snapshot->parts |= PROC_SNAPSHOT_SOCKETS;
+	}
+
+	processes = snapshot->processes;
+out:
+	*count = processes != NULL ? snapshot->count : 0;
+	pthread_mutex_unlock(&snapshot->lock);
+	return processes;
+}
+
+const struct proc_process *proc_snapshot_find_socket(struct proc_snapshot *snapshot, unsigned long inode)
+{
+	size_t first = 0, last = snapshot->socket_count;
+
+	/* the first socket of the inode */
+	while (first < last) {
+		size_t middle = first + (last - first) / 2;
+		if (snapshot->sockets[middle].inode < inode)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	if (first < snapshot->socket_count && snapshot->sockets[first].inode == inode)
+		return snapshot->sockets[first].process;
+	return NULL;
+}
+
+bool proc_snapshot_sockets_denied(struct proc_snapshot *snapshot)
+{
+	return snapshot->sockets_denied;
+}
+
+#endif /* OS_LINUX */
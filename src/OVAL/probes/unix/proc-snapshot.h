@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+#ifndef OPENSCAP_PROC_SNAPSHOT_H
+#define OPENSCAP_PROC_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * Snapshot of the running processes read from /proc. The probes which
+ * look at processes (process58, inetlisteningservers, iflisteners) share
+ * one snapshot during a scan instead of walking /proc for each object.
+ * Kernel threads are not part of the snapshot.
+ */
+struct proc_snapshot;
+
+/* parts of the snapshot which are read only when a probe needs them */
+#define PROC_SNAPSHOT_CMDLINE 0x01 /**< command lines of the processes */
+#define PROC_SNAPSHOT_SOCKETS 0x02 /**< socket inodes open by the processes */
+
+struct proc_process {
+	pid_t pid;
+	pid_t ppid;
+	char state;
+	char comm[16];       /**< command name from /proc/<pid>/stat */
+	int session;
+	int tty_nr;
+	long priority;
+	unsigned long utime;
+	unsigned long stime;
+	unsigned long long start;
+	int ruid;            /**< -1 if unknown */
+	int euid;            /**< -1 if unknown */
+	unsigned loginuid;   /**< -1 if unknown */
+	char *cmdline;       /**< ps-like command line, NULL if it's empty or can't be read */
+	unsigned long *sockets;
+	size_t socket_count;
+};
+
+/**
+ * Get the snapshot of the current scan. The snapshot is shared by all the
+ * callers until the last of them releases it, a snapshot is made on the
+ * next call after that.
+ * @returns NULL if the snapshot can't be allocated
+ */
+struct proc_snapshot *proc_snapshot_acquire(void);
+
+void proc_snapshot_release(struct proc_snapshot *snapshot);
+
+/**
+ * Get the processes of the snapshot in the order they were listed in /proc.
+ * @param parts the PROC_SNAPSHOT_* parts which the caller is going to use
+ * @param count set to the number of processes
+ * @return NULL if /proc can't be read or no process could be read
+ */
+const struct proc_process *proc_snapshot_get_processes(struct proc_snapshot *snapshot, int parts, size_t *count);
+
+/**
+ * Find the first process which has the socket of the given inode open.
+ * The PROC_SNAPSHOT_SOCKETS part has to be requested before.
+ */
+const struct proc_process *proc_snapshot_find_socket(struct proc_snapshot *snapshot, unsigned long inode);
+
+/**
+ * Whether the open files of some process could not be listed because of
+ * missing permissions, the sockets of such processes are not known.
+ */
+bool proc_snapshot_sockets_denied(struct proc_snapshot *snapshot);
+
+#endif /* OPENSCAP_PROC_SNAPSHOT_H */
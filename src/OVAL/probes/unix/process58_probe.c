@@ -100,12 +100,10 @@ extern char const *_cap_names[];
 #include "probe/entcmp.h"
 #include "common/debug_priv.h"
 #include <ctype.h>
-#include "common/oscap_buffer.h"
 #include "process58_probe.h"
+#include "proc-snapshot.h"
 #include "oscap_helpers.h"
 
-#define CHUNK_SIZE 1024
-
 /* Convenience structure for the results being reported */
 struct result_info {
         const char *command_line;
@@ -180,45 +178,6 @@ static void get_boot_time(void)
 	fclose(sf);
 }
 
-static int get_uids(int pid, struct result_info *r)
-{
-	char buf[100];
-	FILE *sf;
-
-	r->ruid = -1;
-	r->user_id = -1;
-	r->loginuid = -1;
-
-	snprintf(buf, sizeof(buf), "/proc/%d/status", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		int line = 0;
-		__fsetlocking(sf, FSETLOCKING_BYCALLER);
-		while (fgets(buf, sizeof(buf), sf)) {
-			if (line == 0) {
-				line++;
-				continue;
-			}
-			if (memcmp(buf, "Uid:", 4) == 0) {
-				sscanf(buf, "Uid: %d %d", &r->ruid, &r->user_id);
-				break;
-			}
-		}
-		fclose(sf);
-	}
-
-	snprintf(buf, sizeof(buf), "/proc/%d/loginuid", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		if (fscanf(sf, "%u", &r->loginuid) < 1) {
-			dW("fscanf failed from %s", buf);
-		}
-		fclose(sf);
-	}
-
-	return 0;
-}
-
 static char *convert_time(unsigned long long t, char *tbuf, int tb_size)
 {
 	unsigned d,h,m,s;
@@ -369,93 +328,16 @@ static int get_exec_shield_status(int pid) {
 	return ret;
 }
 
-/**
- * Parse /proc/%d/cmdline file
- * @param filepath Path to file ~ use preallocated buffer for the path
- * @param buffer output buffer with non-zero size
- * @return ps-like command info or NULL
- */
-static inline bool get_process_cmdline(const char* filepath, struct oscap_buffer* const buffer){
-
-	int fd = open(filepath, O_RDONLY, 0);
-
-	if (fd < 0) {
-		return false;
-	}
-
-	oscap_buffer_clear(buffer);
-
-
-
-	for(;;) {
-		char chunk[CHUNK_SIZE];
-		// Read data, store to buffer
-		ssize_t read_size = read(fd, chunk, CHUNK_SIZE);
-		if (read_size < 0) {
-			close(fd);
-			return false;
-		}
-		oscap_buffer_append_binary_data(buffer, chunk, read_size);
-
-		// If reach end of file, then end the loop
-		if (CHUNK_SIZE != read_size) {
-			break;
-		}
-	}
-
-	close(fd);
-
-	int length = oscap_buffer_get_length(buffer);
-	char* buffer_mem = oscap_buffer_get_raw(buffer);
-
-	if ( length == 0 ) { // empty file
-		return false;
-	} else {
-
-		// Skip multiple trailing zeros
-		int i = length - 1;
-		while ( (i > 0) && (buffer_mem[i] == '\0') ) {
-			--i;
-		}
-
-		// Program and args are separated by '\0'
-		// Replace them with spaces ' '
-		while( i >= 0 ){
-			char chr = buffer_mem[i];
-			if ( ( chr == '\0') || ( chr == '\n' ) ) {
-				buffer_mem[i] = ' ';
-			} else if ( !isprint(chr) ) { // "ps" replace non-printable characters with '.' (LC_ALL=C)
-				buffer_mem[i] = '.';
-			}
-			--i;
-		}
-	}
-	return true;
-}
-
-/**
- * Make "[%s] <defunct>" from cmd string - inplace
- * @param cmd_buffer @see read_process() > cmd_buffer
- * @return pointer to start of string
- */
-static inline char *make_defunc_str(char* const cmd_buffer){
-	static const char DEFUNC_STR[] = "] <defunct>";
-
-	size_t len = strlen(cmd_buffer);
-	memcpy(cmd_buffer + len, DEFUNC_STR, sizeof(DEFUNC_STR));
-	return cmd_buffer;
-}
-
-static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
+static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx, struct proc_snapshot *snapshot)
 {
-	int err = 1, max_cap_id;
-	DIR *d;
-	struct dirent *ent;
+	int max_cap_id;
+	const struct proc_process *processes;
+	size_t count, i;
 	oval_schema_version_t oval_version;
 
-	d = opendir("/proc");
-	if (d == NULL)
-		return err;
+	processes = proc_snapshot_get_processes(snapshot, PROC_SNAPSHOT_CMDLINE, &count);
+	if (processes == NULL)
+		return 1;
 
 	// Get the time tick hertz
 	ticks = (unsigned long)sysconf(_SC_CLK_TCK);
@@ -468,76 +350,25 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		max_cap_id = OVAL_5_11_MAX_CAP_ID;
 	}
 
-	struct oscap_buffer *cmdline_buffer = oscap_buffer_new();
-	
 	char cmd_buffer[1 + 15 + 11 + 1]; // Format:" [ cmd:15 ] <defunc>"
-	cmd_buffer[0] = '[';
 
-	// Scan the directories
-	while (( ent = readdir(d) )) {
-		int fd, len;
-		char buf[256];
-		char *tmp, state, tty_dev[128];
-		int pid, ppid, pgrp, session, tty_nr, tpgid;
-		unsigned flags, sched_policy;
-		unsigned long minflt, cminflt, majflt, cmajflt, uutime, ustime;
-		long cutime, cstime, priority, cnice, nthreads, itrealvalue;
-		unsigned long long start;
+	for (i = 0; i < count; ++i) {
+		const struct proc_process *process = &processes[i];
+		int pid = process->pid;
+		char tty_dev[128];
+		unsigned sched_policy;
 		SEXP_t *cmd_sexp = NULL, *pid_sexp = NULL;
 
-		// Skip non-process58 dir entries
-		if(*ent->d_name<'0' || *ent->d_name>'9')
-			continue;
-		errno = 0;
-		pid = strtol(ent->d_name, NULL, 10);
-		if (errno || pid == 2) // skip err & kthreads
-			continue;
-
-		// Parse up the stat file for the proc
-		snprintf(buf, 32, "/proc/%d/stat", pid);
-		fd = open(buf, O_RDONLY, 0);
-		if (fd < 0)
-			continue;
-		len = read(fd, buf, sizeof buf - 1);
-		close(fd);
-		if (len < 40)
-			continue;
-		buf[len] = 0;
-		tmp = strrchr(buf, ')');
-		if (tmp)
-			*tmp = 0;
-		else
-			continue;
-		memset(cmd_buffer + 1, 0, sizeof(cmd_buffer)-1); // clear cmd after starting '['
-		sscanf(buf, "%d (%15c", &ppid, cmd_buffer + 1);
-		sscanf(tmp+2,	"%c %d %d %d %d %d "
-				"%u %lu %lu %lu %lu "
-				"%lu %lu %lu %ld %ld "
-				"%ld %ld %ld %llu",
-			&state, &ppid, &pgrp, &session, &tty_nr, &tpgid,
-			&flags, &minflt, &cminflt, &majflt, &cmajflt,
-			&uutime, &ustime, &cutime, &cstime, &priority,
-			&cnice, &nthreads, &itrealvalue, &start
-		);
-
-		// Skip kthreads
-		if (ppid == 2)
-			continue;
-
 		const char* cmd;
-		if (state == 'Z') { // zombie
-			cmd = make_defunc_str(cmd_buffer);
+		if (process->state == 'Z') { // zombie
+			snprintf(cmd_buffer, sizeof(cmd_buffer), "[%s] <defunct>", process->comm);
+			cmd = cmd_buffer;
+		} else if (process->cmdline != NULL) {
+			cmd = process->cmdline; // use full cmdline
 		} else {
-			snprintf(buf, 32, "/proc/%d/cmdline", pid);
-			if (get_process_cmdline(buf, cmdline_buffer)) {
-				cmd = oscap_buffer_get_raw(cmdline_buffer); // use full cmdline
-			} else {
-				cmd = cmd_buffer + 1;
-			}
+			cmd = process->comm;
 		}
 
-
-		err = 0; // If we get this far, no permission problems
 		dI("Have command: %s", cmd);
 		cmd_sexp = SEXP_string_newf("%s", cmd);
 		pid_sexp = SEXP_number_newu_32(pid);
@@ -545,7 +376,7 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		    (pid_sexp == NULL || probe_entobj_cmp(pid_ent, pid_sexp) == OVAL_RESULT_TRUE)
 		) {
 			struct result_info r;
-			unsigned long t = uutime/ticks + ustime/ticks;
+			unsigned long t = process->utime/ticks + process->stime/ticks;
 			char tbuf[32], sbuf[32], *selinux_domain_label, **posix_capabilities;
 			int tday,tyear;
 			time_t s_time;
@@ -582,7 +413,7 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 			now = localtime(&s_time);
 			tyear = now->tm_year;
 			tday = now->tm_yday;
-			s_time = boot + (start / ticks);
+			s_time = boot + (process->start / ticks);
 			proc = localtime(&s_time);
 
 			// Select format based on how long we've been running
@@ -601,11 +432,11 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 			r.command_line = cmd;
 			r.exec_time = convert_time(t, tbuf, sizeof(tbuf));
 			r.pid = pid;
-			r.ppid = ppid;
-			r.priority = priority;
+			r.ppid = process->ppid;
+			r.priority = process->priority;
 			r.start_time = sbuf;
 
-			dev_to_tty(tty_dev, sizeof(tty_dev), (dev_t) tty_nr, pid, ABBREV_DEV);
+			dev_to_tty(tty_dev, sizeof(tty_dev), (dev_t) process->tty_nr, pid, ABBREV_DEV);
 			r.tty = tty_dev;
 
 			r.exec_shield = (get_exec_shield_status(pid) > 0);
@@ -616,9 +447,11 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 			posix_capabilities = get_posix_capability(pid, max_cap_id);
 			r.posix_capability = posix_capabilities;
 
-			r.session_id = session;
+			r.session_id = process->session;
 
-			get_uids(pid, &r);
+			r.ruid = process->ruid;
+			r.user_id = process->euid;
+			r.loginuid = process->loginuid;
 			report_finding(&r, ctx);
 
 			if (selinux_domain_label != NULL)
@@ -634,22 +467,33 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		SEXP_free(cmd_sexp);
 		SEXP_free(pid_sexp);
 	}
-        closedir(d);
-	oscap_buffer_free(cmdline_buffer);
-	return err;
+	return 0;
+}
+
+void *process58_probe_init(void)
+{
+	return proc_snapshot_acquire();
+}
+
+void process58_probe_fini(void *arg)
+{
+	proc_snapshot_release(arg);
 }
 
 int process58_probe_main(probe_ctx *ctx, void *arg)
 {
 	SEXP_t *command_line_ent, *pid_ent;
 
+	if (arg == NULL)
+		return PROBE_ENOMEM;
+
 	command_line_ent = probe_obj_getent(probe_ctx_getobject(ctx), "command_line", 1);
 	pid_ent = probe_obj_getent(probe_ctx_getobject(ctx), "pid", 1);
 	if (command_line_ent == NULL && pid_ent == NULL) {
 		return PROBE_ENOVAL;
 	}
 
-	if (read_process(command_line_ent, pid_ent, ctx)) {
+	if (read_process(command_line_ent, pid_ent, ctx, arg)) {
 		SEXP_free(command_line_ent);
 		SEXP_free(pid_ent);
 		return PROBE_EACCESS;
@@ -801,7 +645,25 @@ int process58_probe_main(probe_ctx *ctx, void *arg)
 	return 0;
 }
 
+void *process58_probe_init(void)
+{
+	return NULL;
+}
+
+void process58_probe_fini(void *arg)
+{
+}
+
 #else
+void *process58_probe_init(void)
+{
+	return NULL;
+}
+
+void process58_probe_fini(void *arg)
+{
+}
+
 int process58_probe_main(probe_ctx *ctx, void *arg)
 {
         SEXP_t *item_sexp;
@@ -25,6 +25,8 @@
 
 #include "probe-api.h"
 
+void *process58_probe_init(void);
 int process58_probe_main(probe_ctx *ctx, void *arg);
+void process58_probe_fini(void *arg);
 
 #endif /* OPENSCAP_PROCESS58_PROBE_H */
@@ -36,10 +36,16 @@
 #if defined(OS_LINUX)
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "oval_fts.h"
 #include "common/debug_priv.h"
 #include "sysctl_probe.h"
@@ -47,29 +53,74 @@
 #define PROC_SYS_DIR "/proc/sys"
 #define PROC_SYS_MAXDEPTH 7
 
-int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
+struct sysctl_key {
+	char *mib;   /**< dotted name of the sysctl */
+	char *path;  /**< path of the file in /proc/sys */
+};
+
+/*
+ * The names of the sysctls don't change during a scan, /proc/sys is walked
+ * only once for all the objects which can't be answered by opening a file
+ * of the exact name. The values are always read again.
+ */
+struct sysctl_global {
+	pthread_mutex_t lock;
+	int proc_sys_fd;
+	bool indexed;
+	struct sysctl_key *keys;
+	size_t key_count;
+};
+
+static struct sysctl_global g_sysctl = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.proc_sys_fd = -1,
+	.indexed = false,
+	.keys = NULL,
+	.key_count = 0,
+};
+
+void *sysctl_probe_init(void)
 {
-        OVAL_FTS    *ofts;
-        OVAL_FTSENT *ofts_ent;
+	g_sysctl.proc_sys_fd = open(PROC_SYS_DIR, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (g_sysctl.proc_sys_fd == -1)
+		dD("Can't open %s: %u, %s", PROC_SYS_DIR, errno, strerror(errno));
 
-        SEXP_t *name_entity, *probe_in;
-        SEXP_t *r0, *r1, *r2, *r3;
-        SEXP_t *ent_attrs, *bh_entity, *path_entity, *filename_entity;
-        oval_schema_version_t over;
-        int over_cmp;
+	return &g_sysctl;
+}
 
-	const char *ipv6_conf_path = "/proc/sys/net/ipv6/conf/";
-	size_t ipv6_conf_path_len = strlen(ipv6_conf_path);
+static void sysctl_index_clear(struct sysctl_global *g)
+{
+	for (size_t i = 0; i < g->key_count; ++i) {
+		free(g->keys[i].mib);
+		free(g->keys[i].path);
+	}
+	free(g->keys);
+	g->keys = NULL;
+	g->key_count = 0;
+	g->indexed = false;
+}
 
-        probe_in    = probe_ctx_getobject(ctx);
-        name_entity = probe_obj_getent(probe_in, "name", 1);
-        over        = probe_obj_get_platform_schema_version(probe_in);
-        over_cmp    = oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10));
+void sysctl_probe_fini(void *probe_arg)
+{
+	struct sysctl_global *g = probe_arg;
 
-        if (name_entity == NULL) {
-                dE("Missing \"name\" entity in the input object");
-                return (PROBE_ENOENT);
-        }
+	sysctl_index_clear(g);
+
+	if (g->proc_sys_fd != -1) {
+		close(g->proc_sys_fd);
+		g->proc_sys_fd = -1;
+	}
+}
+
+/*
+ * List all the readable sysctls, the caller holds g->lock.
+ */
+static int sysctl_index_build(struct sysctl_global *g, probe_ctx *ctx)
+{
+        OVAL_FTS    *ofts;
+        OVAL_FTSENT *ofts_ent;
+        SEXP_t *r0, *r1, *r2, *r3;
+        SEXP_t *ent_attrs, *bh_entity, *path_entity, *filename_entity;
 
         /*
          * prepare behaviors
@@ -94,6 +145,7 @@ int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
         path_entity = probe_ent_creat1("path", ent_attrs, r1 = SEXP_string_new(PROC_SYS_DIR, strlen(PROC_SYS_DIR)));
 	SEXP_free(r0);
 	SEXP_free(r1);
+	SEXP_free(ent_attrs);
 
         ent_attrs = probe_attr_creat("operation", r0 = SEXP_number_newi(OVAL_OPERATION_PATTERN_MATCH),
                                      NULL);
@@ -102,40 +154,32 @@ int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
 	SEXP_free(r1);
 	SEXP_free(ent_attrs);
 
-        /*
-         * collect sysctls
-         *  XXX: use direct access for the "equals" op
-         */
         ofts = oval_fts_open_prefixed(NULL, path_entity, filename_entity, NULL, bh_entity, probe_ctx_getresult(ctx));
+	SEXP_free(path_entity);
+	SEXP_free(filename_entity);
+	SEXP_free(bh_entity);
 
         if (ofts == NULL) {
                 dE("oval_fts_open_prefixed(%s, %s) failed", PROC_SYS_DIR, ".\\+");
-		SEXP_free(path_entity);
-		SEXP_free(filename_entity);
-		SEXP_free(bh_entity);
-		SEXP_free(name_entity);
-
-                return (PROBE_EFATAL);
+                return (-1);
         }
 
         while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-                SEXP_t *se_mib;
                 char    mibpath[PATH_MAX], *mib;
                 size_t  miblen;
 		struct stat file_stat;
 
                 snprintf(mibpath, sizeof mibpath, "%s/%s", ofts_ent->path, ofts_ent->file);
+                oval_ftsent_free(ofts_ent);
 
 		/* Skip write-only files, eg. /proc/sys/net/ipv4/route/flush */
 		if (stat(mibpath, &file_stat) == -1) {
 			dE("Stat failed on %s: %u, %s", mibpath, errno, strerror(errno));
-			oval_ftsent_free(ofts_ent);
 			continue;
 		}
 		/* the sysctl utility uses same condition in sysctl.c in ReadSetting() */
 		if ((file_stat.st_mode & S_IRUSR) == 0) {
 			dD("Skipping write-only file %s", mibpath);
-			oval_ftsent_free(ofts_ent);
 			continue;
 		}
 
@@ -149,126 +193,283 @@ int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
                 }
 
                 dD("MIB: %s", mib);
-                se_mib = SEXP_string_new(mib, strlen(mib));
-                free(mib);
-
-                if (probe_entobj_cmp(name_entity, se_mib) == OVAL_RESULT_TRUE) {
-                        FILE   *fp;
-                        SEXP_t *item;
-                        char    sysval[8192];
-                        char   *sysvals[512];
-                        long i, l;
-                        size_t s;
-
-                        dD("MIB match");
-
-                        /*
-                         * read sysctl value
-                         */
-                        fp = fopen(mibpath, "r");
-
-                        if (fp == NULL) {
-                                dE("Can't read sysctl value from \"%s\": %u, %s",
-                                   mibpath, errno, strerror(errno));
-                                goto fail_item;
-                        }
-
-                        l = fread(sysval, 1, sizeof sysval - 1, fp);
-
-                        if (ferror(fp)) {
-				/* Linux 4.1.0 introduced a per-NIC IPv6 stable_secret file.
-				 * The stable_secret file cannot be read until it is set,
-				 * so we skip it when it is not readable. Otherwise we collect it.
-				 */
-				if (strncmp(ofts_ent->path, ipv6_conf_path, ipv6_conf_path_len) == 0 &&
-						strcmp(ofts_ent->file, "stable_secret") == 0) {
-					dD("Skipping file %s", mibpath);
-					oval_ftsent_free(ofts_ent);
-					SEXP_free(se_mib);
-					fclose(fp);
-					continue;
-				} else {
-					dE("An error ocured when reading from \"%s\" (fp=%p): l=%ld, %u, %s",
-						mibpath, fp, l, errno, strerror(errno));
-					goto fail_item;
-				}
-                        }
-
-                        fclose(fp);
-
-			/* Skip empty values as sysctl tool does.
-			 * See https://bugzilla.redhat.com/show_bug.cgi?id=1473207
-			 */
-			if (l == 0) {
-				dD("Skipping file '%s' because it has no value.", mibpath);
-				oval_ftsent_free(ofts_ent);
-				SEXP_free(se_mib);
-				continue;
-			}
-
-                        /*
-                         * sanitize the value
-                         *  - only printable and whitespace chars allowed
-                         *  - remove the last '\n'
-                         */
-                        sysvals[0] = sysval;
-
-                        for(s = 0, i = 0; i < l && s < sizeof sysvals/sizeof(char *) - 1; ++i) {
-	                        if ((!isprint(sysval[i]) && !isspace(sysval[i]))
-	                            || (over_cmp >= 0 && sysval[i] == '\n' /* OVAL 5.10 and above */))
-                                {
-                                        sysval[i] = '\0';
-                                        sysvals[++s] = sysval + i + 1;
-                                }
-                        }
-
-                        if (sysval[l - 1] == '\n')
-                                sysval[l - 1] = '\0';
-                        else
-                                sysval[l] = '\0';
-
-                        if (strlen(sysvals[s]) == 0)
-                                sysvals[s] = NULL;
-                        else
-                                sysvals[++s] = NULL;
-
-                        if (over_cmp >= 0) {
-	                        /* Only in OVAL 5.10 and above */
-	                        item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
-	                                                 "name",  OVAL_DATATYPE_SEXP,   se_mib,
-	                                                 "value", OVAL_DATATYPE_STRING_M, sysvals,
-	                                                 NULL);
-                        } else {
-	                        item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
-	                                                 "name",  OVAL_DATATYPE_SEXP,   se_mib,
-	                                                 "value", OVAL_DATATYPE_STRING, sysval,
-	                                                 NULL);
-                        }
-
-                        goto add_item;
-                fail_item:
-                        if (fp != NULL)
-                                fclose(fp);
-
-			item = probe_item_create(OVAL_UNIX_SYSCTL, NULL, NULL);
-                        probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
-                add_item:
-                        probe_item_collect(ctx, item);
-                }
-
-                oval_ftsent_free(ofts_ent);
-                SEXP_free(se_mib);
+		struct sysctl_key *keys = realloc(g->keys, (g->key_count + 1) * sizeof(struct sysctl_key));
+		if (keys == NULL) {
+			dE("Failed to allocate the index of %zu sysctl keys", g->key_count + 1);
+			free(mib);
+			oval_fts_close(ofts);
+			sysctl_index_clear(g);
+			return (-1);
+		}
+		g->keys = keys;
+		g->keys[g->key_count].mib = mib;
+		g->keys[g->key_count].path = strdup(mibpath);
+		++g->key_count;
         }
 
         oval_fts_close(ofts);
-	SEXP_free(path_entity);
-	SEXP_free(filename_entity);
-	SEXP_free(bh_entity);
+	g->indexed = true;
+
+        return (0);
+}
+
+/*
+ * Map a dotted name to the path of its file relative to /proc/sys. Names
+ * which can't be a path of a sysctl (empty components, slashes) are not
+ * mapped, neither are the names of interfaces which contain dots mapped
+ * right, those are found in the index.
+ */
+static bool sysctl_mib_to_path(const char *mib, char *path, size_t size)
+{
+	size_t len = strlen(mib);
+
+	if (len == 0 || len >= size || mib[0] == '.' || mib[len - 1] == '.' ||
+	    strchr(mib, '/') != NULL || strstr(mib, "..") != NULL)
+		return false;
+
+	for (size_t i = 0; i <= len; ++i)
+		path[i] = mib[i] == '.' ? '/' : mib[i];
+
+	return true;
+}
+
+static void collect_sysctl(probe_ctx *ctx, const char *mib, const char *mibpath, int fd, int over_cmp)
+{
+	const char *ipv6_conf_path = "/proc/sys/net/ipv6/conf/";
+	size_t ipv6_conf_path_len = strlen(ipv6_conf_path);
+	SEXP_t *se_mib, *item;
+	char    sysval[8192];
+	char   *sysvals[512];
+	long i, l;
+	size_t s;
+	ssize_t r;
+
+	/*
+	 * read sysctl value
+	 */
+	for (l = 0; l < (long)sizeof sysval - 1; l += r) {
+		r = read(fd, sysval + l, sizeof sysval - 1 - l);
+		if (r == -1 && errno == EINTR) {
+			r = 0;
+			continue;
+		}
+		if (r <= 0)
+			break;
+	}
+
+	if (r == -1) {
+		/* Linux 4.1.0 introduced a per-NIC IPv6 stable_secret file.
+		 * The stable_secret file cannot be read until it is set,
+		 * so we skip it when it is not readable. Otherwise we collect it.
+		 */
+		const char *file = strrchr(mibpath, '/');
+
+		if (strncmp(mibpath, ipv6_conf_path, ipv6_conf_path_len) == 0 &&
+		    file != NULL && strcmp(file + 1, "stable_secret") == 0) {
+			dD("Skipping file %s", mibpath);
+			return;
+		}
+
+		dE("An error ocured when reading from \"%s\": l=%ld, %u, %s",
+		   mibpath, l, errno, strerror(errno));
+		item = probe_item_create(OVAL_UNIX_SYSCTL, NULL, NULL);
+		probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
+		probe_item_collect(ctx, item);
+		return;
+	}
+
+	/* Skip empty values as sysctl tool does.
+	 * See https://bugzilla.redhat.com/show_bug.cgi?id=1473207
+	 */
+	if (l == 0) {
+		dD("Skipping file '%s' because it has no value.", mibpath);
+		return;
+	}
+
+	/*
+	 * sanitize the value
+	 *  - only printable and whitespace chars allowed
+	 *  - remove the last '\n'
+	 */
+	sysvals[0] = sysval;
+
+	for(s = 0, i = 0; i < l && s < sizeof sysvals/sizeof(char *) - 1; ++i) {
+		if ((!isprint(sysval[i]) && !isspace(sysval[i]))
+		    || (over_cmp >= 0 && sysval[i] == '\n' /* OVAL 5.10 and above */))
+		{
+			sysval[i] = '\0';
+			sysvals[++s] = sysval + i + 1;
+		}
+	}
+
+	if (sysval[l - 1] == '\n')
+		sysval[l - 1] = '\0';
+	else
+		sysval[l] = '\0';
+
+	if (strlen(sysvals[s]) == 0)
+		sysvals[s] = NULL;
+	else
+		sysvals[++s] = NULL;
+
+	se_mib = SEXP_string_new(mib, strlen(mib));
+	if (over_cmp >= 0) {
+		/* Only in OVAL 5.10 and above */
+		item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
+					 "name",  OVAL_DATATYPE_SEXP,   se_mib,
+					 "value", OVAL_DATATYPE_STRING_M, sysvals,
+					 NULL);
+	} else {
+		item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
+					 "name",  OVAL_DATATYPE_SEXP,   se_mib,
+					 "value", OVAL_DATATYPE_STRING, sysval,
+					 NULL);
+	}
+	SEXP_free(se_mib);
+
+	probe_item_collect(ctx, item);
+}
+
+static void collect_sysctl_error(probe_ctx *ctx, const char *mibpath)
+{
+	SEXP_t *item;
+
+	dE("Can't read sysctl value from \"%s\": %u, %s",
+	   mibpath, errno, strerror(errno));
+	item = probe_item_create(OVAL_UNIX_SYSCTL, NULL, NULL);
+	probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
+	probe_item_collect(ctx, item);
+}
+
+static void collect_sysctl_file(probe_ctx *ctx, const char *mib, const char *mibpath, int over_cmp)
+{
+	int fd;
+
+	dD("MIB match");
+	fd = open(mibpath, O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		collect_sysctl_error(ctx, mibpath);
+		return;
+	}
+
+	collect_sysctl(ctx, mib, mibpath, fd, over_cmp);
+	close(fd);
+}
+
+/*
+ * Read the sysctl of the exact name with a single openat() in /proc/sys.
+ * Returns false if there is no file of the name, the name has to be looked
+ * up in the index then.
+ */
+static bool collect_sysctl_by_name(struct sysctl_global *g, probe_ctx *ctx, const char *mib, int over_cmp)
+{
+	char relpath[PATH_MAX], mibpath[sizeof PROC_SYS_DIR + PATH_MAX];
+	struct stat file_stat;
+	int fd;
+
+	if (g->proc_sys_fd == -1 || !sysctl_mib_to_path(mib, relpath, sizeof relpath))
+		return false;
+
+	snprintf(mibpath, sizeof mibpath, "%s/%s", PROC_SYS_DIR, relpath);
+	fd = openat(g->proc_sys_fd, relpath, O_RDONLY | O_CLOEXEC | O_NOCTTY);
+	if (fd == -1) {
+		if (errno != EACCES)
+			return false;
+		/* report a sysctl which we can't read as the index does */
+		if (fstatat(g->proc_sys_fd, relpath, &file_stat, 0) == -1 || !S_ISREG(file_stat.st_mode))
+			return false;
+		if ((file_stat.st_mode & S_IRUSR) != 0) {
+			errno = EACCES;
+			collect_sysctl_error(ctx, mibpath);
+		}
+		return true;
+	}
+
+	if (fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+		close(fd);
+		return false;
+	}
+
+	/* the sysctl utility uses same condition in sysctl.c in ReadSetting() */
+	if ((file_stat.st_mode & S_IRUSR) == 0) {
+		dD("Skipping write-only file %s", mibpath);
+	} else {
+		dD("MIB: %s", mib);
+		collect_sysctl(ctx, mib, mibpath, fd, over_cmp);
+	}
+	close(fd);
+
+	return true;
+}
+
+int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
+{
+	struct sysctl_global *g = probe_arg;
+        SEXP_t *name_entity, *probe_in;
+        oval_schema_version_t over;
+        int over_cmp;
+
+        probe_in    = probe_ctx_getobject(ctx);
+        name_entity = probe_obj_getent(probe_in, "name", 1);
+        over        = probe_obj_get_platform_schema_version(probe_in);
+        over_cmp    = oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10));
+
+        if (name_entity == NULL) {
+                dE("Missing \"name\" entity in the input object");
+                return (PROBE_ENOENT);
+        }
+
+	/*
+	 * use direct access for the "equals" op
+	 */
+	if (probe_ent_getoperation(name_entity, OVAL_OPERATION_EQUALS) == OVAL_OPERATION_EQUALS &&
+	    !probe_ent_attrexists(name_entity, "var_ref")) {
+		SEXP_t *name_val = probe_ent_getval(name_entity);
+		char *name = name_val != NULL ? SEXP_string_cstr(name_val) : NULL;
+		bool found = name != NULL && collect_sysctl_by_name(g, ctx, name, over_cmp);
+
+		free(name);
+		SEXP_free(name_val);
+		if (found) {
+			SEXP_free(name_entity);
+			return (0);
+		}
+	}
+
+        /*
+         * collect sysctls
+         */
+	pthread_mutex_lock(&g->lock);
+	if (!g->indexed && sysctl_index_build(g, ctx) != 0) {
+		pthread_mutex_unlock(&g->lock);
+		SEXP_free(name_entity);
+
+                return (PROBE_EFATAL);
+	}
+	pthread_mutex_unlock(&g->lock);
+
+	for (size_t i = 0; i < g->key_count; ++i) {
+		SEXP_t *se_mib = SEXP_string_new(g->keys[i].mib, strlen(g->keys[i].mib));
+
+		if (probe_entobj_cmp(name_entity, se_mib) == OVAL_RESULT_TRUE)
+			collect_sysctl_file(ctx, g->keys[i].mib, g->keys[i].path, over_cmp);
+		SEXP_free(se_mib);
+	}
+
 	SEXP_free(name_entity);
 
         return (0);
 }
 #else
+void *sysctl_probe_init(void)
+{
+	return NULL;
+}
+
+void sysctl_probe_fini(void *probe_arg)
+{
+}
+
 int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
 {
         return(PROBE_EOPNOTSUPP);
@@ -96,6 +96,33 @@ OSCAP_API struct oval_result_definition * oval_agent_get_result_definition(oval_
  */
 OSCAP_API int oval_agent_reset_session(oval_agent_session_t * ag_sess);
 
+/**
+ * Start the agent session over with empty system characteristics and results,
+ * e.g. to scan another system (see OSCAP_PROBE_ROOT) with the same definition
+ * model. Unlike @ref oval_agent_reset_session nothing collected or evaluated
+ * so far is kept. Result directives of the session are preserved.
+ * @return 0 on success; -1 error
+ */
+OSCAP_API int oval_agent_restart_session(oval_agent_session_t *ag_sess);
+
+/**
+ * Reuse system characteristics saved by a previous scan in the given directory.
+ * Objects addressing a file by its exact path (or querying the package database)
+ * whose inputs did not change since the previous scan are not collected again,
+ * their items are taken from the previous scan. All other objects are collected
+ * as usual. This has to be called before the evaluation.
+ * @param dir directory with the state saved by @ref oval_agent_save_incremental_state
+ * @return number of reused objects; -1 error
+ */
+OSCAP_API int oval_agent_load_incremental_state(oval_agent_session_t *ag_sess, const char *dir);
+
+/**
+ * Save system characteristics of the session into the given directory to be
+ * reused by the next scan, see @ref oval_agent_load_incremental_state.
+ * @return 0 on success; -1 error
+ */
+OSCAP_API int oval_agent_save_incremental_state(oval_agent_session_t *ag_sess, const char *dir);
+
 /**
  * Abort a running probe session
  */
@@ -639,6 +639,26 @@ OSCAP_API struct oval_definition_model *oval_definition_model_clone(struct oval_
  *
  */
 OSCAP_API int oval_definition_model_export(struct oval_definition_model *, const char *file);
+/**
+ * Export an oval_definition_model into a compiled binary file. The compiled
+ * file can be loaded back by oval_definition_model_import_compiled() without
+ * parsing any XML. Only models freshly imported from XML are supported.
+ * @memberof oval_definition_model
+ * @param model The model to compile
+ * @param source The oscap_source the model was imported from, it is used to
+ * key the compiled file to the original content (can be NULL)
+ * @param file Path of the compiled file
+ * @returns zero on success, -1 on error
+ */
+OSCAP_API int oval_definition_model_export_compiled(struct oval_definition_model *model, struct oscap_source *source, const char *file);
+/**
+ * Import an oval_definition_model from a compiled binary file created by
+ * oval_definition_model_export_compiled().
+ * @memberof oval_definition_model
+ * @param file Path of the compiled file
+ * @returns newly build oval_definition_model, or NULL if something went wrong
+ */
+OSCAP_API struct oval_definition_model *oval_definition_model_import_compiled(const char *file);
 /**
  * Free OVAL object model and all binded variable models.
  * @memberof oval_definition_model
@@ -131,6 +131,40 @@ OSCAP_API struct oval_results_model *oval_results_model_new(struct oval_definiti
  */
 OSCAP_API int oval_results_model_import_source(struct oval_results_model *model, struct oscap_source *source);
 
+/**
+ * @struct oval_results_stream_handler
+ * Callbacks for oval_results_stream_source(). Callbacks which are NULL are
+ * not called and the parts of the document they would report are skipped.
+ * Strings passed to the callbacks are valid only during the call.
+ * A callback returning a non-zero value stops the processing.
+ */
+struct oval_results_stream_handler {
+	/** Start of a result system, the systems are numbered from 0 */
+	int (*system)(int index, void *arg);
+	/** Result of a definition */
+	int (*definition)(const char *definition_id, int version, int variable_instance,
+			oval_definition_class_t def_class, oval_result_t result, void *arg);
+	/** Result of a test */
+	int (*test)(const char *test_id, int version, int variable_instance, oval_result_t result, void *arg);
+	/** Result of an item tested by the test */
+	int (*tested_item)(const char *test_id, int variable_instance, const char *item_id, oval_result_t result, void *arg);
+	/** Item of the system characteristics (e.g. "rpminfo_item"), which are not read at all when NULL */
+	int (*item)(const char *item_id, const char *item_type, oval_syschar_status_t status, void *arg);
+	void *arg;                      ///< user data passed to the callbacks
+};
+
+/**
+ * Read the results from the oscap_source without building the results model.
+ * The document is read sequentially and the results are reported to the callbacks
+ * as they are encountered, so huge results documents can be processed in bounded memory.
+ * The OVAL Definitions and the system characteristics are skipped unless
+ * the item callback is set.
+ * @param source The oscap_source to read from
+ * @param handler The callbacks
+ * @return 0 on success, -1 if an error occurred, or the non-zero value returned by a callback
+ */
+OSCAP_API int oval_results_stream_source(struct oscap_source *source, const struct oval_results_stream_handler *handler);
+
 /**
  * Copy an oval_results_model.
  * @return A copy of the specified @ref oval_results_model.
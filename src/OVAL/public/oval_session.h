@@ -231,6 +231,18 @@ OSCAP_API int oval_session_export(struct oval_session *session);
  */
 OSCAP_API void oval_session_set_export_system_characteristics(struct oval_session *session, bool export);
 
+/**
+ * Set directory with the state of incremental scans. Objects whose inputs
+ * did not change since the scan saved in the directory are not collected
+ * again and the system characteristics of this scan are saved there
+ * after the evaluation. See \ref oval_agent_load_incremental_state.
+ *
+ * @memberof oval_session
+ * @param session an \ref oval_session
+ * @param dir path to the directory, NULL disables incremental scans
+ */
+OSCAP_API void oval_session_set_incremental_state(struct oval_session *session, const char *dir);
+
 /**
  * Set property of remote content.
  * @memberof oval_session
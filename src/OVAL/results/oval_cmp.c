@@ -28,6 +28,7 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 
@@ -167,3 +168,138 @@ oval_result_t oval_ent_cmp_str(char *state_data, oval_datatype_t state_data_type
 	const char *sys_data = oval_sysent_get_value(sysent);
 	return oval_str_cmp_str(state_data, state_data_type, sys_data, operation);
 }
+
+struct oval_cmp_value {
+	char *state_data;
+	oval_datatype_t datatype;
+	oval_operation_t operation;
+	bool compiled;				///< false if the state data could not be pre-parsed
+	union {
+		intmax_t integer;
+		double real;
+		bool boolean;
+		struct {
+			pcre *re;
+			pcre_extra *extra;
+		} regex;
+		struct oval_evr_string *evr;
+		struct oval_ipaddr ipaddr;
+	} data;
+};
+
+static inline bool cstr_to_boolean(const char *cstr)
+{
+	return strcmp(cstr, "true") == 0 || strcmp(cstr, "1") == 0;
+}
+
+struct oval_cmp_value *oval_cmp_value_new(const char *state_data, oval_datatype_t state_data_type, oval_operation_t operation)
+{
+	struct oval_cmp_value *value = calloc(1, sizeof(struct oval_cmp_value));
+	value->state_data = oscap_strdup(state_data);
+	value->datatype = state_data_type;
+	value->operation = operation;
+
+	/* Values which cannot be parsed stay uncompiled, oval_str_cmp_str()
+	 * is used for them and it reports the error for every comparison. */
+	switch (state_data_type) {
+	case OVAL_DATATYPE_STRING:
+		if (operation == OVAL_OPERATION_PATTERN_MATCH) {
+			value->data.regex.re = oval_string_regex_compile(state_data, &value->data.regex.extra);
+			value->compiled = (value->data.regex.re != NULL);
+		}
+		break;
+	case OVAL_DATATYPE_INTEGER:
+		value->compiled = cstr_to_intmax(state_data, &value->data.integer);
+		break;
+	case OVAL_DATATYPE_FLOAT:
+		value->compiled = cstr_to_double(state_data, &value->data.real);
+		break;
+	case OVAL_DATATYPE_BOOLEAN:
+		value->data.boolean = cstr_to_boolean(state_data);
+		value->compiled = true;
+		break;
+	case OVAL_DATATYPE_EVR_STRING:
+	case OVAL_DATATYPE_DEBIAN_EVR_STRING:
+		value->data.evr = oval_evr_string_new(state_data);
+		value->compiled = true;
+		break;
+	case OVAL_DATATYPE_IPV4ADDR:
+		value->compiled = (oval_ipaddr_parse(AF_INET, state_data, &value->data.ipaddr) == 0);
+		break;
+	case OVAL_DATATYPE_IPV6ADDR:
+		value->compiled = (oval_ipaddr_parse(AF_INET6, state_data, &value->data.ipaddr) == 0);
+		break;
+	default:
+		break;
+	}
+	return value;
+}
+
+void oval_cmp_value_free(struct oval_cmp_value *value)
+{
+	if (value == NULL)
+		return;
+	if (value->compiled) {
+		switch (value->datatype) {
+		case OVAL_DATATYPE_STRING:
+			if (value->data.regex.extra != NULL)
+				pcre_free(value->data.regex.extra);
+			pcre_free(value->data.regex.re);
+			break;
+		case OVAL_DATATYPE_EVR_STRING:
+		case OVAL_DATATYPE_DEBIAN_EVR_STRING:
+			oval_evr_string_free(value->data.evr);
+			break;
+		default:
+			break;
+		}
+	}
+	free(value->state_data);
+	free(value);
+}
+
+oval_result_t oval_cmp_value_cmp_str(const struct oval_cmp_value *value, const char *sys_data)
+{
+	if (!value->compiled)
+		return oval_str_cmp_str(value->state_data, value->datatype, sys_data, value->operation);
+
+	switch (value->datatype) {
+	case OVAL_DATATYPE_STRING:
+		return oval_string_regex_cmp(value->data.regex.re, value->data.regex.extra, value->state_data, sys_data);
+	case OVAL_DATATYPE_INTEGER: {
+		intmax_t syschar_val;
+		if (!cstr_to_intmax(sys_data, &syschar_val)) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL,
+				"Conversion of the string \"%s\" to an integer (%u bits) failed: %s",
+				sys_data, sizeof(intmax_t)*8, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_int_cmp(value->data.integer, syschar_val, value->operation);
+	}
+	case OVAL_DATATYPE_FLOAT: {
+		double sys_val;
+		if (!cstr_to_double(sys_data, &sys_val)) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL,
+				"Conversion of the string \"%s\" to a floating type (double) failed: %s",
+				sys_data, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_float_cmp(value->data.real, sys_val, value->operation);
+	}
+	case OVAL_DATATYPE_BOOLEAN:
+		return oval_boolean_cmp(value->data.boolean, cstr_to_boolean(sys_data), value->operation);
+	case OVAL_DATATYPE_EVR_STRING:
+	case OVAL_DATATYPE_DEBIAN_EVR_STRING:
+		return oval_evr_string_cmp_parsed(value->data.evr, sys_data, value->operation);
+	case OVAL_DATATYPE_IPV4ADDR:
+	case OVAL_DATATYPE_IPV6ADDR:
+		return oval_ipaddr_cmp_parsed(&value->data.ipaddr, sys_data, value->operation);
+	default:
+		return oval_str_cmp_str(value->state_data, value->datatype, sys_data, value->operation);
+	}
+}
+
+oval_result_t oval_ent_cmp_value(const struct oval_cmp_value *value, struct oval_sysent *sysent)
+{
+	return oval_cmp_value_cmp_str(value, oval_sysent_get_value(sysent));
+}
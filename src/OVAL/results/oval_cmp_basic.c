@@ -120,10 +120,8 @@ static int istrcmp(const char *st1, const char *st2)
 	return oscap_strcasecmp(st1, st2);
 }
 
-static oval_result_t strregcomp(const char *pattern, const char *test_str)
+pcre *oval_string_regex_compile(const char *pattern, pcre_extra **extra)
 {
-	int ret;
-	oval_result_t result = OVAL_RESULT_ERROR;
 	pcre *re;
 	const char *err;
 	int errofs;
@@ -132,20 +130,40 @@ static oval_result_t strregcomp(const char *pattern, const char *test_str)
 	if (re == NULL) {
 		dE("Unable to compile regex pattern '%s', "
 				"pcre_compile() returned error (offset: %d): '%s'.\n", pattern, errofs, err);
-		return OVAL_RESULT_ERROR;
+		return NULL;
 	}
+	if (extra != NULL) {
+		/* The pattern is going to be matched many times, it is worth studying */
+		*extra = pcre_study(re, 0, &err);
+	}
+	return re;
+}
+
+oval_result_t oval_string_regex_cmp(const pcre *re, const pcre_extra *extra, const char *pattern, const char *syschar)
+{
+	oval_result_t result;
+	syschar = syschar ? syschar : "";
 
-	ret = pcre_exec(re, NULL, test_str, strlen(test_str), 0, 0, NULL, 0);
+	int ret = pcre_exec(re, extra, syschar, strlen(syschar), 0, 0, NULL, 0);
 	if (ret > -1 ) {
 		result = OVAL_RESULT_TRUE;
 	} else if (ret == -1) {
 		result = OVAL_RESULT_FALSE;
 	} else {
 		dE("Unable to match regex pattern '%s' on string '%s', "
-				"pcre_exec() returned error: %d.\n", pattern, test_str, ret);
+				"pcre_exec() returned error: %d.\n", pattern, syschar, ret);
 		result = OVAL_RESULT_ERROR;
 	}
+	return result;
+}
+
+static oval_result_t strregcomp(const char *pattern, const char *test_str)
+{
+	pcre *re = oval_string_regex_compile(pattern, NULL);
+	if (re == NULL)
+		return OVAL_RESULT_ERROR;
 
+	oval_result_t result = oval_string_regex_cmp(re, NULL, pattern, test_str);
 	pcre_free(re);
 	return result;
 }
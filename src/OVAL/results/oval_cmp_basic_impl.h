@@ -23,6 +23,8 @@
 #ifndef OSCAP_OVAL_CMP_BASIC_IMPL_H_
 #define OSCAP_OVAL_CMP_BASIC_IMPL_H_
 
+#include <pcre.h>
+
 #include "../common/util.h"
 #include "oval_definitions.h"
 #include "oval_types.h"
@@ -36,6 +38,18 @@ oval_result_t oval_float_cmp(const double state_val, const double sys_val, oval_
 
 oval_result_t oval_string_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
+/**
+ * Compile regular expression of a state for oval_string_regex_cmp.
+ * @param extra if not NULL, set to the result of pcre_study (may be NULL)
+ * @returns compiled pattern or NULL when the pattern is not valid
+ */
+pcre *oval_string_regex_compile(const char *pattern, pcre_extra **extra);
+
+/**
+ * Match the system data with a compiled regular expression (the pattern_match operation).
+ */
+oval_result_t oval_string_regex_cmp(const pcre *re, const pcre_extra *extra, const char *pattern, const char *syschar);
+
 oval_result_t oval_binary_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
 
@@ -52,13 +52,35 @@ static int risdigit(int c) {
 #endif
 
 static inline int rpmevrcmp(const char *a, const char *b);
+static inline int rpmevrcmp_parsed(const char *a, const struct oval_evr_string *b);
 static int compare_values(const char *str1, const char *str2);
 static void parseEVR(char *evr, const char **ep, const char **vp, const char **rp);
 
-oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation)
+struct oval_evr_string {
+	char *evr;				///< copy of the string split by parseEVR
+	const char *epoch;
+	const char *version;
+	const char *release;
+};
+
+struct oval_evr_string *oval_evr_string_new(const char *evr)
 {
-	int result = rpmevrcmp(sys, state);
+	struct oval_evr_string *parsed = malloc(sizeof(struct oval_evr_string));
+	parsed->evr = oscap_strdup(evr);
+	parseEVR(parsed->evr, &parsed->epoch, &parsed->version, &parsed->release);
+	return parsed;
+}
+
+void oval_evr_string_free(struct oval_evr_string *evr)
+{
+	if (evr == NULL)
+		return;
+	free(evr->evr);
+	free(evr);
+}
 
+static oval_result_t _evr_result(int result, oval_operation_t operation)
+{
 	if (operation == OVAL_OPERATION_EQUALS) {
 		return ((result == 0) ? OVAL_RESULT_TRUE : OVAL_RESULT_FALSE);
 	} else if (operation == OVAL_OPERATION_NOT_EQUAL) {
@@ -77,6 +99,16 @@ oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_opera
 	return OVAL_RESULT_ERROR;
 }
 
+oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation)
+{
+	return _evr_result(rpmevrcmp(sys, state), operation);
+}
+
+oval_result_t oval_evr_string_cmp_parsed(const struct oval_evr_string *state, const char *sys, oval_operation_t operation)
+{
+	return _evr_result(rpmevrcmp_parsed(sys, state), operation);
+}
+
 static inline int rpmevrcmp(const char *a, const char *b)
 {
 	/* This mimics rpmevrcmp which is not exported by rpmlib version 4.
@@ -104,6 +136,27 @@ static inline int rpmevrcmp(const char *a, const char *b)
 	return result;
 }
 
+/* Like rpmevrcmp, but the second version has been split already */
+static inline int rpmevrcmp_parsed(const char *a, const struct oval_evr_string *b)
+{
+	const char *a_epoch, *a_version, *a_release;
+	char *a_copy;
+	int result;
+
+	a_copy = oscap_strdup(a);
+	parseEVR(a_copy, &a_epoch, &a_version, &a_release);
+
+	result = compare_values(a_epoch, b->epoch);
+	if (!result) {
+		result = compare_values(a_version, b->version);
+		if (!result)
+			result = compare_values(a_release, b->release);
+	}
+
+	free(a_copy);
+	return result;
+}
+
 static int compare_values(const char *str1, const char *str2)
 {
 	/*
@@ -47,6 +47,21 @@
  */
 oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation);
 
+/**
+ * EVR string of a state split into epoch, version and release, so that it
+ * does not need to be parsed again for every compared item.
+ */
+struct oval_evr_string;
+
+struct oval_evr_string *oval_evr_string_new(const char *evr);
+
+void oval_evr_string_free(struct oval_evr_string *evr);
+
+/**
+ * Same as oval_evr_string_cmp with the state parsed by oval_evr_string_new.
+ */
+oval_result_t oval_evr_string_cmp_parsed(const struct oval_evr_string *state, const char *sys, oval_operation_t operation);
+
 oval_result_t oval_versiontype_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
 
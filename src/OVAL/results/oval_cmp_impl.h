@@ -50,5 +50,24 @@ oval_result_t oval_ent_cmp_str(char *state_data, oval_datatype_t state_data_type
  */
 oval_result_t oval_str_cmp_str(char *state_data, oval_datatype_t state_data_type, const char *sys_data, oval_operation_t operation);
 
+/**
+ * Value of a state entity compiled for comparisons with many items. The
+ * state data is converted according to its datatype only once (integers,
+ * floats, EVR strings, IP addresses, regular expressions), the comparison
+ * of every item then converts only the system data.
+ */
+struct oval_cmp_value;
+
+struct oval_cmp_value *oval_cmp_value_new(const char *state_data, oval_datatype_t state_data_type, oval_operation_t operation);
+
+void oval_cmp_value_free(struct oval_cmp_value *value);
+
+/**
+ * Same as oval_str_cmp_str with the state data of the compiled value.
+ */
+oval_result_t oval_cmp_value_cmp_str(const struct oval_cmp_value *value, const char *sys_data);
+
+oval_result_t oval_ent_cmp_value(const struct oval_cmp_value *value, struct oval_sysent *sysent);
+
 
 #endif
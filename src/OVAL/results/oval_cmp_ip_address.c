@@ -86,26 +86,20 @@ static inline int ipaddr_parse(int af, const char *oval_ip_string, uint32_t *mas
 	return ipv6addr_parse(oval_ip_string, mask_out, ip_out);
 }
 
-oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_operation_t op)
+/* Compare the addresses parsed by ipaddr_parse, the addresses get masked */
+static oval_result_t ipaddr_cmp_parsed(int af, void *addr1, uint32_t mask1, void *addr2, uint32_t mask2, oval_operation_t op)
 {
 	oval_result_t result = OVAL_RESULT_ERROR;
-	uint32_t mask1 = 0, mask2 = 0;
-	char addr1[INET6_ADDRSTRLEN];
-	char addr2[INET6_ADDRSTRLEN];
-
-	if (ipaddr_parse(af, s1, &mask1, &addr1) || ipaddr_parse(af, s2, &mask2, &addr2)) {
-		return result;
-	}
 
 	switch (op) {
 	case OVAL_OPERATION_EQUALS:
-		if (!ipaddr_cmp(af, &addr1, &addr2) && mask1 == mask2)
+		if (!ipaddr_cmp(af, addr1, addr2) && mask1 == mask2)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
 		break;
 	case OVAL_OPERATION_NOT_EQUAL:
-		if (ipaddr_cmp(af, &addr1, &addr2) || mask1 != mask2)
+		if (ipaddr_cmp(af, addr1, addr2) || mask1 != mask2)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -122,9 +116,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		}
 
 		/* Otherwise, compare the first bits defined by mask1 */
-		ipaddr_mask(af, &addr1, mask1);
-		ipaddr_mask(af, &addr2, mask1);
-		if (ipaddr_cmp(af, &addr1, &addr2) == 0)
+		ipaddr_mask(af, addr1, mask1);
+		ipaddr_mask(af, addr2, mask1);
+		if (ipaddr_cmp(af, addr1, addr2) == 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -133,9 +127,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		if (mask1 != mask2) {
 			return OVAL_RESULT_ERROR;
 		}
-		ipaddr_mask(af, &addr1, mask1);
-		ipaddr_mask(af, &addr2, mask2);
-		if (ipaddr_cmp(af, &addr1, &addr2) < 0)
+		ipaddr_mask(af, addr1, mask1);
+		ipaddr_mask(af, addr2, mask2);
+		if (ipaddr_cmp(af, addr1, addr2) < 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -144,9 +138,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		if (mask1 != mask2) {
 			return OVAL_RESULT_ERROR;
 		}
-		ipaddr_mask(af, &addr1, mask1);
-		ipaddr_mask(af, &addr2, mask2);
-		if (ipaddr_cmp(af, &addr1, &addr2) <= 0)
+		ipaddr_mask(af, addr1, mask1);
+		ipaddr_mask(af, addr2, mask2);
+		if (ipaddr_cmp(af, addr1, addr2) <= 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -163,9 +157,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		}
 
 		/* Otherwise, compare the first bits defined by mask2 */
-		ipaddr_mask(af, &addr1, mask2);
-		ipaddr_mask(af, &addr2, mask2);
-		if (ipaddr_cmp(af, &addr1, &addr2) == 0)
+		ipaddr_mask(af, addr1, mask2);
+		ipaddr_mask(af, addr2, mask2);
+		if (ipaddr_cmp(af, addr1, addr2) == 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -174,9 +168,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		if (mask1 != mask2) {
 			return OVAL_RESULT_ERROR;
 		}
-		ipaddr_mask(af, &addr1, mask1);
-		ipaddr_mask(af, &addr2, mask2);
-		if (ipaddr_cmp(af, &addr1, &addr2) > 0)
+		ipaddr_mask(af, addr1, mask1);
+		ipaddr_mask(af, addr2, mask2);
+		if (ipaddr_cmp(af, addr1, addr2) > 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -185,9 +179,9 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 		if (mask1 != mask2) {
 			return OVAL_RESULT_ERROR;
 		}
-		ipaddr_mask(af, &addr1, mask1);
-		ipaddr_mask(af, &addr2, mask2);
-		if (ipaddr_cmp(af, &addr1, &addr2) >= 0)
+		ipaddr_mask(af, addr1, mask1);
+		ipaddr_mask(af, addr2, mask2);
+		if (ipaddr_cmp(af, addr1, addr2) >= 0)
 			result = OVAL_RESULT_TRUE;
 		else
 			result = OVAL_RESULT_FALSE;
@@ -200,6 +194,39 @@ oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_opera
 	return result;
 }
 
+oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_operation_t op)
+{
+	uint32_t mask1 = 0, mask2 = 0;
+	char addr1[INET6_ADDRSTRLEN];
+	char addr2[INET6_ADDRSTRLEN];
+
+	if (ipaddr_parse(af, s1, &mask1, &addr1) || ipaddr_parse(af, s2, &mask2, &addr2)) {
+		return OVAL_RESULT_ERROR;
+	}
+	return ipaddr_cmp_parsed(af, &addr1, mask1, &addr2, mask2, op);
+}
+
+int oval_ipaddr_parse(int af, const char *s, struct oval_ipaddr *ipaddr)
+{
+	memset(ipaddr, 0, sizeof(struct oval_ipaddr));
+	ipaddr->af = af;
+	return ipaddr_parse(af, s, &ipaddr->mask, &ipaddr->addr);
+}
+
+oval_result_t oval_ipaddr_cmp_parsed(const struct oval_ipaddr *state, const char *sys, oval_operation_t op)
+{
+	uint32_t mask2 = 0;
+	char addr1[INET6_ADDRSTRLEN];
+	char addr2[INET6_ADDRSTRLEN];
+
+	if (ipaddr_parse(state->af, sys, &mask2, &addr2)) {
+		return OVAL_RESULT_ERROR;
+	}
+	/* the comparison masks the address of the state, use a copy */
+	memcpy(addr1, state->addr, sizeof(state->addr));
+	return ipaddr_cmp_parsed(state->af, &addr1, state->mask, &addr2, mask2, op);
+}
+
 static inline int ipv4addr_parse(const char *oval_ipv4_string, uint32_t *netmask_out, struct in_addr *ip_out)
 {
 	char *s, *pfx;
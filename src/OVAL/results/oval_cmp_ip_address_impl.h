@@ -31,6 +31,8 @@
 #ifndef OSCAP_OVAL_IP_ADDRESS_IMPL_H_
 #define OSCAP_OVAL_IP_ADDRESS_IMPL_H_
 
+#include <stdint.h>
+
 #include "common/util.h"
 
 #include "oval_definitions.h"
@@ -49,5 +51,25 @@
  */
 oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_operation_t op);
 
+/**
+ * IP address or address set of a state parsed by oval_ipaddr_parse.
+ */
+struct oval_ipaddr {
+	int af;				///< AF_INET or AF_INET6
+	uint32_t mask;			///< netmask (IPv4) or prefix length (IPv6)
+	unsigned char addr[16];		///< struct in_addr or struct in6_addr
+};
+
+/**
+ * Parse IP address of a state, so that it can be compared with many items.
+ * @returns 0 on success, -1 if the address is not valid
+ */
+int oval_ipaddr_parse(int af, const char *s, struct oval_ipaddr *ipaddr);
+
+/**
+ * Same as oval_ipaddr_cmp with the state parsed by oval_ipaddr_parse.
+ */
+oval_result_t oval_ipaddr_cmp_parsed(const struct oval_ipaddr *state, const char *sys, oval_operation_t op);
+
 
 #endif
@@ -62,6 +62,7 @@ struct oval_results_model {
 	struct oval_probe_session *probe_session;
 #endif
 	bool   export_sys_chars;
+	bool   fast_verdict;
 };
 
 struct oval_results_model *oval_results_model_new(struct oval_definition_model *definition_model,
@@ -97,6 +98,7 @@ struct oval_results_model *oval_results_model_new_with_probe_session(struct oval
 	model->probe_session = probe_session;
 #endif
 	model->export_sys_chars = true;
+	model->fast_verdict = false;
 	return model;
 }
 
@@ -116,6 +118,19 @@ struct oval_results_model *oval_results_model_clone(struct oval_results_model *o
 	return new_resmodel;
 }
 
+void oval_results_model_reset_systems(struct oval_results_model *model, struct oval_syschar_model **syschar_models)
+{
+	oval_collection_free_items(model->systems, (oscap_destruct_func) oval_result_system_free);
+	model->systems = oval_collection_new();
+	if (syschar_models) {
+		struct oval_syschar_model *syschar_model;
+		for (syschar_model = *syschar_models; syschar_model; syschar_model = *(++syschar_models)) {
+			oval_result_system_new(model, syschar_model);
+		}
+	}
+	oval_generator_update_timestamp(model->generator);
+}
+
 void oval_results_model_set_export_system_characteristics(struct oval_results_model *model, bool export)
 {
 	model->export_sys_chars = export;
@@ -126,6 +141,16 @@ bool oval_results_model_get_export_system_characteristics(struct oval_results_mo
 	return model->export_sys_chars;
 }
 
+void oval_results_model_set_fast_verdict(struct oval_results_model *model, bool fast_verdict)
+{
+	model->fast_verdict = fast_verdict;
+}
+
+bool oval_results_model_get_fast_verdict(struct oval_results_model *model)
+{
+	return model->fast_verdict;
+}
+
 void oval_results_model_free(struct oval_results_model *model)
 {
 	__attribute__nonnull__(model);
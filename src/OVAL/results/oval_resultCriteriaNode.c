@@ -341,13 +341,21 @@ static oval_result_t _oval_result_criteria_node_result(struct oval_result_criter
 			struct oval_result_criteria_node_iterator *subnodes
 			    = oval_result_criteria_node_get_subnodes(node);
 			oval_operator_t operator = oval_result_criteria_node_get_operator(node);
+			struct oval_result_system *sys = oval_result_criteria_get_system(node);
+			bool fast_verdict = oval_results_model_get_fast_verdict(oval_result_system_get_results_model(sys));
 			struct oresults node_res;
 			ores_clear(&node_res);
 			while (oval_result_criteria_node_iterator_has_more(subnodes)) {
 				struct oval_result_criteria_node *subnode
 				    = oval_result_criteria_node_iterator_next(subnodes);
 				oval_result_t subres = oval_result_criteria_node_eval(subnode);
+				/* an internal error must not be dropped, it would let the other children decide */
+				if (((signed) subres) == -1)
+					subres = OVAL_RESULT_ERROR;
 				ores_add_res(&node_res, subres);
+				/* the remaining children are left not evaluated, their tests do not collect objects */
+				if (fast_verdict && ores_is_decided_byopr(&node_res, operator))
+					break;
 			}
 			oval_result_criteria_node_iterator_free(subnodes);
 			result = ores_get_result_byopr(&node_res, operator);
@@ -0,0 +1,244 @@
+/**
+ * @file oval_resultStream.c
+ * \brief Open Vulnerability and Assessment Language
+ *
+ * Streaming import of OVAL Results documents. Unlike
+ * oval_results_model_import_source() nothing is materialized, the results
+ * are reported to callbacks as they are read, so the memory needed does
+ * not depend on the size of the document.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <libxml/xmlreader.h>
+
+#include "oval_results.h"
+#include "oval_agent_api_impl.h"
+#include "oval_parser_impl.h"
+#include "results/oval_results_impl.h"
+
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/util.h"
+#include "source/oscap_source_priv.h"
+
+/* Elements of the document are recognized by their depth:
+ *
+ * 0 <oval_results>
+ * 1   <results>                         (other children are skipped)
+ * 2     <system>
+ * 3       <definitions> <tests> <oval_system_characteristics>
+ * 4         <definition> <test> <system_data>
+ * 5           <tested_item> <item>
+ */
+enum oval_result_stream_section {
+	OVAL_RESULT_STREAM_NONE = 0,
+	OVAL_RESULT_STREAM_DEFINITIONS,
+	OVAL_RESULT_STREAM_TESTS,
+	OVAL_RESULT_STREAM_SYSCHAR,
+};
+
+struct oval_result_stream {
+	xmlTextReaderPtr reader;
+	const struct oval_results_stream_handler *handler;
+	bool has_root;
+	enum oval_result_stream_section section;
+	int system_index;
+	char *test_id;                  ///< id of the test being read (for tested items)
+	int test_variable_instance;
+};
+
+static int _stream_definition(struct oval_result_stream *stream)
+{
+	const struct oval_results_stream_handler *handler = stream->handler;
+	if (handler->definition == NULL)
+		return 0;
+
+	char *id = (char *) xmlTextReaderGetAttribute(stream->reader, BAD_CAST "definition_id");
+	int version = oval_parser_int_attribute(stream->reader, "version", 0);
+	int variable_instance = oval_parser_int_attribute(stream->reader, "variable_instance", 1);
+	char *class_str = (char *) xmlTextReaderGetAttribute(stream->reader, BAD_CAST "class");
+	oval_definition_class_t def_class = oval_definition_class_enum(class_str);
+	oval_result_t result = oval_result_parse(stream->reader, "result", OVAL_ENUMERATION_INVALID);
+
+	int ret = handler->definition(id, version, variable_instance, def_class, result, handler->arg);
+	free(class_str);
+	free(id);
+	return ret;
+}
+
+static int _stream_test(struct oval_result_stream *stream)
+{
+	const struct oval_results_stream_handler *handler = stream->handler;
+
+	free(stream->test_id);
+	stream->test_id = (char *) xmlTextReaderGetAttribute(stream->reader, BAD_CAST "test_id");
+	stream->test_variable_instance = oval_parser_int_attribute(stream->reader, "variable_instance", 1);
+	if (handler->test == NULL)
+		return 0;
+
+	int version = oval_parser_int_attribute(stream->reader, "version", 0);
+	oval_result_t result = oval_result_parse(stream->reader, "result", OVAL_ENUMERATION_INVALID);
+
+	return handler->test(stream->test_id, version, stream->test_variable_instance, result, handler->arg);
+}
+
+static int _stream_tested_item(struct oval_result_stream *stream)
+{
+	const struct oval_results_stream_handler *handler = stream->handler;
+
+	char *item_id = (char *) xmlTextReaderGetAttribute(stream->reader, BAD_CAST "item_id");
+	oval_result_t result = oval_result_parse(stream->reader, "result", OVAL_ENUMERATION_INVALID);
+
+	int ret = handler->tested_item(stream->test_id, stream->test_variable_instance, item_id, result, handler->arg);
+	free(item_id);
+	return ret;
+}
+
+static int _stream_item(struct oval_result_stream *stream)
+{
+	const struct oval_results_stream_handler *handler = stream->handler;
+
+	char *id = (char *) xmlTextReaderGetAttribute(stream->reader, BAD_CAST "id");
+	const char *type = (const char *) xmlTextReaderConstLocalName(stream->reader);
+	oval_syschar_status_t status = oval_syschar_status_parse(stream->reader, "status", SYSCHAR_STATUS_EXISTS);
+
+	int ret = handler->item(id, type, status, handler->arg);
+	free(id);
+	return ret;
+}
+
+/*
+ * Process the element the reader is positioned at.
+ * @param descend set to true if the children of the element are of interest
+ */
+static int _stream_element(struct oval_result_stream *stream, bool *descend)
+{
+	const struct oval_results_stream_handler *handler = stream->handler;
+	const char *name = (const char *) xmlTextReaderConstLocalName(stream->reader);
+	int depth = xmlTextReaderDepth(stream->reader);
+
+	*descend = false;
+	switch (depth) {
+	case 0: {
+		const char *namespace = (const char *) xmlTextReaderConstNamespaceUri(stream->reader);
+		if (namespace == NULL || strcmp(namespace, (const char *) OVAL_RESULTS_NAMESPACE) != 0 ||
+				strcmp(name, OVAL_ROOT_ELM_RESULTS) != 0) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Missing \"oval_results\" element");
+			return -1;
+		}
+		stream->has_root = true;
+		*descend = true;
+		return 0;
+	}
+	case 1:
+		*descend = (strcmp(name, "results") == 0);
+		return 0;
+	case 2:
+		if (strcmp(name, "system") != 0)
+			return 0;
+		*descend = true;
+		stream->section = OVAL_RESULT_STREAM_NONE;
+		return handler->system ? handler->system(stream->system_index++, handler->arg) : 0;
+	case 3:
+		if (strcmp(name, "definitions") == 0) {
+			stream->section = OVAL_RESULT_STREAM_DEFINITIONS;
+			*descend = (handler->definition != NULL);
+		} else if (strcmp(name, "tests") == 0) {
+			stream->section = OVAL_RESULT_STREAM_TESTS;
+			*descend = (handler->test != NULL || handler->tested_item != NULL);
+		} else if (strcmp(name, OVAL_ROOT_ELM_SYSCHARS) == 0) {
+			/* usually the biggest part of the document, read it only on demand */
+			stream->section = OVAL_RESULT_STREAM_SYSCHAR;
+			*descend = (handler->item != NULL);
+		} else {
+			stream->section = OVAL_RESULT_STREAM_NONE;
+		}
+		return 0;
+	case 4:
+		switch (stream->section) {
+		case OVAL_RESULT_STREAM_DEFINITIONS:
+			return (strcmp(name, "definition") == 0) ? _stream_definition(stream) : 0;
+		case OVAL_RESULT_STREAM_TESTS:
+			if (strcmp(name, "test") != 0)
+				return 0;
+			*descend = (handler->tested_item != NULL);
+			return _stream_test(stream);
+		case OVAL_RESULT_STREAM_SYSCHAR:
+			*descend = (strcmp(name, "system_data") == 0);
+			return 0;
+		default:
+			return 0;
+		}
+	case 5:
+		if (stream->section == OVAL_RESULT_STREAM_TESTS && strcmp(name, "tested_item") == 0)
+			return _stream_tested_item(stream);
+		if (stream->section == OVAL_RESULT_STREAM_SYSCHAR)
+			return _stream_item(stream);
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+int oval_results_stream_source(struct oscap_source *source, const struct oval_results_stream_handler *handler)
+{
+	__attribute__nonnull__(source);
+	__attribute__nonnull__(handler);
+
+	struct oval_result_stream stream = {
+		.reader = oscap_source_get_streaming_xmlTextReader(source),
+		.handler = handler,
+	};
+	if (stream.reader == NULL)
+		return -1;
+
+	int ret = 0;
+	int rc = xmlTextReaderRead(stream.reader);
+	while (rc == 1) {
+		bool descend = true;
+		if (xmlTextReaderNodeType(stream.reader) == XML_READER_TYPE_ELEMENT) {
+			ret = _stream_element(&stream, &descend);
+			if (ret != 0)
+				break;
+		}
+		/* subtrees of no interest are skipped without being expanded */
+		rc = descend ? xmlTextReaderRead(stream.reader) : xmlTextReaderNext(stream.reader);
+	}
+
+	if (rc == -1) {
+		oscap_setxmlerr(xmlGetLastError());
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not read OVAL Results from '%s'.", oscap_source_readable_origin(source));
+		ret = -1;
+	} else if (ret == 0 && !stream.has_root) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Missing \"oval_results\" element");
+		ret = -1;
+	}
+
+	free(stream.test_id);
+	xmlFreeTextReader(stream.reader);
+	return ret;
+}
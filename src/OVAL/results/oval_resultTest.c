@@ -381,6 +381,39 @@ oval_result_t ores_get_result_byopr(struct oresults *ores, oval_operator_t op)
 	return result;
 }
 
+/* Whether more results could no longer change ores_get_result_bychk() */
+bool ores_is_decided_bychk(const struct oresults *ores, oval_check_t check)
+{
+	switch (check) {
+	case OVAL_CHECK_ALL:
+		return ores->false_cnt > 0;
+	case OVAL_CHECK_AT_LEAST_ONE:
+		return ores->true_cnt > 0;
+	case OVAL_CHECK_NONE_EXIST:
+	case OVAL_CHECK_NONE_SATISFY:
+		return ores->true_cnt > 0;
+	case OVAL_CHECK_ONLY_ONE:
+		return ores->true_cnt > 1;
+	default:
+		return false;
+	}
+}
+
+/* Whether more results could no longer change ores_get_result_byopr() */
+bool ores_is_decided_byopr(const struct oresults *ores, oval_operator_t op)
+{
+	switch (op) {
+	case OVAL_OPERATOR_AND:
+		return ores->false_cnt > 0;
+	case OVAL_OPERATOR_OR:
+		return ores->true_cnt > 0;
+	case OVAL_OPERATOR_ONE:
+		return ores->true_cnt > 1;
+	default:
+		return false;
+	}
+}
+
 static inline oval_result_t _evaluate_sysent_with_variable(struct oval_syschar_model *syschar_model, struct oval_entity *state_entity, struct oval_sysent *item_entity, oval_operation_t state_entity_operation, struct oval_state_content *content)
 {
 	oval_syschar_collection_flag_t flag;
@@ -505,10 +538,206 @@ static oval_result_t _evaluate_sysent_record(struct oval_state_content *state_co
 	return ores_get_result_byopr(&record_ores, OVAL_OPERATOR_AND);
 }
 
-static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_model, struct oval_sysent *item_entity, struct oval_entity *state_entity, oval_operation_t state_entity_operation, struct oval_state_content *content)
+/* Items are compared with the states of a test in batches. The entities of
+ * the items in a batch are sorted into columns, one column per state entity,
+ * and every state entity is then compared with its whole column. */
+#define OVAL_ITEM_BATCH_SIZE 256
+
+struct oval_column_entry {
+	int item;				///< index of the item in the batch
+	struct oval_sysent *sysent;
+};
+
+struct oval_column {
+	struct oval_column_entry *entries;
+	int count;
+	int size;
+};
+
+/* State content prepared for comparisons: the entity name and attributes are
+ * looked up and the values of the entity are compiled only once per test. */
+struct oval_compiled_content {
+	struct oval_state_content *content;
+	struct oval_entity *entity;
+	const char *name;
+	oval_operation_t operation;
+	oval_check_t entity_check;
+	oval_existence_t check_existence;
+	bool mask;
+	struct oval_cmp_value **values;		///< NULL if the entity is compared the usual way
+	int value_count;
+};
+
+struct oval_compiled_state {
+	struct oval_state *state;
+	oval_operator_t operator;
+	bool invalid;				///< every item compared with the state is an error
+	struct oval_compiled_content *contents;	///< in the order of oval_state_get_contents()
+	struct oval_column *columns;		///< one per content
+	int content_count;
+};
+
+struct oval_item_batch {
+	int count;
+	struct oval_result_item *ritems[OVAL_ITEM_BATCH_SIZE];
+	struct oval_sysitem *items[OVAL_ITEM_BATCH_SIZE];
+	struct oval_status_counter counters[OVAL_ITEM_BATCH_SIZE];
+	bool invalid[OVAL_ITEM_BATCH_SIZE];		///< the item has a NULL entity
+	struct oresults item_ores[OVAL_ITEM_BATCH_SIZE];	///< results of the states compared so far
+	/* used while comparing the items with one state */
+	bool pending[OVAL_ITEM_BATCH_SIZE];
+	bool failed[OVAL_ITEM_BATCH_SIZE];
+	struct oresults ste_ores[OVAL_ITEM_BATCH_SIZE];
+	struct oresults ent_ores[OVAL_ITEM_BATCH_SIZE];
+	bool fast_verdict;		///< skip comparisons which can't change the decided results
+};
+
+static struct oval_cmp_value **_oval_compile_variable_values(struct oval_syschar_model *syschar_model, struct oval_entity *state_entity, oval_operation_t operation, int *count)
+{
+	struct oval_variable *variable = oval_entity_get_variable(state_entity);
+	if (variable == NULL || oval_syschar_model_compute_variable(syschar_model, variable) != 0)
+		return NULL;
+	oval_syschar_collection_flag_t flag = oval_variable_get_collection_flag(variable);
+	if (flag != SYSCHAR_FLAG_COMPLETE && flag != SYSCHAR_FLAG_INCOMPLETE)
+		return NULL;
+
+	struct oval_collection *values = oval_collection_new();
+	bool valid = true;
+	struct oval_value_iterator *val_itr = oval_variable_get_values(variable);
+	while (valid && oval_value_iterator_has_more(val_itr)) {
+		struct oval_value *value = oval_value_iterator_next(val_itr);
+		const char *text = oval_value_get_text(value);
+		/* errors are left to _evaluate_sysent_with_variable() */
+		if (text == NULL)
+			valid = false;
+		else
+			oval_collection_add(values, oval_cmp_value_new(text, oval_value_get_datatype(value), operation));
+	}
+	oval_value_iterator_free(val_itr);
+
+	struct oval_cmp_value **compiled = NULL;
+	*count = 0;
+	if (valid) {
+		struct oval_iterator *it = oval_collection_iterator(values);
+		compiled = malloc((oval_collection_iterator_remaining(it) + 1) * sizeof(struct oval_cmp_value *));
+		while (oval_collection_iterator_has_more(it))
+			compiled[(*count)++] = oval_collection_iterator_next(it);
+		oval_collection_iterator_free(it);
+		oval_collection_free(values);
+	} else {
+		oval_collection_free_items(values, (oscap_destruct_func) oval_cmp_value_free);
+	}
+	return compiled;
+}
+
+static const char *_oval_state_entity_name(struct oval_state *state, struct oval_entity *state_entity)
+{
+	const char *state_entity_name = oval_entity_get_name(state_entity);
+
+	if (oscap_streq(state_entity_name, "line") &&
+		oval_state_get_subtype(state) == (oval_subtype_t) OVAL_INDEPENDENT_TEXT_FILE_CONTENT) {
+		/* Hack: textfilecontent_state/line shall be compared against textfilecontent_item/text.
+		 *
+		 * textfilecontent_test and textfilecontent54_test share the same syschar
+		 * (textfilecontent_item). In OVAL 5.3 and below this syschar did not hold any usable
+		 * information ('text' ent). In OVAL 5.4 textfilecontent_test was deprecated. But the
+		 * 'text' ent has been added to textfilecontent_item, making it potentially usable. */
+		oval_schema_version_t over = oval_state_get_platform_schema_version(state);
+		if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.4)) >= 0) {
+			/* The OVAL-5.3 does not have textfilecontent_item/text */
+			state_entity_name = "text";
+		}
+	}
+	return state_entity_name;
+}
+
+static void _oval_compiled_state_init(struct oval_compiled_state *compiled, struct oval_syschar_model *syschar_model, struct oval_state *state)
+{
+	compiled->state = state;
+	compiled->operator = oval_state_get_operator(state);
+	compiled->invalid = false;
+	compiled->content_count = 0;
+	struct oval_state_content_iterator *contents = oval_state_get_contents(state);
+	int size = oval_collection_iterator_remaining((struct oval_iterator *) contents) + 1;
+	compiled->contents = calloc(size, sizeof(struct oval_compiled_content));
+	compiled->columns = calloc(size, sizeof(struct oval_column));
+	while (oval_state_content_iterator_has_more(contents)) {
+		struct oval_state_content *content = oval_state_content_iterator_next(contents);
+		struct oval_compiled_content *cc = &compiled->contents[compiled->content_count++];
+
+		if (content == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL state content");
+			compiled->invalid = true;
+			break;
+		}
+		if ((cc->entity = oval_state_content_get_entity(content)) == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity");
+			compiled->invalid = true;
+			break;
+		}
+		if ((cc->name = _oval_state_entity_name(state, cc->entity)) == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity name");
+			compiled->invalid = true;
+			break;
+		}
+		cc->content = content;
+		cc->operation = oval_entity_get_operation(cc->entity);
+		cc->entity_check = oval_state_content_get_ent_check(content);
+		cc->check_existence = oval_state_content_get_check_existence(content);
+		cc->mask = oval_entity_get_mask(cc->entity);
+
+		if (oval_entity_get_varref_type(cc->entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
+			cc->values = _oval_compile_variable_values(syschar_model, cc->entity, cc->operation, &cc->value_count);
+		} else if (oval_entity_get_datatype(cc->entity) != OVAL_DATATYPE_RECORD) {
+			struct oval_value *value = oval_entity_get_value(cc->entity);
+			const char *text = value != NULL ? oval_value_get_text(value) : NULL;
+			if (text == NULL)
+				continue;
+			cc->values = malloc(sizeof(struct oval_cmp_value *));
+			cc->values[0] = oval_cmp_value_new(text, oval_value_get_datatype(value), cc->operation);
+			cc->value_count = 1;
+		}
+	}
+	oval_state_content_iterator_free(contents);
+}
+
+static void _oval_compiled_state_clear(struct oval_compiled_state *compiled)
+{
+	for (int i = 0; i < compiled->content_count; i++) {
+		struct oval_compiled_content *cc = &compiled->contents[i];
+		for (int j = 0; j < cc->value_count; j++)
+			oval_cmp_value_free(cc->values[j]);
+		free(cc->values);
+		free(compiled->columns[i].entries);
+	}
+	free(compiled->contents);
+	free(compiled->columns);
+}
+
+static oval_result_t _evaluate_sysent_compiled(const struct oval_compiled_content *compiled, struct oval_entity *state_entity, struct oval_sysent *item_entity, struct oval_state_content *content)
+{
+	if (oval_entity_get_varref_type(state_entity) != OVAL_ENTITY_VARREF_ATTRIBUTE)
+		return oval_ent_cmp_value(compiled->values[0], item_entity);
+
+	struct oresults var_ores;
+	ores_clear(&var_ores);
+	for (int i = 0; i < compiled->value_count; i++) {
+		oval_result_t var_val_res = oval_ent_cmp_value(compiled->values[i], item_entity);
+		if (var_val_res == OVAL_RESULT_ERROR) {
+			dE("Error occured when comparing a variable '%s' value with collected item entity = '%s'",
+				oval_variable_get_id(oval_entity_get_variable(state_entity)), oval_sysent_get_value(item_entity));
+		}
+		ores_add_res(&var_ores, var_val_res);
+	}
+	return ores_get_result_bychk(&var_ores, oval_state_content_get_var_check(content));
+}
+
+static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_model, struct oval_sysent *item_entity, struct oval_entity *state_entity, oval_operation_t state_entity_operation, struct oval_state_content *content, const struct oval_compiled_content *compiled)
 {
 	if (oval_sysent_get_status(item_entity) == SYSCHAR_STATUS_DOES_NOT_EXIST) {
 		return OVAL_RESULT_FALSE;
+	} else if (compiled != NULL && compiled->values != NULL) {
+		return _evaluate_sysent_compiled(compiled, state_entity, item_entity, content);
 	} else if (oval_entity_get_varref_type(state_entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
 
 		return _evaluate_sysent_with_variable(syschar_model,
@@ -542,137 +771,157 @@ static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_
 	}
 }
 
-static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct oval_sysitem *cur_sysitem, struct oval_state *state)
+static void _oval_column_add(struct oval_column *column, int item, struct oval_sysent *sysent)
 {
-	struct oval_state_content_iterator *state_contents_itr;
-	struct oresults ste_ores;
-	oval_operator_t operator;
-	oval_result_t result = OVAL_RESULT_ERROR;
-
-	ores_clear(&ste_ores);
-
-	state_contents_itr = oval_state_get_contents(state);
-	while (oval_state_content_iterator_has_more(state_contents_itr)) {
-		struct oval_state_content *content;
-		struct oval_entity *state_entity;
-		char *state_entity_name;
-		oval_operation_t state_entity_operation;
-		oval_check_t entity_check;
-		oval_existence_t check_existence;
-		oval_result_t ste_ent_res;
-		struct oval_sysent_iterator *item_entities_itr;
-		struct oresults ent_ores;
-		struct oval_status_counter counter;
-		bool found_matching_item;
-
-		if ((content = oval_state_content_iterator_next(state_contents_itr)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL state content");
-			goto fail;
-		}
-		if ((state_entity = oval_state_content_get_entity(content)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity");
-			goto fail;
-		}
-		if ((state_entity_name = oval_entity_get_name(state_entity)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity name");
-			goto fail;
-		}
-
-		if (oscap_streq(state_entity_name, "line") &&
-			oval_state_get_subtype(state) == (oval_subtype_t) OVAL_INDEPENDENT_TEXT_FILE_CONTENT) {
-			/* Hack: textfilecontent_state/line shall be compared against textfilecontent_item/text.
-			 *
-			 * textfilecontent_test and textfilecontent54_test share the same syschar
-			 * (textfilecontent_item). In OVAL 5.3 and below this syschar did not hold any usable
-			 * information ('text' ent). In OVAL 5.4 textfilecontent_test was deprecated. But the
-			 * 'text' ent has been added to textfilecontent_item, making it potentially usable. */
-			oval_schema_version_t over = oval_state_get_platform_schema_version(state);
-			if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.4)) >= 0) {
-				/* The OVAL-5.3 does not have textfilecontent_item/text */
-				state_entity_name = "text";
-			}
-		}
+	if (column->count == column->size) {
+		column->size = column->size ? 2 * column->size : 32;
+		column->entries = realloc(column->entries, column->size * sizeof(struct oval_column_entry));
+	}
+	column->entries[column->count].item = item;
+	column->entries[column->count].sysent = sysent;
+	column->count++;
+}
 
-		entity_check = oval_state_content_get_ent_check(content);
-		check_existence = oval_state_content_get_check_existence(content);
-		state_entity_operation = oval_entity_get_operation(state_entity);
+/* Sort the entities of the pending items into the columns of the state */
+static void _oval_item_batch_transpose(struct oval_item_batch *batch, struct oval_compiled_state *compiled)
+{
+	for (int c = 0; c < compiled->content_count; c++)
+		compiled->columns[c].count = 0;
 
-		ores_clear(&ent_ores);
-		found_matching_item = false;
-		oval_status_counter_clear(&counter);
+	for (int i = 0; i < batch->count; i++) {
+		if (!batch->pending[i] || batch->failed[i])
+			continue;
 
-		item_entities_itr = oval_sysitem_get_sysents(cur_sysitem);
+		struct oval_sysent_iterator *item_entities_itr = oval_sysitem_get_sysents(batch->items[i]);
 		while (oval_sysent_iterator_has_more(item_entities_itr)) {
-			struct oval_sysent *item_entity;
-			oval_result_t ent_val_res;
-			char *item_entity_name;
-			oval_syschar_status_t item_status;
-
-			item_entity = oval_sysent_iterator_next(item_entities_itr);
-			if (item_entity == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
-				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
+			struct oval_sysent *item_entity = oval_sysent_iterator_next(item_entities_itr);
+			const char *item_entity_name = oval_sysent_get_name(item_entity);
+			for (int c = 0; c < compiled->content_count; c++) {
+				const struct oval_compiled_content *cc = &compiled->contents[c];
+				if (strcmp(item_entity_name, cc->name))
+					continue;
+				/* copy mask attribute from state to item */
+				if (cc->mask)
+					oval_sysent_set_mask(item_entity, 1);
+				_oval_column_add(&compiled->columns[c], i, item_entity);
 			}
-			item_status = oval_sysent_get_status(item_entity);
-			oval_status_counter_add_status(&counter, item_status);
+		}
+		oval_sysent_iterator_free(item_entities_itr);
 
-			item_entity_name = oval_sysent_get_name(item_entity);
-			if (strcmp(item_entity_name, state_entity_name))
-				continue;
+		for (int c = 0; c < compiled->content_count; c++) {
+			const struct oval_column *column = &compiled->columns[c];
+			if (column->count == 0 || column->entries[column->count - 1].item != i)
+				dW("Entity name '%s' from state (id: '%s') not found in item (id: '%s').",
+				   compiled->contents[c].name, oval_state_get_id(compiled->state),
+				   oval_sysitem_get_id(batch->items[i]));
+		}
+	}
+}
 
-			found_matching_item = true;
+/* Compare one state entity with its column. For the fast verdict, entities of
+ * items whose result is already decided by the entity check or by the state
+ * operator are skipped. Otherwise all of them are compared, a failing
+ * comparison makes the result an error. */
+static void _oval_column_eval(struct oval_syschar_model *syschar_model, struct oval_item_batch *batch,
+		const struct oval_compiled_state *compiled, int c)
+{
+	const struct oval_compiled_content *cc = &compiled->contents[c];
+	const struct oval_column *column = &compiled->columns[c];
 
-			/* copy mask attribute from state to item */
-			if (oval_entity_get_mask(state_entity))
-				oval_sysent_set_mask(item_entity,1);
+	for (int i = 0; i < batch->count; i++)
+		ores_clear(&batch->ent_ores[i]);
 
-			ent_val_res = _evaluate_sysent(syschar_model, item_entity, state_entity,
-					state_entity_operation, content);
-			if (ent_val_res == OVAL_RESULT_TRUE) {
-				dI("Entity '%s'='%s' of item '%s' matches corresponding entity in state '%s'.",
-						oval_sysent_get_name(item_entity),
-						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
-			}
-			if (ent_val_res == OVAL_RESULT_ERROR) {
-				dI("Comparing entity '%s'='%s' of item '%s' to corresponding entity in state '%s' was not successful.",
-						oval_sysent_get_name(item_entity),
-						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
-			}
-			if (((signed) ent_val_res) == -1) {
-				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
-			}
+	for (int e = 0; e < column->count; e++) {
+		int i = column->entries[e].item;
+		struct oval_sysent *item_entity = column->entries[e].sysent;
+		if (batch->failed[i])
+			continue;
+		if (batch->fast_verdict &&
+		    (ores_is_decided_bychk(&batch->ent_ores[i], cc->entity_check) ||
+		     ores_is_decided_byopr(&batch->ste_ores[i], compiled->operator)))
+			continue;
 
-			ores_add_res(&ent_ores, ent_val_res);
+		oval_result_t ent_val_res = _evaluate_sysent(syschar_model, item_entity, cc->entity,
+				cc->operation, cc->content, cc);
+		if (ent_val_res == OVAL_RESULT_TRUE) {
+			dI("Entity '%s'='%s' of item '%s' matches corresponding entity in state '%s'.",
+					oval_sysent_get_name(item_entity),
+					oval_sysent_get_value(item_entity),
+					oval_sysitem_get_id(batch->items[i]), oval_state_get_id(compiled->state));
 		}
-		oval_sysent_iterator_free(item_entities_itr);
-
-		if (!found_matching_item)
-			dW("Entity name '%s' from state (id: '%s') not found in item (id: '%s').",
-			   state_entity_name, oval_state_get_id(state), oval_sysitem_get_id(cur_sysitem));
+		if (ent_val_res == OVAL_RESULT_ERROR) {
+			dI("Comparing entity '%s'='%s' of item '%s' to corresponding entity in state '%s' was not successful.",
+					oval_sysent_get_name(item_entity),
+					oval_sysent_get_value(item_entity),
+					oval_sysitem_get_id(batch->items[i]), oval_state_get_id(compiled->state));
+		}
+		if (((signed) ent_val_res) == -1) {
+			batch->failed[i] = true;
+			continue;
+		}
+		ores_add_res(&batch->ent_ores[i], ent_val_res);
+	}
 
-		ste_ent_res = ores_get_result_bychk(&ent_ores, entity_check);
-		ores_add_res(&ste_ores, ste_ent_res);
-		oval_result_t cres = oval_status_counter_get_result(&counter, check_existence);
-		ores_add_res(&ste_ores, cres);
+	for (int i = 0; i < batch->count; i++) {
+		if (!batch->pending[i] || batch->failed[i])
+			continue;
+		if (batch->fast_verdict && ores_is_decided_byopr(&batch->ste_ores[i], compiled->operator))
+			continue;
+		ores_add_res(&batch->ste_ores[i], ores_get_result_bychk(&batch->ent_ores[i], cc->entity_check));
+		ores_add_res(&batch->ste_ores[i], oval_status_counter_get_result(&batch->counters[i], cc->check_existence));
 	}
-	oval_state_content_iterator_free(state_contents_itr);
+}
 
-	operator = oval_state_get_operator(state);
-	result = ores_get_result_byopr(&ste_ores, operator);
-	dI("Item '%s' compared to state '%s' with result %s.",
-			   oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state),
-			   oval_result_get_text(result));
+/* Compare the items of the batch with one state of the test */
+static void _oval_item_batch_eval_state(struct oval_syschar_model *syschar_model, struct oval_item_batch *batch,
+		struct oval_compiled_state *compiled, oval_operator_t ste_opr)
+{
+	for (int i = 0; i < batch->count; i++) {
+		/* for the fast verdict, the result of the item is known without this state */
+		batch->pending[i] = !batch->fast_verdict || !ores_is_decided_byopr(&batch->item_ores[i], ste_opr);
+		batch->failed[i] = batch->invalid[i] || compiled->invalid;
+		ores_clear(&batch->ste_ores[i]);
+	}
 
-	return result;
+	if (!compiled->invalid) {
+		_oval_item_batch_transpose(batch, compiled);
+		for (int c = 0; c < compiled->content_count; c++)
+			_oval_column_eval(syschar_model, batch, compiled, c);
+	}
 
- fail:
-	oval_state_content_iterator_free(state_contents_itr);
+	for (int i = 0; i < batch->count; i++) {
+		if (!batch->pending[i])
+			continue;
+		oval_result_t result = batch->failed[i] ? OVAL_RESULT_ERROR :
+			ores_get_result_byopr(&batch->ste_ores[i], compiled->operator);
+		dI("Item '%s' compared to state '%s' with result %s.",
+				   oval_sysitem_get_id(batch->items[i]), oval_state_get_id(compiled->state),
+				   oval_result_get_text(result));
+		ores_add_res(&batch->item_ores[i], result);
+	}
+}
 
-	return OVAL_RESULT_ERROR;
+static void _oval_item_batch_add(struct oval_item_batch *batch, struct oval_result_item *ritem, struct oval_sysitem *item)
+{
+	int i = batch->count++;
+	batch->ritems[i] = ritem;
+	batch->items[i] = item;
+	batch->invalid[i] = false;
+	ores_clear(&batch->item_ores[i]);
+
+	/* statuses of all the entities of the item, used for check_existence of state entities */
+	oval_status_counter_clear(&batch->counters[i]);
+	struct oval_sysent_iterator *item_entities_itr = oval_sysitem_get_sysents(item);
+	while (oval_sysent_iterator_has_more(item_entities_itr)) {
+		struct oval_sysent *item_entity = oval_sysent_iterator_next(item_entities_itr);
+		if (item_entity == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
+			batch->invalid[i] = true;
+			break;
+		}
+		oval_status_counter_add_status(&batch->counters[i], oval_sysent_get_status(item_entity));
+	}
+	oval_sysent_iterator_free(item_entities_itr);
 }
 
 #define ITEMMAP (struct oval_string_map    *)args[2]
@@ -691,6 +940,22 @@ static void _oval_test_item_consumer(struct oval_result_item *item, void **args)
 	}
 }
 
+static void _oval_item_batch_eval(struct oval_syschar_model *syschar_model, struct oval_item_batch *batch,
+		struct oval_compiled_state *compiled_states, int state_count, oval_operator_t ste_opr,
+		bool item_results, struct oresults *item_ores)
+{
+	for (int s = 0; s < state_count; s++)
+		_oval_item_batch_eval_state(syschar_model, batch, &compiled_states[s], ste_opr);
+
+	for (int i = 0; i < batch->count; i++) {
+		oval_result_t item_res = ores_get_result_byopr(&batch->item_ores[i], ste_opr);
+		ores_add_res(item_ores, item_res);
+		if (item_results)
+			oval_result_item_set_result(batch->ritems[i], item_res);
+	}
+	batch->count = 0;
+}
+
 static oval_result_t eval_check_state(struct oval_test *test, void **args)
 {
 	struct oval_syschar_model *syschar_model;
@@ -705,6 +970,11 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 	syschar_model = oval_result_system_get_syschar_model(SYSTEM);
 	ores_clear(&item_ores);
 
+	/* results of individual items are not needed for the fast verdict */
+	struct oval_results_model *results_model = oval_result_system_get_results_model(SYSTEM);
+	bool fast_verdict = oval_results_model_get_fast_verdict(results_model);
+	bool item_results = !fast_verdict;
+
 	char *state_names = oval_test_get_state_names(test);
 	if (state_names) {
 		dI("In test '%s' %s of the collected items must satisfy these states: %s.",
@@ -712,13 +982,28 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 		free(state_names);
 	}
 
+	/* The states are compared with every item, compile them only once */
+	int state_count = 0;
+	struct oval_state_iterator *ste_itr = oval_test_get_states(test);
+	struct oval_compiled_state *compiled_states = calloc(oval_collection_iterator_remaining((struct oval_iterator *) ste_itr) + 1,
+			sizeof(struct oval_compiled_state));
+	while (oval_state_iterator_has_more(ste_itr))
+		_oval_compiled_state_init(&compiled_states[state_count++], syschar_model, oval_state_iterator_next(ste_itr));
+	oval_state_iterator_free(ste_itr);
+
+	struct oval_item_batch *batch = malloc(sizeof(struct oval_item_batch));
+	batch->count = 0;
+	batch->fast_verdict = fast_verdict;
+	/* For the fast verdict the batches start with a single item and grow,
+	 * so that the evaluation stops soon after the item deciding the check. */
+	int batch_limit = fast_verdict ? 1 : OVAL_ITEM_BATCH_SIZE;
+	bool decided = false;
+
 	ritems_itr = oval_result_test_get_items(TEST);
-	while (oval_result_item_iterator_has_more(ritems_itr)) {
+	while (!decided && oval_result_item_iterator_has_more(ritems_itr)) {
 		struct oval_result_item *ritem;
 		struct oval_sysitem *item;
 		oval_syschar_status_t item_status;
-		struct oresults ste_ores;
-		struct oval_state_iterator *ste_itr;
 		oval_result_t item_res;
 
 		ritem = oval_result_item_iterator_next(ritems_itr);
@@ -730,35 +1015,37 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 		case SYSCHAR_STATUS_NOT_COLLECTED:
 			item_res = OVAL_RESULT_ERROR;
 			ores_add_res(&item_ores, item_res);
-			oval_result_item_set_result(ritem, item_res);
+			if (item_results)
+				oval_result_item_set_result(ritem, item_res);
+			decided = fast_verdict && ores_is_decided_bychk(&item_ores, ste_check);
 			continue;
 		case SYSCHAR_STATUS_DOES_NOT_EXIST:
 			item_res = OVAL_RESULT_FALSE;
 			ores_add_res(&item_ores, item_res);
-			oval_result_item_set_result(ritem, item_res);
+			if (item_results)
+				oval_result_item_set_result(ritem, item_res);
+			decided = fast_verdict && ores_is_decided_bychk(&item_ores, ste_check);
 			continue;
 		default:
 			break;
 		}
 
-		ores_clear(&ste_ores);
-
-		ste_itr = oval_test_get_states(test);
-		while (oval_state_iterator_has_more(ste_itr)) {
-			struct oval_state *ste;
-			oval_result_t ste_res;
-
-			ste = oval_state_iterator_next(ste_itr);
-			ste_res = eval_item(syschar_model, item, ste);
-			ores_add_res(&ste_ores, ste_res);
+		_oval_item_batch_add(batch, ritem, item);
+		if (batch->count == batch_limit) {
+			_oval_item_batch_eval(syschar_model, batch, compiled_states, state_count, ste_opr, item_results, &item_ores);
+			decided = fast_verdict && ores_is_decided_bychk(&item_ores, ste_check);
+			if (batch_limit < OVAL_ITEM_BATCH_SIZE)
+				batch_limit *= 2;
 		}
-		oval_state_iterator_free(ste_itr);
-
-		item_res = ores_get_result_byopr(&ste_ores, ste_opr);
-		ores_add_res(&item_ores, item_res);
-		oval_result_item_set_result(ritem, item_res);
 	}
 	oval_result_item_iterator_free(ritems_itr);
+	if (batch->count > 0 && !decided)
+		_oval_item_batch_eval(syschar_model, batch, compiled_states, state_count, ste_opr, item_results, &item_ores);
+
+	free(batch);
+	for (int i = 0; i < state_count; i++)
+		_oval_compiled_state_clear(&compiled_states[i]);
+	free(compiled_states);
 
 	result = ores_get_result_bychk(&item_ores, ste_check);
 
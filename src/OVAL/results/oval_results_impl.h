@@ -89,12 +89,28 @@ int ores_add_res(struct oresults *ores, oval_result_t res);
 void ores_clear(struct oresults *ores);
 oval_result_t ores_get_result_bychk(struct oresults *ores, oval_check_t check);
 oval_result_t ores_get_result_byopr(struct oresults *ores, oval_operator_t op);
+bool ores_is_decided_bychk(const struct oresults *ores, oval_check_t check);
+bool ores_is_decided_byopr(const struct oresults *ores, oval_operator_t op);
 
 #if defined(OVAL_PROBES_ENABLED)
 struct oval_results_model *oval_results_model_new_with_probe_session(struct oval_definition_model *definition_model, struct oval_syschar_model **syschar_models, struct oval_probe_session *probe_session);
 #endif
 struct oval_probe_session *oval_results_model_get_probe_session(struct oval_results_model *model);
 void oval_results_model_add_system(struct oval_results_model *, struct oval_result_system *);
+/**
+ * Drop all result systems of the model and start over with the given
+ * system characteristics. Directives and settings of the model are kept.
+ */
+void oval_results_model_reset_systems(struct oval_results_model *model, struct oval_syschar_model **syschar_models);
+/**
+ * Set the fast verdict evaluation mode. Only the results of definitions are
+ * needed then, which is the case for thin results: results of items are not
+ * recorded, evaluation of a test stops at the first item which decides its
+ * check and evaluation of criteria stops at the first child which decides
+ * the operator. Tests which are not evaluated do not collect their objects.
+ */
+void oval_results_model_set_fast_verdict(struct oval_results_model *model, bool fast_verdict);
+bool oval_results_model_get_fast_verdict(struct oval_results_model *model);
 
 struct oval_result_definition_iterator *oval_result_definition_iterator_new(struct oval_smc *mapping);
 struct oval_result_test_iterator *oval_result_test_iterator_new(struct oval_smc *mapping);
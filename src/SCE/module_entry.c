@@ -31,10 +31,29 @@
 
 #include "sce_engine_api.h"
 #include "XCCDF_POLICY/public/check_engine_plugin.h"
+#include "common/debug_priv.h"
 
 #include <libgen.h>
+#include <stdlib.h>
 #include <string.h>
 
+/* Limits of the scripts can be set in the environment, there are no
+ * command line options for them. */
+static unsigned long sce_engine_env_limit(const char *name)
+{
+	const char *value = getenv(name);
+	if (value == NULL || *value == '\0')
+		return 0;
+
+	char *end;
+	unsigned long limit = strtoul(value, &end, 10);
+	if (*end != '\0') {
+		dW("Invalid value of %s: '%s'", name, value);
+		return 0;
+	}
+	return limit;
+}
+
 static int sce_engine_register(struct xccdf_policy_model *model, const char *path_hint, void **user_data)
 {
 	struct sce_parameters *parameters = (struct sce_parameters*) *user_data;
@@ -44,6 +63,8 @@ static int sce_engine_register(struct xccdf_policy_model *model, const char *pat
 	parameters = sce_parameters_new();
 	sce_parameters_set_xccdf_directory(parameters, path_hint);
 	sce_parameters_allocate_session(parameters);
+	sce_parameters_set_timeout(parameters, sce_engine_env_limit("OSCAP_SCE_TIMEOUT"));
+	sce_parameters_set_memory_limit(parameters, sce_engine_env_limit("OSCAP_SCE_MEMORY_LIMIT"));
 
 	*user_data = (void*)parameters; // This way the data will get freed later
 
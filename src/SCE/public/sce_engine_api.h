@@ -210,6 +210,35 @@ OSCAP_API void sce_parameters_set_xccdf_directory(struct sce_parameters* v, cons
  */
 OSCAP_API const char* sce_parameters_get_xccdf_directory(struct sce_parameters* v);
 
+/**
+ * Sets the wall-clock time limit of a script check
+ *
+ * The script and the processes it started are killed when the limit is
+ * exceeded and the check results in XCCDF_RESULT_ERROR.
+ *
+ * @param seconds time limit in seconds, 0 means no limit (default)
+ * @memberof sce_parameters
+ */
+OSCAP_API void sce_parameters_set_timeout(struct sce_parameters* v, unsigned int seconds);
+
+/**
+ * @memberof sce_parameters
+ */
+OSCAP_API unsigned int sce_parameters_get_timeout(struct sce_parameters* v);
+
+/**
+ * Sets the limit of the address space of a script check
+ *
+ * @param megabytes memory limit in MiB, 0 means no limit (default)
+ * @memberof sce_parameters
+ */
+OSCAP_API void sce_parameters_set_memory_limit(struct sce_parameters* v, size_t megabytes);
+
+/**
+ * @memberof sce_parameters
+ */
+OSCAP_API size_t sce_parameters_get_memory_limit(struct sce_parameters* v);
+
 /**
  * Sets SCE session to use for check results storage
  *
@@ -36,6 +36,7 @@
 #include "common/oscap_string.h"
 #include "common/debug_priv.h"
 #include "sce_engine_api.h"
+#include "XCCDF_POLICY/public/check_engine_plugin.h"
 #include "oscap_helpers.h"
 
 #include <stdlib.h>
@@ -53,6 +54,11 @@
 #include <limits.h>
 #include <unistd.h>
 #include <libgen.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/resource.h>
 
 struct sce_check_result
 {
@@ -207,12 +213,14 @@ void sce_check_result_export(struct sce_check_result* v, const char* target_file
 struct sce_session
 {
 	struct oscap_list* results;
+	pthread_mutex_t results_lock;
 };
 
 struct sce_session* sce_session_new(void)
 {
 	struct sce_session* ret = malloc(sizeof(struct sce_session));
 	ret->results = oscap_list_new();
+	pthread_mutex_init(&ret->results_lock, NULL);
 
 	return ret;
 }
@@ -223,6 +231,7 @@ void sce_session_free(struct sce_session* s)
 		return;
 
 	oscap_list_free(s->results, (oscap_destruct_func) sce_check_result_free);
+	pthread_mutex_destroy(&s->results_lock);
 	free(s);
 }
 
@@ -234,7 +243,15 @@ void sce_session_reset(struct sce_session* s)
 
 void sce_session_add_check_result(struct sce_session* s, struct sce_check_result* result)
 {
+	/* checks of the session may be evaluated by several threads */
+	pthread_mutex_lock(&s->results_lock);
 	oscap_list_push(s->results, result);
+	pthread_mutex_unlock(&s->results_lock);
+}
+
+static void _sce_session_add_deferred_result(void *session, void *result)
+{
+	sce_session_add_check_result(session, result);
 }
 
 OSCAP_ITERATOR_GEN(sce_check_result)
@@ -263,6 +280,8 @@ struct sce_parameters
 {
 	char* xccdf_directory;
 	struct sce_session* session;
+	unsigned int timeout;		// seconds, 0 means no limit
+	size_t memory_limit;		// MiB, 0 means no limit
 };
 
 struct sce_parameters* sce_parameters_new(void)
@@ -270,6 +289,8 @@ struct sce_parameters* sce_parameters_new(void)
 	struct sce_parameters *ret = malloc(sizeof(struct sce_parameters));
 	ret->xccdf_directory = NULL;
 	ret->session = NULL;
+	ret->timeout = 0;
+	ret->memory_limit = 0;
 
 	return ret;
 }
@@ -298,6 +319,26 @@ const char* sce_parameters_get_xccdf_directory(struct sce_parameters* v)
 	return v->xccdf_directory;
 }
 
+void sce_parameters_set_timeout(struct sce_parameters* v, unsigned int seconds)
+{
+	v->timeout = seconds;
+}
+
+unsigned int sce_parameters_get_timeout(struct sce_parameters* v)
+{
+	return v->timeout;
+}
+
+void sce_parameters_set_memory_limit(struct sce_parameters* v, size_t megabytes)
+{
+	v->memory_limit = megabytes;
+}
+
+size_t sce_parameters_get_memory_limit(struct sce_parameters* v)
+{
+	return v->memory_limit;
+}
+
 void sce_parameters_set_session(struct sce_parameters* v, struct sce_session* value)
 {
 	sce_session_free(v->session);
@@ -316,17 +357,18 @@ void sce_parameters_allocate_session(struct sce_parameters* v)
 
 static void _pipe_try_read_into_string(int fd, struct oscap_string *string, bool *eof)
 {
-	// FIXME: Read by larger chunks in the future
-	char readbuf;
+	char readbuf[4096];
 	while (true) {
-		const int read_status = read(fd, &readbuf, 1);
-		if (read_status == 1) {  // successful read
-			if (readbuf == '&') {
-				// & is a special case, we have to "escape" it manually
-				// (all else will eventually get handled by libxml)
-				oscap_string_append_string(string, "&amp;");
-			} else {
-				oscap_string_append_char(string, readbuf);
+		const ssize_t read_status = read(fd, readbuf, sizeof(readbuf));
+		if (read_status > 0) {  // successful read
+			for (ssize_t i = 0; i < read_status; i++) {
+				if (readbuf[i] == '&') {
+					// & is a special case, we have to "escape" it manually
+					// (all else will eventually get handled by libxml)
+					oscap_string_append_string(string, "&amp;");
+				} else {
+					oscap_string_append_char(string, readbuf[i]);
+				}
 			}
 		}
 		else if (read_status == 0) {  // EOF
@@ -334,7 +376,7 @@ static void _pipe_try_read_into_string(int fd, struct oscap_string *string, bool
 			break;
 		}
 		else {
-			if (errno == EAGAIN) {
+			if (errno == EAGAIN || errno == EINTR) {
 				// NOOP, we are waiting for more input
 				break;
 			}
@@ -346,6 +388,57 @@ static void _pipe_try_read_into_string(int fd, struct oscap_string *string, bool
 	}
 }
 
+static long long _monotonic_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * Read both output pipes of a script until it closes them. Returns false
+ * if the timeout (in seconds, 0 for none) expired before that.
+ */
+static bool _pipes_drain(int stdout_fd, int stderr_fd, struct oscap_string *stdout_string,
+		struct oscap_string *stderr_string, unsigned int timeout)
+{
+	struct pollfd fds[2] = {
+		{ .fd = stdout_fd, .events = POLLIN },
+		{ .fd = stderr_fd, .events = POLLIN },
+	};
+	struct oscap_string *strings[2] = { stdout_string, stderr_string };
+	bool eof[2] = { false, false };
+
+	const long long deadline = timeout > 0 ? _monotonic_ms() + timeout * 1000LL : 0;
+
+	// we have to read from both pipes at the same time to avoid stalling
+	while (!eof[0] || !eof[1]) {
+		int wait_ms = -1;
+		if (deadline > 0) {
+			const long long left = deadline - _monotonic_ms();
+			if (left <= 0)
+				return false;
+			wait_ms = left > INT_MAX ? INT_MAX : (int) left;
+		}
+
+		if (poll(fds, 2, wait_ms) == -1) {
+			if (errno == EINTR)
+				continue;
+			oscap_seterr(OSCAP_EFAMILY_SCE, "Failed to wait for script output: %s", strerror(errno));
+			break;
+		}
+
+		for (int i = 0; i < 2; i++) {
+			if (eof[i] || fds[i].revents == 0)
+				continue;
+			_pipe_try_read_into_string(fds[i].fd, strings[i], &eof[i]);
+			if (eof[i])
+				fds[i].fd = -1; // poll ignores negative descriptors
+		}
+	}
+
+	return true;
+}
 
 static void free_env_values(char **env_values, size_t index_of_first_env_value_not_compiled_in, size_t real_env_values_count) {
 	for (size_t i = index_of_first_env_value_not_compiled_in; i < real_env_values_count; i++) {
@@ -498,7 +591,8 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 	// We open a pipe for communication with the forked process
 	int stdout_pipefd[2];
 	int stderr_pipefd[2];
-	if (pipe(stdout_pipefd) == -1 || pipe(stderr_pipefd) == -1)
+	// the pipes must not leak into scripts forked by other threads at the same time
+	if (pipe2(stdout_pipefd, O_CLOEXEC) == -1 || pipe2(stderr_pipefd, O_CLOEXEC) == -1)
 	{
 		perror("pipe");
 		free_env_values(env_values, index_of_first_env_value_not_compiled_in, env_value_count);
@@ -540,6 +634,17 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 
 			// we are the child process
 
+			if (parameters->timeout > 0) {
+				// the script gets its own process group, so the processes
+				// it starts are killed with it when it runs out of time
+				setpgid(0, 0);
+			}
+			if (parameters->memory_limit > 0) {
+				struct rlimit limit;
+				limit.rlim_cur = limit.rlim_max = (rlim_t) parameters->memory_limit * 1024 * 1024;
+				setrlimit(RLIMIT_AS, &limit);
+			}
+
 			if(use_sce_wrapper)
 				execvpe("oscap-run-sce-script", argvp, env_values);
 			else
@@ -593,22 +698,19 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 				return XCCDF_RESULT_ERROR;
 			}
 
-			// we have to read from both pipes at the same time to avoid stalling
+			if (parameters->timeout > 0) {
+				// avoid racing with the child, the process group has to
+				// exist before we may need to kill it
+				setpgid(fork_result, fork_result);
+			}
+
 			struct oscap_string *stdout_string = oscap_string_new();
 			struct oscap_string *stderr_string = oscap_string_new();
 
-			bool stdout_eof = false;
-			bool stderr_eof = false;
-
-			while (!stdout_eof || !stderr_eof) {
-				if (!stdout_eof)
-					_pipe_try_read_into_string(stdout_pipefd[0], stdout_string, &stdout_eof);
-
-				if (!stderr_eof)
-					_pipe_try_read_into_string(stderr_pipefd[0], stderr_string, &stderr_eof);
-
-				// sleep for 10ms to avoid wasting CPU
-				usleep(10 * 1000);
+			if (!_pipes_drain(stdout_pipefd[0], stderr_pipefd[0], stdout_string, stderr_string, parameters->timeout)) {
+				dW("Script '%s' didn't finish within %u seconds, killing it.", href, parameters->timeout);
+				kill(-fork_result, SIGKILL);
+				oscap_string_append_string(stderr_string, "\nThe script was killed because it exceeded the time limit.\n");
 			}
 
 			close(stdout_pipefd[0]);
@@ -647,7 +749,9 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 					sce_check_result_add_environment_variable(check_result, env_values[i]);
 				}
 
-				sce_session_add_check_result(session, check_result);
+				/* results of concurrently evaluated checks are collected in the document order */
+				xccdf_policy_engine_defer(_sce_session_add_deferred_result, session, check_result,
+						(oscap_destruct_func) sce_check_result_free);
 			}
 
 			free_env_values(env_values, index_of_first_env_value_not_compiled_in, env_value_count);
@@ -690,6 +794,7 @@ xccdf_test_result_type_t sce_engine_eval_rule(struct xccdf_policy *policy, const
 
 bool xccdf_policy_model_register_engine_sce(struct xccdf_policy_model * model, struct sce_parameters *parameters)
 {
-	return xccdf_policy_model_register_engine_and_query_callback(model,
+	/* every check runs in its own process, so checks can be evaluated concurrently */
+	return xccdf_policy_model_register_concurrent_engine(model,
 		"http://open-scap.org/page/SCE", sce_engine_eval_rule, (void*)parameters, NULL);
 }
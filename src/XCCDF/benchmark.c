@@ -51,7 +51,7 @@ struct xccdf_backref {
 	char *id;		// id
 };
 
-struct xccdf_benchmark *xccdf_benchmark_import_source(struct oscap_source *source)
+static struct xccdf_benchmark *_xccdf_benchmark_parse_source(struct oscap_source *source)
 {
 	xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
 
@@ -65,6 +65,17 @@ struct xccdf_benchmark *xccdf_benchmark_import_source(struct oscap_source *sourc
 		xccdf_benchmark_free(benchmark);
 		return NULL;
 	}
+	xccdf_benchmark_cache_store(benchmark, source);
+	return benchmark;
+}
+
+struct xccdf_benchmark *xccdf_benchmark_import_source(struct oscap_source *source)
+{
+	struct xccdf_benchmark *benchmark = xccdf_benchmark_cache_load(source);
+	if (benchmark == NULL)
+		benchmark = _xccdf_benchmark_parse_source(source);
+	if (benchmark == NULL)
+		return NULL;
 
 	// This is sadly the only place where we can pass origin file information
 	// to the CPE1 embedded dictionary (if any). It is necessary to figure out
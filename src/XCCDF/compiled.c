@@ -0,0 +1,975 @@
+/**
+ * @file compiled.c
+ * @brief Compiled (binary) representation of the XCCDF Benchmark
+ *
+ * The compiled form stores a parsed xccdf_benchmark in a compact binary file
+ * that can be loaded back without any XML processing. See
+ * common/oscap_compiled.h for the header and encoding; the body is:
+ *
+ *   schema namespace, benchmark item, notices, plain texts, front and
+ *   rear matter, models, embedded CPE dictionary and platform
+ *   specification, values, profiles, content
+ *
+ * Items are stored in the order of the lists they belong to, groups nest
+ * their values and content. The embedded CPE models are kept as XML.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <libxml/xmlreader.h>
+#include <libxml/xmlwriter.h>
+
+#include "item.h"
+#include "elements.h"
+#include "helpers.h"
+#include "xccdf_impl.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/oscap_compiled.h"
+#include "source/oscap_source_priv.h"
+#include "CPE/cpedict_priv.h"
+#include "CPE/cpelang_priv.h"
+#include "CPE/cpe_ctx_priv.h"
+
+#define XCCDF_COMPILED_MAGIC "OSCAPXCC"
+#define XCCDF_COMPILED_FORMAT 2
+#define XCCDF_COMPILED_SUFFIX ".xccdfc"
+#define XCCDF_CACHE_DIR_ENV "OSCAP_XCCDF_CACHE_DIR"
+#define XCCDF_COMPILED_MAX_DEPTH 256
+
+#define XCCDF_DEFAULT_MODEL "urn:xccdf:scoring:default"
+
+/***************************************************************************/
+/* Writer
+ * */
+
+#define _write_uint oscap_compiled_write_uint
+#define _write_int oscap_compiled_write_int
+#define _write_float oscap_compiled_write_float
+#define _write_str oscap_compiled_write_str
+
+typedef void (*_write_func)(struct oscap_compiled_writer *w, const void *data);
+
+static void _write_list(struct oscap_compiled_writer *w, const struct oscap_list *list, _write_func write)
+{
+	_write_uint(w, list != NULL ? list->itemcount : 0);
+	for (struct oscap_list_item *it = list != NULL ? list->first : NULL; it != NULL; it = it->next)
+		write(w, it->data);
+}
+
+static void _write_string(struct oscap_compiled_writer *w, const void *str)
+{
+	_write_str(w, str);
+}
+
+static void _write_text(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct oscap_text *text = data;
+	_write_uint(w, text != NULL);
+	if (text == NULL)
+		return;
+	_write_str(w, text->lang);
+	_write_str(w, text->text);
+	_write_uint(w, text->traits.override_given | text->traits.html << 1 | text->traits.can_override << 2 |
+			text->traits.can_substitute << 3 | text->traits.overrides << 4);
+}
+
+static void _write_reference(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct oscap_reference *ref = data;
+	_write_str(w, ref->title);
+	_write_str(w, ref->creator);
+	_write_str(w, ref->subject);
+	_write_str(w, ref->description);
+	_write_str(w, ref->publisher);
+	_write_str(w, ref->contributor);
+	_write_str(w, ref->date);
+	_write_str(w, ref->type);
+	_write_str(w, ref->format);
+	_write_str(w, ref->identifier);
+	_write_str(w, ref->source);
+	_write_str(w, ref->language);
+	_write_str(w, ref->relation);
+	_write_str(w, ref->coverage);
+	_write_str(w, ref->rights);
+	_write_uint(w, ref->is_dublincore);
+	_write_str(w, ref->href);
+}
+
+static void _write_warning(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_warning *warning = data;
+	_write_uint(w, warning->category);
+	_write_text(w, warning->text);
+}
+
+static void _write_status(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_status *status = data;
+	_write_uint(w, status->status);
+	_write_int(w, status->date);
+}
+
+static void _write_item_base(struct oscap_compiled_writer *w, const struct xccdf_item_base *base)
+{
+	_write_str(w, base->id);
+	_write_str(w, base->cluster_id);
+	_write_float(w, base->weight);
+	_write_list(w, base->title, _write_text);
+	_write_list(w, base->description, _write_text);
+	_write_list(w, base->question, _write_text);
+	_write_list(w, base->rationale, _write_text);
+	_write_list(w, base->warnings, _write_warning);
+	_write_str(w, base->version);
+	_write_str(w, base->version_update);
+	_write_str(w, base->version_time);
+	_write_str(w, base->extends);
+	_write_list(w, base->statuses, _write_status);
+	_write_list(w, base->dc_statuses, _write_reference);
+	_write_list(w, base->references, _write_reference);
+	_write_list(w, base->platforms, _write_string);
+	_write_uint(w, base->flags.selected | base->flags.hidden << 1 | base->flags.resolved << 2 |
+			base->flags.abstract << 3 | base->flags.prohibit_changes << 4 |
+			base->flags.interactive << 5 | base->flags.multiple << 6);
+	_write_uint(w, base->defined_flags.selected | base->defined_flags.hidden << 1 |
+			base->defined_flags.resolved << 2 | base->defined_flags.abstract << 3 |
+			base->defined_flags.prohibit_changes << 4 | base->defined_flags.interactive << 5 |
+			base->defined_flags.multiple << 6 | base->defined_flags.weight << 7 |
+			base->defined_flags.role << 8 | base->defined_flags.severity << 9);
+	_write_list(w, base->metadata, _write_string);
+}
+
+static void _write_requires(struct oscap_compiled_writer *w, const void *data)
+{
+	_write_list(w, data, _write_string);
+}
+
+static void _write_profile_note(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_profile_note *note = data;
+	_write_str(w, note->reftag);
+	_write_text(w, note->text);
+}
+
+static void _write_ident(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_ident *ident = data;
+	_write_str(w, ident->id);
+	_write_str(w, ident->system);
+}
+
+static void _write_check_import(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_check_import *import = data;
+	_write_str(w, import->name);
+	_write_str(w, import->xpath);
+	_write_str(w, import->content);
+}
+
+static void _write_check_export(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_check_export *export = data;
+	_write_str(w, export->name);
+	_write_str(w, export->value);
+}
+
+static void _write_check_content_ref(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_check_content_ref *ref = data;
+	_write_str(w, ref->href);
+	_write_str(w, ref->name);
+}
+
+static void _write_check(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_check *check = data;
+	_write_uint(w, check->oper);
+	_write_str(w, check->id);
+	_write_str(w, check->system);
+	_write_str(w, check->selector);
+	_write_str(w, check->content);
+	_write_uint(w, check->flags.multicheck | check->flags.def_multicheck << 1 |
+			check->flags.negate << 2 | check->flags.def_negate << 3);
+	_write_list(w, check->imports, _write_check_import);
+	_write_list(w, check->exports, _write_check_export);
+	_write_list(w, check->content_refs, _write_check_content_ref);
+	_write_list(w, check->children, _write_check);
+}
+
+static void _write_fix(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_fix *fix = data;
+	_write_uint(w, fix->reboot);
+	_write_uint(w, fix->strategy);
+	_write_uint(w, fix->disruption);
+	_write_uint(w, fix->complexity);
+	_write_str(w, fix->id);
+	_write_str(w, fix->content);
+	_write_str(w, fix->system);
+	_write_str(w, fix->platform);
+}
+
+static void _write_fixtext(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_fixtext *fixtext = data;
+	_write_text(w, fixtext->text);
+	_write_uint(w, fixtext->reboot);
+	_write_uint(w, fixtext->strategy);
+	_write_uint(w, fixtext->disruption);
+	_write_uint(w, fixtext->complexity);
+	_write_str(w, fixtext->fixref);
+}
+
+static void _write_value_instance(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_value_instance *inst = data;
+	_write_str(w, inst->selector);
+	_write_uint(w, inst->type);
+	_write_str(w, inst->value);
+	_write_str(w, inst->defval);
+	_write_list(w, inst->choices, _write_string);
+	_write_float(w, inst->lower_bound);
+	_write_float(w, inst->upper_bound);
+	_write_str(w, inst->match);
+	_write_uint(w, inst->flags.value_given | inst->flags.defval_given << 1 |
+			inst->flags.must_match_given << 2 | inst->flags.must_match << 3);
+}
+
+static void _write_select(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_select *sel = data;
+	_write_str(w, sel->item);
+	_write_uint(w, sel->selected);
+	_write_list(w, sel->remarks, _write_text);
+}
+
+static void _write_setvalue(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_setvalue *sv = data;
+	_write_str(w, sv->item);
+	_write_str(w, sv->value);
+}
+
+static void _write_refine_value(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_refine_value *rv = data;
+	_write_str(w, rv->item);
+	_write_str(w, rv->selector);
+	_write_uint(w, rv->oper);
+	_write_list(w, rv->remarks, _write_text);
+}
+
+static void _write_refine_rule(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_refine_rule *rr = data;
+	_write_str(w, rr->item);
+	_write_str(w, rr->selector);
+	_write_uint(w, rr->role);
+	_write_uint(w, rr->severity);
+	_write_float(w, rr->weight);
+	_write_list(w, rr->remarks, _write_text);
+}
+
+static void _write_item(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_item *item = data;
+	_write_uint(w, item->type);
+	_write_item_base(w, &item->item);
+
+	switch (item->type) {
+	case XCCDF_RULE:
+		_write_str(w, item->sub.rule.impact_metric);
+		_write_uint(w, item->sub.rule.role);
+		_write_uint(w, item->sub.rule.severity);
+		_write_list(w, item->sub.rule.requires, _write_requires);
+		_write_list(w, item->sub.rule.conflicts, _write_string);
+		_write_list(w, item->sub.rule.profile_notes, _write_profile_note);
+		_write_list(w, item->sub.rule.idents, _write_ident);
+		_write_list(w, item->sub.rule.checks, _write_check);
+		_write_list(w, item->sub.rule.fixes, _write_fix);
+		_write_list(w, item->sub.rule.fixtexts, _write_fixtext);
+		break;
+	case XCCDF_GROUP:
+		_write_list(w, item->sub.group.requires, _write_requires);
+		_write_list(w, item->sub.group.conflicts, _write_string);
+		_write_list(w, item->sub.group.values, _write_item);
+		_write_list(w, item->sub.group.content, _write_item);
+		break;
+	case XCCDF_VALUE:
+		_write_uint(w, item->sub.value.type);
+		_write_uint(w, item->sub.value.interface_hint);
+		_write_uint(w, item->sub.value.oper);
+		_write_list(w, item->sub.value.instances, _write_value_instance);
+		_write_list(w, item->sub.value.sources, _write_string);
+		break;
+	case XCCDF_PROFILE:
+		_write_str(w, item->sub.profile.note_tag);
+		_write_list(w, item->sub.profile.selects, _write_select);
+		_write_list(w, item->sub.profile.setvalues, _write_setvalue);
+		_write_list(w, item->sub.profile.refine_values, _write_refine_value);
+		_write_list(w, item->sub.profile.refine_rules, _write_refine_rule);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+static void _write_notice(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_notice *notice = data;
+	_write_str(w, notice->id);
+	_write_text(w, notice->text);
+}
+
+static void _write_plain_text(struct oscap_compiled_writer *w, const void *data)
+{
+	const struct xccdf_plain_text *ptext = data;
+	_write_str(w, ptext->id);
+	_write_str(w, ptext->text);
+}
+
+static void _write_models(struct oscap_compiled_writer *w, const struct oscap_list *models)
+{
+	/* The implied default scoring model is added by xccdf_benchmark_new() */
+	size_t count = 0;
+	for (struct oscap_list_item *it = models->first; it != NULL; it = it->next)
+		if (oscap_strcmp(((struct xccdf_model *) it->data)->system, XCCDF_DEFAULT_MODEL) != 0)
+			count++;
+	_write_uint(w, count);
+
+	for (struct oscap_list_item *it = models->first; it != NULL; it = it->next) {
+		const struct xccdf_model *model = it->data;
+		if (oscap_strcmp(model->system, XCCDF_DEFAULT_MODEL) == 0)
+			continue;
+		_write_str(w, model->system);
+
+		size_t pcount = 0;
+		struct oscap_htable_iterator *hit = oscap_htable_iterator_new(model->params);
+		while (oscap_htable_iterator_has_more(hit)) {
+			oscap_htable_iterator_next(hit);
+			pcount++;
+		}
+		_write_uint(w, pcount);
+		oscap_htable_iterator_reset(hit);
+		while (oscap_htable_iterator_has_more(hit)) {
+			const char *name;
+			void *value;
+			oscap_htable_iterator_next_kv(hit, &name, &value);
+			_write_str(w, name);
+			_write_str(w, value);
+		}
+		oscap_htable_iterator_free(hit);
+	}
+}
+
+typedef void (*_cpe_export_func)(const void *model, xmlTextWriterPtr writer);
+
+/* The CPE API can only export via xmlTextWriter, keep the embedded models as XML */
+static char *_cpe_to_xml(const void *model, _cpe_export_func export)
+{
+	if (model == NULL)
+		return NULL;
+	xmlBufferPtr buffer = xmlBufferCreate();
+	xmlTextWriterPtr writer = xmlNewTextWriterMemory(buffer, 0);
+	export(model, writer);
+	xmlFreeTextWriter(writer);
+	char *xml = oscap_strdup((const char *) xmlBufferContent(buffer));
+	xmlBufferFree(buffer);
+	return xml;
+}
+
+static int _xccdf_compiled_write(const struct xccdf_benchmark *benchmark, const unsigned char *digest, uint64_t source_size,
+		const char *file, bool atomic)
+{
+	const struct xccdf_item *bench = XITEM(benchmark);
+	struct oscap_compiled_writer *w = oscap_compiled_writer_new();
+	_write_str(w, xccdf_version_info_get_namespace_uri(bench->sub.benchmark.schema_version));
+	_write_item_base(w, &bench->item);
+	_write_str(w, bench->sub.benchmark.style);
+	_write_str(w, bench->sub.benchmark.style_href);
+	_write_str(w, bench->sub.benchmark.lang);
+	_write_list(w, bench->sub.benchmark.notices, _write_notice);
+	_write_list(w, bench->sub.benchmark.plain_texts, _write_plain_text);
+	_write_list(w, bench->sub.benchmark.front_matter, _write_text);
+	_write_list(w, bench->sub.benchmark.rear_matter, _write_text);
+	_write_models(w, bench->sub.benchmark.models);
+
+	char *cpe_list = _cpe_to_xml(bench->sub.benchmark.cpe_list, (_cpe_export_func) cpe_dict_export);
+	char *cpe_lang_model = _cpe_to_xml(bench->sub.benchmark.cpe_lang_model, (_cpe_export_func) cpe_lang_export);
+	_write_str(w, cpe_list);
+	_write_str(w, cpe_lang_model);
+	free(cpe_list);
+	free(cpe_lang_model);
+
+	_write_list(w, bench->sub.benchmark.values, _write_item);
+	_write_list(w, bench->sub.benchmark.profiles, _write_item);
+	_write_list(w, bench->sub.benchmark.content, _write_item);
+
+	int ret = oscap_compiled_writer_save(w, XCCDF_COMPILED_MAGIC, XCCDF_COMPILED_FORMAT, digest, source_size, file, atomic);
+	oscap_compiled_writer_free(w);
+	return ret;
+}
+
+/***************************************************************************/
+/* Reader
+ * */
+
+#define _read_uint oscap_compiled_read_uint
+#define _read_int oscap_compiled_read_int
+#define _read_float oscap_compiled_read_float
+#define _read_bool oscap_compiled_read_bool
+#define _read_count oscap_compiled_read_count
+
+static inline char *_read_str(struct oscap_compiled_reader *r)
+{
+	return oscap_strdup(oscap_compiled_read_str(r));
+}
+
+typedef void *(*_read_func)(struct oscap_compiled_reader *r);
+
+static void _read_list(struct oscap_compiled_reader *r, struct oscap_list *list, _read_func read)
+{
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->failed; i++)
+		oscap_list_add(list, read(r));
+}
+
+static void *_read_string(struct oscap_compiled_reader *r)
+{
+	char *str = _read_str(r);
+	/* lists of strings never contain NULL */
+	if (str == NULL) {
+		r->failed = true;
+		str = oscap_strdup("");
+	}
+	return str;
+}
+
+static void *_read_text(struct oscap_compiled_reader *r)
+{
+	if (!_read_bool(r))
+		return NULL;
+	struct oscap_text *text = calloc(1, sizeof(struct oscap_text));
+	text->lang = _read_str(r);
+	text->text = _read_str(r);
+	uint64_t traits = _read_uint(r);
+	text->traits.override_given = traits & 1;
+	text->traits.html = (traits >> 1) & 1;
+	text->traits.can_override = (traits >> 2) & 1;
+	text->traits.can_substitute = (traits >> 3) & 1;
+	text->traits.overrides = (traits >> 4) & 1;
+	return text;
+}
+
+static void *_read_list_text(struct oscap_compiled_reader *r)
+{
+	struct oscap_text *text = _read_text(r);
+	if (text == NULL) {
+		r->failed = true;
+		text = oscap_text_new();
+	}
+	return text;
+}
+
+static void *_read_reference(struct oscap_compiled_reader *r)
+{
+	struct oscap_reference *ref = oscap_reference_new();
+	ref->title = _read_str(r);
+	ref->creator = _read_str(r);
+	ref->subject = _read_str(r);
+	ref->description = _read_str(r);
+	ref->publisher = _read_str(r);
+	ref->contributor = _read_str(r);
+	ref->date = _read_str(r);
+	ref->type = _read_str(r);
+	ref->format = _read_str(r);
+	ref->identifier = _read_str(r);
+	ref->source = _read_str(r);
+	ref->language = _read_str(r);
+	ref->relation = _read_str(r);
+	ref->coverage = _read_str(r);
+	ref->rights = _read_str(r);
+	ref->is_dublincore = _read_bool(r);
+	ref->href = _read_str(r);
+	return ref;
+}
+
+static void *_read_warning(struct oscap_compiled_reader *r)
+{
+	struct xccdf_warning *warning = xccdf_warning_new();
+	warning->category = _read_uint(r);
+	warning->text = _read_text(r);
+	return warning;
+}
+
+static void *_read_status(struct oscap_compiled_reader *r)
+{
+	struct xccdf_status *status = xccdf_status_new();
+	status->status = _read_uint(r);
+	status->date = _read_int(r);
+	return status;
+}
+
+static void _read_item_base(struct oscap_compiled_reader *r, struct xccdf_item_base *base)
+{
+	base->id = _read_str(r);
+	base->cluster_id = _read_str(r);
+	base->weight = _read_float(r);
+	_read_list(r, base->title, _read_list_text);
+	_read_list(r, base->description, _read_list_text);
+	_read_list(r, base->question, _read_list_text);
+	_read_list(r, base->rationale, _read_list_text);
+	_read_list(r, base->warnings, _read_warning);
+	base->version = _read_str(r);
+	base->version_update = _read_str(r);
+	base->version_time = _read_str(r);
+	base->extends = _read_str(r);
+	_read_list(r, base->statuses, _read_status);
+	_read_list(r, base->dc_statuses, _read_reference);
+	_read_list(r, base->references, _read_reference);
+	_read_list(r, base->platforms, _read_string);
+
+	uint64_t flags = _read_uint(r);
+	base->flags.selected = flags & 1;
+	base->flags.hidden = (flags >> 1) & 1;
+	base->flags.resolved = (flags >> 2) & 1;
+	base->flags.abstract = (flags >> 3) & 1;
+	base->flags.prohibit_changes = (flags >> 4) & 1;
+	base->flags.interactive = (flags >> 5) & 1;
+	base->flags.multiple = (flags >> 6) & 1;
+	flags = _read_uint(r);
+	base->defined_flags.selected = flags & 1;
+	base->defined_flags.hidden = (flags >> 1) & 1;
+	base->defined_flags.resolved = (flags >> 2) & 1;
+	base->defined_flags.abstract = (flags >> 3) & 1;
+	base->defined_flags.prohibit_changes = (flags >> 4) & 1;
+	base->defined_flags.interactive = (flags >> 5) & 1;
+	base->defined_flags.multiple = (flags >> 6) & 1;
+	base->defined_flags.weight = (flags >> 7) & 1;
+	base->defined_flags.role = (flags >> 8) & 1;
+	base->defined_flags.severity = (flags >> 9) & 1;
+
+	_read_list(r, base->metadata, _read_string);
+}
+
+static void *_read_requires(struct oscap_compiled_reader *r)
+{
+	struct oscap_list *ids = oscap_list_new();
+	_read_list(r, ids, _read_string);
+	return ids;
+}
+
+static void *_read_profile_note(struct oscap_compiled_reader *r)
+{
+	struct xccdf_profile_note *note = xccdf_profile_note_new();
+	note->reftag = _read_str(r);
+	note->text = _read_text(r);
+	return note;
+}
+
+static void *_read_ident(struct oscap_compiled_reader *r)
+{
+	struct xccdf_ident *ident = xccdf_ident_new();
+	ident->id = _read_str(r);
+	ident->system = _read_str(r);
+	return ident;
+}
+
+static void *_read_check_import(struct oscap_compiled_reader *r)
+{
+	struct xccdf_check_import *import = xccdf_check_import_new();
+	import->name = _read_str(r);
+	import->xpath = _read_str(r);
+	import->content = _read_str(r);
+	return import;
+}
+
+static void *_read_check_export(struct oscap_compiled_reader *r)
+{
+	struct xccdf_check_export *export = xccdf_check_export_new();
+	export->name = _read_str(r);
+	export->value = _read_str(r);
+	return export;
+}
+
+static void *_read_check_content_ref(struct oscap_compiled_reader *r)
+{
+	struct xccdf_check_content_ref *ref = xccdf_check_content_ref_new();
+	ref->href = _read_str(r);
+	ref->name = _read_str(r);
+	return ref;
+}
+
+static struct xccdf_check *_read_check(struct oscap_compiled_reader *r, int depth)
+{
+	struct xccdf_check *check = xccdf_check_new();
+	check->oper = _read_uint(r);
+	check->id = _read_str(r);
+	check->system = _read_str(r);
+	check->selector = _read_str(r);
+	check->content = _read_str(r);
+	uint64_t flags = _read_uint(r);
+	check->flags.multicheck = flags & 1;
+	check->flags.def_multicheck = (flags >> 1) & 1;
+	check->flags.negate = (flags >> 2) & 1;
+	check->flags.def_negate = (flags >> 3) & 1;
+	_read_list(r, check->imports, _read_check_import);
+	_read_list(r, check->exports, _read_check_export);
+	_read_list(r, check->content_refs, _read_check_content_ref);
+
+	size_t count = _read_count(r);
+	if (count > 0 && depth >= XCCDF_COMPILED_MAX_DEPTH)
+		r->failed = true;
+	for (size_t i = 0; i < count && !r->failed; i++)
+		oscap_list_add(check->children, _read_check(r, depth + 1));
+	return check;
+}
+
+static void *_read_fix(struct oscap_compiled_reader *r)
+{
+	struct xccdf_fix *fix = xccdf_fix_new();
+	fix->reboot = _read_bool(r);
+	fix->strategy = _read_uint(r);
+	fix->disruption = _read_uint(r);
+	fix->complexity = _read_uint(r);
+	fix->id = _read_str(r);
+	fix->content = _read_str(r);
+	fix->system = _read_str(r);
+	fix->platform = _read_str(r);
+	return fix;
+}
+
+static void *_read_fixtext(struct oscap_compiled_reader *r)
+{
+	struct xccdf_fixtext *fixtext = xccdf_fixtext_new();
+	fixtext->text = _read_text(r);
+	fixtext->reboot = _read_bool(r);
+	fixtext->strategy = _read_uint(r);
+	fixtext->disruption = _read_uint(r);
+	fixtext->complexity = _read_uint(r);
+	fixtext->fixref = _read_str(r);
+	return fixtext;
+}
+
+static struct xccdf_value_instance *_read_value_instance(struct oscap_compiled_reader *r, struct xccdf_item *value)
+{
+	struct xccdf_value_instance *inst = xccdf_value_new_instance(XVALUE(value));
+	inst->selector = _read_str(r);
+	inst->type = _read_uint(r);
+	inst->value = _read_str(r);
+	inst->defval = _read_str(r);
+	_read_list(r, inst->choices, _read_string);
+	inst->lower_bound = _read_float(r);
+	inst->upper_bound = _read_float(r);
+	inst->match = _read_str(r);
+	uint64_t flags = _read_uint(r);
+	inst->flags.value_given = flags & 1;
+	inst->flags.defval_given = (flags >> 1) & 1;
+	inst->flags.must_match_given = (flags >> 2) & 1;
+	inst->flags.must_match = (flags >> 3) & 1;
+	return inst;
+}
+
+static void *_read_select(struct oscap_compiled_reader *r)
+{
+	struct xccdf_select *sel = xccdf_select_new();
+	sel->item = _read_str(r);
+	sel->selected = _read_bool(r);
+	_read_list(r, sel->remarks, _read_list_text);
+	return sel;
+}
+
+static void *_read_setvalue(struct oscap_compiled_reader *r)
+{
+	struct xccdf_setvalue *sv = xccdf_setvalue_new();
+	sv->item = _read_str(r);
+	sv->value = _read_str(r);
+	return sv;
+}
+
+static void *_read_refine_value(struct oscap_compiled_reader *r)
+{
+	struct xccdf_refine_value *rv = xccdf_refine_value_new();
+	rv->item = _read_str(r);
+	rv->selector = _read_str(r);
+	rv->oper = _read_uint(r);
+	_read_list(r, rv->remarks, _read_list_text);
+	return rv;
+}
+
+static void *_read_refine_rule(struct oscap_compiled_reader *r)
+{
+	struct xccdf_refine_rule *rr = xccdf_refine_rule_new();
+	rr->item = _read_str(r);
+	rr->selector = _read_str(r);
+	rr->role = _read_uint(r);
+	rr->severity = _read_uint(r);
+	rr->weight = _read_float(r);
+	_read_list(r, rr->remarks, _read_list_text);
+	return rr;
+}
+
+static void _read_items(struct oscap_compiled_reader *r, struct oscap_list *list, struct xccdf_item *parent, int depth);
+
+/* Items are created exactly as the parser creates them and registered within the Benchmark once their id is known */
+static struct xccdf_item *_read_item(struct oscap_compiled_reader *r, struct xccdf_item *parent, int depth)
+{
+	struct xccdf_item *item;
+	xccdf_type_t type = _read_uint(r);
+	switch (type) {
+	case XCCDF_RULE:
+		item = xccdf_rule_new_internal(parent);
+		break;
+	case XCCDF_GROUP:
+		item = xccdf_group_new_internal(parent);
+		break;
+	case XCCDF_VALUE:
+		item = xccdf_value_new_internal(parent, 0);
+		break;
+	case XCCDF_PROFILE:
+		item = xccdf_profile_new_internal(parent);
+		break;
+	default:
+		r->failed = true;
+		return NULL;
+	}
+
+	_read_item_base(r, &item->item);
+	if (item->item.id == NULL || !xccdf_benchmark_register_item(xccdf_item_get_benchmark(item), item)) {
+		/* An unregistered item must not be looked up when the Benchmark is freed */
+		item->item.parent = NULL;
+		r->failed = true;
+	}
+
+	switch (type) {
+	case XCCDF_RULE: {
+		item->sub.rule.impact_metric = _read_str(r);
+		item->sub.rule.role = _read_uint(r);
+		item->sub.rule.severity = _read_uint(r);
+		_read_list(r, item->sub.rule.requires, _read_requires);
+		_read_list(r, item->sub.rule.conflicts, _read_string);
+		_read_list(r, item->sub.rule.profile_notes, _read_profile_note);
+		_read_list(r, item->sub.rule.idents, _read_ident);
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->failed; i++)
+			oscap_list_add(item->sub.rule.checks, _read_check(r, 0));
+		_read_list(r, item->sub.rule.fixes, _read_fix);
+		_read_list(r, item->sub.rule.fixtexts, _read_fixtext);
+		break;
+	}
+	case XCCDF_GROUP:
+		_read_list(r, item->sub.group.requires, _read_requires);
+		_read_list(r, item->sub.group.conflicts, _read_string);
+		if (depth >= XCCDF_COMPILED_MAX_DEPTH) {
+			r->failed = true;
+			break;
+		}
+		_read_items(r, item->sub.group.values, item, depth + 1);
+		_read_items(r, item->sub.group.content, item, depth + 1);
+		break;
+	case XCCDF_VALUE: {
+		item->sub.value.type = _read_uint(r);
+		item->sub.value.interface_hint = _read_uint(r);
+		item->sub.value.oper = _read_uint(r);
+		size_t count = _read_count(r);
+		for (size_t i = 0; i < count && !r->failed; i++)
+			oscap_list_add(item->sub.value.instances, _read_value_instance(r, item));
+		_read_list(r, item->sub.value.sources, _read_string);
+		break;
+	}
+	case XCCDF_PROFILE:
+		item->sub.profile.note_tag = _read_str(r);
+		_read_list(r, item->sub.profile.selects, _read_select);
+		_read_list(r, item->sub.profile.setvalues, _read_setvalue);
+		_read_list(r, item->sub.profile.refine_values, _read_refine_value);
+		_read_list(r, item->sub.profile.refine_rules, _read_refine_rule);
+		break;
+	default:
+		break;
+	}
+	return item;
+}
+
+static void _read_items(struct oscap_compiled_reader *r, struct oscap_list *list, struct xccdf_item *parent, int depth)
+{
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->failed; i++) {
+		struct xccdf_item *item = _read_item(r, parent, depth);
+		if (item != NULL)
+			oscap_list_add(list, item);
+	}
+}
+
+static void *_read_notice(struct oscap_compiled_reader *r)
+{
+	struct xccdf_notice *notice = xccdf_notice_new();
+	notice->id = _read_str(r);
+	oscap_text_free(notice->text);
+	notice->text = _read_text(r);
+	return notice;
+}
+
+static void *_read_plain_text(struct oscap_compiled_reader *r)
+{
+	struct xccdf_plain_text *ptext = xccdf_plain_text_new();
+	ptext->id = _read_str(r);
+	ptext->text = _read_str(r);
+	return ptext;
+}
+
+static void _read_models(struct oscap_compiled_reader *r, struct xccdf_benchmark *benchmark)
+{
+	size_t count = _read_count(r);
+	for (size_t i = 0; i < count && !r->failed; i++) {
+		struct xccdf_model *model = xccdf_model_new();
+		model->system = _read_str(r);
+		size_t pcount = _read_count(r);
+		for (size_t j = 0; j < pcount && !r->failed; j++) {
+			const char *name = oscap_compiled_read_str(r);
+			char *value = _read_str(r);
+			if (name == NULL || !oscap_htable_add(model->params, name, value)) {
+				free(value);
+				r->failed = true;
+			}
+		}
+		xccdf_benchmark_add_model(benchmark, model);
+	}
+}
+
+static xmlTextReaderPtr _cpe_reader(const char *xml)
+{
+	xmlTextReaderPtr reader = xmlReaderForMemory(xml, strlen(xml), NULL, NULL, 0);
+	if (reader == NULL)
+		return NULL;
+	while (xmlTextReaderRead(reader) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) ;
+	return reader;
+}
+
+static void _read_cpe_models(struct oscap_compiled_reader *r, struct xccdf_benchmark *benchmark)
+{
+	const char *cpe_list = oscap_compiled_read_str(r);
+	const char *cpe_lang_model = oscap_compiled_read_str(r);
+	xmlTextReaderPtr reader;
+
+	if (cpe_list != NULL) {
+		if ((reader = _cpe_reader(cpe_list)) != NULL) {
+			struct cpe_parser_ctx *ctx = cpe_parser_ctx_from_reader(reader);
+			xccdf_benchmark_set_cpe_list(benchmark, cpe_dict_model_parse(ctx));
+			cpe_parser_ctx_free(ctx);
+			xmlFreeTextReader(reader);
+		}
+		if (xccdf_benchmark_get_cpe_list(benchmark) == NULL)
+			r->failed = true;
+	}
+	if (cpe_lang_model != NULL) {
+		if ((reader = _cpe_reader(cpe_lang_model)) != NULL) {
+			xccdf_benchmark_set_cpe_lang_model(benchmark, cpe_lang_model_parse(reader));
+			xmlFreeTextReader(reader);
+		}
+		if (xccdf_benchmark_get_cpe_lang_model(benchmark) == NULL)
+			r->failed = true;
+	}
+}
+
+static struct xccdf_benchmark *_xccdf_compiled_load(const char *file,
+		const unsigned char *expected_digest, const uint64_t *expected_size, bool quiet)
+{
+	struct oscap_compiled_reader r;
+	if (oscap_compiled_reader_open(&r, file, XCCDF_COMPILED_MAGIC, XCCDF_COMPILED_FORMAT,
+			expected_digest, expected_size, quiet) != 0)
+		return NULL;
+
+	struct xccdf_benchmark *benchmark = xccdf_benchmark_new();
+	struct xccdf_item *bench = XITEM(benchmark);
+	bench->sub.benchmark.schema_version = xccdf_version_info_find_namespace(oscap_compiled_read_str(&r));
+	if (bench->sub.benchmark.schema_version == NULL)
+		r.failed = true;
+	_read_item_base(&r, &bench->item);
+	bench->sub.benchmark.style = _read_str(&r);
+	bench->sub.benchmark.style_href = _read_str(&r);
+	bench->sub.benchmark.lang = _read_str(&r);
+	_read_list(&r, bench->sub.benchmark.notices, _read_notice);
+	_read_list(&r, bench->sub.benchmark.plain_texts, _read_plain_text);
+	_read_list(&r, bench->sub.benchmark.front_matter, _read_list_text);
+	_read_list(&r, bench->sub.benchmark.rear_matter, _read_list_text);
+	_read_models(&r, benchmark);
+	_read_cpe_models(&r, benchmark);
+	_read_items(&r, bench->sub.benchmark.values, bench, 0);
+	_read_items(&r, bench->sub.benchmark.profiles, bench, 0);
+	_read_items(&r, bench->sub.benchmark.content, bench, 0);
+
+	if (!oscap_compiled_reader_close(&r)) {
+		dW("Compiled XCCDF Benchmark '%s' is damaged.", file);
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "%s is not a valid compiled XCCDF Benchmark.", file);
+		xccdf_benchmark_free(benchmark);
+		return NULL;
+	}
+	return benchmark;
+}
+
+/***************************************************************************/
+/* The automatic cache
+ * */
+
+struct xccdf_benchmark *xccdf_benchmark_cache_load(struct oscap_source *source)
+{
+	unsigned char digest[OSCAP_DIGEST_SIZE];
+	uint64_t size;
+	char *path = oscap_compiled_cache_path(XCCDF_CACHE_DIR_ENV, source, XCCDF_COMPILED_FORMAT, XCCDF_COMPILED_SUFFIX, digest, &size);
+	if (path == NULL)
+		return NULL;
+	struct xccdf_benchmark *benchmark = _xccdf_compiled_load(path, digest, &size, true);
+	if (benchmark != NULL)
+		dI("Loaded XCCDF Benchmark of %s from cache '%s'.", oscap_source_readable_origin(source), path);
+	free(path);
+	return benchmark;
+}
+
+void xccdf_benchmark_cache_store(struct xccdf_benchmark *benchmark, struct oscap_source *source)
+{
+	/* Results of former evaluations are not a part of the compiled form */
+	if (XITEM(benchmark)->sub.benchmark.results->itemcount != 0) {
+		dI("XCCDF Benchmark of %s contains TestResults, it is not cached.", oscap_source_readable_origin(source));
+		return;
+	}
+
+	unsigned char digest[OSCAP_DIGEST_SIZE];
+	uint64_t size;
+	char *path = oscap_compiled_cache_path(XCCDF_CACHE_DIR_ENV, source, XCCDF_COMPILED_FORMAT, XCCDF_COMPILED_SUFFIX, digest, &size);
+	if (path == NULL)
+		return;
+
+	if (_xccdf_compiled_write(benchmark, digest, size, path, true) != 0) {
+		char *err = oscap_err_get_full_error();
+		dW("Could not store XCCDF Benchmark of %s to cache '%s': %s", oscap_source_readable_origin(source), path, err);
+		free(err);
+	} else {
+		dI("Stored XCCDF Benchmark of %s to cache '%s'.", oscap_source_readable_origin(source), path);
+	}
+	free(path);
+}
@@ -97,6 +97,11 @@ static const struct xccdf_version_info *_namespace_get_xccdf_version_info(const
 	return NULL;
 }
 
+const struct xccdf_version_info *xccdf_version_info_find_namespace(const char *namespace_uri)
+{
+	return namespace_uri != NULL ? _namespace_get_xccdf_version_info(namespace_uri) : NULL;
+}
+
 const struct xccdf_version_info* xccdf_detect_version_parser(xmlTextReaderPtr reader)
 {
 	const struct xccdf_version_info *mapptr;
@@ -446,6 +446,10 @@ struct xccdf_result *xccdf_benchmark_get_result_by_id(struct xccdf_benchmark *be
 struct xccdf_result *xccdf_benchmark_get_result_by_id_suffix(struct xccdf_benchmark *benchmark, const char *testresult_suffix);
 bool xccdf_add_item(struct oscap_list *list, struct xccdf_item *parent, struct xccdf_item *item, const char *prefix);
 
+/* compiled benchmark cache, enabled by the OSCAP_XCCDF_CACHE_DIR environment variable */
+struct xccdf_benchmark *xccdf_benchmark_cache_load(struct oscap_source *source);
+void xccdf_benchmark_cache_store(struct xccdf_benchmark *benchmark, struct oscap_source *source);
+
 struct xccdf_tailoring *xccdf_tailoring_parse(xmlTextReaderPtr reader, struct xccdf_item* benchmark);
 xmlNodePtr xccdf_tailoring_to_dom(struct xccdf_tailoring *tailoring, xmlDocPtr doc, xmlNodePtr parent, const struct xccdf_version_info *version_info);
 
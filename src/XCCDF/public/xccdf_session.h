@@ -254,6 +254,17 @@ OSCAP_API void xccdf_session_set_custom_oval_eval_fn(struct xccdf_session *sessi
  */
 OSCAP_API bool xccdf_session_set_product_cpe(struct xccdf_session *session, const char *product_cpe);
 
+/**
+ * Set directory with the state of incremental scans. OVAL objects whose inputs
+ * did not change since the scan saved in the directory are not collected again
+ * and the system characteristics are saved there by \ref xccdf_session_evaluate.
+ * See \ref oval_agent_load_incremental_state.
+ * @memberof xccdf_session
+ * @param session XCCDF Session.
+ * @param dir path to the directory, NULL disables incremental scans
+ */
+OSCAP_API void xccdf_session_set_incremental_state(struct xccdf_session *session, const char *dir);
+
 /**
  * Set whether the System Characteristics shall be exported in result files.
  * @memberof xccdf_session
@@ -322,6 +333,16 @@ OSCAP_API bool xccdf_session_set_arf_export(struct xccdf_session *session, const
  */
 OSCAP_API bool xccdf_session_set_report_export(struct xccdf_session *session, const char *report_file);
 
+/**
+ * Set whether the HTML Report shall be generated natively from the evaluated
+ * models instead of transforming the ARF by XSLT. The native report is much
+ * faster and needs less memory for large benchmarks. Default is false.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param native_report true to generate the report without XSLT
+ */
+OSCAP_API void xccdf_session_set_native_report(struct xccdf_session *session, bool native_report);
+
 /**
  * Select XCCDF Profile for evaluation.
  * @memberof xccdf_session
@@ -442,6 +463,18 @@ OSCAP_API int xccdf_session_load_tailoring(struct xccdf_session *session);
  */
 OSCAP_API int xccdf_session_evaluate(struct xccdf_session *session);
 
+/**
+ * Drop results of the last evaluation and everything collected from the
+ * scanned system, so that the session can evaluate another target (see
+ * OSCAP_PROBE_ROOT) without loading the content again. The policy model
+ * and the parsed OVAL definitions are kept. Exported documents are dropped
+ * as well, set the export file names for the next target before exporting.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @returns zero on success
+ */
+OSCAP_API int xccdf_session_reset_results(struct xccdf_session *session);
+
 /**
  * Export XCCDF file.
  * @memberof xccdf_session
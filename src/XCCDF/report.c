@@ -0,0 +1,2060 @@
+/**
+ * @file report.c
+ * @brief Native HTML report of XCCDF results
+ *
+ * The report is written directly from the evaluated xccdf_policy, its
+ * xccdf_result and the results models of the OVAL agents, without
+ * exporting them to XML and running xccdf-report.xsl over the document.
+ * The HTML has the same sections, ids and classes as the XSLT report, the
+ * styles, scripts and logo are taken from the XSLT files so that both
+ * reports look the same.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libxml/parser.h>
+#include <libxml/xmlwriter.h>
+
+#include "item.h"
+#include "helpers.h"
+#include "report_priv.h"
+#include "common/debug_priv.h"
+#include "common/_error.h"
+#include "common/list.h"
+#include "common/oscapxml.h"
+#include "common/oscap_string.h"
+#include "common/util.h"
+#include "oscap_helpers.h"
+#include "OVAL/public/oval_results.h"
+#include "OVAL/public/oval_system_characteristics.h"
+
+#define REPORT_OVAL_SYSTEM "http://oval.mitre.org/XMLSchema/oval-definitions-5"
+#define REPORT_SCE_SYSTEM "http://open-scap.org/page/SCE"
+#define REPORT_XHTML_NAMESPACE "http://www.w3.org/1999/xhtml"
+#define REPORT_MAX_OVAL_ITEMS 100
+
+struct report_rule_result {
+	struct xccdf_rule_result *rule_result;
+	int index;				///< position in the TestResult, identifies the rule result in the page
+};
+
+struct report_counts {
+	int rules;				///< rules in the group and its subgroups
+	int fail;				///< rules with a failed result
+	int error;
+	int unknown;
+	int notchecked;
+	int notselected;
+};
+
+struct xccdf_report {
+	xmlTextWriterPtr writer;
+	struct xccdf_policy *policy;
+	struct xccdf_benchmark *benchmark;
+	struct xccdf_result *result;
+	struct oval_agent_session **oval_agents;
+	xmlDoc *resources;			///< xccdf-resources.xsl
+	xmlDoc *branding;			///< xccdf-branding.xsl
+	struct oscap_htable *rule_results;	///< rule id -> list of report_rule_result
+	struct oscap_htable *counts;		///< benchmark or group id -> report_counts
+	struct oscap_htable *references;	///< href -> name of every reference in the benchmark
+};
+
+/* Names of the well known references, see xccdf-references.xsl */
+static const struct {
+	const char *prefix;
+	const char *name;
+} REFERENCE_NAMES[] = {
+	{"http://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-53", "NIST SP 800-53"},
+	{"http://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-171", "NIST SP 800-171"},
+	{"http://iase.disa.mil/stigs/cci/", "DISA CCI"},
+	{"http://iase.disa.mil/stigs/srgs/", "DISA SRG"},
+	{"http://iase.disa.mil/stigs/os/general/Pages/index.aspx", "DISA SRG"},
+	{"http://iase.disa.mil/stigs/app-security/app-servers/Pages/general.aspx", "DISA SRG"},
+	{"http://iase.disa.mil/stigs/os/", "DISA STIG"},
+	{"http://iase.disa.mil/stigs/app-security/", "DISA STIG"},
+	{"https://www.pcisecuritystandards.org/", "PCI-DSS Requirement"},
+	{"https://benchmarks.cisecurity.org/", "CIS Recommendation"},
+	{"https://www.fbi.gov/file-repository/cjis-security-policy", "FBI CJIS"},
+	{"http://www.ssi.gouv.fr/administration/bonnes-pratiques", "ANSSI"},
+	{"https://www.gpo.gov/fdsys/pkg/CFR-2007-title45-vol1", "HIPAA"},
+	{"https://www.iso.org/standard/54534.html", "ISO 27001-2013"},
+	{"https://iase.disa.mil/stigs/pages/stig-viewing-guidance", "STIG Viewer"},
+	{NULL, NULL}
+};
+
+static const char *_reference_name(const char *href)
+{
+	for (int i = 0; REFERENCE_NAMES[i].prefix != NULL; i++) {
+		if (oscap_str_startswith(href, REFERENCE_NAMES[i].prefix))
+			return REFERENCE_NAMES[i].name;
+	}
+	return href;
+}
+
+/* The texts are sourced from XCCDF 1.2 specification, see xccdf-share.xsl */
+static const char *_result_tooltip(xccdf_test_result_type_t result)
+{
+	switch (result) {
+	case XCCDF_RESULT_PASS:
+		return "The target system or system component satisfied all the conditions of the rule.";
+	case XCCDF_RESULT_FIXED:
+		return "The Rule had failed, but was then fixed (possibly by a tool that can automatically apply remediation, or possibly by the human auditor).";
+	case XCCDF_RESULT_INFORMATIONAL:
+		return "The Rule was checked, but the output from the checking engine is simply information for auditors or administrators; it is not a compliance category. This status value is designed for Rule elements whose main purpose is to extract information from the target rather than test the target.";
+	case XCCDF_RESULT_FAIL:
+		return "The target system or system component did not satisfy at least one condition of the rule.";
+	case XCCDF_RESULT_ERROR:
+		return "The checking engine could not complete the evaluation, therefore the status of the target's compliance with the rule is not certain. This could happen, for example, if a testing tool was run with insufficient privileges and could not gather all of the necessary information.";
+	case XCCDF_RESULT_UNKNOWN:
+		return "The testing tool encountered some problem and the result is unknown. For example, a result of 'unknown' might be given if the testing tool was unable to interpret the output of the checking engine (the output has no meaning to the testing tool).";
+	case XCCDF_RESULT_NOT_CHECKED:
+		return "The Rule was not evaluated by the checking engine. This status is designed for Rule elements that have no check elements or that correspond to an unsupported checking system. It may also correspond to a status returned by a checking engine if the checking engine does not support the indicated check code.";
+	case XCCDF_RESULT_NOT_SELECTED:
+		return "The Rule was not selected in the evaluation. This may be caused by the rule not being selected by default in the benchmark or by the profile unselecting it.";
+	case XCCDF_RESULT_NOT_APPLICABLE:
+		return "The Rule was not applicable to the target of the test. For example, the Rule might have been specific to a different version of the target OS, or it might have been a test against a platform feature that was not installed.";
+	default:
+		return "";
+	}
+}
+
+static const char *_severity_text(xccdf_level_t severity)
+{
+	const char *text = oscap_enum_to_string(XCCDF_LEVEL_MAP, severity);
+	return text != NULL ? text : "unknown";
+}
+
+/***************************************************************************/
+/* Writer helpers
+ * */
+
+static void _start(struct xccdf_report *report, const char *name, const char *class)
+{
+	xmlTextWriterStartElement(report->writer, BAD_CAST name);
+	if (class != NULL)
+		xmlTextWriterWriteAttribute(report->writer, BAD_CAST "class", BAD_CAST class);
+}
+
+static void _end(struct xccdf_report *report)
+{
+	/* HTML does not know self-closing elements, <div/> has to be <div></div> */
+	xmlTextWriterFullEndElement(report->writer);
+}
+
+static void _end_void(struct xccdf_report *report)
+{
+	xmlTextWriterEndElement(report->writer);
+}
+
+static void _attr(struct xccdf_report *report, const char *name, const char *value)
+{
+	xmlTextWriterWriteAttribute(report->writer, BAD_CAST name, BAD_CAST (value != NULL ? value : ""));
+}
+
+static void _attrf(struct xccdf_report *report, const char *name, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	xmlTextWriterWriteVFormatAttribute(report->writer, BAD_CAST name, fmt, ap);
+	va_end(ap);
+}
+
+static void _text(struct xccdf_report *report, const char *text)
+{
+	if (text != NULL)
+		xmlTextWriterWriteString(report->writer, BAD_CAST text);
+}
+
+static void _textf(struct xccdf_report *report, const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	xmlTextWriterWriteVFormatString(report->writer, fmt, ap);
+	va_end(ap);
+}
+
+static void _raw(struct xccdf_report *report, const char *text)
+{
+	if (text != NULL)
+		xmlTextWriterWriteRaw(report->writer, BAD_CAST text);
+}
+
+static void _nbsp(struct xccdf_report *report)
+{
+	_raw(report, "&#160;");
+}
+
+static void _element(struct xccdf_report *report, const char *name, const char *class, const char *text)
+{
+	_start(report, name, class);
+	_text(report, text);
+	_end(report);
+}
+
+static void _label(struct xccdf_report *report, const char *class, const char *title, const char *text)
+{
+	_start(report, "span", class);
+	if (title != NULL)
+		_attr(report, "title", title);
+	_text(report, text);
+	_end(report);
+}
+
+static void _abbr(struct xccdf_report *report, const char *title, const char *text)
+{
+	_start(report, "abbr", NULL);
+	_attr(report, "title", title);
+	_text(report, text);
+	_end(report);
+}
+
+static bool _is_void_element(const xmlChar *name)
+{
+	static const char *VOID_ELEMENTS[] = {
+		"area", "base", "br", "col", "hr", "img", "input", "link", "meta", "wbr", NULL
+	};
+	for (int i = 0; VOID_ELEMENTS[i] != NULL; i++) {
+		if (xmlStrEqual(name, BAD_CAST VOID_ELEMENTS[i]))
+			return true;
+	}
+	return false;
+}
+
+static void _write_html_nodes(struct xccdf_report *report, xmlNode *node, bool markup)
+{
+	for (; node != NULL; node = node->next) {
+		switch (node->type) {
+		case XML_TEXT_NODE:
+		case XML_CDATA_SECTION_NODE:
+			_text(report, (const char *) node->content);
+			break;
+		case XML_ELEMENT_NODE:
+			/* other elements (unresolved xccdf:sub, xccdf:instance) are replaced by their text */
+			if (!markup || node->ns == NULL || !xmlStrEqual(node->ns->href, BAD_CAST REPORT_XHTML_NAMESPACE)) {
+				_write_html_nodes(report, node->children, markup);
+				break;
+			}
+			xmlTextWriterStartElement(report->writer, node->name);
+			for (xmlAttr *attr = node->properties; attr != NULL; attr = attr->next) {
+				xmlChar *value = xmlNodeGetContent((xmlNode *) attr);
+				xmlTextWriterWriteAttribute(report->writer, attr->name, value);
+				xmlFree(value);
+			}
+			_write_html_nodes(report, node->children, markup);
+			if (node->children == NULL && _is_void_element(node->name))
+				_end_void(report);
+			else
+				_end(report);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * Write XCCDF text with XHTML markup (description, fixtext, ...) with the
+ * values of xccdf:sub elements substituted. The XHTML elements are written
+ * without namespaces so that the browser treats them as HTML.
+ * @param markup if false, only the text content is written (e.g. fix scripts)
+ */
+static void _write_xccdf_text(struct xccdf_report *report, const char *text, bool markup)
+{
+	if (text == NULL)
+		return;
+	if (strchr(text, '<') == NULL && strchr(text, '&') == NULL) {
+		_text(report, text);
+		return;
+	}
+
+	char *resolved = NULL;
+	/* only texts with xccdf:sub need to be resolved */
+	if (strstr(text, "sub") != NULL)
+		resolved = xccdf_policy_substitute(text, report->policy);
+
+	char *document = oscap_sprintf("<x xmlns='" REPORT_XHTML_NAMESPACE "'>%s</x>", resolved != NULL ? resolved : text);
+	xmlDoc *doc = xmlReadMemory(document, strlen(document), NULL, NULL,
+			XML_PARSE_NONET | XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+	if (doc == NULL) {
+		_text(report, resolved != NULL ? resolved : text);
+	} else {
+		_write_html_nodes(report, xmlDocGetRootElement(doc)->children, markup);
+		xmlFreeDoc(doc);
+	}
+	free(document);
+	free(resolved);
+}
+
+static void _write_xccdf_texts(struct xccdf_report *report, struct oscap_text_iterator *texts)
+{
+	struct oscap_text *text = oscap_textlist_get_preferred_text(texts, NULL);
+	oscap_text_iterator_free(texts);
+	if (text != NULL)
+		_write_xccdf_text(report, oscap_text_get_text(text), true);
+}
+
+static bool _has_text(struct oscap_text_iterator *texts)
+{
+	bool has_text = false;
+	while (!has_text && oscap_text_iterator_has_more(texts)) {
+		const char *text = oscap_text_get_text(oscap_text_iterator_next(texts));
+		has_text = (text != NULL && *text != '\0');
+	}
+	oscap_text_iterator_free(texts);
+	return has_text;
+}
+
+static void _write_item_title(struct xccdf_report *report, struct xccdf_item *item)
+{
+	char *title = xccdf_policy_get_readable_item_title(report->policy, item, NULL);
+	if (title != NULL && *title != '\0')
+		_text(report, title);
+	else
+		_textf(report, "ID: %s", xccdf_item_get_id(item));
+	free(title);
+}
+
+/* Copy the content of an xsl:template */
+static xmlNode *_xsl_template(xmlDoc *doc, const char *name)
+{
+	xmlNode *root = xmlDocGetRootElement(doc);
+	for (xmlNode *node = root->children; node != NULL; node = node->next) {
+		if (node->type != XML_ELEMENT_NODE || !xmlStrEqual(node->name, BAD_CAST "template"))
+			continue;
+		xmlChar *template_name = xmlGetProp(node, BAD_CAST "name");
+		bool found = xmlStrEqual(template_name, BAD_CAST name);
+		xmlFree(template_name);
+		if (found)
+			return node;
+	}
+	return NULL;
+}
+
+static void _write_xsl_template_text(struct xccdf_report *report, xmlDoc *doc, const char *name)
+{
+	xmlNode *template = _xsl_template(doc, name);
+	if (template == NULL)
+		return;
+	xmlChar *content = xmlNodeGetContent(template);
+	_raw(report, (const char *) content);
+	xmlFree(content);
+}
+
+static void _write_xsl_template_markup(struct xccdf_report *report, xmlDoc *doc, const char *name)
+{
+	xmlNode *template = _xsl_template(doc, name);
+	if (template == NULL)
+		return;
+	xmlBuffer *buffer = xmlBufferCreate();
+	for (xmlNode *node = template->children; node != NULL; node = node->next) {
+		if (node->type == XML_ELEMENT_NODE)
+			xmlNodeDump(buffer, doc, node, 0, 0);
+	}
+	_raw(report, (const char *) xmlBufferContent(buffer));
+	xmlBufferFree(buffer);
+}
+
+static xmlDoc *_load_xsl(const char *name)
+{
+	char *path = oscap_sprintf("%s/%s", oscap_path_to_xslt(), name);
+	xmlDoc *doc = xmlReadFile(path, NULL, XML_PARSE_NONET | XML_PARSE_HUGE);
+	if (doc == NULL || xmlDocGetRootElement(doc) == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "XSLT file '%s' not found in path '%s' when trying to generate HTML report.",
+				name, oscap_path_to_xslt());
+		xmlFreeDoc(doc);
+		doc = NULL;
+	}
+	free(path);
+	return doc;
+}
+
+/***************************************************************************/
+/* Indexes
+ * */
+
+static void _rule_result_list_free(struct oscap_list *list)
+{
+	oscap_list_free(list, free);
+}
+
+static void _index_rule_results(struct xccdf_report *report)
+{
+	int index = 0;
+	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(report->result);
+	while (xccdf_rule_result_iterator_has_more(rr_it)) {
+		struct xccdf_rule_result *rule_result = xccdf_rule_result_iterator_next(rr_it);
+		const char *idref = xccdf_rule_result_get_idref(rule_result);
+		if (idref == NULL)
+			continue;
+		struct oscap_list *list = oscap_htable_get(report->rule_results, idref);
+		if (list == NULL) {
+			list = oscap_list_new();
+			oscap_htable_add(report->rule_results, idref, list);
+		}
+		struct report_rule_result *rr = malloc(sizeof(struct report_rule_result));
+		rr->rule_result = rule_result;
+		rr->index = index++;
+		oscap_list_add(list, rr);
+	}
+	xccdf_rule_result_iterator_free(rr_it);
+}
+
+static void _index_references(struct xccdf_report *report, struct xccdf_item *item)
+{
+	struct oscap_reference_iterator *references = xccdf_item_get_references(item);
+	while (oscap_reference_iterator_has_more(references)) {
+		const char *href = oscap_reference_get_href(oscap_reference_iterator_next(references));
+		if (href == NULL || *href == '\0' || oscap_htable_get(report->references, href) != NULL)
+			continue;
+		if (strcmp(href, "https://github.com/OpenSCAP/scap-security-guide/wiki/Contributors") == 0)
+			continue;
+		oscap_htable_add(report->references, href, (void *) _reference_name(href));
+	}
+	oscap_reference_iterator_free(references);
+}
+
+static struct xccdf_item_iterator *_item_content(struct xccdf_item *item)
+{
+	if (xccdf_item_get_type(item) == XCCDF_BENCHMARK)
+		return xccdf_benchmark_get_content(XBENCHMARK(item));
+	return xccdf_group_get_content(XGROUP(item));
+}
+
+/* Count rule results of all rules in the group and its subgroups */
+static void _index_counts(struct xccdf_report *report, struct xccdf_item *item, struct report_counts *parent)
+{
+	struct report_counts *counts = calloc(1, sizeof(struct report_counts));
+	_index_references(report, item);
+
+	struct xccdf_item_iterator *content = _item_content(item);
+	while (xccdf_item_iterator_has_more(content)) {
+		struct xccdf_item *child = xccdf_item_iterator_next(content);
+		switch (xccdf_item_get_type(child)) {
+		case XCCDF_GROUP:
+			_index_counts(report, child, counts);
+			break;
+		case XCCDF_RULE: {
+			_index_references(report, child);
+			counts->rules++;
+			bool seen[XCCDF_RESULT_FIXED + 1] = {false};
+			struct oscap_list *results = oscap_htable_get(report->rule_results, xccdf_item_get_id(child));
+			struct oscap_iterator *it = results != NULL ? oscap_iterator_new(results) : NULL;
+			while (it != NULL && oscap_iterator_has_more(it)) {
+				struct report_rule_result *rr = oscap_iterator_next(it);
+				xccdf_test_result_type_t result = xccdf_rule_result_get_result(rr->rule_result);
+				if (result > 0 && result <= XCCDF_RESULT_FIXED)
+					seen[result] = true;
+			}
+			if (it != NULL)
+				oscap_iterator_free(it);
+			counts->fail += seen[XCCDF_RESULT_FAIL];
+			counts->error += seen[XCCDF_RESULT_ERROR];
+			counts->unknown += seen[XCCDF_RESULT_UNKNOWN];
+			counts->notchecked += seen[XCCDF_RESULT_NOT_CHECKED];
+			counts->notselected += seen[XCCDF_RESULT_NOT_SELECTED];
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	xccdf_item_iterator_free(content);
+
+	if (parent != NULL) {
+		parent->rules += counts->rules;
+		parent->fail += counts->fail;
+		parent->error += counts->error;
+		parent->unknown += counts->unknown;
+		parent->notchecked += counts->notchecked;
+		parent->notselected += counts->notselected;
+	}
+	if (!oscap_htable_add(report->counts, xccdf_item_get_id(item), counts))
+		free(counts);
+}
+
+/***************************************************************************/
+/* Introduction and characteristics
+ * */
+
+static void _write_head(struct xccdf_report *report)
+{
+	_raw(report, "<!DOCTYPE html>\n");
+	_start(report, "html", NULL);
+	_attr(report, "lang", "en");
+	_start(report, "head", NULL);
+	_start(report, "meta", NULL);
+	_attr(report, "charset", "utf-8");
+	_end_void(report);
+	_start(report, "meta", NULL);
+	_attr(report, "http-equiv", "X-UA-Compatible");
+	_attr(report, "content", "IE=edge");
+	_end_void(report);
+	_start(report, "meta", NULL);
+	_attr(report, "name", "viewport");
+	_attr(report, "content", "width=device-width, initial-scale=1");
+	_end_void(report);
+	_start(report, "title", NULL);
+	_textf(report, "%s | OpenSCAP Evaluation Report", xccdf_result_get_id(report->result));
+	_end(report);
+	_start(report, "style", NULL);
+	_write_xsl_template_text(report, report->resources, "css-sources");
+	_end(report);
+	_start(report, "script", NULL);
+	_write_xsl_template_text(report, report->resources, "js-sources");
+	_end(report);
+	_end(report);
+}
+
+static void _write_header(struct xccdf_report *report)
+{
+	_start(report, "nav", "navbar navbar-default");
+	_attr(report, "role", "navigation");
+	_start(report, "div", "navbar-header");
+	_attr(report, "style", "float: none");
+	_start(report, "a", "navbar-brand");
+	_attr(report, "href", "#");
+	_write_xsl_template_markup(report, report->branding, "xccdf-branding-logo");
+	_end(report);
+	_start(report, "div", NULL);
+	_element(report, "h1", NULL, "OpenSCAP Evaluation Report");
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+static void _write_footer(struct xccdf_report *report)
+{
+	_start(report, "footer", NULL);
+	_attr(report, "id", "footer");
+	_start(report, "div", "container");
+	_start(report, "p", "muted credit");
+	_text(report, "Generated using ");
+	_start(report, "a", NULL);
+	_attr(report, "href", "http://open-scap.org");
+	_text(report, "OpenSCAP");
+	_end(report);
+	_textf(report, " %s", oscap_get_version());
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+static void _write_introduction(struct xccdf_report *report)
+{
+	struct xccdf_item *benchmark = XITEM(report->benchmark);
+	struct xccdf_profile *profile = xccdf_policy_get_profile(report->policy);
+	if (profile != NULL && xccdf_profile_get_id(profile) == NULL)
+		profile = NULL;
+
+	_start(report, "div", NULL);
+	_attr(report, "id", "introduction");
+	_start(report, "div", "row");
+
+	_start(report, "h2", NULL);
+	_write_item_title(report, benchmark);
+	_end(report);
+
+	if (profile != NULL) {
+		_start(report, "blockquote", NULL);
+		_text(report, "with profile ");
+		_start(report, "mark", NULL);
+		char *title = xccdf_policy_get_readable_item_title(report->policy, XITEM(profile), NULL);
+		_text(report, (title != NULL && *title != '\0') ? title : xccdf_profile_get_id(profile));
+		free(title);
+		_end(report);
+		if (_has_text(xccdf_profile_get_description(profile))) {
+			_start(report, "div", "col-md-12 well well-lg horizontal-scroll");
+			_start(report, "div", "description profile-description");
+			_start(report, "small", NULL);
+			_write_xccdf_texts(report, xccdf_profile_get_description(profile));
+			_end(report);
+			_end(report);
+			_end(report);
+		}
+		_end(report);
+	}
+
+	_start(report, "div", "col-md-12 well well-lg horizontal-scroll");
+	if (_has_text(xccdf_benchmark_get_front_matter(report->benchmark))) {
+		_start(report, "div", "front-matter");
+		_write_xccdf_texts(report, xccdf_benchmark_get_front_matter(report->benchmark));
+		_end(report);
+	}
+	if (_has_text(xccdf_item_get_description(benchmark))) {
+		_start(report, "div", "description");
+		_write_xccdf_texts(report, xccdf_item_get_description(benchmark));
+		_end(report);
+	}
+	struct xccdf_notice_iterator *notices = xccdf_benchmark_get_notices(report->benchmark);
+	if (xccdf_notice_iterator_has_more(notices)) {
+		_start(report, "div", "top-spacer-10");
+		while (xccdf_notice_iterator_has_more(notices)) {
+			struct xccdf_notice *notice = xccdf_notice_iterator_next(notices);
+			_start(report, "div", "alert alert-info");
+			_write_xccdf_text(report, oscap_text_get_text(xccdf_notice_get_text(notice)), true);
+			_end(report);
+		}
+		_end(report);
+	}
+	xccdf_notice_iterator_free(notices);
+	_end(report);
+
+	_end(report);
+	_end(report);
+}
+
+static void _write_characteristics_row(struct xccdf_report *report, const char *header, const char *value)
+{
+	_start(report, "tr", NULL);
+	_element(report, "th", NULL, header);
+	_element(report, "td", NULL, value);
+	_end(report);
+}
+
+static bool _string_iterator_contains(struct oscap_string_iterator *it, const char *str)
+{
+	bool found = false;
+	while (!found && oscap_string_iterator_has_more(it))
+		found = oscap_streq(oscap_string_iterator_next(it), str);
+	oscap_string_iterator_free(it);
+	return found;
+}
+
+static void _write_platforms(struct xccdf_report *report, bool applicable)
+{
+	struct oscap_string_iterator *platforms = xccdf_benchmark_get_platforms(report->benchmark);
+	while (oscap_string_iterator_has_more(platforms)) {
+		const char *platform = oscap_string_iterator_next(platforms);
+		if (_string_iterator_contains(xccdf_result_get_applicable_platforms(report->result), platform) != applicable)
+			continue;
+		_start(report, "li", "list-group-item");
+		if (applicable) {
+			_start(report, "span", "label label-success");
+			_attrf(report, "title", "CPE platform %s was found applicable on the evaluated machine", platform);
+			_text(report, platform);
+			_end(report);
+		} else {
+			_label(report, "label label-default", "This CPE platform was not applicable on the evaluated machine", platform);
+		}
+		_end(report);
+	}
+	oscap_string_iterator_free(platforms);
+}
+
+static void _write_characteristics(struct xccdf_report *report)
+{
+	struct xccdf_result *result = report->result;
+
+	_start(report, "div", NULL);
+	_attr(report, "id", "characteristics");
+	_element(report, "h2", NULL, "Evaluation Characteristics");
+	_start(report, "div", "row");
+
+	_start(report, "div", "col-md-5 well well-lg horizontal-scroll");
+	_start(report, "table", "table table-bordered");
+	struct oscap_string_iterator *targets = xccdf_result_get_targets(result);
+	_write_characteristics_row(report, "Evaluation target",
+			oscap_string_iterator_has_more(targets) ? oscap_string_iterator_next(targets) : "");
+	oscap_string_iterator_free(targets);
+	const char *benchmark_uri = xccdf_result_get_benchmark_uri(result);
+	if (benchmark_uri != NULL) {
+		_write_characteristics_row(report, "Benchmark URL", benchmark_uri);
+		_write_characteristics_row(report, "Benchmark ID", xccdf_benchmark_get_id(report->benchmark));
+	}
+	if (xccdf_benchmark_get_version(report->benchmark) != NULL)
+		_write_characteristics_row(report, "Benchmark version", xccdf_benchmark_get_version(report->benchmark));
+	if (xccdf_result_get_profile(result) != NULL)
+		_write_characteristics_row(report, "Profile ID", xccdf_result_get_profile(result));
+	const char *start_time = xccdf_result_get_start_time(result);
+	_write_characteristics_row(report, "Started at", start_time != NULL ? start_time : "unknown time");
+	_write_characteristics_row(report, "Finished at", xccdf_result_get_end_time(result));
+	struct xccdf_identity_iterator *identities = xccdf_result_get_identities(result);
+	_write_characteristics_row(report, "Performed by", xccdf_identity_iterator_has_more(identities) ?
+			xccdf_identity_get_name(xccdf_identity_iterator_next(identities)) : "unknown user");
+	xccdf_identity_iterator_free(identities);
+	const char *test_system = xccdf_result_get_test_system(result);
+	_write_characteristics_row(report, "Test system", test_system != NULL ? test_system : "unknown");
+	_end(report);
+	_end(report);
+
+	_start(report, "div", "col-md-3 horizontal-scroll");
+	_element(report, "h4", NULL, "CPE Platforms");
+	_start(report, "ul", "list-group");
+	/* all the applicable platforms first */
+	_write_platforms(report, true);
+	_write_platforms(report, false);
+	_end(report);
+	_end(report);
+
+	_start(report, "div", "col-md-4 horizontal-scroll");
+	_element(report, "h4", NULL, "Addresses");
+	_start(report, "ul", "list-group");
+	struct oscap_htable *seen = oscap_htable_new();
+	struct oscap_string_iterator *addresses = xccdf_result_get_target_addresses(result);
+	while (oscap_string_iterator_has_more(addresses)) {
+		const char *address = oscap_string_iterator_next(addresses);
+		if (!oscap_htable_add(seen, address, (void *) address))
+			continue;
+		_start(report, "li", "list-group-item");
+		if (strchr(address, ':') != NULL)
+			_label(report, "label label-info", NULL, "IPv6");
+		else if (strchr(address, '.') != NULL)
+			_label(report, "label label-primary", NULL, "IPv4");
+		_nbsp(report);
+		_text(report, address);
+		_end(report);
+	}
+	oscap_string_iterator_free(addresses);
+	struct xccdf_target_fact_iterator *facts = xccdf_result_get_target_facts(result);
+	while (xccdf_target_fact_iterator_has_more(facts)) {
+		struct xccdf_target_fact *fact = xccdf_target_fact_iterator_next(facts);
+		const char *value = xccdf_target_fact_get_value(fact);
+		if (!oscap_streq(xccdf_target_fact_get_name(fact), "urn:xccdf:fact:ethernet:MAC") ||
+				value == NULL || !oscap_htable_add(seen, value, (void *) value))
+			continue;
+		_start(report, "li", "list-group-item");
+		_label(report, "label label-default", NULL, "MAC");
+		_nbsp(report);
+		_text(report, value);
+		_end(report);
+	}
+	xccdf_target_fact_iterator_free(facts);
+	oscap_htable_free0(seen);
+	_end(report);
+	_end(report);
+
+	_end(report);
+	_end(report);
+}
+
+/***************************************************************************/
+/* Compliance and scoring
+ * */
+
+static double _percent(int part, int total)
+{
+	return total > 0 ? (double) part / total * 100 : 0;
+}
+
+static void _write_progress_bar(struct xccdf_report *report, const char *class, double width, int count, const char *text)
+{
+	_start(report, "div", class);
+	_attrf(report, "style", "width: %g%%", width);
+	_textf(report, "%d %s", count, text);
+	_end(report);
+}
+
+static void _write_compliance_and_scoring(struct xccdf_report *report)
+{
+	int total = 0, ignored = 0, passed = 0, failed = 0, uncertain = 0;
+	int failed_low = 0, failed_medium = 0, failed_high = 0;
+
+	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(report->result);
+	while (xccdf_rule_result_iterator_has_more(rr_it)) {
+		struct xccdf_rule_result *rule_result = xccdf_rule_result_iterator_next(rr_it);
+		total++;
+		switch (xccdf_rule_result_get_result(rule_result)) {
+		case XCCDF_RESULT_NOT_SELECTED:
+		case XCCDF_RESULT_NOT_APPLICABLE:
+			ignored++;
+			break;
+		case XCCDF_RESULT_PASS:
+		case XCCDF_RESULT_FIXED:
+			passed++;
+			break;
+		case XCCDF_RESULT_FAIL:
+			failed++;
+			switch (xccdf_rule_result_get_severity(rule_result)) {
+			case XCCDF_LOW: failed_low++; break;
+			case XCCDF_MEDIUM: failed_medium++; break;
+			case XCCDF_HIGH: failed_high++; break;
+			default: break;
+			}
+			break;
+		case XCCDF_RESULT_ERROR:
+		case XCCDF_RESULT_UNKNOWN:
+			uncertain++;
+			break;
+		default:
+			break;
+		}
+	}
+	xccdf_rule_result_iterator_free(rr_it);
+	int considered = total - ignored;
+	int failed_other = failed - failed_low - failed_medium - failed_high;
+
+	_start(report, "div", NULL);
+	_attr(report, "id", "compliance-and-scoring");
+	_element(report, "h2", NULL, "Compliance and Scoring");
+
+	if (failed > 0) {
+		_start(report, "div", "alert alert-danger");
+		_start(report, "strong", NULL);
+		_textf(report, "The target system did not satisfy the conditions of %d rules!", failed);
+		_end(report);
+		if (uncertain > 0)
+			_textf(report, " Furthermore, the results of %d rules were inconclusive.", uncertain);
+		_text(report, " Please review rule results and consider applying remediation.");
+		_end(report);
+	} else if (uncertain > 0) {
+		_start(report, "div", "alert alert-warning");
+		_start(report, "strong", NULL);
+		_textf(report, "There were no failed rules, but the results of %d rules were inconclusive!", uncertain);
+		_end(report);
+		_text(report, " Please review rule results and consider applying remediation.");
+		_end(report);
+	} else {
+		_start(report, "div", "alert alert-success");
+		_element(report, "strong", NULL, "There were no failed or uncertain rules.");
+		_text(report, " It seems that no action is necessary.");
+		_end(report);
+	}
+
+	_element(report, "h3", NULL, "Rule results");
+	_start(report, "div", "progress");
+	_attrf(report, "title", "Displays proportion of passed/fixed, failed/error, and other rules (in that order). "
+			"There were %d rules taken into account.", considered);
+	_write_progress_bar(report, "progress-bar progress-bar-success", _percent(passed, considered), passed, "passed");
+	_write_progress_bar(report, "progress-bar progress-bar-danger", _percent(failed, considered), failed, "failed");
+	_write_progress_bar(report, "progress-bar progress-bar-warning", _percent(considered - passed - failed, considered),
+			considered - passed - failed, "other");
+	_end(report);
+
+	_element(report, "h3", NULL, "Severity of failed rules");
+	_start(report, "div", "progress");
+	_attrf(report, "title", "Displays proportion of high, medium, low, and other severity failed rules (in that order). "
+			"There were %d total failed rules.", failed);
+	_write_progress_bar(report, "progress-bar progress-bar-success", _percent(failed_other, failed), failed_other, "other");
+	_write_progress_bar(report, "progress-bar progress-bar-info", _percent(failed_low, failed), failed_low, "low");
+	_write_progress_bar(report, "progress-bar progress-bar-warning", _percent(failed_medium, failed), failed_medium, "medium");
+	_write_progress_bar(report, "progress-bar progress-bar-danger", _percent(failed_high, failed), failed_high, "high");
+	_end(report);
+
+	_start(report, "h3", NULL);
+	_attr(report, "title", "As per the XCCDF specification");
+	_text(report, "Score");
+	_end(report);
+	_start(report, "table", "table table-striped table-bordered");
+	_start(report, "thead", NULL);
+	_start(report, "tr", NULL);
+	_element(report, "th", NULL, "Scoring system");
+	_element(report, "th", "text-center", "Score");
+	_element(report, "th", "text-center", "Maximum");
+	_start(report, "th", "text-center");
+	_attr(report, "style", "width: 40%");
+	_text(report, "Percent");
+	_end(report);
+	_end(report);
+	_end(report);
+	_start(report, "tbody", NULL);
+	struct xccdf_score_iterator *scores = xccdf_result_get_scores(report->result);
+	while (xccdf_score_iterator_has_more(scores)) {
+		struct xccdf_score *score = xccdf_score_iterator_next(scores);
+		float value = xccdf_score_get_score(score);
+		float maximum = xccdf_score_get_maximum(score);
+		double percent = maximum != 0 ? value / maximum * 100 : 0;
+		double rounded = round(percent * 100) / 100;
+
+		_start(report, "tr", NULL);
+		_element(report, "td", NULL, xccdf_score_get_system(score));
+		_start(report, "td", "text-center");
+		_textf(report, "%f", value);
+		_end(report);
+		_start(report, "td", "text-center");
+		_textf(report, "%f", maximum);
+		_end(report);
+		_start(report, "td", NULL);
+		_start(report, "div", "progress");
+		_start(report, "div", "progress-bar progress-bar-success");
+		_attrf(report, "style", "width: %g%%", percent);
+		if (percent >= 50)
+			_textf(report, "%g%%", rounded);
+		_end(report);
+		_start(report, "div", "progress-bar progress-bar-danger");
+		_attrf(report, "style", "width: %g%%", 100 - percent);
+		if (percent < 50)
+			_textf(report, "%g%%", rounded);
+		_end(report);
+		_end(report);
+		_end(report);
+		_end(report);
+	}
+	xccdf_score_iterator_free(scores);
+	_end(report);
+	_end(report);
+
+	_end(report);
+}
+
+/***************************************************************************/
+/* Rule overview
+ * */
+
+static int _reference_cmp(const void *a, const void *b)
+{
+	struct oscap_reference *const *ra = a;
+	struct oscap_reference *const *rb = b;
+	int cmp = strcmp(oscap_reference_get_href(*ra), oscap_reference_get_href(*rb));
+	/* keep the document order of references with the same href */
+	return cmp != 0 ? cmp : (ra < rb ? -1 : (ra > rb));
+}
+
+static void _json_string(struct oscap_string *json, const char *str)
+{
+	oscap_string_append_char(json, '"');
+	for (; *str != '\0'; str++) {
+		if (*str == '"' || *str == '\\')
+			oscap_string_append_char(json, '\\');
+		oscap_string_append_char(json, *str);
+	}
+	oscap_string_append_char(json, '"');
+}
+
+/* References of the rule grouped by their href, see references-to-json in xccdf-report-impl.xsl */
+static char *_references_to_json(struct xccdf_item *item)
+{
+	struct oscap_list *list = oscap_list_new();
+	struct oscap_reference_iterator *references = xccdf_item_get_references(item);
+	while (oscap_reference_iterator_has_more(references)) {
+		struct oscap_reference *ref = oscap_reference_iterator_next(references);
+		if (oscap_reference_get_href(ref) != NULL && *oscap_reference_get_href(ref) != '\0')
+			oscap_list_add(list, ref);
+	}
+	oscap_reference_iterator_free(references);
+
+	int count = oscap_list_get_itemcount(list);
+	struct oscap_reference **refs = malloc((count + 1) * sizeof(struct oscap_reference *));
+	int i = 0;
+	struct oscap_iterator *it = oscap_iterator_new(list);
+	while (oscap_iterator_has_more(it))
+		refs[i++] = oscap_iterator_next(it);
+	oscap_iterator_free(it);
+	oscap_list_free0(list);
+	qsort(refs, count, sizeof(struct oscap_reference *), _reference_cmp);
+
+	struct oscap_string *json = oscap_string_new();
+	oscap_string_append_char(json, '{');
+	for (i = 0; i < count; i++) {
+		const char *href = oscap_reference_get_href(refs[i]);
+		bool first = (i == 0 || strcmp(href, oscap_reference_get_href(refs[i - 1])) != 0);
+		if (first) {
+			if (i != 0)
+				oscap_string_append_string(json, "],");
+			_json_string(json, _reference_name(href));
+			oscap_string_append_string(json, ":[");
+		} else {
+			oscap_string_append_char(json, ',');
+		}
+		char *text = oscap_trim(oscap_strdup(oscap_reference_get_title(refs[i])));
+		_json_string(json, (text != NULL && *text != '\0') ? text : "unknown");
+		free(text);
+	}
+	if (count > 0)
+		oscap_string_append_char(json, ']');
+	oscap_string_append_char(json, '}');
+	free(refs);
+	return oscap_string_bequeath(json);
+}
+
+static void _write_result_cell(struct xccdf_report *report, xccdf_test_result_type_t result, const char *class)
+{
+	const char *result_text = xccdf_test_result_type_get_text(result);
+	_start(report, "td", NULL);
+	_attrf(report, "class", "%srule-result rule-result-%s", class, result_text);
+	_start(report, "div", NULL);
+	_abbr(report, _result_tooltip(result), result_text);
+	_end(report);
+	_end(report);
+}
+
+static struct xccdf_check *_rule_result_check(struct xccdf_rule_result *rule_result)
+{
+	struct xccdf_check_iterator *checks = xccdf_rule_result_get_checks(rule_result);
+	struct xccdf_check *check = xccdf_check_iterator_has_more(checks) ? xccdf_check_iterator_next(checks) : NULL;
+	xccdf_check_iterator_free(checks);
+	return check;
+}
+
+static const char *_check_content_ref_name(struct xccdf_check *check)
+{
+	struct xccdf_check_content_ref_iterator *refs = xccdf_check_get_content_refs(check);
+	const char *name = xccdf_check_content_ref_iterator_has_more(refs) ?
+			xccdf_check_content_ref_get_name(xccdf_check_content_ref_iterator_next(refs)) : NULL;
+	xccdf_check_content_ref_iterator_free(refs);
+	return name;
+}
+
+static void _write_rule_overview_leaf(struct xccdf_report *report, struct xccdf_item *item, int indent)
+{
+	struct oscap_list *results = oscap_htable_get(report->rule_results, xccdf_item_get_id(item));
+	if (results == NULL)
+		return;
+
+	char *references = NULL;
+	struct oscap_iterator *it = oscap_iterator_new(results);
+	while (oscap_iterator_has_more(it)) {
+		struct report_rule_result *rr = oscap_iterator_next(it);
+		xccdf_test_result_type_t result = xccdf_rule_result_get_result(rr->rule_result);
+		if (result == XCCDF_RESULT_NOT_SELECTED)
+			continue;
+		const char *id = xccdf_item_get_id(item);
+		const char *result_text = xccdf_test_result_type_get_text(result);
+		if (references == NULL)
+			references = _references_to_json(item);
+
+		_start(report, "tr", NULL);
+		_attr(report, "data-tt-id", id);
+		if (result == XCCDF_RESULT_FAIL || result == XCCDF_RESULT_ERROR || result == XCCDF_RESULT_UNKNOWN)
+			_attrf(report, "class", "rule-overview-leaf rule-overview-leaf-%s rule-overview-needs-attention", result_text);
+		else
+			_attrf(report, "class", "rule-overview-leaf rule-overview-leaf-%s rule-overview-leaf-id-%s", result_text, id);
+		_attrf(report, "id", "rule-overview-leaf-rr%d", rr->index);
+		_attr(report, "data-tt-parent-id", xccdf_item_get_id(xccdf_item_get_parent(item)));
+		_attr(report, "data-references", references);
+
+		_start(report, "td", NULL);
+		_attrf(report, "style", "padding-left: %dpx", indent * 19);
+		_start(report, "a", NULL);
+		_attrf(report, "href", "#rule-detail-rr%d", rr->index);
+		_attrf(report, "onclick", "return openRuleDetailsDialog('rr%d')", rr->index);
+		_write_item_title(report, item);
+		_end(report);
+		struct xccdf_check *check = _rule_result_check(rr->rule_result);
+		if (check != NULL && xccdf_check_get_multicheck(check))
+			_textf(report, " (%s)", _check_content_ref_name(check));
+		struct xccdf_override_iterator *overrides = xccdf_rule_result_get_overrides(rr->rule_result);
+		if (xccdf_override_iterator_has_more(overrides)) {
+			_nbsp(report);
+			_label(report, "label label-warning", NULL, "waived");
+		}
+		xccdf_override_iterator_free(overrides);
+		_end(report);
+
+		_start(report, "td", "rule-severity");
+		_attr(report, "style", "text-align: center");
+		_text(report, _severity_text(xccdf_rule_result_get_severity(rr->rule_result)));
+		_end(report);
+		_write_result_cell(report, result, "");
+		_end(report);
+	}
+	oscap_iterator_free(it);
+	free(references);
+}
+
+static void _write_badge(struct xccdf_report *report, int count, const char *text)
+{
+	if (count <= 0)
+		return;
+	_nbsp(report);
+	_start(report, "span", "badge");
+	_textf(report, "%dx %s", count, text);
+	_end(report);
+}
+
+static void _write_rule_overview_node(struct xccdf_report *report, struct xccdf_item *item, int indent)
+{
+	const char *id = xccdf_item_get_id(item);
+	struct report_counts *counts = oscap_htable_get(report->counts, id);
+	if (counts == NULL || counts->notselected >= counts->rules)
+		return;
+
+	_start(report, "tr", NULL);
+	_attr(report, "data-tt-id", id);
+	_attrf(report, "class", "rule-overview-inner-node rule-overview-inner-node-id-%s", id);
+	struct xccdf_item *parent = xccdf_item_get_parent(item);
+	if (parent != NULL)
+		_attr(report, "data-tt-parent-id", xccdf_item_get_id(parent));
+	_start(report, "td", NULL);
+	_attr(report, "colspan", "3");
+	_attrf(report, "style", "padding-left: %dpx", indent * 19);
+	if (counts->fail + counts->error + counts->unknown + counts->notchecked > 0) {
+		_start(report, "strong", NULL);
+		_write_item_title(report, item);
+		_end(report);
+		_write_badge(report, counts->fail, "fail");
+		_write_badge(report, counts->error, "error");
+		_write_badge(report, counts->unknown, "unknown");
+		_write_badge(report, counts->notchecked, "notchecked");
+	} else {
+		_write_item_title(report, item);
+		_start(report, "script", NULL);
+		_text(report, "$(document).ready(function(){$('.treetable').treetable(\"collapseNode\",\"");
+		_text(report, id);
+		_text(report, "\");});");
+		_end(report);
+	}
+	_end(report);
+	_end(report);
+
+	/* groups first, then rules */
+	struct xccdf_item_iterator *content = _item_content(item);
+	while (xccdf_item_iterator_has_more(content)) {
+		struct xccdf_item *child = xccdf_item_iterator_next(content);
+		if (xccdf_item_get_type(child) == XCCDF_GROUP)
+			_write_rule_overview_node(report, child, indent + 1);
+	}
+	xccdf_item_iterator_reset(content);
+	while (xccdf_item_iterator_has_more(content)) {
+		struct xccdf_item *child = xccdf_item_iterator_next(content);
+		if (xccdf_item_get_type(child) == XCCDF_RULE)
+			_write_rule_overview_leaf(report, child, indent + 1);
+	}
+	xccdf_item_iterator_free(content);
+}
+
+static void _write_rule_display_toggle(struct xccdf_report *report, const char *value)
+{
+	_start(report, "div", "checkbox");
+	_start(report, "label", NULL);
+	_start(report, "input", "toggle-rule-display");
+	_attr(report, "type", "checkbox");
+	_attr(report, "onclick", "toggleRuleDisplay(this)");
+	_attr(report, "checked", "checked");
+	_attr(report, "value", value);
+	_end_void(report);
+	_text(report, value);
+	_end(report);
+	_end(report);
+}
+
+static int _strcmp_ptr(const void *a, const void *b)
+{
+	return strcmp(*(const char *const *) a, *(const char *const *) b);
+}
+
+static void _write_reference_options(struct xccdf_report *report)
+{
+	size_t count = 0, size = 16;
+	const char **hrefs = malloc(size * sizeof(const char *));
+	struct oscap_htable_iterator *it = oscap_htable_iterator_new(report->references);
+	while (oscap_htable_iterator_has_more(it)) {
+		if (count == size) {
+			size *= 2;
+			hrefs = realloc(hrefs, size * sizeof(const char *));
+		}
+		hrefs[count++] = oscap_htable_iterator_next_key(it);
+	}
+	oscap_htable_iterator_free(it);
+	qsort(hrefs, count, sizeof(const char *), _strcmp_ptr);
+
+	for (size_t i = 0; i < count; i++) {
+		const char *name = oscap_htable_get(report->references, hrefs[i]);
+		_start(report, "option", NULL);
+		_attr(report, "value", name);
+		_text(report, name);
+		_end(report);
+	}
+	free(hrefs);
+}
+
+static void _write_rule_overview(struct xccdf_report *report)
+{
+	_start(report, "div", NULL);
+	_attr(report, "id", "rule-overview");
+	_element(report, "h2", NULL, "Rule Overview");
+
+	_start(report, "div", "form-group js-only hidden-print");
+	_start(report, "div", "row");
+	_start(report, "div", NULL);
+	_attr(report, "title", "Filter rules by their XCCDF result");
+	_start(report, "div", "col-sm-2 toggle-rule-display-success");
+	_write_rule_display_toggle(report, "pass");
+	_write_rule_display_toggle(report, "fixed");
+	_write_rule_display_toggle(report, "informational");
+	_end(report);
+	_start(report, "div", "col-sm-2 toggle-rule-display-danger");
+	_write_rule_display_toggle(report, "fail");
+	_write_rule_display_toggle(report, "error");
+	_write_rule_display_toggle(report, "unknown");
+	_end(report);
+	_start(report, "div", "col-sm-2 toggle-rule-display-other");
+	_write_rule_display_toggle(report, "notchecked");
+	_write_rule_display_toggle(report, "notapplicable");
+	_end(report);
+	_end(report);
+
+	_start(report, "div", "col-sm-6");
+	_start(report, "div", "input-group");
+	_start(report, "input", "form-control");
+	_attr(report, "type", "text");
+	_attr(report, "placeholder", "Search through XCCDF rules");
+	_attr(report, "id", "search-input");
+	_attr(report, "oninput", "ruleSearch()");
+	_end_void(report);
+	_start(report, "div", "input-group-btn");
+	_start(report, "button", "btn btn-default");
+	_attr(report, "onclick", "ruleSearch()");
+	_text(report, "Search");
+	_end(report);
+	_end(report);
+	_end(report);
+	_start(report, "p", NULL);
+	_attr(report, "id", "search-matches");
+	_end(report);
+	_text(report, "Group rules by:");
+	_start(report, "select", NULL);
+	_attr(report, "name", "groupby");
+	_attr(report, "onchange", "groupRulesBy(value)");
+	_start(report, "option", NULL);
+	_attr(report, "value", "default");
+	_attr(report, "selected", "selected");
+	_text(report, "Default");
+	_end(report);
+	_start(report, "option", NULL);
+	_attr(report, "value", "severity");
+	_text(report, "Severity");
+	_end(report);
+	_start(report, "option", NULL);
+	_attr(report, "value", "result");
+	_text(report, "Result");
+	_end(report);
+	_start(report, "option", NULL);
+	_attr(report, "disabled", "disabled");
+	_text(report, "──────────");
+	_end(report);
+	_write_reference_options(report);
+	_end(report);
+	_end(report);
+	_end(report);
+	_end(report);
+
+	_start(report, "table", "treetable table table-bordered");
+	_start(report, "thead", NULL);
+	_start(report, "tr", NULL);
+	_element(report, "th", NULL, "Title");
+	_start(report, "th", NULL);
+	_attr(report, "style", "width: 120px; text-align: center");
+	_text(report, "Severity");
+	_end(report);
+	_start(report, "th", NULL);
+	_attr(report, "style", "width: 120px; text-align: center");
+	_text(report, "Result");
+	_end(report);
+	_end(report);
+	_end(report);
+	_start(report, "tbody", NULL);
+	_write_rule_overview_node(report, XITEM(report->benchmark), 0);
+	_end(report);
+	_end(report);
+
+	_end(report);
+}
+
+/***************************************************************************/
+/* OVAL details
+ * */
+
+static struct oval_result_definition *_oval_definition(struct xccdf_report *report, const char *href, const char *name)
+{
+	if (report->oval_agents == NULL || name == NULL)
+		return NULL;
+
+	struct oval_result_definition *definition = NULL;
+	/* the agent of the referenced file first, then any other */
+	for (int pass = 0; pass < 2 && definition == NULL; pass++) {
+		for (int i = 0; report->oval_agents[i] != NULL && definition == NULL; i++) {
+			bool same_file = oscap_streq(oval_agent_get_filename(report->oval_agents[i]), href);
+			if (same_file != (pass == 0))
+				continue;
+			struct oval_results_model *model = oval_agent_get_results_model(report->oval_agents[i]);
+			struct oval_result_system_iterator *systems = oval_results_model_get_systems(model);
+			if (oval_result_system_iterator_has_more(systems))
+				definition = oval_result_system_get_definition(oval_result_system_iterator_next(systems), name);
+			oval_result_system_iterator_free(systems);
+		}
+	}
+	return definition;
+}
+
+static const char *_sysent_value(struct oval_sysitem *sysitem, const char *name)
+{
+	const char *value = NULL;
+	struct oval_sysent_iterator *sysents = oval_sysitem_get_sysents(sysitem);
+	while (value == NULL && oval_sysent_iterator_has_more(sysents)) {
+		struct oval_sysent *sysent = oval_sysent_iterator_next(sysents);
+		if (oscap_streq(oval_sysent_get_name(sysent), name))
+			value = oval_sysent_get_value(sysent);
+	}
+	oval_sysent_iterator_free(sysents);
+	return value != NULL ? value : "";
+}
+
+static void _write_sysitem_head(struct xccdf_report *report, struct oval_sysitem *sysitem)
+{
+	static const char *FILE_HEAD[] = {"Path", "Type", "UID", "GID", "Size (B)", "Permissions", NULL};
+	static const char *TEXTFILECONTENT_HEAD[] = {"Path", "Content", NULL};
+
+	_start(report, "tr", NULL);
+	const char **head = NULL;
+	switch ((int) oval_sysitem_get_subtype(sysitem)) {
+	case OVAL_UNIX_FILE:
+		head = FILE_HEAD;
+		break;
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT_54:
+		head = TEXTFILECONTENT_HEAD;
+		break;
+	default:
+		break;
+	}
+	if (head != NULL) {
+		for (int i = 0; head[i] != NULL; i++)
+			_element(report, "th", NULL, head[i]);
+	} else {
+		struct oval_sysent_iterator *sysents = oval_sysitem_get_sysents(sysitem);
+		while (oval_sysent_iterator_has_more(sysents)) {
+			char *label = oscap_strdup(oval_sysent_get_name(oval_sysent_iterator_next(sysents)));
+			for (char *c = label; c != NULL && *c != '\0'; c++) {
+				if (*c == '_')
+					*c = ' ';
+			}
+			if (label != NULL && *label >= 'a' && *label <= 'z')
+				*label -= 'a' - 'A';
+			_element(report, "th", NULL, label);
+			free(label);
+		}
+		oval_sysent_iterator_free(sysents);
+	}
+	_end(report);
+}
+
+static void _write_sysitem_path(struct xccdf_report *report, struct oval_sysitem *sysitem)
+{
+	_start(report, "td", NULL);
+	_textf(report, "%s/%s", _sysent_value(sysitem, "path"), _sysent_value(sysitem, "filename"));
+	_end(report);
+}
+
+static char _permission(struct oval_sysitem *sysitem, const char *name, char set)
+{
+	return oscap_streq(_sysent_value(sysitem, name), "true") ? set : '-';
+}
+
+static void _write_sysitem_body(struct xccdf_report *report, struct oval_sysitem *sysitem)
+{
+	_start(report, "tr", NULL);
+	switch ((int) oval_sysitem_get_subtype(sysitem)) {
+	case OVAL_UNIX_FILE: {
+		_write_sysitem_path(report, sysitem);
+		_element(report, "td", NULL, _sysent_value(sysitem, "type"));
+		_element(report, "td", NULL, _sysent_value(sysitem, "user_id"));
+		_element(report, "td", NULL, _sysent_value(sysitem, "group_id"));
+		_element(report, "td", NULL, _sysent_value(sysitem, "size"));
+		char permissions[] = {
+			_permission(sysitem, "uread", 'r'), _permission(sysitem, "uwrite", 'w'),
+			oscap_streq(_sysent_value(sysitem, "suid"), "true") ? 's' : _permission(sysitem, "uexec", 'x'),
+			_permission(sysitem, "gread", 'r'), _permission(sysitem, "gwrite", 'w'),
+			oscap_streq(_sysent_value(sysitem, "sgid"), "true") ? 's' : _permission(sysitem, "gexec", 'x'),
+			_permission(sysitem, "oread", 'r'), _permission(sysitem, "owrite", 'w'),
+			_permission(sysitem, "oexec", 'x'), '\0'
+		};
+		_start(report, "td", NULL);
+		_start(report, "code", NULL);
+		_text(report, permissions);
+		if (oscap_streq(_sysent_value(sysitem, "sticky"), "true"))
+			_text(report, "t");
+		else
+			_nbsp(report);
+		_end(report);
+		_end(report);
+		break;
+	}
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT_54:
+		_write_sysitem_path(report, sysitem);
+		_element(report, "td", NULL, _sysent_value(sysitem, "text"));
+		break;
+	default: {
+		struct oval_sysent_iterator *sysents = oval_sysitem_get_sysents(sysitem);
+		while (oval_sysent_iterator_has_more(sysents))
+			_element(report, "td", NULL, oval_sysent_get_value(oval_sysent_iterator_next(sysents)));
+		oval_sysent_iterator_free(sysents);
+		break;
+	}
+	}
+	_end(report);
+}
+
+static void _write_oval_test(struct xccdf_report *report, struct oval_result_test *rtest)
+{
+	struct oval_test *test = oval_result_test_get_test(rtest);
+	oval_result_t result = oval_result_test_get_result(rtest);
+	const char *comment = oval_test_get_comment(test);
+
+	_start(report, "h4", NULL);
+	if (comment != NULL) {
+		_label(report, "label label-primary", NULL, comment);
+		_nbsp(report);
+	}
+	_label(report, "label label-default", NULL, oval_test_get_id(test));
+	_nbsp(report);
+	_label(report, result == OVAL_RESULT_TRUE ? "label label-success" : "label label-danger", NULL,
+			oval_result_get_text(result));
+	_end(report);
+
+	int count = 0;
+	struct oval_result_item_iterator *items = oval_result_test_get_items(rtest);
+	while (oval_result_item_iterator_has_more(items)) {
+		struct oval_sysitem *sysitem = oval_result_item_get_sysitem(oval_result_item_iterator_next(items));
+		if (count == 0) {
+			_element(report, "h5", NULL, "Following items have been found on the system:");
+			_start(report, "table", "table table-striped table-bordered");
+			_start(report, "thead", NULL);
+			_write_sysitem_head(report, sysitem);
+			_end(report);
+			_start(report, "tbody", NULL);
+		}
+		/* the table is limited to 100 lines */
+		if (count < REPORT_MAX_OVAL_ITEMS)
+			_write_sysitem_body(report, sysitem);
+		count++;
+	}
+	oval_result_item_iterator_free(items);
+
+	if (count > 0) {
+		_end(report);
+		_end(report);
+		if (count > REPORT_MAX_OVAL_ITEMS)
+			_textf(report, "... and %d more items.", count - REPORT_MAX_OVAL_ITEMS);
+		return;
+	}
+
+	/* The tested object does not exist or an error occurred while accessing it */
+	struct oval_object *object = oval_test_get_object(test);
+	if (object == NULL)
+		return;
+	_element(report, "h5", NULL, "No items have been found conforming to the following objects:");
+	_start(report, "h5", NULL);
+	_text(report, "Object ");
+	_start(report, "strong", NULL);
+	_start(report, "abbr", NULL);
+	if (oval_object_get_comment(object) != NULL)
+		_attr(report, "title", oval_object_get_comment(object));
+	_text(report, oval_object_get_id(object));
+	_end(report);
+	_end(report);
+	_text(report, " of type ");
+	_start(report, "strong", NULL);
+	_textf(report, "%s_object", oval_subtype_get_text(oval_object_get_subtype(object)));
+	_end(report);
+	_end(report);
+}
+
+static void _write_oval_criteria(struct xccdf_report *report, struct oval_result_criteria_node *node)
+{
+	if (node == NULL)
+		return;
+
+	switch (oval_result_criteria_node_get_type(node)) {
+	case OVAL_NODETYPE_CRITERIA: {
+		struct oval_result_criteria_node_iterator *subnodes = oval_result_criteria_node_get_subnodes(node);
+		while (oval_result_criteria_node_iterator_has_more(subnodes))
+			_write_oval_criteria(report, oval_result_criteria_node_iterator_next(subnodes));
+		oval_result_criteria_node_iterator_free(subnodes);
+		break;
+	}
+	case OVAL_NODETYPE_CRITERION: {
+		struct oval_result_test *rtest = oval_result_criteria_node_get_test(node);
+		if (rtest != NULL)
+			_write_oval_test(report, rtest);
+		break;
+	}
+	case OVAL_NODETYPE_EXTENDDEF: {
+		struct oval_result_definition *definition = oval_result_criteria_node_get_extends(node);
+		if (definition != NULL)
+			_write_oval_criteria(report, oval_result_definition_get_criteria(definition));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/* Details of the check system, returns false if there were none */
+static bool _write_check_system_details(struct xccdf_report *report, struct xccdf_check *check, bool started)
+{
+	const char *system = xccdf_check_get_system(check);
+	if (oscap_streq(system, REPORT_OVAL_SYSTEM)) {
+		struct xccdf_check_content_ref_iterator *refs = xccdf_check_get_content_refs(check);
+		while (xccdf_check_content_ref_iterator_has_more(refs)) {
+			struct xccdf_check_content_ref *ref = xccdf_check_content_ref_iterator_next(refs);
+			const char *href = xccdf_check_content_ref_get_href(ref);
+			struct oval_result_definition *definition =
+				_oval_definition(report, href, xccdf_check_content_ref_get_name(ref));
+			if (definition == NULL || oval_result_definition_get_criteria(definition) == NULL)
+				continue;
+			if (!started) {
+				_start(report, "div", "check-system-details");
+				started = true;
+			}
+			_start(report, "span", "label label-default");
+			_start(report, "abbr", NULL);
+			_attrf(report, "title", "OVAL details taken from results of '%s'", href != NULL ? href : "");
+			_text(report, "OVAL test results details");
+			_end(report);
+			_end(report);
+			_start(report, "div", "panel panel-default");
+			_start(report, "div", "panel-body");
+			_write_oval_criteria(report, oval_result_definition_get_criteria(definition));
+			_end(report);
+			_end(report);
+		}
+		xccdf_check_content_ref_iterator_free(refs);
+	} else if (oscap_streq(system, REPORT_SCE_SYSTEM)) {
+		struct xccdf_check_import_iterator *imports = xccdf_check_get_imports(check);
+		while (xccdf_check_import_iterator_has_more(imports)) {
+			struct xccdf_check_import *import = xccdf_check_import_iterator_next(imports);
+			const char *name = xccdf_check_import_get_name(import);
+			const char *content = xccdf_check_import_get_content(import);
+			if (content == NULL || *content == '\0' || (!oscap_streq(name, "stdout") && !oscap_streq(name, "stderr")))
+				continue;
+			if (!started) {
+				_start(report, "div", "check-system-details");
+				started = true;
+			}
+			char *title = oscap_sprintf("Script Check Engine %s taken from check-import", name);
+			char *label = oscap_sprintf("SCE %s", name);
+			_start(report, "span", "label label-default");
+			_abbr(report, title, label);
+			_end(report);
+			_start(report, "pre", NULL);
+			_element(report, "code", NULL, content);
+			_end(report);
+			free(label);
+			free(title);
+		}
+		xccdf_check_import_iterator_free(imports);
+	}
+	return started;
+}
+
+/***************************************************************************/
+/* Result details
+ * */
+
+static void _write_idents_refs(struct xccdf_report *report, struct xccdf_item *item)
+{
+	struct xccdf_ident_iterator *idents = xccdf_rule_get_idents(XRULE(item));
+	if (xccdf_ident_iterator_has_more(idents)) {
+		_start(report, "p", NULL);
+		_label(report, "label label-info", "A globally meaningful identifiers for this rule. MAY be the name "
+				"or identifier of a security configuration issue or vulnerability that the rule remediates. "
+				"By setting an identifier on a rule, the benchmark author effectively declares that the rule "
+				"instantiates, implements, or remediates the issue for which the name was assigned.", "Identifiers:");
+		_nbsp(report);
+		bool first = true;
+		while (xccdf_ident_iterator_has_more(idents)) {
+			struct xccdf_ident *ident = xccdf_ident_iterator_next(idents);
+			const char *system = xccdf_ident_get_system(ident);
+			const char *id = xccdf_ident_get_id(ident);
+			char *title = oscap_sprintf("%s: %s", system != NULL ? system : "", id != NULL ? id : "");
+			if (!first)
+				_text(report, ", ");
+			first = false;
+			if (system != NULL && oscap_str_startswith(system, "http://cve.mitre.org")) {
+				_start(report, "a", NULL);
+				_attrf(report, "href", "https://cve.mitre.org/cgi-bin/cvename.cgi?name=%s", id);
+				_abbr(report, title, id);
+				_end(report);
+			} else if (system != NULL && oscap_str_startswith(system, "https://access.redhat.com/errata")) {
+				_start(report, "a", NULL);
+				_attrf(report, "href", "https://access.redhat.com/errata/%s.html", id);
+				_abbr(report, title, id);
+				_end(report);
+			} else {
+				_abbr(report, title, id);
+			}
+			free(title);
+		}
+		_end(report);
+	}
+	xccdf_ident_iterator_free(idents);
+
+	struct oscap_reference_iterator *references = xccdf_item_get_references(item);
+	if (oscap_reference_iterator_has_more(references)) {
+		_start(report, "p", NULL);
+		_label(report, "label label-default", "Provide a reference to a document or resource where the user "
+				"can learn more about the subject of the Rule or Group.", "References:");
+		_nbsp(report);
+		bool first = true;
+		while (oscap_reference_iterator_has_more(references)) {
+			struct oscap_reference *ref = oscap_reference_iterator_next(references);
+			const char *href = oscap_reference_get_href(ref);
+			const char *text = oscap_reference_get_title(ref);
+			if (!first)
+				_text(report, ", ");
+			first = false;
+			if (href != NULL) {
+				_start(report, "a", NULL);
+				_attr(report, "href", href);
+				_text(report, (text != NULL && *text != '\0') ? text : href);
+				_end(report);
+			} else {
+				_text(report, text);
+			}
+		}
+		_end(report);
+	}
+	oscap_reference_iterator_free(references);
+}
+
+static void _write_details_row(struct xccdf_report *report, const char *header, const char *class)
+{
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, header);
+	_start(report, "td", NULL);
+	_start(report, "div", class);
+}
+
+static void _write_details_row_end(struct xccdf_report *report)
+{
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+static void _write_fix(struct xccdf_report *report, struct xccdf_fix *fix, int id)
+{
+	const char *system = xccdf_fix_get_system(fix);
+	const char *fix_type = "script";
+	if (oscap_streq(system, "urn:xccdf:fix:script:sh"))
+		fix_type = "Shell script";
+	else if (oscap_streq(system, "urn:xccdf:fix:script:ansible"))
+		fix_type = "Ansible snippet";
+	else if (oscap_streq(system, "urn:xccdf:fix:script:puppet"))
+		fix_type = "Puppet snippet";
+	else if (oscap_streq(system, "urn:redhat:anaconda:pre"))
+		fix_type = "Anaconda snippet";
+
+	_start(report, "a", "btn btn-success");
+	_attr(report, "data-toggle", "collapse");
+	_attrf(report, "data-target", "#fix-%d", id);
+	_attr(report, "tabindex", "0");
+	_attr(report, "role", "button");
+	_attr(report, "aria-expanded", "false");
+	_attr(report, "title", "Activate to reveal");
+	_attr(report, "href", "#!");
+	_textf(report, "Remediation %s ", fix_type);
+	_raw(report, "&#8690;");
+	_end(report);
+	_start(report, "br", NULL);
+	_end_void(report);
+
+	_start(report, "div", "panel-collapse collapse");
+	_attrf(report, "id", "fix-%d", id);
+	xccdf_level_t complexity = xccdf_fix_get_complexity(fix);
+	xccdf_level_t disruption = xccdf_fix_get_disruption(fix);
+	xccdf_strategy_t strategy = xccdf_fix_get_strategy(fix);
+	bool reboot = xccdf_fix_get_reboot(fix);
+	if (complexity != XCCDF_LEVEL_NOT_DEFINED || disruption != XCCDF_LEVEL_NOT_DEFINED ||
+			strategy != XCCDF_STRATEGY_UNKNOWN || reboot) {
+		_start(report, "table", "table table-striped table-bordered table-condensed");
+		if (complexity != XCCDF_LEVEL_NOT_DEFINED)
+			_write_characteristics_row(report, "Complexity:", _severity_text(complexity));
+		if (disruption != XCCDF_LEVEL_NOT_DEFINED)
+			_write_characteristics_row(report, "Disruption:", _severity_text(disruption));
+		if (reboot)
+			_write_characteristics_row(report, "Reboot:", "true");
+		if (strategy != XCCDF_STRATEGY_UNKNOWN)
+			_write_characteristics_row(report, "Strategy:", oscap_enum_to_string(XCCDF_STRATEGY_MAP, strategy));
+		_end(report);
+	}
+	_start(report, "pre", NULL);
+	_start(report, "code", NULL);
+	_write_xccdf_text(report, xccdf_fix_get_content(fix), false);
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+static void _write_result_details_table(struct xccdf_report *report, struct xccdf_item *item, struct report_rule_result *rr)
+{
+	struct xccdf_rule_result *rule_result = rr->rule_result;
+	xccdf_test_result_type_t result = xccdf_rule_result_get_result(rule_result);
+	struct xccdf_check *check = _rule_result_check(rule_result);
+
+	_start(report, "table", "table table-striped table-bordered");
+	_start(report, "tbody", NULL);
+
+	_start(report, "tr", NULL);
+	_element(report, "td", "col-md-3", "Rule ID");
+	_element(report, "td", "rule-id col-md-9", xccdf_item_get_id(item));
+	_end(report);
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, "Result");
+	_write_result_cell(report, result, "");
+	_end(report);
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, "Multi-check rule");
+	_element(report, "td", NULL, (check != NULL && xccdf_check_get_multicheck(check)) ? "yes" : "no");
+	_end(report);
+	if (check != NULL && oscap_streq(xccdf_check_get_system(check), REPORT_OVAL_SYSTEM)) {
+		_start(report, "tr", NULL);
+		_element(report, "td", NULL, "OVAL Definition ID");
+		_element(report, "td", NULL, _check_content_ref_name(check));
+		_end(report);
+	}
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, "Time");
+	_element(report, "td", NULL, xccdf_rule_result_get_time(rule_result));
+	_end(report);
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, "Severity");
+	_element(report, "td", NULL, _severity_text(xccdf_rule_result_get_severity(rule_result)));
+	_end(report);
+	_start(report, "tr", NULL);
+	_element(report, "td", NULL, "Identifiers and References");
+	_start(report, "td", "identifiers");
+	_write_idents_refs(report, item);
+	_end(report);
+	_end(report);
+
+	struct xccdf_override_iterator *overrides = xccdf_rule_result_get_overrides(rule_result);
+	if (xccdf_override_iterator_has_more(overrides)) {
+		_start(report, "tr", NULL);
+		_start(report, "td", NULL);
+		_attr(report, "colspan", "2");
+		while (xccdf_override_iterator_has_more(overrides)) {
+			struct xccdf_override *override = xccdf_override_iterator_next(overrides);
+			const char *old_result = xccdf_test_result_type_get_text(xccdf_override_get_old_result(override));
+			_start(report, "div", "alert alert-warning waiver");
+			_text(report, "This rule has been waived by ");
+			_element(report, "strong", NULL, xccdf_override_get_authority(override));
+			_text(report, " at ");
+			_element(report, "strong", NULL, xccdf_override_get_time(override));
+			_text(report, ".");
+			_element(report, "blockquote", NULL, oscap_text_get_text(xccdf_override_get_remark(override)));
+			_start(report, "small", NULL);
+			_text(report, "The previous result was ");
+			_start(report, "span", NULL);
+			_attrf(report, "class", "rule-result rule-result-%s", old_result);
+			_nbsp(report);
+			_text(report, old_result);
+			_nbsp(report);
+			_end(report);
+			_text(report, ".");
+			_end(report);
+			_end(report);
+		}
+		_end(report);
+		_end(report);
+	}
+	xccdf_override_iterator_free(overrides);
+
+	if (_has_text(xccdf_item_get_description(item))) {
+		_write_details_row(report, "Description", "description");
+		_start(report, "p", NULL);
+		_write_xccdf_texts(report, xccdf_item_get_description(item));
+		_end(report);
+		_write_details_row_end(report);
+	}
+	if (_has_text(xccdf_item_get_rationale(item))) {
+		_write_details_row(report, "Rationale", "rationale");
+		_start(report, "p", NULL);
+		_write_xccdf_texts(report, xccdf_item_get_rationale(item));
+		_end(report);
+		_write_details_row_end(report);
+	}
+
+	struct xccdf_warning_iterator *warnings = xccdf_item_get_warnings(item);
+	if (xccdf_warning_iterator_has_more(warnings)) {
+		_start(report, "tr", NULL);
+		_element(report, "td", NULL, "Warnings");
+		_start(report, "td", NULL);
+		while (xccdf_warning_iterator_has_more(warnings)) {
+			struct xccdf_warning *warning = xccdf_warning_iterator_next(warnings);
+			_start(report, "div", "panel panel-warning");
+			_start(report, "div", "panel-heading");
+			_label(report, "label label-warning", NULL, "warning");
+			_nbsp(report);
+			_write_xccdf_text(report, oscap_text_get_text(xccdf_warning_get_text(warning)), true);
+			_end(report);
+			_end(report);
+		}
+		_end(report);
+		_end(report);
+	}
+	xccdf_warning_iterator_free(warnings);
+
+	struct xccdf_message_iterator *messages = xccdf_rule_result_get_messages(rule_result);
+	if (xccdf_message_iterator_has_more(messages)) {
+		_start(report, "tr", NULL);
+		_start(report, "td", NULL);
+		_attr(report, "colspan", "2");
+		_start(report, "div", "evaluation-messages");
+		_start(report, "span", "label label-default");
+		_abbr(report, "Messages taken from rule-result", "Evaluation messages");
+		_end(report);
+		_start(report, "div", "panel panel-default");
+		_start(report, "div", "panel-body");
+		while (xccdf_message_iterator_has_more(messages)) {
+			struct xccdf_message *message = xccdf_message_iterator_next(messages);
+			const char *severity = NULL;
+			switch (xccdf_message_get_severity(message)) {
+			case XCCDF_MSG_INFO: severity = "info"; break;
+			case XCCDF_MSG_WARNING: severity = "warning"; break;
+			case XCCDF_MSG_ERROR: severity = "error"; break;
+			default: break;
+			}
+			if (severity != NULL) {
+				_label(report, "label label-primary", NULL, severity);
+				_nbsp(report);
+			}
+			_element(report, "pre", NULL, xccdf_message_get_content(message));
+		}
+		_end(report);
+		_end(report);
+		_end(report);
+		_end(report);
+		_end(report);
+	}
+	xccdf_message_iterator_free(messages);
+
+	if (result == XCCDF_RESULT_FAIL || result == XCCDF_RESULT_ERROR || result == XCCDF_RESULT_UNKNOWN) {
+		struct xccdf_fixtext_iterator *fixtexts = xccdf_rule_get_fixtexts(XRULE(item));
+		while (xccdf_fixtext_iterator_has_more(fixtexts)) {
+			struct xccdf_fixtext *fixtext = xccdf_fixtext_iterator_next(fixtexts);
+			_start(report, "tr", NULL);
+			_start(report, "td", NULL);
+			_attr(report, "colspan", "2");
+			_start(report, "div", "remediation-description");
+			_label(report, "label label-success", NULL, "Remediation description:");
+			_start(report, "div", "panel panel-default");
+			_start(report, "div", "panel-body");
+			_write_xccdf_text(report, oscap_text_get_text(xccdf_fixtext_get_text(fixtext)), true);
+			_end(report);
+			_end(report);
+			_end(report);
+			_end(report);
+			_end(report);
+		}
+		xccdf_fixtext_iterator_free(fixtexts);
+
+		int fix_index = 0;
+		struct xccdf_fix_iterator *fixes = xccdf_rule_get_fixes(XRULE(item));
+		while (xccdf_fix_iterator_has_more(fixes)) {
+			struct xccdf_fix *fix = xccdf_fix_iterator_next(fixes);
+			_start(report, "tr", "noprint");
+			_start(report, "td", NULL);
+			_attr(report, "colspan", "2");
+			_start(report, "div", "remediation");
+			/* unique within the page, rule results are numbered by their position */
+			_write_fix(report, fix, rr->index * 1000 + fix_index++);
+			_end(report);
+			_end(report);
+			_end(report);
+		}
+		xccdf_fix_iterator_free(fixes);
+	}
+
+	_end(report);
+	_end(report);
+}
+
+static void _write_result_details_leaf(struct xccdf_report *report, struct xccdf_item *item)
+{
+	struct oscap_list *results = oscap_htable_get(report->rule_results, xccdf_item_get_id(item));
+	if (results == NULL)
+		return;
+
+	struct oscap_iterator *it = oscap_iterator_new(results);
+	while (oscap_iterator_has_more(it)) {
+		struct report_rule_result *rr = oscap_iterator_next(it);
+		struct xccdf_rule_result *rule_result = rr->rule_result;
+		xccdf_test_result_type_t result = xccdf_rule_result_get_result(rule_result);
+		if (result == XCCDF_RESULT_NOT_SELECTED)
+			continue;
+		const char *id = xccdf_item_get_id(item);
+
+		_start(report, "div", NULL);
+		_attrf(report, "class", "panel panel-default rule-detail rule-detail-%s rule-detail-id-%s",
+				xccdf_test_result_type_get_text(result), id);
+		_attrf(report, "id", "rule-detail-rr%d", rr->index);
+
+		_start(report, "div", "keywords sr-only");
+		xmlTextWriterWriteComment(report->writer, BAD_CAST "This allows OpenSCAP JS to search the report rules");
+		_write_item_title(report, item);
+		_textf(report, "%s ", id);
+		xccdf_level_t severity = xccdf_rule_result_get_severity(rule_result);
+		if (severity != XCCDF_LEVEL_NOT_DEFINED)
+			_text(report, _severity_text(severity));
+		struct xccdf_ident_iterator *idents = xccdf_rule_result_get_idents(rule_result);
+		while (xccdf_ident_iterator_has_more(idents))
+			_textf(report, "%s ", xccdf_ident_get_id(xccdf_ident_iterator_next(idents)));
+		xccdf_ident_iterator_free(idents);
+		_end(report);
+
+		_start(report, "div", "panel-heading");
+		_start(report, "h3", "panel-title");
+		_write_item_title(report, item);
+		_end(report);
+		_end(report);
+
+		_start(report, "div", "panel-body");
+		_write_result_details_table(report, item, rr);
+		bool details = false;
+		struct xccdf_check_iterator *checks = xccdf_rule_result_get_checks(rule_result);
+		while (xccdf_check_iterator_has_more(checks))
+			details = _write_check_system_details(report, xccdf_check_iterator_next(checks), details);
+		xccdf_check_iterator_free(checks);
+		if (details)
+			_end(report);
+		_end(report);
+
+		_end(report);
+	}
+	oscap_iterator_free(it);
+}
+
+static void _write_result_details_node(struct xccdf_report *report, struct xccdf_item *item)
+{
+	struct xccdf_item_iterator *content = _item_content(item);
+	while (xccdf_item_iterator_has_more(content)) {
+		struct xccdf_item *child = xccdf_item_iterator_next(content);
+		if (xccdf_item_get_type(child) == XCCDF_GROUP)
+			_write_result_details_node(report, child);
+	}
+	xccdf_item_iterator_reset(content);
+	while (xccdf_item_iterator_has_more(content)) {
+		struct xccdf_item *child = xccdf_item_iterator_next(content);
+		if (xccdf_item_get_type(child) == XCCDF_RULE)
+			_write_result_details_leaf(report, child);
+	}
+	xccdf_item_iterator_free(content);
+}
+
+static void _write_result_details(struct xccdf_report *report)
+{
+	_start(report, "div", "js-only hidden-print");
+	_start(report, "button", "btn btn-info");
+	_attr(report, "type", "button");
+	_attr(report, "onclick", "return toggleResultDetails(this)");
+	_text(report, "Show all result details");
+	_end(report);
+	_end(report);
+
+	_start(report, "div", NULL);
+	_attr(report, "id", "result-details");
+	_element(report, "h2", NULL, "Result Details");
+	_write_result_details_node(report, XITEM(report->benchmark));
+	_start(report, "a", NULL);
+	_attr(report, "href", "#result-details");
+	_start(report, "button", "btn btn-secondary noprint");
+	_attr(report, "type", "button");
+	_text(report, "Scroll back to the first rule");
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+static void _write_rear_matter(struct xccdf_report *report)
+{
+	_start(report, "div", NULL);
+	_attr(report, "id", "rear-matter");
+	_start(report, "div", "row top-spacer-10");
+	_start(report, "div", "col-md-12 well well-lg");
+	if (_has_text(xccdf_benchmark_get_rear_matter(report->benchmark))) {
+		_start(report, "div", "rear-matter");
+		_write_xccdf_texts(report, xccdf_benchmark_get_rear_matter(report->benchmark));
+		_end(report);
+	}
+	_end(report);
+	_end(report);
+	_end(report);
+}
+
+int xccdf_report_export_html(struct xccdf_policy *policy, struct xccdf_result *result,
+		struct oval_agent_session **oval_agents, const char *filename)
+{
+	__attribute__nonnull__(policy);
+	__attribute__nonnull__(result);
+	__attribute__nonnull__(filename);
+
+	struct xccdf_report report = {
+		.policy = policy,
+		.benchmark = xccdf_policy_model_get_benchmark(xccdf_policy_get_model(policy)),
+		.result = result,
+		.oval_agents = oval_agents,
+	};
+
+	report.resources = _load_xsl("xccdf-resources.xsl");
+	if (report.resources == NULL)
+		return -1;
+	report.branding = _load_xsl("xccdf-branding.xsl");
+	if (report.branding == NULL) {
+		xmlFreeDoc(report.resources);
+		return -1;
+	}
+	report.writer = xmlNewTextWriterFilename(filename, 0);
+	if (report.writer == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open %s for writing the HTML report.", filename);
+		xmlFreeDoc(report.branding);
+		xmlFreeDoc(report.resources);
+		return -1;
+	}
+
+	report.rule_results = oscap_htable_new();
+	report.counts = oscap_htable_new();
+	report.references = oscap_htable_new();
+	_index_rule_results(&report);
+	_index_counts(&report, XITEM(report.benchmark), NULL);
+
+	_write_head(&report);
+	_start(&report, "body", NULL);
+	_write_header(&report);
+	_start(&report, "div", "container");
+	_start(&report, "div", NULL);
+	_attr(&report, "id", "content");
+	_write_introduction(&report);
+	_write_characteristics(&report);
+	_write_compliance_and_scoring(&report);
+	_write_rule_overview(&report);
+	_write_result_details(&report);
+	_write_rear_matter(&report);
+	_end(&report);
+	_end(&report);
+	_write_footer(&report);
+	_end(&report);
+	_end(&report);
+	_raw(&report, "\n");
+
+	int ret = 0;
+	if (xmlTextWriterFlush(report.writer) < 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write the HTML report to %s.", filename);
+		ret = -1;
+	}
+	xmlFreeTextWriter(report.writer);
+
+	oscap_htable_free(report.rule_results, (oscap_destruct_func) _rule_result_list_free);
+	oscap_htable_free(report.counts, free);
+	oscap_htable_free0(report.references);
+	xmlFreeDoc(report.branding);
+	xmlFreeDoc(report.resources);
+	return ret;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+#ifndef OSCAP_XCCDF_REPORT_PRIV_H
+#define OSCAP_XCCDF_REPORT_PRIV_H
+
+#include "public/xccdf_benchmark.h"
+#include "XCCDF_POLICY/public/xccdf_policy.h"
+#include "OVAL/public/oval_agent_api.h"
+
+/**
+ * Write HTML report of the given TestResult without going through XSLT.
+ * The report is generated directly from the models, it has the same
+ * sections as the report made by xccdf-report.xsl.
+ * @param policy XCCDF Policy which has been evaluated
+ * @param result XCCDF TestResult of the evaluation
+ * @param oval_agents NULL terminated array of OVAL agent sessions used during
+ * the evaluation (their results are used for OVAL details), may be NULL
+ * @param filename path to the HTML file
+ * @returns 0 on success, -1 on error
+ */
+int xccdf_report_export_html(struct xccdf_policy *policy, struct xccdf_result *result,
+		struct oval_agent_session **oval_agents, const char *filename);
+
+#endif
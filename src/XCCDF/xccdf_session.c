@@ -55,6 +55,7 @@
 #include "XCCDF_POLICY/xccdf_policy_priv.h"
 #include "XCCDF_POLICY/xccdf_policy_model_priv.h"
 #include "item.h"
+#include "report_priv.h"
 #include "public/xccdf_session.h"
 #include "XCCDF_POLICY/public/check_engine_plugin.h"
 #include "oscap_helpers.h"
@@ -77,6 +78,7 @@ struct xccdf_session {
 		struct xccdf_result *result;		///< XCCDF Result model.
 		float base_score;			///< Basec score of the latest evaluation.
 		struct oscap_source *result_source;     ///< oscap_source for the exported XCCDF result
+		struct xccdf_result *exported_result;   ///< Copy of the result which was added to the Benchmark for export
 	} xccdf;
 	struct {
 		struct ds_sds_session *session;         ///< SDS Registry abstract structure
@@ -92,6 +94,7 @@ struct xccdf_session {
 		struct oval_agent_session **agents;	///< OVAL Agent Session
 		xccdf_policy_engine_eval_fn user_eval_fn;///< Custom OVAL engine callback
 		char *product_cpe;			///< CPE of scanner product.
+		char *incremental_state;		///< Directory with system characteristics of the previous scan
 		struct oscap_source* arf_report;	///< ARF report
 		struct oscap_htable *result_sources;    ///< mapping 'filepath' to oscap_source for OVAL results
 		struct oscap_htable *results_mapping;    ///< mapping OVAL filename to filepath for OVAL results
@@ -102,6 +105,7 @@ struct xccdf_session {
 		char *xccdf_file;			///< Path to XCCDF file to export
 		char *xccdf_stig_viewer_file;		///< Path to STIG Viewer XCCDF file to export
 		char *report_file;			///< Path to HTML file to eport
+		bool native_report;			///< Shall the HTML report be written without XSLT?
 		bool oval_results;			///< Shall be the OVAL results files exported?
 		bool oval_variables;			///< Shall be the OVAL variable files exported?
 		bool check_engine_plugins_results;	///< Shall the check engine plugins results be exported?
@@ -259,6 +263,7 @@ void xccdf_session_free(struct xccdf_session *session)
 	oscap_list_free0(session->check_engine_plugins);
 	free(session->user_cpe);
 	free(session->oval.product_cpe);
+	free(session->oval.incremental_state);
 	_xccdf_session_free_oval_agents(session);
 	_oval_content_resources_free(session->oval.custom_resources);
 	_oval_content_resources_free(session->oval.resources);
@@ -381,6 +386,12 @@ bool xccdf_session_set_product_cpe(struct xccdf_session *session, const char *pr
 	return true;
 }
 
+void xccdf_session_set_incremental_state(struct xccdf_session *session, const char *dir)
+{
+	free(session->oval.incremental_state);
+	session->oval.incremental_state = oscap_strdup(dir);
+}
+
 void xccdf_session_set_without_sys_chars_export(struct xccdf_session *session, bool without_sys_chars)
 {
 	session->export.without_sys_chars = without_sys_chars;
@@ -429,6 +440,11 @@ bool xccdf_session_set_report_export(struct xccdf_session *session, const char *
 	return true;
 }
 
+void xccdf_session_set_native_report(struct xccdf_session *session, bool native_report)
+{
+	session->export.native_report = native_report;
+}
+
 bool xccdf_session_set_profile_id(struct xccdf_session *session, const char *profile_id)
 {
 	if (xccdf_policy_model_get_policy_by_id(session->xccdf.policy_model, profile_id) == NULL)
@@ -1050,12 +1066,22 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 							OVAL_RESULT_UNKNOWN | OVAL_RESULT_NOT_EVALUATED |
 							OVAL_RESULT_NOT_APPLICABLE | OVAL_RESULT_ERROR,
 							OVAL_DIRECTIVE_CONTENT_THIN);
+			/* only verdicts of definitions are reported, let the evaluation short-circuit */
+			oval_results_model_set_fast_verdict(res_model, true);
 		}
 
 		/* store our name in the generated documents */
 		oval_agent_set_product_name(tmp_sess, session->oval.product_cpe != NULL ?
 				session->oval.product_cpe : (char *) oscap_productname);
 
+		/* take what did not change from the previous scan */
+		if (session->oval.incremental_state != NULL &&
+				oval_agent_load_incremental_state(tmp_sess, session->oval.incremental_state) < 0) {
+			char *err = oscap_err_get_full_error();
+			dW("All objects of '%s' will be collected: %s", contents[idx]->href, err);
+			free(err);
+		}
+
 		/* remember sessions */
 		session->oval.agents = realloc(session->oval.agents, (idx + 2) * sizeof(struct oval_agent_session *));
 		session->oval.agents[idx] = tmp_sess;
@@ -1218,6 +1244,13 @@ int xccdf_session_evaluate(struct xccdf_session *session)
 			session->xccdf.base_score = xccdf_score_get_score(score);
 	}
 	xccdf_model_iterator_free(model_it);
+
+	if (session->oval.incremental_state != NULL) {
+		for (int i = 0; session->oval.agents != NULL && session->oval.agents[i]; i++) {
+			if (oval_agent_save_incremental_state(session->oval.agents[i], session->oval.incremental_state) != 0)
+				return 1;
+		}
+	}
 	return 0;
 }
 
@@ -1267,14 +1300,77 @@ static inline int _xccdf_gen_report(struct oscap_source *infile, const char *id,
 	return _app_xslt(infile, "xccdf-report.xsl", outfile, params);
 }
 
+static void _xccdf_session_remove_result(struct xccdf_result_iterator *it, struct xccdf_result *result)
+{
+	while (xccdf_result_iterator_has_more(it)) {
+		if (xccdf_result_iterator_next(it) == result) {
+			xccdf_result_iterator_remove(it);
+			break;
+		}
+	}
+	xccdf_result_iterator_free(it);
+}
+
+int xccdf_session_reset_results(struct xccdf_session *session)
+{
+	if (session->xccdf.policy_model == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Cannot build xccdf_policy.");
+		return 1;
+	}
+
+	/* exported documents of the previous evaluation */
+	oscap_source_free(session->oval.arf_report);
+	session->oval.arf_report = NULL;
+	oscap_source_free(session->xccdf.result_source);
+	session->xccdf.result_source = NULL;
+	_xccdf_session_free_oval_result_sources(session);
+	oscap_htable_free(session->oval.results_mapping, (oscap_destruct_func) free);
+	session->oval.results_mapping = NULL;
+	oscap_htable_free(session->oval.arf_report_mapping, (oscap_destruct_func) free);
+	session->oval.arf_report_mapping = NULL;
+
+	/* results of the previous evaluation */
+	if (session->xccdf.exported_result != NULL) {
+		struct xccdf_benchmark *benchmark = xccdf_policy_model_get_benchmark(session->xccdf.policy_model);
+		_xccdf_session_remove_result(xccdf_benchmark_get_results(benchmark), session->xccdf.exported_result);
+		session->xccdf.exported_result = NULL;
+	}
+	if (session->xccdf.result != NULL) {
+		struct xccdf_policy *policy = xccdf_session_get_xccdf_policy(session);
+		if (policy != NULL)
+			_xccdf_session_remove_result(xccdf_policy_get_results(policy), session->xccdf.result);
+		session->xccdf.result = NULL;
+	}
+	session->xccdf.base_score = 0;
+
+	/* everything collected from the scanned system, the parsed content stays */
+	int ret = 0;
+	if (session->oval.agents != NULL) {
+		for (int i = 0; session->oval.agents[i]; i++) {
+			if (oval_agent_restart_session(session->oval.agents[i]) != 0) {
+				oscap_seterr(OSCAP_EFAMILY_OSCAP, "Failed to restart OVAL agent session for: '%s'.",
+						oval_agent_get_filename(session->oval.agents[i]));
+				ret = 1;
+			}
+		}
+	}
+	if (cpe_session_reset_results(xccdf_policy_model_get_cpe_session(session->xccdf.policy_model)) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Failed to restart OVAL agent sessions for CPE applicability checking.");
+		ret = 1;
+	}
+	return ret;
+}
+
 static int _build_xccdf_result_source(struct xccdf_session *session)
 {
 	if (session->xccdf.result_source != NULL) {
 		return 0;
 	}
 
-	/* Build oscap_source of XCCDF TestResult only when needed */
-	if (session->export.xccdf_file != NULL || session->export.report_file != NULL || session->export.arf_file != NULL || session->export.xccdf_stig_viewer_file != NULL) {
+	/* Build oscap_source of XCCDF TestResult only when needed, the native
+	 * HTML report is written directly from the models */
+	bool xslt_report = session->export.report_file != NULL && !session->export.native_report;
+	if (session->export.xccdf_file != NULL || xslt_report || session->export.arf_file != NULL || session->export.xccdf_stig_viewer_file != NULL) {
 		struct xccdf_benchmark *benchmark = xccdf_policy_model_get_benchmark(session->xccdf.policy_model);
 
 		if (session->xccdf.result == NULL) {
@@ -1284,6 +1380,7 @@ static int _build_xccdf_result_source(struct xccdf_session *session)
 		}
 		struct xccdf_result* cloned_result = xccdf_result_clone(session->xccdf.result);
 		xccdf_benchmark_add_result(benchmark, cloned_result);
+		session->xccdf.exported_result = cloned_result;
 		session->xccdf.result_source = xccdf_benchmark_export_source(benchmark, session->export.xccdf_file);
 
 		if (session->export.xccdf_file != NULL) {
@@ -1325,6 +1422,17 @@ int xccdf_session_export_xccdf(struct xccdf_session *session)
 	if (session->export.report_file == NULL)
 		return 0;
 
+	if (session->export.native_report) {
+		if (session->xccdf.result == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "No XCCDF results to export.");
+			return 1;
+		}
+		if (xccdf_report_export_html(xccdf_session_get_xccdf_policy(session), session->xccdf.result,
+				session->oval.agents, session->export.report_file) != 0)
+			return 1;
+		return 0;
+	}
+
 	struct oscap_source* arf = xccdf_session_create_arf_source(session);
 	if (arf == NULL) {
 		return 1;
@@ -1616,6 +1724,7 @@ int xccdf_session_export_arf(struct xccdf_session *session)
 		if (session->full_validation) {
 			if (oscap_source_validate(arf_source, _reporter, NULL) != 0) {
 				oscap_source_free(arf_source);
+				session->oval.arf_report = NULL;
 				return 1;
 			}
 		}
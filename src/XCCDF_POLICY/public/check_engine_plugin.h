@@ -62,6 +62,17 @@ OSCAP_API int check_engine_plugin_cleanup(struct check_engine_plugin_def *plugin
 OSCAP_API int check_engine_plugin_export_results(struct check_engine_plugin_def *plugin, struct xccdf_policy_model *model, bool validate, const char *path_hint);
 OSCAP_API const char *check_engine_plugin_get_capabilities(struct check_engine_plugin_def *plugin);
 
+/**
+ * Run @a fn(@a usr, @a arg) when the rule whose check is being evaluated is
+ * reported. Checks of concurrent engines are evaluated in any order, their
+ * side effects (e.g. collected results) shall be applied this way, so that
+ * they follow the document order. Outside of a rule evaluation @a fn is run
+ * immediately.
+ * @param free_fn releases @a arg when the rule is not going to be reported
+ * because the evaluation has been aborted
+ */
+OSCAP_API void xccdf_policy_engine_defer(void (*fn)(void *usr, void *arg), void *usr, void *arg, void (*free_fn)(void *arg));
+
 /**
  * This is the entry point of shared objects implementing extra check engines
  */
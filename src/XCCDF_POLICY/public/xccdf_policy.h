@@ -239,6 +239,23 @@ OSCAP_API struct oscap_htable_iterator *xccdf_policy_model_get_cpe_oval_sessions
  */
 OSCAP_API bool xccdf_policy_model_register_engine_and_query_callback(struct xccdf_policy_model *model, char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn);
 
+/**
+ * Function to register callback for checking system which can evaluate
+ * several checks at the same time. Checks of such system may be evaluated
+ * by worker threads, concurrently with each other and with checks of other
+ * systems. Checks of systems registered by
+ * xccdf_policy_model_register_engine_and_query_callback() are evaluated one
+ * after another by the thread which evaluates the policy.
+ * @param model XCCDF Policy Model
+ * @param sys String representing given checking system
+ * @param eval_fn Callback - pointer to thread-safe function called by XCCDF Policy system when rule parsed
+ * @param usr optional parameter for passing user data to callback
+ * @param query_fn - optional parameter for providing xccdf_policy_engine_query_fn implementation for given system.
+ * @memberof xccdf_policy_model
+ * @return true if callback registered succesfully, false otherwise
+ */
+OSCAP_API bool xccdf_policy_model_register_concurrent_engine(struct xccdf_policy_model *model, char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn);
+
 typedef int (*policy_reporter_output)(struct xccdf_rule_result *, void *);
 
 /**
@@ -27,6 +27,8 @@
 #include <config.h>
 #endif
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -36,6 +38,7 @@
 #include "xccdf_policy_engine_priv.h"
 #include "reporter_priv.h"
 #include "public/xccdf_policy.h"
+#include "public/check_engine_plugin.h"
 #include "public/xccdf_benchmark.h"
 #include "public/oscap_text.h"
 
@@ -50,6 +53,7 @@
 #include "common/list.h"
 #include "common/_error.h"
 #include "common/debug_priv.h"
+#include "common/oscap_timing_priv.h"
 #include "common/text_priv.h"
 #include "XCCDF/result_scoring_priv.h"
 #include "xccdf_policy_resolve.h"
@@ -785,9 +789,19 @@ static bool _xccdf_policy_cpe_check_cb(const char* sys, const char* href, const
 	struct xccdf_policy_model* model = cb_usr->model;
 
 	char* prefixed_href = _cpe_get_oval_href(cb_usr->dict, cb_usr->lang_model, href);
+	// the same checks are shared by many platforms and CPE names
+	char *key = oscap_sprintf("%s#%s", prefixed_href ? prefixed_href : "", name ? name : "");
+	const bool *cached = cpe_session_get_cached_result(model->cpe->check_results, key);
+	if (cached != NULL) {
+		free(key);
+		free(prefixed_href);
+		return *cached;
+	}
+
 	struct oval_agent_session *session = cpe_session_lookup_oval_session(model->cpe, prefixed_href);
 	free(prefixed_href);
 	if (session == NULL) {
+		free(key);
 		return false;
 	}
 
@@ -798,6 +812,8 @@ static bool _xccdf_policy_cpe_check_cb(const char* sys, const char* href, const
 		// error message should already be set in the function
 	}
 
+	cpe_session_cache_result(model->cpe->check_results, key, result == OVAL_RESULT_TRUE);
+	free(key);
 	return result == OVAL_RESULT_TRUE;
 }
 
@@ -829,91 +845,56 @@ static bool _xccdf_policy_cpe_dict_cb(struct cpe_name* name, void* usr)
 	return ret;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_dict(struct xccdf_policy_model *model, struct cpe_dict_model *dict, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
-
-	while (oscap_string_iterator_has_more(platforms))
-	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Platform could be a reference to CPE2 platform, skip the ones
-		// that aren't valid CPE names.
-		if (!cpe_name_check(platform))
-			continue;
-
-		struct cpe_name* name = cpe_name_new(platform);
-
-		struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = dict;
-		usr->lang_model = NULL;
-		const bool applicable = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
-		free(usr);
-
-		cpe_name_free(name);
+	// Platform could be a reference to CPE2 platform, skip the ones
+	// that aren't valid CPE names.
+	if (!cpe_name_check(platform))
+		return false;
 
-		if (applicable)
-		{
-			ret = true;
+	struct cpe_name* name = cpe_name_new(platform);
 
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
-	}
-	oscap_string_iterator_reset(platforms);
+	struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
+	usr->model = model;
+	usr->dict = dict;
+	usr->lang_model = NULL;
+	const bool applicable = cpe_name_applicable_dict(name, dict, (cpe_check_fn) _xccdf_policy_cpe_check_cb, usr);
+	free(usr);
 
-	return ret;
+	cpe_name_free(name);
+	return applicable;
 }
 
-static bool xccdf_policy_model_platforms_are_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable_lang_model(struct xccdf_policy_model *model, struct cpe_lang_model *lang_model, const char *platform)
 {
-	// at this point we know that the item has 1 or more platforms specified
-	bool ret = false;
+	// Specification says that platform should begin with "#" if it is
+	// a reference to a CPE2 platform. However content exists where this
+	// is not strictly followed so we support both with and without "#"
+	// references.
 
-	while (oscap_string_iterator_has_more(platforms))
+	const char* platform_shifted = platform;
+	if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
 	{
-		const char* platform = oscap_string_iterator_next(platforms);
-		// Specification says that platform should begin with "#" if it is
-		// a reference to a CPE2 platform. However content exists where this
-		// is not strictly followed so we support both with and without "#"
-		// references.
-
-		const char* platform_shifted = platform;
-		if (strlen(platform_shifted) >= 1 && *platform_shifted == '#')
-		{
-			// skip the "#" character
-			platform_shifted++;
-		}
-
-		struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
-		usr->model = model;
-		usr->dict = NULL;
-		usr->lang_model = lang_model;
-		const bool applicable = cpe_platform_applicable_lang_model(platform_shifted, lang_model, (cpe_check_fn)_xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, usr);
-		free(usr);
-
-		if (applicable)
-		{
-			ret = true;
-
-			if (oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
-				oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
-			}
-		}
+		// skip the "#" character
+		platform_shifted++;
 	}
-	oscap_string_iterator_reset(platforms);
 
-	return ret;
+	struct cpe_check_cb_usr* usr = malloc(sizeof(struct cpe_check_cb_usr));
+	usr->model = model;
+	usr->dict = NULL;
+	usr->lang_model = lang_model;
+	const bool applicable = cpe_platform_applicable_lang_model(platform_shifted, lang_model, (cpe_check_fn)_xccdf_policy_cpe_check_cb, (cpe_dict_fn)_xccdf_policy_cpe_dict_cb, usr);
+	free(usr);
+
+	return applicable;
 }
 
-bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+static bool xccdf_policy_model_platform_is_applicable(struct xccdf_policy_model *model, const char *platform)
 {
-	// we have to check whether the item has any platforms at all, if it has none
-	// it should be applicable to all platforms
-	if (!oscap_string_iterator_has_more(platforms))
-		return true;
+	// Thousands of items usually share a handful of platforms.
+	const bool *cached = cpe_session_get_cached_result(model->cpe->platform_results, platform);
+	if (cached != NULL)
+		return *cached;
 
 	bool ret = false;
 	// We do not check whether the platform entries are valid platform refs
@@ -924,107 +905,386 @@ bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *mode
 	struct xccdf_benchmark* benchmark = xccdf_policy_model_get_benchmark(model);
 	struct cpe_lang_model *embedded_lang_model = xccdf_benchmark_get_cpe_lang_model(benchmark);
 	if (embedded_lang_model != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, embedded_lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, embedded_lang_model, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *lang_models = oscap_iterator_new(model->cpe->lang_models);
 	while (oscap_iterator_has_more(lang_models)) {
 		struct cpe_lang_model *lang_model = (struct cpe_lang_model *) oscap_iterator_next(lang_models);
-		if (xccdf_policy_model_platforms_are_applicable_lang_model(model, lang_model, platforms))
+		if (xccdf_policy_model_platform_is_applicable_lang_model(model, lang_model, platform))
 			ret = true;
 	}
 	oscap_iterator_free(lang_models);
 
 	struct cpe_dict_model *embedded_dict = xccdf_benchmark_get_cpe_list(benchmark);
 	if (embedded_dict != NULL) {
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, embedded_dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, embedded_dict, platform))
 			ret = true;
 	}
 
 	struct oscap_iterator *dicts = oscap_iterator_new(model->cpe->dicts);
 	while (oscap_iterator_has_more(dicts)) {
 		struct cpe_dict_model *dict = (struct cpe_dict_model *) oscap_iterator_next(dicts);
-		if (xccdf_policy_model_platforms_are_applicable_dict(model, dict, platforms))
+		if (xccdf_policy_model_platform_is_applicable_dict(model, dict, platform))
 			ret = true;
 	}
 	oscap_iterator_free(dicts);
 
+	if (ret && oscap_htable_get(model->cpe->applicable_platforms, platform) == NULL) {
+		oscap_htable_add(model->cpe->applicable_platforms, platform, 0);
+	}
+	cpe_session_cache_result(model->cpe->platform_results, platform, ret);
+	return ret;
+}
+
+bool xccdf_policy_model_platforms_are_applicable(struct xccdf_policy_model *model, struct oscap_string_iterator *platforms)
+{
+	// we have to check whether the item has any platforms at all, if it has none
+	// it should be applicable to all platforms
+	if (!oscap_string_iterator_has_more(platforms))
+		return true;
+
+	// all the platforms are checked, the applicable ones are listed in the results
+	bool ret = false;
+	while (oscap_string_iterator_has_more(platforms)) {
+		if (xccdf_policy_model_platform_is_applicable(model, oscap_string_iterator_next(platforms)))
+			ret = true;
+	}
+	oscap_string_iterator_reset(platforms);
+
 	return ret;
 }
 
 bool xccdf_policy_model_item_is_applicable(struct xccdf_policy_model *model, struct xccdf_item *item)
 {
+	const char *id = xccdf_item_get_id(item);
+	const bool *cached = id != NULL ? cpe_session_get_cached_result(model->cpe->item_results, id) : NULL;
+	if (cached != NULL)
+		return *cached;
+
+	bool ret = false;
 	struct xccdf_item* parent = xccdf_item_get_parent(item);
 	if (!parent || xccdf_policy_model_item_is_applicable(model, parent))
 	{
 		struct oscap_string_iterator* platforms = xccdf_item_get_platforms(item);
-		bool ret = xccdf_policy_model_platforms_are_applicable(model, platforms);
+		ret = xccdf_policy_model_platforms_are_applicable(model, platforms);
 		oscap_string_iterator_free(platforms);
+	}
+	// otherwise parent is not applicable
+
+	if (id != NULL)
+		cpe_session_cache_result(model->cpe->item_results, id, ret);
+	return ret;
+}
+
+/*
+ * Rules are evaluated in two passes. The first pass walks the benchmark in
+ * the document order and decides about each rule whether it is selected,
+ * applicable and which check is going to be evaluated. The second pass
+ * evaluates the checks and reports the results in the document order.
+ *
+ * Checks of the engines which can run concurrently (SCE) are evaluated by
+ * worker threads ahead of the reporting thread. All the other checks are
+ * evaluated by the reporting thread at their turn, because the checking
+ * engines keep a state which depends on the order of evaluation and the
+ * probes of an OVAL session have to be used by the thread which opened them.
+ */
 
-		return ret;
+/* how many rules ahead of the reported one the workers evaluate, per thread */
+#define XCCDF_EVAL_AHEAD_PER_THREAD 4
+
+typedef enum {
+	RULE_JOB_PENDING,
+	RULE_JOB_RUNNING,
+	RULE_JOB_FINISHED
+} rule_job_state_t;
+
+struct rule_job {
+	const struct xccdf_rule *rule;
+	struct xccdf_check *check;     ///< check to evaluate, NULL if the result is already known
+	xccdf_role_t role;
+	int res;                       ///< result of the rule
+	const char *message;           ///< message of the rule result
+	bool report_start;             ///< send the start callback for the rule
+	bool concurrent;               ///< may be evaluated by a worker thread
+	bool reported;                 ///< results were reported during the evaluation (multi-check)
+	int report;                    ///< return value of the reporting during the evaluation
+	size_t *deps;                  ///< pairs of first and last index of jobs which have to be finished before
+	size_t deps_count;             ///< number of the pairs in deps
+	struct err_queue *errors;      ///< errors set by a worker thread during the evaluation
+	struct oscap_list *deferred;   ///< actions of the engines to run when the rule is reported
+	rule_job_state_t state;
+};
+
+struct rule_job_deferred {
+	void (*fn)(void *usr, void *arg);
+	void *usr;
+	void *arg;
+	oscap_destruct_func free_fn;
+};
+
+/* The job being evaluated by the current thread */
+static pthread_key_t rule_job_key;
+static pthread_once_t rule_job_key_once = PTHREAD_ONCE_INIT;
+
+static void _rule_job_key_create(void)
+{
+	(void) pthread_key_create(&rule_job_key, NULL);
+}
+
+void xccdf_policy_engine_defer(void (*fn)(void *usr, void *arg), void *usr, void *arg, oscap_destruct_func free_fn)
+{
+	(void) pthread_once(&rule_job_key_once, _rule_job_key_create);
+	struct rule_job *job = pthread_getspecific(rule_job_key);
+	if (job == NULL) {
+		fn(usr, arg);
+		return;
 	}
-	else
-	{
-		// parent is not applicable
-		return false;
+
+	struct rule_job_deferred *deferred = malloc(sizeof(struct rule_job_deferred));
+	if (deferred == NULL) {
+		if (free_fn != NULL)
+			free_fn(arg);
+		return;
+	}
+	deferred->fn = fn;
+	deferred->usr = usr;
+	deferred->arg = arg;
+	deferred->free_fn = free_fn;
+	if (job->deferred == NULL)
+		job->deferred = oscap_list_new();
+	oscap_list_add(job->deferred, deferred);
+}
+
+static void _rule_job_deferred_run(struct rule_job_deferred *deferred)
+{
+	deferred->fn(deferred->usr, deferred->arg);
+	free(deferred);
+}
+
+static void _rule_job_deferred_free(struct rule_job_deferred *deferred)
+{
+	if (deferred->free_fn != NULL)
+		deferred->free_fn(deferred->arg);
+	free(deferred);
+}
+
+struct rule_job_range {
+	size_t first;
+	size_t last;
+};
+
+struct rule_schedule {
+	struct xccdf_policy *policy;
+	struct xccdf_result *result;
+	struct rule_job *jobs;
+	size_t count;
+	size_t alloc;
+	struct oscap_htable *ranges;   ///< item ID -> range of jobs of the item
+	size_t next;                   ///< first job which can still be pending
+	size_t ahead;                  ///< workers start only jobs before the reported job + ahead
+	size_t reporting;              ///< job being reported
+	bool stop;                     ///< workers shall not start new jobs
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+static struct rule_job *_rule_schedule_add_job(struct rule_schedule *schedule, const struct xccdf_rule *rule)
+{
+	if (schedule->count == schedule->alloc) {
+		size_t alloc = schedule->alloc == 0 ? 64 : schedule->alloc * 2;
+		struct rule_job *jobs = realloc(schedule->jobs, alloc * sizeof(struct rule_job));
+		if (jobs == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to allocate memory for the evaluation of rule '%s'.", xccdf_rule_get_id(rule));
+			return NULL;
+		}
+		schedule->jobs = jobs;
+		schedule->alloc = alloc;
+	}
+	struct rule_job *job = &schedule->jobs[schedule->count++];
+	memset(job, 0, sizeof(struct rule_job));
+	job->rule = rule;
+	job->report_start = true;
+	job->state = RULE_JOB_FINISHED;
+	return job;
+}
+
+static int _rule_schedule_add_range(struct rule_schedule *schedule, const char *id, size_t first)
+{
+	if (id == NULL || first == schedule->count)
+		return 0;
+	struct rule_job_range *range = malloc(sizeof(struct rule_job_range));
+	if (range == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to allocate memory for the evaluation of item '%s'.", id);
+		return -1;
 	}
+	range->first = first;
+	range->last = schedule->count - 1;
+	if (!oscap_htable_add(schedule->ranges, id, range))
+		free(range);
+	return 0;
 }
 
 /**
- * Evaluate given check which is immediate child of the rule.
- * A possibe child checks will be evaluated by xccdf_policy_check_evaluate.
- * This duplication is needed to handle @multi-check correctly,
- * which is (in general) not predictable in any way.
+ * Check whether all the checks in the tree are evaluated by engines which
+ * can evaluate several checks at the same time.
  */
-static inline int
-_xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rule *rule, struct xccdf_result *result)
+static bool _xccdf_policy_check_is_concurrent(struct xccdf_policy *policy, const struct xccdf_check *check)
+{
+	bool concurrent = true;
+	if (xccdf_check_get_complex(check)) {
+		struct xccdf_check_iterator *child_it = xccdf_check_get_children(check);
+		while (concurrent && xccdf_check_iterator_has_more(child_it))
+			concurrent = _xccdf_policy_check_is_concurrent(policy, xccdf_check_iterator_next(child_it));
+		xccdf_check_iterator_free(child_it);
+		return concurrent;
+	}
+
+	bool found = false;
+	struct oscap_iterator *cb_it = _xccdf_policy_get_engines_by_sysname(policy, xccdf_check_get_system(check));
+	while (concurrent && oscap_iterator_has_more(cb_it)) {
+		struct xccdf_policy_engine *engine = (struct xccdf_policy_engine *) oscap_iterator_next(cb_it);
+		concurrent = xccdf_policy_engine_is_concurrent(engine);
+		found = true;
+	}
+	oscap_iterator_free(cb_it);
+	return concurrent && found;
+}
+
+static bool _xccdf_check_has_multicheck(const struct xccdf_check *check)
+{
+	if (xccdf_check_get_complex(check) || !xccdf_check_get_multicheck(check))
+		return false;
+
+	bool multicheck = false;
+	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
+	while (!multicheck && xccdf_check_content_ref_iterator_has_more(content_it))
+		multicheck = xccdf_check_content_ref_get_name(xccdf_check_content_ref_iterator_next(content_it)) == NULL;
+	xccdf_check_content_ref_iterator_free(content_it);
+	return multicheck;
+}
+
+/**
+ * Decide what has to be done to get the result of the rule.
+ * @returns 0 on success, -1 on error
+ */
+static int
+_xccdf_policy_rule_schedule(struct xccdf_policy *policy, const struct xccdf_rule *rule, struct rule_schedule *schedule)
 {
 	const char* rule_id = xccdf_rule_get_id(rule);
 	const bool is_selected = xccdf_policy_is_item_selected(policy, rule_id);
-	const char *message = NULL;
-	int report = 0;
+	struct rule_job *job = _rule_schedule_add_job(schedule, rule);
+	if (job == NULL)
+		return -1;
 
 	/* If policy selects only one rule and the rule currently being
 	 * evaluated is not equal to the selected rule, do not evaluate it and
 	 * mark it as notselected. */
 	if (policy->rule != NULL) {
 		if (strcmp(policy->rule, rule_id) != 0) {
-			return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_SELECTED, NULL);
+			job->report_start = false;
+			job->res = XCCDF_RESULT_NOT_SELECTED;
+			return 0;
 		}
 		policy->rule_found = 1;
 	}
-	/* Otherwise start reporting */
-	report = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) rule);
-	if (report)
-		return report;
 
 	struct xccdf_refine_rule_internal* r_rule = oscap_htable_get(policy->refine_rules_internal, rule_id);
-	xccdf_role_t role = xccdf_get_final_role(rule, r_rule);
+	job->role = xccdf_get_final_role(rule, r_rule);
 
 	if (!is_selected) {
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_SELECTED, NULL);
+		job->res = XCCDF_RESULT_NOT_SELECTED;
+		return 0;
 	}
 	dI("Evaluating XCCDF rule '%s'.", rule_id);
 
-	if (role == XCCDF_ROLE_UNCHECKED)
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_CHECKED, NULL);
+	if (job->role == XCCDF_ROLE_UNCHECKED) {
+		job->res = XCCDF_RESULT_NOT_CHECKED;
+		return 0;
+	}
 
 	const bool is_applicable = xccdf_policy_model_item_is_applicable(policy->model, (struct xccdf_item*)rule);
 	if (!is_applicable) {
 		dI("Rule '%s' is not applicable.", rule_id);
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_APPLICABLE, NULL);
+		job->res = XCCDF_RESULT_NOT_APPLICABLE;
+		return 0;
 	}
 
 	const struct xccdf_check *orig_check = _xccdf_policy_rule_get_applicable_check(policy, (struct xccdf_item *) rule);
-	if (orig_check == NULL)
+	if (orig_check == NULL) {
 		// No candidate or applicable check found.
-		return _xccdf_policy_report_rule_result(policy, result, rule, NULL, XCCDF_RESULT_NOT_CHECKED, "No candidate or applicable check found.");
+		job->res = XCCDF_RESULT_NOT_CHECKED;
+		job->message = "No candidate or applicable check found.";
+		return 0;
+	}
 
 	// we need to clone the check to avoid changing the original content
-	struct xccdf_check *check = xccdf_check_clone(orig_check);
-	if (xccdf_check_get_complex(check))
-		return _xccdf_policy_report_rule_result(policy, result, rule, check, xccdf_policy_check_evaluate(policy, check), NULL);
+	job->check = xccdf_check_clone(orig_check);
+	// multi-check reports its results as it goes, it's evaluated by the reporting thread
+	job->concurrent = !_xccdf_check_has_multicheck(job->check) && _xccdf_policy_check_is_concurrent(policy, job->check);
+	job->state = RULE_JOB_PENDING;
+	return 0;
+}
+
+/**
+ * Make the jobs of rules wait for the rules and groups which they require
+ * or conflict with. Only the items preceding the rule are waited for.
+ */
+static int _rule_schedule_add_dependencies(struct rule_schedule *schedule, size_t index)
+{
+	struct rule_job *job = &schedule->jobs[index];
+	struct oscap_string_iterator *id_it;
+	struct oscap_stringlist_iterator *requires_it = xccdf_rule_get_requires(job->rule);
+	struct oscap_list *ids = oscap_list_new();
+
+	while (oscap_stringlist_iterator_has_more(requires_it)) {
+		id_it = oscap_stringlist_get_strings(oscap_stringlist_iterator_next(requires_it));
+		while (oscap_string_iterator_has_more(id_it))
+			oscap_list_add(ids, (void *) oscap_string_iterator_next(id_it));
+		oscap_string_iterator_free(id_it);
+	}
+	oscap_stringlist_iterator_free(requires_it);
+	id_it = xccdf_rule_get_conflicts(job->rule);
+	while (oscap_string_iterator_has_more(id_it))
+		oscap_list_add(ids, (void *) oscap_string_iterator_next(id_it));
+	oscap_string_iterator_free(id_it);
+
+	int ret = 0;
+	struct oscap_iterator *it = oscap_iterator_new(ids);
+	while (oscap_iterator_has_more(it)) {
+		const struct rule_job_range *range = oscap_htable_get(schedule->ranges, oscap_iterator_next(it));
+		if (range == NULL || range->first >= index)
+			continue;
+		size_t *deps = realloc(job->deps, (job->deps_count + 1) * 2 * sizeof(size_t));
+		if (deps == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to allocate memory for the dependencies of rule '%s'.", xccdf_rule_get_id(job->rule));
+			ret = -1;
+			break;
+		}
+		job->deps = deps;
+		job->deps[job->deps_count * 2] = range->first;
+		job->deps[job->deps_count * 2 + 1] = range->last < index ? range->last : index - 1;
+		job->deps_count++;
+	}
+	oscap_iterator_free(it);
+	oscap_list_free(ids, NULL);
+	return ret;
+}
+
+/**
+ * Evaluate the check of the job. Multi-check reports its results during the
+ * evaluation, so the result is needed only when called by the reporting thread.
+ */
+static void
+_xccdf_policy_rule_job_evaluate_check(struct xccdf_policy *policy, struct rule_job *job, struct xccdf_result *result)
+{
+	const struct xccdf_rule *rule = job->rule;
+	struct xccdf_check *check = job->check;
+	if (xccdf_check_get_complex(check)) {
+		job->res = xccdf_policy_check_evaluate(policy, check);
+		return;
+	}
 
 	// Now we are evaluating single simple xccdf:check within xccdf:rule.
 	// Since the fact that a check will yield multi-check is not predictable in general
@@ -1034,14 +1294,18 @@ _xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rul
 	// Important: if touching this code, please revisit also xccdf_policy_check_evaluate.
 	const char *system_name = xccdf_check_get_system(check);
 	struct oscap_list *bindings = xccdf_policy_check_get_value_bindings(policy, xccdf_check_get_exports(check));
-	if (bindings == NULL)
-		return _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "Value bindings not found.");
-
+	if (bindings == NULL) {
+		job->res = XCCDF_RESULT_UNKNOWN;
+		job->message = "Value bindings not found.";
+		return;
+	}
 
 	struct xccdf_check_content_ref_iterator *content_it = xccdf_check_get_content_refs(check);
 	struct xccdf_check_content_ref *content;
 	const char *content_name;
 	const char *href;
+	const char *message = NULL;
+	int report = 0;
 	int ret = XCCDF_RESULT_NOT_CHECKED; // initialized for the case of no check-content-refs present
 	while (xccdf_check_content_ref_iterator_has_more(content_it)) {
 		message = NULL;
@@ -1051,19 +1315,22 @@ _xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rul
 
 		if (content_name == NULL && xccdf_check_get_multicheck(check)) {
 			// parent element is Rule, @multi-check is required
+			assert(!job->concurrent);
 			struct oscap_list *oval_definition_list = _xccdf_policy_get_oval_definitions_for_href(policy, system_name, href);
 			if (oval_definition_list != NULL) {
 				// multi-check is supported by checking-engine
 				struct oscap_iterator *oval_definition_iterator = oscap_iterator_new(oval_definition_list);
+				job->reported = true;
+				job->check = NULL;
 				if (!oscap_iterator_has_more(oval_definition_iterator)) {
 					// Super special case when oval file contains no definitions
 					// thus multi-check shall yield zero rule-results.
-					report = _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "No definitions found for @multi-check.");
+					job->report = _xccdf_policy_report_rule_result(policy, result, rule, check, XCCDF_RESULT_UNKNOWN, "No definitions found for @multi-check.");
 					oscap_iterator_free(oval_definition_iterator);
 					oscap_list_free(oval_definition_list, NULL);
 					xccdf_check_content_ref_iterator_free(content_it);
 					oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
-					return report;
+					return;
 				}
 				while (oscap_iterator_has_more(oval_definition_iterator)) {
 					struct oval_definition *oval_definition = oscap_iterator_next(oval_definition_iterator);
@@ -1090,7 +1357,8 @@ _xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rul
 				xccdf_check_content_ref_iterator_free(content_it);
 				oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
 				xccdf_check_free(check);
-				return report;
+				job->report = report;
+				return;
 			}
 			else
 				message = "Checking engine does not support multi-check; falling back to multi-check='false'";
@@ -1112,53 +1380,277 @@ _xccdf_policy_rule_evaluate(struct xccdf_policy * policy, const struct xccdf_rul
 	if ((xccdf_test_result_type_t) ret == XCCDF_RESULT_NOT_CHECKED)
 		message = "None of the check-content-ref elements was resolvable.";
 
-	if (role == XCCDF_ROLE_UNSCORED)
+	if (job->role == XCCDF_ROLE_UNSCORED)
 		ret = XCCDF_RESULT_INFORMATIONAL;
 
 	xccdf_check_content_ref_iterator_free(content_it);
 	oscap_list_free(bindings, (oscap_destruct_func) xccdf_value_binding_free);
 	/* Negate only once */
-	ret = _resolve_negate(ret, check);
-	return _xccdf_policy_report_rule_result(policy, result, rule, check, ret, message);
+	job->res = _resolve_negate(ret, check);
+	job->message = message;
 }
 
-/** 
- * Evaluate the XCCDF item. If it is group, start recursive cycle, otherwise get XCCDF check
- * and evaluate it.
- * Name collision with xccdf_item -> changed to xccdf_policy_item 
+/**
+ * Evaluate the job, its evaluation time is recorded when profiling. Rules
+ * evaluated concurrently share the process CPU time and bytes read.
  */
-static int xccdf_policy_item_evaluate(struct xccdf_policy * policy, struct xccdf_item * item, struct xccdf_result * result)
+static void
+_xccdf_policy_rule_job_evaluate(struct xccdf_policy *policy, struct rule_job *job, struct xccdf_result *result)
 {
-    struct xccdf_item_iterator      * child_it;
-    struct xccdf_item               * child;
-    int ret = 0;
+	struct oscap_timing_sample start;
+	struct oscap_timing_usage usage;
 
-    xccdf_type_t itype = xccdf_item_get_type(item);
+	(void) pthread_once(&rule_job_key_once, _rule_job_key_create);
+	(void) pthread_setspecific(rule_job_key, job);
+	if (!oscap_timing_enabled()) {
+		_xccdf_policy_rule_job_evaluate_check(policy, job, result);
+	} else {
+		oscap_timing_sample(&start);
+		_xccdf_policy_rule_job_evaluate_check(policy, job, result);
+		oscap_timing_usage_since(&start, &usage);
+		oscap_timing_record_rule(xccdf_rule_get_id(job->rule), &usage);
+	}
+	(void) pthread_setspecific(rule_job_key, NULL);
+}
 
-    switch (itype) {
-        case XCCDF_RULE:{
-			return _xccdf_policy_rule_evaluate(policy, (struct xccdf_rule *) item, result);
-        } break;
+/**
+ * Walk the XCCDF item. If it is group, start recursive cycle, otherwise
+ * schedule the evaluation of the rule.
+ * Name collision with xccdf_item -> changed to xccdf_policy_item
+ */
+static int xccdf_policy_item_schedule(struct xccdf_policy *policy, struct xccdf_item *item, struct rule_schedule *schedule)
+{
+	struct xccdf_item_iterator      * child_it;
+	struct xccdf_item               * child;
+	const size_t first = schedule->count;
+	int ret = 0;
+
+	xccdf_type_t itype = xccdf_item_get_type(item);
+
+	switch (itype) {
+		case XCCDF_RULE:{
+			ret = _xccdf_policy_rule_schedule(policy, (struct xccdf_rule *) item, schedule);
+		} break;
 
-        case XCCDF_GROUP:{
+		case XCCDF_GROUP:{
 			child_it = xccdf_group_get_content((const struct xccdf_group *)item);
 			while (xccdf_item_iterator_has_more(child_it)) {
 				child = xccdf_item_iterator_next(child_it);
-				ret = xccdf_policy_item_evaluate(policy, child, result);
+				ret = xccdf_policy_item_schedule(policy, child, schedule);
 				if (ret != 0)
 					break;
 			}
 			xccdf_item_iterator_free(child_it);
-        } break;
-        
-        default: 
-                    /* TODO: set warning bad argument and return ? */
+		} break;
+
+		default:
+			/* TODO: set warning bad argument and return ? */
 			assert(false);
 			return -1;
-            break;
-    } 
+			break;
+	}
 
-    return ret;
+	if (ret == 0)
+		ret = _rule_schedule_add_range(schedule, xccdf_item_get_id(item), first);
+	return ret;
+}
+
+static bool _rule_schedule_job_is_runnable(const struct rule_schedule *schedule, const struct rule_job *job)
+{
+	if (job->state != RULE_JOB_PENDING || !job->concurrent)
+		return false;
+	for (size_t i = 0; i < job->deps_count; i++) {
+		for (size_t j = job->deps[i * 2]; j <= job->deps[i * 2 + 1]; j++) {
+			if (schedule->jobs[j].state != RULE_JOB_FINISHED)
+				return false;
+		}
+	}
+	return true;
+}
+
+static void *_rule_schedule_worker(void *arg)
+{
+	struct rule_schedule *schedule = arg;
+
+	pthread_mutex_lock(&schedule->lock);
+	while (!schedule->stop) {
+		while (schedule->next < schedule->count && schedule->jobs[schedule->next].state != RULE_JOB_PENDING)
+			schedule->next++;
+		if (schedule->next == schedule->count)
+			break;
+
+		struct rule_job *job = NULL;
+		/* checks far ahead of the reporting would run in vain if the evaluation is aborted */
+		size_t end = schedule->reporting + schedule->ahead;
+		if (end > schedule->count)
+			end = schedule->count;
+		for (size_t i = schedule->next; i < end && job == NULL; i++) {
+			if (_rule_schedule_job_is_runnable(schedule, &schedule->jobs[i]))
+				job = &schedule->jobs[i];
+		}
+		if (job == NULL) {
+			pthread_cond_wait(&schedule->cond, &schedule->lock);
+			continue;
+		}
+
+		job->state = RULE_JOB_RUNNING;
+		pthread_mutex_unlock(&schedule->lock);
+		_xccdf_policy_rule_job_evaluate(schedule->policy, job, NULL);
+		job->errors = oscap_err_detach();
+		pthread_mutex_lock(&schedule->lock);
+		job->state = RULE_JOB_FINISHED;
+		pthread_cond_broadcast(&schedule->cond);
+	}
+	pthread_mutex_unlock(&schedule->lock);
+	return NULL;
+}
+
+/* Workers finish the checks they are evaluating and don't start any other */
+static void _rule_schedule_stop(struct rule_schedule *schedule)
+{
+	pthread_mutex_lock(&schedule->lock);
+	schedule->stop = true;
+	pthread_cond_broadcast(&schedule->cond);
+	pthread_mutex_unlock(&schedule->lock);
+}
+
+/**
+ * Get the result of the job and report it. Jobs which can't be evaluated by
+ * workers or haven't been taken by any of them yet are evaluated here.
+ */
+static int _rule_schedule_report_job(struct rule_schedule *schedule, struct rule_job *job)
+{
+	struct xccdf_policy *policy = schedule->policy;
+	int ret;
+
+	if (job->report_start) {
+		ret = xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_START, (void *) job->rule);
+		if (ret != 0)
+			return ret;
+	}
+
+	pthread_mutex_lock(&schedule->lock);
+	schedule->reporting = job - schedule->jobs;
+	pthread_cond_broadcast(&schedule->cond);
+	if (job->state == RULE_JOB_PENDING) {
+		job->state = RULE_JOB_RUNNING;
+		pthread_mutex_unlock(&schedule->lock);
+		_xccdf_policy_rule_job_evaluate(policy, job, schedule->result);
+		pthread_mutex_lock(&schedule->lock);
+		job->state = RULE_JOB_FINISHED;
+		pthread_cond_broadcast(&schedule->cond);
+	}
+	while (job->state != RULE_JOB_FINISHED)
+		pthread_cond_wait(&schedule->cond, &schedule->lock);
+	pthread_mutex_unlock(&schedule->lock);
+
+	oscap_err_attach(job->errors);
+	job->errors = NULL;
+	/* the job is reported now, in the document order */
+	oscap_list_free(job->deferred, (oscap_destruct_func) _rule_job_deferred_run);
+	job->deferred = NULL;
+	if (job->reported)
+		return job->report;
+
+	if (job->res == -1)
+		return -1;
+	struct xccdf_check *check = job->check;
+	job->check = NULL;
+	return _xccdf_policy_report_rule_result(policy, schedule->result, job->rule, check, job->res, job->message);
+}
+
+int xccdf_policy_eval_thread_count(void)
+{
+	const char *threads_str = getenv("OSCAP_XCCDF_EVAL_THREADS");
+	long threads = 1;
+
+	/* parallel evaluation is opt-in */
+	if (threads_str != NULL && sscanf(threads_str, "%ld", &threads) != 1) {
+		dW("Invalid value of OSCAP_XCCDF_EVAL_THREADS: '%s'", threads_str);
+		threads = 1;
+	}
+
+	return threads > 1 ? (int) threads : 1;
+}
+
+/**
+ * Evaluate the rules of the benchmark and report their results in the
+ * document order.
+ * @returns zero on success, -1 on error or the non-zero value returned by
+ * a reporting callback
+ */
+static int xccdf_policy_rules_evaluate(struct xccdf_policy *policy, struct xccdf_benchmark *benchmark, struct xccdf_result *result)
+{
+	struct rule_schedule schedule = {
+		.policy = policy,
+		.result = result,
+		.ranges = oscap_htable_new(),
+	};
+	int ret = 0;
+
+	/** We need to process document top-down order.
+	 * See conflicts/requires and Item Processing Algorithm */
+	struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
+	while (ret == 0 && xccdf_item_iterator_has_more(item_it))
+		ret = xccdf_policy_item_schedule(policy, xccdf_item_iterator_next(item_it), &schedule);
+	xccdf_item_iterator_free(item_it);
+
+	size_t concurrent_count = 0;
+	for (size_t i = 0; ret == 0 && i < schedule.count; i++) {
+		if (schedule.jobs[i].concurrent) {
+			ret = _rule_schedule_add_dependencies(&schedule, i);
+			concurrent_count++;
+		}
+	}
+
+	pthread_mutex_init(&schedule.lock, NULL);
+	pthread_cond_init(&schedule.cond, NULL);
+
+	/* the reporting thread is one of the evaluating threads */
+	size_t workers_count = ret == 0 ? (size_t) xccdf_policy_eval_thread_count() - 1 : 0;
+	if (workers_count > concurrent_count)
+		workers_count = concurrent_count;
+	schedule.ahead = XCCDF_EVAL_AHEAD_PER_THREAD * (workers_count + 1);
+	pthread_t *workers = NULL;
+	if (workers_count > 0) {
+		workers = malloc(workers_count * sizeof(pthread_t));
+		if (workers == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to allocate memory for the threads evaluating rules.");
+			workers_count = 0;
+			ret = -1;
+		}
+	}
+	size_t started = 0;
+	while (started < workers_count) {
+		if (pthread_create(&workers[started], NULL, _rule_schedule_worker, &schedule) != 0) {
+			dW("Can't start a thread evaluating rules: %s", strerror(errno));
+			break;
+		}
+		started++;
+	}
+	if (started > 0)
+		dI("Evaluating %zu concurrent checks using %zu threads.", concurrent_count, started + 1);
+
+	for (size_t i = 0; ret == 0 && i < schedule.count; i++)
+		ret = _rule_schedule_report_job(&schedule, &schedule.jobs[i]);
+	/* also when a callback aborted the evaluation, no other check shall be started */
+	_rule_schedule_stop(&schedule);
+	for (size_t i = 0; i < started; i++)
+		pthread_join(workers[i], NULL);
+	free(workers);
+
+	/* results of the jobs which were not reported */
+	for (size_t i = 0; i < schedule.count; i++) {
+		xccdf_check_free(schedule.jobs[i].check);
+		oscap_err_discard(schedule.jobs[i].errors);
+		oscap_list_free(schedule.jobs[i].deferred, (oscap_destruct_func) _rule_job_deferred_free);
+		free(schedule.jobs[i].deps);
+	}
+	pthread_cond_destroy(&schedule.cond);
+	pthread_mutex_destroy(&schedule.lock);
+	oscap_htable_free(schedule.ranges, free);
+	free(schedule.jobs);
+	return ret;
 }
 
 struct oscap_file_entry {
@@ -1566,6 +2058,15 @@ xccdf_policy_model_register_engine_and_query_callback(struct xccdf_policy_model
 	return oscap_list_add(model->engines, engine);
 }
 
+bool
+xccdf_policy_model_register_concurrent_engine(struct xccdf_policy_model *model, char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn)
+{
+	__attribute__nonnull__(model);
+	struct xccdf_policy_engine *engine = xccdf_policy_engine_new(sys, eval_fn, usr, query_fn);
+	xccdf_policy_engine_set_concurrent(engine, true);
+	return oscap_list_add(model->engines, engine);
+}
+
 void xccdf_policy_model_unregister_engines(struct xccdf_policy_model *model, const char *sys)
 {
 	__attribute__nonnull__(model);
@@ -2037,21 +2538,11 @@ struct xccdf_result * xccdf_policy_evaluate(struct xccdf_policy * policy)
 
     free(id);
 
-	/** We need to process document top-down order.
-	 * See conflicts/requires and Item Processing Algorithm */
-	struct xccdf_item_iterator *item_it = xccdf_benchmark_get_content(benchmark);
-	while (xccdf_item_iterator_has_more(item_it)) {
-		struct xccdf_item *item = xccdf_item_iterator_next(item_it);
-		ret = xccdf_policy_item_evaluate(policy, item, result);
-		if (ret == -1) {
-			xccdf_item_iterator_free(item_it);
-			xccdf_result_free(result);
-			return NULL;
-		}
-		if (ret != 0)
-			break;
+	ret = xccdf_policy_rules_evaluate(policy, benchmark, result);
+	if (ret == -1) {
+		xccdf_result_free(result);
+		return NULL;
 	}
-	xccdf_item_iterator_free(item_it);
 
 	if (policy->rule != NULL && !policy->rule_found) {
 		oscap_seterr(OSCAP_EFAMILY_XCCDF,
@@ -35,6 +35,7 @@ struct xccdf_policy_engine {
 	xccdf_policy_engine_eval_fn callback;   ///< format of callback function
 	void * usr;                             ///< User data structure
 	xccdf_policy_engine_query_fn query_fn;  ///< query callback function
+	bool concurrent;                        ///< eval function may run in several threads at once
 };
 
 struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn)
@@ -45,10 +46,21 @@ struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engi
 		engine->callback = eval_fn;
 		engine->usr = usr;
 		engine->query_fn = query_fn;
+		engine->concurrent = false;
 	}
 	return engine;
 }
 
+void xccdf_policy_engine_set_concurrent(struct xccdf_policy_engine *engine, bool concurrent)
+{
+	engine->concurrent = concurrent;
+}
+
+bool xccdf_policy_engine_is_concurrent(const struct xccdf_policy_engine *engine)
+{
+	return engine->concurrent;
+}
+
 bool xccdf_policy_engine_filter(struct xccdf_policy_engine *engine, const char *sysname)
 {
 	return oscap_strcmp(engine->system, sysname) == 0;
@@ -47,6 +47,20 @@ struct xccdf_policy_engine;
  */
 struct xccdf_policy_engine *xccdf_policy_engine_new(char *sys, xccdf_policy_engine_eval_fn eval_fn, void *usr, xccdf_policy_engine_query_fn query_fn);
 
+/**
+ * Mark the checking engine as able to evaluate several checks at the same
+ * time. Checks of engines which are not concurrent are evaluated one after
+ * another in the document order.
+ * @memberof xccdf_policy_engine
+ */
+void xccdf_policy_engine_set_concurrent(struct xccdf_policy_engine *engine, bool concurrent);
+
+/**
+ * @memberof xccdf_policy_engine
+ * @returns true if checks of the engine can be evaluated concurrently
+ */
+bool xccdf_policy_engine_is_concurrent(const struct xccdf_policy_engine *engine);
+
 /**
  * Filter function returning true if given callback is for the given checking engine,
  * false otherwise.
@@ -135,5 +135,12 @@ int xccdf_policy_report_cb(struct xccdf_policy *policy, const char *sysname, voi
  */
 struct xccdf_benchmark *xccdf_policy_get_benchmark(const struct xccdf_policy *policy);
 
+/**
+ * Get the number of threads which may be used to process rules of a policy.
+ * It's set by OSCAP_XCCDF_EVAL_THREADS, 1 by default.
+ * @returns at least 1
+ */
+int xccdf_policy_eval_thread_count(void);
+
 
 #endif
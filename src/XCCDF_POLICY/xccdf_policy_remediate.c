@@ -37,13 +37,17 @@
 #include <unistd.h>
 #endif
 
+#include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <pcre.h>
+#include <pthread.h>
 
 #include "XCCDF/item.h"
 #include "common/_error.h"
+#include "common/list.h"
 #include "common/debug_priv.h"
 #include "common/oscap_acquire.h"
+#include "common/oscap_string.h"
 #include "xccdf_policy_priv.h"
 #include "xccdf_policy_model_priv.h"
 #include "public/xccdf_policy.h"
@@ -99,7 +103,7 @@ static int _write_text_to_fd_and_free(int output_fd, char *text)
 	return ret;
 }
 
-static int _write_remediation_to_fd_and_free(int output_fd, const char* template, char* text)
+static void _append_remediation(struct oscap_string *output, const char* template, char* text)
 {
 	if (oscap_streq(template, "urn:xccdf:fix:script:ansible")) {
 		// Add required indentation in front of every single line
@@ -130,20 +134,10 @@ static int _write_remediation_to_fd_and_free(int output_fd, const char* template
 			}
 
 			if (strlen(current) > 0) {
-				// write indentation
-				if (_write_text_to_fd(output_fd, indentation) != 0) {
-					free(text);
-					return 1;
-				}
-				if (_write_text_to_fd(output_fd, current) != 0) {
-					free(text);
-					return 1;
-				}
-			}
-			if (_write_text_to_fd(output_fd, "\n") != 0) {
-				free(text);
-				return 1;
+				oscap_string_append_string(output, indentation);
+				oscap_string_append_string(output, current);
 			}
+			oscap_string_append_char(output, '\n');
 
 			if (next_delim != NULL) {
 				// text is NULL terminated to this is guaranteed to point to valid memory
@@ -151,19 +145,14 @@ static int _write_remediation_to_fd_and_free(int output_fd, const char* template
 			}
 		} while (next_delim != NULL);
 
-		if (_write_text_to_fd(output_fd, "\n") != 0) {
-			free(text);
-			return 1;
-		}
-
-		free(text);
-		return 0;
-
+		oscap_string_append_char(output, '\n');
 	} else {
 		// no extra processing is needed
-		return _write_text_to_fd_and_free(output_fd, text);
+		oscap_string_append_string(output, text);
 	}
+	free(text);
 }
+
 struct _interpret_map {
 	const char *sys;
 	const char *interpret;
@@ -376,107 +365,161 @@ static inline int _xccdf_fix_decode_xml(struct xccdf_fix *fix, char **result)
 	return 0;
 }
 
-#if defined(unix) || defined(__unix__) || defined(__unix)
-static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_fix *fix)
+/*
+ * Find the interpreter of the fix and decode its text. If the fix can't be
+ * executed, the reason is added to the rule result and 1 is returned.
+ */
+static int _xccdf_fix_prepare_script(struct xccdf_rule_result *rr, struct xccdf_fix *fix, const char **interpret, char **fix_text)
 {
-	if (rr == NULL) {
-		return 1;
-	}
-
 	if (fix == NULL || oscap_streq(xccdf_fix_get_content(fix), NULL)) {
 		_rule_add_info_message(rr, "No fix available.");
 		return 1;
 	}
-	
-	const char *interpret = NULL;
-	if ((interpret = _get_supported_interpret(xccdf_fix_get_system(fix), NULL)) == NULL) {
+
+	if ((*interpret = _get_supported_interpret(xccdf_fix_get_system(fix), NULL)) == NULL) {
 		_rule_add_info_message(rr, "Not supported xccdf:fix/@system='%s' or missing interpreter.",
 				xccdf_fix_get_system(fix) == NULL ? "" : xccdf_fix_get_system(fix));
 		return 1;
 	}
 
-	char *fix_text = NULL;
-	if (_xccdf_fix_decode_xml(fix, &fix_text) != 0) {
+	if (_xccdf_fix_decode_xml(fix, fix_text) != 0) {
 		_rule_add_info_message(rr, "Fix element contains unresolved child elements.");
 		return 1;
 	}
+	return 0;
+}
 
-	int result = 1;
-
-	char *temp_dir = oscap_acquire_temp_dir();
-	if (temp_dir == NULL)
-		goto cleanup;
+#if defined(unix) || defined(__unix__) || defined(__unix)
+/*
+ * Write the script to a new file in the directory. Returns the name of the
+ * file or NULL, in which case the error message is returned in error.
+ */
+static char *_fix_script_write(const char *temp_dir, const char *text, char **error)
+{
 	// TODO: Directory and files shall be labeled with SELinux to prevent
 	// confined processes with less priviledges to transit to oscap domain
 	// and become basically unconfined.
 	char *temp_file = NULL;
 	int fd = oscap_acquire_temp_file(temp_dir, "fix-XXXXXXXX", &temp_file);
 	if (fd == -1) {
-		_rule_add_info_message(rr, "mkstemp failed: %s", strerror(errno));
-		goto cleanup;
+		*error = oscap_sprintf("mkstemp failed: %s", strerror(errno));
+		return NULL;
 	}
 
-	if (_write_text_to_fd(fd, fix_text) != 0) {
-		_rule_add_info_message(rr, "Could not write to the temp file: %s", strerror(errno));
+	if (_write_text_to_fd(fd, text) != 0) {
+		*error = oscap_sprintf("Could not write to the temp file: %s", strerror(errno));
 		(void) close(fd);
-		goto cleanup;
+		free(temp_file);
+		return NULL;
 	}
 
-	if (close(fd) != 0)
-		_rule_add_info_message(rr, "Could not close temp file: %s", strerror(errno));
+	if (close(fd) != 0) {
+		*error = oscap_sprintf("Could not close temp file: %s", strerror(errno));
+		free(temp_file);
+		return NULL;
+	}
+	return temp_file;
+}
 
+/*
+ * Run the script by the interpreter. Returns the combined stdout and stderr
+ * of the script and sets its exit code. Returns NULL if the script couldn't
+ * be started, in which case the error message is returned in error.
+ */
+static char *_fix_script_run(const char *interpret, const char *script, int *exit_code, char **error)
+{
 	int pipefd[2];
 	if (pipe(pipefd) == -1) {
-		_rule_add_info_message(rr, "Could not create pipe: %s", strerror(errno));
-		goto cleanup;
+		*error = oscap_sprintf("Could not create pipe: %s", strerror(errno));
+		return NULL;
 	}
 
 	int fork_result = fork();
-	if (fork_result >= 0) {
-		/* fork succeded */
-		if (fork_result == 0) {
-			/* Execute fix and forward output to the parrent. */
-			close(pipefd[0]);
-			dup2(pipefd[1], fileno(stdout));
-			dup2(pipefd[1], fileno(stderr));
-			close(pipefd[1]);
-
-			char *const argvp[3] = {
-				(char *)interpret,
-				temp_file,
-				NULL
-			};
-
-			char *const envp[2] = {
-				"PATH=/bin:/sbin:/usr/bin:/usr/sbin",
-				NULL
-			};
-
-			execve(interpret, argvp, envp);
-			/* Wow, execve returned. In this special case, we failed to execute the fix
-			 * and we return 0 from function. At least the following error message will
-			 * indicate the problem in xccdf:message. */
-			printf("Error while executing fix script: execve returned: %s\n", strerror(errno));
-			exit(42);
-		} else {
-			free(temp_file);
-			close(pipefd[1]);
-			char *stdout_buff = oscap_acquire_pipe_to_string(pipefd[0]);
-			int wstatus;
-			waitpid(fork_result, &wstatus, 0);
-			_rule_add_info_message(rr, "Fix execution completed and returned: %d", WEXITSTATUS(wstatus));
-			if (stdout_buff != NULL && stdout_buff[0] != '\0')
-				_rule_add_info_message(rr, stdout_buff);
-			free(stdout_buff);
-			/* We return zero to indicate success. Rather than returning the exit code. */
-			result = 0;
-		}
-	} else {
-		_rule_add_info_message(rr, "Failed to fork. %s", strerror(errno));
-		free(temp_file);
+	if (fork_result < 0) {
+		*error = oscap_sprintf("Failed to fork. %s", strerror(errno));
+		close(pipefd[0]);
+		close(pipefd[1]);
+		return NULL;
+	}
+
+	if (fork_result == 0) {
+		/* Execute fix and forward output to the parrent. */
+		close(pipefd[0]);
+		dup2(pipefd[1], fileno(stdout));
+		dup2(pipefd[1], fileno(stderr));
+		close(pipefd[1]);
+
+		char *const argvp[3] = {
+			(char *)interpret,
+			(char *)script,
+			NULL
+		};
+
+		char *const envp[2] = {
+			"PATH=/bin:/sbin:/usr/bin:/usr/sbin",
+			NULL
+		};
+
+		execve(interpret, argvp, envp);
+		/* Wow, execve returned. In this special case, we failed to execute the fix
+		 * and we return 0 from function. At least the following error message will
+		 * indicate the problem in xccdf:message. */
+		printf("Error while executing fix script: execve returned: %s\n", strerror(errno));
+		exit(42);
+	}
+
+	close(pipefd[1]);
+	char *stdout_buff = oscap_acquire_pipe_to_string(pipefd[0]);
+	int wstatus;
+	waitpid(fork_result, &wstatus, 0);
+	*exit_code = WEXITSTATUS(wstatus);
+	return stdout_buff != NULL ? stdout_buff : oscap_strdup("");
+}
+
+static void _rule_add_fix_output(struct xccdf_rule_result *rr, int exit_code, const char *output)
+{
+	_rule_add_info_message(rr, "Fix execution completed and returned: %d", exit_code);
+	if (output != NULL && output[0] != '\0')
+		_rule_add_info_message(rr, "%s", output);
+}
+
+static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_fix *fix)
+{
+	if (rr == NULL) {
+		return 1;
 	}
 
+	const char *interpret = NULL;
+	char *fix_text = NULL;
+	if (_xccdf_fix_prepare_script(rr, fix, &interpret, &fix_text) != 0)
+		return 1;
+
+	int result = 1;
+	char *error = NULL;
+	char *temp_file = NULL;
+
+	char *temp_dir = oscap_acquire_temp_dir();
+	if (temp_dir == NULL)
+		goto cleanup;
+
+	temp_file = _fix_script_write(temp_dir, fix_text, &error);
+	if (temp_file == NULL)
+		goto cleanup;
+
+	int exit_code;
+	char *output = _fix_script_run(interpret, temp_file, &exit_code, &error);
+	if (output == NULL)
+		goto cleanup;
+	_rule_add_fix_output(rr, exit_code, output);
+	free(output);
+	/* We return zero to indicate success. Rather than returning the exit code. */
+	result = 0;
+
 cleanup:
+	if (error != NULL)
+		_rule_add_info_message(rr, "%s", error);
+	free(error);
+	free(temp_file);
 	oscap_acquire_cleanup_dir(&temp_dir);
 	free(fix_text);
 	return result;
@@ -499,54 +542,53 @@ static inline int _xccdf_fix_execute(struct xccdf_rule_result *rr, struct xccdf_
 }
 #endif
 
-int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
+/*
+ * Find the fix of a failed rule result and resolve its substitutions. The
+ * resolved fix is added to the rule result. Returns NULL if there is no fix
+ * to execute, the reason is recorded in the rule result.
+ */
+static struct xccdf_fix *_xccdf_policy_rule_result_prepare_fix(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
 {
-	if (policy == NULL || rr == NULL)
-		return 1;
-	if (xccdf_rule_result_get_result(rr) != XCCDF_RESULT_FAIL)
-		return 0;
-
-	// if a miscellaneous error happens (fix unsuitable or if we want to skip it for any reason
-	// we set misc_error to one, and the fix will be reported as error (and not skipped without log like before)
-	int misc_error=0;
-
 	if (fix == NULL) {
 		fix = _find_suitable_fix(policy, rr);
 		if (fix == NULL) {
 			// We want to append xccdf:message about missing fix.
 			_rule_add_info_message(rr, "No suitable fix found.");
 			xccdf_rule_result_set_result(rr, XCCDF_RESULT_FAIL);
-			misc_error=1;
+			return NULL;
 		}
 	}
 
+	/* Initialize the fix. */
+	struct xccdf_fix *cfix = xccdf_fix_clone(fix);
+	int res = xccdf_policy_resolve_fix_substitution(policy, cfix, rr, test_result);
+	xccdf_rule_result_add_fix(rr, cfix);
+	if (res != 0) {
+		_rule_add_info_message(rr, "Fix execution was aborted: Text substitution failed.");
+		xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
+		return NULL;
+	}
+	return cfix;
+}
+
+static void _rule_result_fix_not_executed(struct xccdf_rule_result *rr)
+{
+	_rule_add_info_message(rr, "Fix was not executed. Execution was aborted.");
+	xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
+}
+
+/*
+ * Report the remediated rule and, if its fix was executed, verify the fix
+ * by evaluating the check of the rule again.
+ */
+static int _xccdf_policy_rule_result_verify_fix(struct xccdf_policy *policy, struct xccdf_rule_result *rr, bool fix_executed)
+{
 	struct xccdf_check *check = NULL;
 	struct xccdf_check_iterator *check_it = xccdf_rule_result_get_checks(rr);
 	while (xccdf_check_iterator_has_more(check_it))
 		check = xccdf_check_iterator_next(check_it);
 	xccdf_check_iterator_free(check_it);
 
-	if(misc_error == 0){
-		/* Initialize the fix. */
-		struct xccdf_fix *cfix = xccdf_fix_clone(fix);
-		int res = xccdf_policy_resolve_fix_substitution(policy, cfix, rr, test_result);
-		xccdf_rule_result_add_fix(rr, cfix);
-		if (res != 0) {
-			_rule_add_info_message(rr, "Fix execution was aborted: Text substitution failed.");
-			xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
-			misc_error=1;
-		}else{
-
-			/* Execute the fix. */
-			res = _xccdf_fix_execute(rr, cfix);
-			if (res != 0) {
-				_rule_add_info_message(rr, "Fix was not executed. Execution was aborted.");
-				xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
-				misc_error=1;
-			}
-		}
-	}
-
 	/* We report rule during remediation even if fix isn't executed due to a miscellaneous error */
 	int report = 0;
 	struct xccdf_rule *rule = _lookup_rule_by_rule_result(policy, rr);
@@ -560,7 +602,7 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 			return report;
 	}
 
-	if(misc_error == 0){
+	if (fix_executed) {
 		/* Verify fix if applied by calling OVAL again */
 		if (check == NULL) {
 			xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
@@ -581,9 +623,235 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 	return rule == NULL ? 0 : xccdf_policy_report_cb(policy, XCCDF_POLICY_OUTCB_END, (void *) rr);
 }
 
+int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf_rule_result *rr, struct xccdf_fix *fix, struct xccdf_result *test_result)
+{
+	if (policy == NULL || rr == NULL)
+		return 1;
+	if (xccdf_rule_result_get_result(rr) != XCCDF_RESULT_FAIL)
+		return 0;
+
+	// if a miscellaneous error happens (fix unsuitable or if we want to skip it for any reason
+	// the fix will be reported as error (and not skipped without log like before)
+	bool fix_executed = false;
+	struct xccdf_fix *cfix = _xccdf_policy_rule_result_prepare_fix(policy, rr, fix, test_result);
+	if (cfix != NULL) {
+		/* Execute the fix. */
+		if (_xccdf_fix_execute(rr, cfix) != 0)
+			_rule_result_fix_not_executed(rr);
+		else
+			fix_executed = true;
+	}
+
+	return _xccdf_policy_rule_result_verify_fix(policy, rr, fix_executed);
+}
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+/* A failed rule whose fix is executed as a part of a batch */
+struct _fix_batch_item {
+	struct xccdf_rule_result *rr;
+	struct xccdf_fix *fix;		// resolved fix owned by the rule result, NULL if there is none
+	const char *interpret;
+	char *text;			// decoded text of the fix, NULL if it can't be executed
+	char *output;			// output of the fix, NULL if it wasn't executed
+	int exit_code;
+};
+
+/*
+ * Execute the shell fixes of the items from first to last (excluded) by one
+ * shell process. Every fix is sourced in its own subshell, so that an exit
+ * or a syntax error in a fix doesn't end the others. The shell prints
+ * a marker line with the exit code after each fix, the output of the fixes
+ * is split at the markers.
+ */
+static void _fix_batch_run_shell(const char *temp_dir, struct _fix_batch_item *items, size_t first, size_t last)
+{
+	char *error = NULL;
+	// the random part of the directory name makes the marker unique
+	const char *marker = strrchr(temp_dir, '/') != NULL ? strrchr(temp_dir, '/') + 1 : temp_dir;
+	struct oscap_string *batch = oscap_string_new();
+	size_t batched = 0;
+
+	for (size_t i = first; i < last; i++) {
+		struct _fix_batch_item *item = &items[i];
+		if (item->text == NULL || strcmp(item->interpret, "/bin/bash") != 0)
+			continue;
+
+		char *fix_file = _fix_script_write(temp_dir, item->text, &error);
+		if (fix_file == NULL) {
+			_rule_add_info_message(item->rr, "%s", error);
+			free(error);
+			error = NULL;
+			continue;
+		}
+		char *call = oscap_sprintf("( . '%s' )\nprintf '\\n%s %zu %%d\\n' $?\n", fix_file, marker, i);
+		oscap_string_append_string(batch, call);
+		free(call);
+		free(fix_file);
+		batched++;
+	}
+
+	char *batch_text = oscap_string_bequeath(batch);
+	if (batched == 0) {
+		free(batch_text);
+		return;
+	}
+
+	char *output = NULL;
+	char *batch_file = _fix_script_write(temp_dir, batch_text, &error);
+	int exit_code;
+	if (batch_file != NULL)
+		output = _fix_script_run("/bin/bash", batch_file, &exit_code, &error);
+	free(batch_file);
+	free(batch_text);
+	dI("Executed %zu fixes by one shell.", batched);
+
+	const char *current = output;
+	for (size_t i = first; i < last; i++) {
+		struct _fix_batch_item *item = &items[i];
+		if (item->text == NULL || strcmp(item->interpret, "/bin/bash") != 0)
+			continue;
+
+		if (current == NULL) {
+			if (error != NULL)
+				_rule_add_info_message(item->rr, "%s", error);
+			continue;
+		}
+
+		char *needle = oscap_sprintf("\n%s %zu ", marker, i);
+		const char *end = strstr(current, needle);
+		if (end != NULL) {
+			item->output = malloc(end - current + 1);
+			if (item->output != NULL) {
+				memcpy(item->output, current, end - current);
+				item->output[end - current] = '\0';
+			}
+			end += strlen(needle);
+			item->exit_code = atoi(end);
+			const char *next_line = strchr(end, '\n');
+			current = next_line != NULL ? next_line + 1 : end + strlen(end);
+		}
+		free(needle);
+	}
+
+	free(error);
+	free(output);
+}
+
+/*
+ * Execute the fixes of the items in their order. Consecutive shell fixes
+ * are executed by one shell process, fixes of other interprets are executed
+ * one by one after the shell fixes preceding them.
+ */
+static void _fix_batch_execute(struct _fix_batch_item *items, size_t count)
+{
+	char *error = NULL;
+	char *temp_dir = oscap_acquire_temp_dir();
+	if (temp_dir == NULL)
+		return;
+
+	size_t first = 0;		// first item which wasn't executed yet
+	for (size_t i = 0; i < count; i++) {
+		struct _fix_batch_item *item = &items[i];
+		if (item->text == NULL || strcmp(item->interpret, "/bin/bash") == 0)
+			continue;
+
+		_fix_batch_run_shell(temp_dir, items, first, i);
+		first = i + 1;
+
+		char *script = _fix_script_write(temp_dir, item->text, &error);
+		if (script != NULL)
+			item->output = _fix_script_run(item->interpret, script, &item->exit_code, &error);
+		free(script);
+		if (error != NULL) {
+			_rule_add_info_message(item->rr, "%s", error);
+			free(error);
+			error = NULL;
+		}
+	}
+	_fix_batch_run_shell(temp_dir, items, first, count);
+
+	oscap_acquire_cleanup_dir(&temp_dir);
+}
+
+/*
+ * Execute the fixes of all the failed rules first and verify them after
+ * that. This saves starting a process for every fix. When the batch can't
+ * grow, the rules which didn't fit in are remediated one by one after it.
+ * @returns -1 if nothing could be batched, the fixes have to be executed one by one
+ */
+static int _xccdf_policy_remediate_batched(struct xccdf_policy *policy, struct xccdf_result *result)
+{
+	size_t count = 0;
+	size_t allocated = 16;
+	struct _fix_batch_item *items = malloc(allocated * sizeof(struct _fix_batch_item));
+	if (items == NULL) {
+		dW("Failed to allocate memory for the batch of fixes, executing them one by one.");
+		return -1;
+	}
+
+	struct xccdf_rule_result *left_out = NULL;
+	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
+	while (xccdf_rule_result_iterator_has_more(rr_it)) {
+		struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
+		if (xccdf_rule_result_get_result(rr) != XCCDF_RESULT_FAIL)
+			continue;
+
+		if (count == allocated) {
+			struct _fix_batch_item *grown = realloc(items, 2 * allocated * sizeof(struct _fix_batch_item));
+			if (grown == NULL) {
+				dW("Failed to allocate memory for the batch of fixes, executing the remaining ones one by one.");
+				left_out = rr;
+				break;
+			}
+			items = grown;
+			allocated *= 2;
+		}
+		struct _fix_batch_item *item = &items[count++];
+		memset(item, 0, sizeof(*item));
+		item->rr = rr;
+		item->fix = _xccdf_policy_rule_result_prepare_fix(policy, rr, NULL, result);
+		if (item->fix != NULL && _xccdf_fix_prepare_script(rr, item->fix, &item->interpret, &item->text) != 0) {
+			free(item->text);
+			item->text = NULL;
+		}
+	}
+
+	_fix_batch_execute(items, count);
+
+	for (size_t i = 0; i < count; i++) {
+		struct _fix_batch_item *item = &items[i];
+		if (item->fix != NULL) {
+			if (item->output != NULL)
+				_rule_add_fix_output(item->rr, item->exit_code, item->output);
+			else
+				_rule_result_fix_not_executed(item->rr);
+		}
+		_xccdf_policy_rule_result_verify_fix(policy, item->rr, item->output != NULL);
+		free(item->text);
+		free(item->output);
+	}
+	free(items);
+
+	if (left_out != NULL) {
+		xccdf_policy_rule_result_remediate(policy, left_out, NULL, result);
+		while (xccdf_rule_result_iterator_has_more(rr_it))
+			xccdf_policy_rule_result_remediate(policy, xccdf_rule_result_iterator_next(rr_it), NULL, result);
+	}
+	xccdf_rule_result_iterator_free(rr_it);
+	return 0;
+}
+#endif
+
 int xccdf_policy_remediate(struct xccdf_policy *policy, struct xccdf_result *result)
 {
 	__attribute__nonnull__(result);
+#if defined(unix) || defined(__unix__) || defined(__unix)
+	const char *batch = getenv("OSCAP_REMEDIATE_BATCH");
+	if (batch != NULL && strcmp(batch, "1") == 0 && _xccdf_policy_remediate_batched(policy, result) == 0) {
+		xccdf_result_set_end_time_current(result);
+		return 0;
+	}
+#endif
 	struct xccdf_rule_result_iterator *rr_it = xccdf_result_get_rule_results(result);
 	while (xccdf_rule_result_iterator_has_more(rr_it)) {
 		struct xccdf_rule_result *rr = xccdf_rule_result_iterator_next(rr_it);
@@ -614,43 +882,44 @@ static const struct xccdf_fix *_find_fix_for_template(struct xccdf_policy *polic
 	return fix;
 }
 
-static int _write_fix_header_to_fd(const char *sys, int output_fd, struct xccdf_rule *rule, unsigned int current, unsigned int total)
+static bool _is_shell_template(const char *sys)
+{
+	return oscap_streq(sys, "") || oscap_streq(sys, "urn:xccdf:fix:script:sh") || oscap_streq(sys, "urn:xccdf:fix:commands");
+}
+
+static void _append_fix_header(const char *sys, struct oscap_string *output, struct xccdf_rule *rule, unsigned int current, unsigned int total)
 {
-	if (oscap_streq(sys, "") || oscap_streq(sys, "urn:xccdf:fix:script:sh") || oscap_streq(sys, "urn:xccdf:fix:commands")) {
+	if (_is_shell_template(sys)) {
 		char *fix_header = oscap_sprintf(
 				"###############################################################################\n"
 				"# BEGIN fix (%i / %i) for '%s'\n"
 				"###############################################################################\n"
 				"(>&2 echo \"Remediating rule %i/%i: '%s'\")\n",
 				current, total, xccdf_rule_get_id(rule), current, total, xccdf_rule_get_id(rule));
-		return _write_text_to_fd_and_free(output_fd, fix_header);
-	} else {
-		return 0;
+		oscap_string_append_string(output, fix_header);
+		free(fix_header);
 	}
 }
 
-static int _write_fix_footer_to_fd(const char *sys, int output_fd, struct xccdf_rule *rule)
+static void _append_fix_footer(const char *sys, struct oscap_string *output, struct xccdf_rule *rule)
 {
-	if (oscap_streq(sys, "") || oscap_streq(sys, "urn:xccdf:fix:script:sh") || oscap_streq(sys, "urn:xccdf:fix:commands")) {
+	if (_is_shell_template(sys)) {
 		char *fix_footer = oscap_sprintf("\n# END fix for '%s'\n\n", xccdf_rule_get_id(rule));
-		return _write_text_to_fd_and_free(output_fd, fix_footer);
-	} else {
-		return 0;
+		oscap_string_append_string(output, fix_footer);
+		free(fix_footer);
 	}
 }
 
-static int _write_fix_missing_warning_to_fd(const char *sys, int output_fd, struct xccdf_rule *rule)
+static void _append_fix_missing_warning(const char *sys, struct oscap_string *output, struct xccdf_rule *rule)
 {
-	if (oscap_streq(sys, "") || oscap_streq(sys, "urn:xccdf:fix:script:sh") || oscap_streq(sys, "urn:xccdf:fix:commands")) {
+	if (_is_shell_template(sys)) {
 		char *fix_footer = oscap_sprintf("(>&2 echo \"FIX FOR THIS RULE '%s' IS MISSING!\")\n", xccdf_rule_get_id(rule));
-		return _write_text_to_fd_and_free(output_fd, fix_footer);
-	} else {
-		return 0;
+		oscap_string_append_string(output, fix_footer);
+		free(fix_footer);
 	}
 }
 
-
-static inline int _parse_ansible_fix(const char *fix_text, struct oscap_list *variables, struct oscap_list *tasks)
+static pcre *_ansible_variable_regex_compile(void)
 {
 	// TODO: Tolerate different indentation styles in this regex
 	const char *pattern =
@@ -663,9 +932,12 @@ static inline int _parse_ansible_fix(const char *fix_text, struct oscap_list *va
 	if (re == NULL) {
 		dE("Unable to compile regex pattern, "
 				"pcre_compile() returned error (offset: %d): '%s'.\n", errofs, err);
-		return 1;
 	}
+	return re;
+}
 
+static inline int _parse_ansible_fix(const pcre *re, const char *fix_text, struct oscap_list *variables, struct oscap_list *tasks)
+{
 	// ovector sizing:
 	// 2 elements are used for the whole needle,
 	// 4 elements are used for the 2 capture groups
@@ -684,7 +956,6 @@ static inline int _parse_ansible_fix(const char *fix_text, struct oscap_list *va
 		if (match != 3) {
 			dE("Expected 2 capture group matches per XCCDF variable. Found %i!",
 				match - 1);
-			pcre_free(re);
 			return 1;
 		}
 
@@ -704,9 +975,7 @@ static inline int _parse_ansible_fix(const char *fix_text, struct oscap_list *va
 		free(variable_name);
 		free(variable_value);
 
-		if (!oscap_list_contains(variables, var_line, (oscap_cmp_func) oscap_streq)) {
-			oscap_list_add(variables, var_line);
-		}
+		oscap_list_add(variables, var_line);
 
 		// Remarks: ovector doesn't contain values relative to start_offset, it contains
 		// absolute indices of fix_text.
@@ -726,12 +995,12 @@ static inline int _parse_ansible_fix(const char *fix_text, struct oscap_list *va
 		oscap_list_add(tasks, remediation_part);
 	}
 
-	pcre_free(re);
 	return 0;
 }
 
-static int _xccdf_policy_rule_get_fix_text(struct xccdf_policy *policy, struct xccdf_rule *rule, const char *template, char **fix_text)
+static int _xccdf_policy_rule_get_fix(struct xccdf_policy *policy, struct xccdf_rule *rule, const char *template, struct xccdf_fix **cfix)
 {
+	*cfix = NULL;
 	// Ensure that given Rule is selected and applicable (CPE).
 	const bool is_selected = xccdf_policy_is_item_selected(policy, xccdf_rule_get_id(rule));
 	if (!is_selected) {
@@ -747,57 +1016,166 @@ static int _xccdf_policy_rule_get_fix_text(struct xccdf_policy *policy, struct x
 	dI("Processing a fix for Rule/@id=\"%s\"", xccdf_rule_get_id(rule));
 
 	// Process Text Substitute within the fix
-	struct xccdf_fix *cfix = xccdf_fix_clone(fix);
-	int res = xccdf_policy_resolve_fix_substitution(policy, cfix, NULL, NULL);
+	*cfix = xccdf_fix_clone(fix);
+	int res = xccdf_policy_resolve_fix_substitution(policy, *cfix, NULL, NULL);
 	if (res != 0) {
 		oscap_seterr(OSCAP_EFAMILY_OSCAP, "A fix for Rule/@id=\"%s\" was skipped: Text substitution failed.",
 				xccdf_rule_get_id(rule));
-		xccdf_fix_free(cfix);
+		xccdf_fix_free(*cfix);
+		*cfix = NULL;
 		return res == 1; // Value 2 indicates warning.
 	}
-	// Refine. Resolve XML comments, CDATA and remaining elements
-	if (_xccdf_fix_decode_xml(cfix, fix_text) != 0) {
-		oscap_seterr(OSCAP_EFAMILY_OSCAP, "A fix element for Rule/@id=\"%s\" contains unresolved child elements.",
-				xccdf_rule_get_id(rule));
-		xccdf_fix_free(cfix);
-		return 1;
-	}
-	xccdf_fix_free(cfix);
 	return 0;
 }
 
-static int _xccdf_policy_rule_generate_fix(struct xccdf_policy *policy, struct xccdf_rule *rule, const char *template, int output_fd, unsigned int current, unsigned int total)
+/*
+ * Output of a rule in a generated script. The fixes are looked up in the
+ * document order, because that needs the policy. Decoding and formatting
+ * of the fixes is independent and it is done by several threads, the
+ * outputs are written in the document order after that.
+ */
+struct _fix_chunk {
+	struct xccdf_rule *rule;
+	struct xccdf_fix *fix;		// resolved fix, NULL if there is none
+	int ret;
+	bool unresolved;		// the fix contains unresolved child elements
+	char *text;			// output of the rule
+	struct oscap_list *variables;	// Ansible variables of the fix
+};
+
+struct _fix_chunk_list {
+	struct _fix_chunk *chunks;
+	size_t count;
+	const char *template;
+	const pcre *re;			// Ansible variables, NULL for other templates
+	size_t next;			// next chunk to be formatted
+	pthread_mutex_t lock;
+};
+
+static void _fix_chunk_format(struct _fix_chunk_list *list, size_t index)
 {
-	int ret = _write_fix_header_to_fd(template, output_fd, rule, current, total);
-	if (ret != 0) {
-		return ret;
-	}
+	struct _fix_chunk *chunk = &list->chunks[index];
 	char *fix_text = NULL;
-	ret = _xccdf_policy_rule_get_fix_text(policy, rule, template, &fix_text);
-	if (fix_text == NULL || ret != 0) {
-		ret = _write_fix_missing_warning_to_fd(template, output_fd, rule);
+
+	// Refine. Resolve XML comments, CDATA and remaining elements
+	if (chunk->fix != NULL && _xccdf_fix_decode_xml(chunk->fix, &fix_text) != 0) {
+		chunk->unresolved = true;
+		chunk->ret = 1;
+	}
+
+	struct oscap_string *output = oscap_string_new();
+	if (list->re != NULL) {
+		if (fix_text != NULL) {
+			struct oscap_list *tasks = oscap_list_new();
+			chunk->variables = oscap_list_new();
+			chunk->ret = _parse_ansible_fix(list->re, fix_text, chunk->variables, tasks);
+			struct oscap_iterator *tasks_it = oscap_iterator_new(tasks);
+			while (oscap_iterator_has_more(tasks_it))
+				_append_remediation(output, list->template, oscap_strdup(oscap_iterator_next(tasks_it)));
+			oscap_iterator_free(tasks_it);
+			oscap_list_free(tasks, free);
+			free(fix_text);
+		}
 	} else {
-		ret = _write_remediation_to_fd_and_free(output_fd, template, fix_text);
+		_append_fix_header(list->template, output, chunk->rule, index + 1, list->count);
+		if (fix_text == NULL)
+			_append_fix_missing_warning(list->template, output, chunk->rule);
+		else
+			_append_remediation(output, list->template, fix_text);
+		_append_fix_footer(list->template, output, chunk->rule);
 	}
-	if (ret != 0) {
-		return ret;
+	chunk->text = oscap_string_bequeath(output);
+}
+
+static void *_fix_chunk_worker(void *arg)
+{
+	struct _fix_chunk_list *list = arg;
+
+	while (true) {
+		pthread_mutex_lock(&list->lock);
+		const size_t index = list->next++;
+		pthread_mutex_unlock(&list->lock);
+		if (index >= list->count)
+			break;
+		_fix_chunk_format(list, index);
 	}
-	ret = _write_fix_footer_to_fd(template, output_fd, rule);
-	return ret;
+	return NULL;
 }
 
-static int _xccdf_policy_rule_generate_ansible_fix(struct xccdf_policy *policy, struct xccdf_rule *rule, const char *template, struct oscap_list *variables, struct oscap_list *tasks)
+static void _fix_chunk_list_format(struct _fix_chunk_list *list)
 {
-	char *fix_text = NULL;
-	int ret = _xccdf_policy_rule_get_fix_text(policy, rule, template, &fix_text);
-	if (fix_text == NULL) {
-		return ret;
+	// the parser has to be initialized before it's used by the threads
+	xmlInitParser();
+	pthread_mutex_init(&list->lock, NULL);
+
+	size_t workers_count = (size_t) xccdf_policy_eval_thread_count() - 1;
+	if (workers_count > list->count / 2)
+		workers_count = list->count / 2;
+	pthread_t *workers = workers_count > 0 ? malloc(workers_count * sizeof(pthread_t)) : NULL;
+	size_t started = 0;
+	// without the array the fixes are formatted by this thread only
+	while (workers != NULL && started < workers_count && pthread_create(&workers[started], NULL, _fix_chunk_worker, list) == 0)
+		started++;
+
+	_fix_chunk_worker(list);
+
+	for (size_t i = 0; i < started; i++)
+		pthread_join(workers[i], NULL);
+	free(workers);
+	pthread_mutex_destroy(&list->lock);
+}
+
+/*
+ * Look up the fixes of the rules until the first error, which is returned.
+ * Later rules are left out of the list.
+ * @returns -1 if the list can't be allocated, it's empty then
+ */
+static int _fix_chunk_list_init(struct _fix_chunk_list *list, struct oscap_list *rules_to_fix, struct xccdf_policy *policy, const char *template, bool stop_on_error)
+{
+	int ret = 0;
+	const size_t rules_count = oscap_list_get_itemcount(rules_to_fix);
+	list->chunks = calloc(rules_count, sizeof(struct _fix_chunk));
+	list->count = 0;
+	list->template = template;
+	list->re = NULL;
+	list->next = 0;
+	if (list->chunks == NULL && rules_count > 0) {
+		oscap_seterr(OSCAP_EFAMILY_XCCDF, "Failed to allocate memory for the fixes of %zu rules.", rules_count);
+		return -1;
 	}
-	ret = _parse_ansible_fix(fix_text, variables, tasks);
-	free(fix_text);
+
+	struct oscap_iterator *rules_to_fix_it = oscap_iterator_new(rules_to_fix);
+	while (oscap_iterator_has_more(rules_to_fix_it)) {
+		struct _fix_chunk *chunk = &list->chunks[list->count++];
+		chunk->rule = (struct xccdf_rule *) oscap_iterator_next(rules_to_fix_it);
+		chunk->ret = _xccdf_policy_rule_get_fix(policy, chunk->rule, template, &chunk->fix);
+		if (chunk->ret != 0 && stop_on_error) {
+			ret = chunk->ret;
+			break;
+		}
+	}
+	oscap_iterator_free(rules_to_fix_it);
 	return ret;
 }
 
+static void _fix_chunk_list_free(struct _fix_chunk_list *list)
+{
+	for (size_t i = 0; i < list->count; i++) {
+		xccdf_fix_free(list->chunks[i].fix);
+		free(list->chunks[i].text);
+		oscap_list_free(list->chunks[i].variables, free);
+	}
+	free(list->chunks);
+}
+
+static void _fix_chunk_report_unresolved(const struct _fix_chunk *chunk)
+{
+	if (chunk->unresolved) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "A fix element for Rule/@id=\"%s\" contains unresolved child elements.",
+				xccdf_rule_get_id(chunk->rule));
+	}
+}
+
 static int _xccdf_item_recursive_gather_selected_rules(struct xccdf_policy *policy, struct xccdf_item *item, struct oscap_list *rule_list)
 {
 	int ret = 0;
@@ -1024,51 +1402,70 @@ static int _write_script_header_to_fd(struct xccdf_policy *policy, struct xccdf_
 
 static int _xccdf_policy_generate_fix_ansible(struct oscap_list *rules_to_fix, struct xccdf_policy *policy, const char *sys, int output_fd)
 {
-	int ret = 0;
-	struct oscap_list *variables = oscap_list_new();
-	struct oscap_list *tasks = oscap_list_new();
-	struct oscap_iterator *rules_to_fix_it = oscap_iterator_new(rules_to_fix);
-	while (oscap_iterator_has_more(rules_to_fix_it)) {
-		struct xccdf_rule *rule = (struct xccdf_rule*)oscap_iterator_next(rules_to_fix_it);
-		ret = _xccdf_policy_rule_generate_ansible_fix(policy, rule, sys, variables, tasks);
-		if (ret != 0)
-			break;
-	}
-	oscap_iterator_free(rules_to_fix_it);
-
-	_write_text_to_fd(output_fd, "  vars:\n");
-	struct oscap_iterator *variables_it = oscap_iterator_new(variables);
-	while(oscap_iterator_has_more(variables_it)) {
-		char *var_line = (char *) oscap_iterator_next(variables_it);
-		_write_text_to_fd(output_fd, var_line);
+	struct _fix_chunk_list list;
+	int ret = _fix_chunk_list_init(&list, rules_to_fix, policy, sys, true);
+	pcre *re = _ansible_variable_regex_compile();
+	if (re == NULL) {
+		// none of the fixes can be parsed
+		_fix_chunk_list_free(&list);
+		list.chunks = NULL;
+		list.count = 0;
+		ret = 1;
 	}
-	oscap_iterator_free(variables_it);
-	oscap_list_free(variables, free);
-
-	_write_text_to_fd(output_fd, "  tasks:\n");
-	struct oscap_iterator *tasks_it = oscap_iterator_new(tasks);
-	while(oscap_iterator_has_more(tasks_it)) {
-		char *var_line = strdup((char *) oscap_iterator_next(tasks_it));
-		_write_remediation_to_fd_and_free(output_fd, sys, var_line);
+	list.re = re;
+	_fix_chunk_list_format(&list);
+
+	// Variables have to be written before all the tasks, the same variable
+	// is written only once.
+	struct oscap_string *variables = oscap_string_new();
+	struct oscap_string *tasks = oscap_string_new();
+	struct oscap_htable *seen_variables = oscap_htable_new();
+	oscap_string_append_string(variables, "  vars:\n");
+	oscap_string_append_string(tasks, "  tasks:\n");
+	for (size_t i = 0; i < list.count; i++) {
+		struct _fix_chunk *chunk = &list.chunks[i];
+		_fix_chunk_report_unresolved(chunk);
+		struct oscap_iterator *variables_it = oscap_iterator_new(chunk->variables);
+		while (oscap_iterator_has_more(variables_it)) {
+			const char *var_line = oscap_iterator_next(variables_it);
+			if (oscap_htable_add(seen_variables, var_line, NULL))
+				oscap_string_append_string(variables, var_line);
+		}
+		oscap_iterator_free(variables_it);
+		oscap_string_append_string(tasks, chunk->text);
+		if (chunk->ret != 0) {
+			ret = chunk->ret;
+			break;
+		}
 	}
-	oscap_iterator_free(tasks_it);
-	oscap_list_free(tasks, free);
+	oscap_htable_free0(seen_variables);
+
+	if (_write_text_to_fd(output_fd, oscap_string_get_cstr(variables)) == 0)
+		_write_text_to_fd(output_fd, oscap_string_get_cstr(tasks));
+	oscap_string_free(variables);
+	oscap_string_free(tasks);
+	_fix_chunk_list_free(&list);
+	if (re != NULL)
+		pcre_free(re);
 	return ret;
 }
 
 static int _xccdf_policy_generate_fix_other(struct oscap_list *rules_to_fix, struct xccdf_policy *policy, const char *sys, int output_fd)
 {
 	int ret = 0;
-	const unsigned int total = oscap_list_get_itemcount(rules_to_fix);
-	unsigned int current = 1;
-	struct oscap_iterator *rules_to_fix_it = oscap_iterator_new(rules_to_fix);
-	while (oscap_iterator_has_more(rules_to_fix_it)) {
-		struct xccdf_rule *rule = (struct xccdf_rule *) oscap_iterator_next(rules_to_fix_it);
-		ret = _xccdf_policy_rule_generate_fix(policy, rule, sys, output_fd, current++, total);
+	struct _fix_chunk_list list;
+	if (_fix_chunk_list_init(&list, rules_to_fix, policy, sys, false) != 0)
+		return -1;
+	_fix_chunk_list_format(&list);
+
+	for (size_t i = 0; i < list.count; i++) {
+		_fix_chunk_report_unresolved(&list.chunks[i]);
+		// a rule without a usable fix gets a warning in the script
+		ret = _write_text_to_fd(output_fd, list.chunks[i].text);
 		if (ret != 0)
 			break;
 	}
-	oscap_iterator_free(rules_to_fix_it);
+	_fix_chunk_list_free(&list);
 	return ret;
 }
 
@@ -57,4 +57,25 @@ struct oscap_err_t {
  */
 void __oscap_seterr(const char *file, uint32_t line, const char *func, oscap_errfamily_t family, ...);
 
+struct err_queue;
+
+/**
+ * Take the errors set in the calling thread. The thread has no errors
+ * afterwards. This is used to hand over errors of a worker thread to the
+ * thread which reports them.
+ * @returns the queue of errors or NULL if there are none
+ */
+struct err_queue *oscap_err_detach(void);
+
+/**
+ * Append errors taken by oscap_err_detach() to the errors of the calling
+ * thread. The given queue is disposed.
+ */
+void oscap_err_attach(struct err_queue *errors);
+
+/**
+ * Dispose errors taken by oscap_err_detach() which won't be reported.
+ */
+void oscap_err_discard(struct err_queue *errors);
+
 #endif				/* _OSCAP_ERROR_H */
@@ -149,6 +149,42 @@ void oscap_clearerr(void)
 	err_queue_free(q, (oscap_destruct_func) oscap_err_free);
 }
 
+struct err_queue *oscap_err_detach(void)
+{
+#ifdef OSCAP_THREAD_SAFE
+	struct err_queue *q;
+
+	(void)pthread_once(&__once, oscap_errkey_init);
+
+	q = pthread_getspecific(__key);
+	(void)pthread_setspecific(__key, NULL);
+	return q;
+#else
+	struct err_queue *detached = q;
+
+	q = NULL;
+	return detached;
+#endif
+}
+
+void oscap_err_attach(struct err_queue *errors)
+{
+	if (errors == NULL)
+		return;
+
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_once(&__once, oscap_errkey_init);
+#endif
+	while (!err_queue_is_empty(errors))
+		_push_err(err_queue_pop_first(errors));
+	err_queue_free(errors, NULL);
+}
+
+void oscap_err_discard(struct err_queue *errors)
+{
+	err_queue_free(errors, (oscap_destruct_func) oscap_err_free);
+}
+
 bool oscap_err(void)
 {
 #ifdef OSCAP_THREAD_SAFE
@@ -0,0 +1,407 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef OS_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "oscap_compiled.h"
+#include "list.h"
+#include "_error.h"
+#include "debug_priv.h"
+#include "oscap_acquire.h"
+#include "oscap_helpers.h"
+#include "oscap.h"
+#include "source/oscap_source_priv.h"
+
+/* Large models have tens of thousands of distinct strings */
+#define STRING_IDS_HSIZE 65521
+
+struct compiled_buffer {
+	unsigned char *data;
+	size_t length;
+	size_t capacity;
+};
+
+struct oscap_compiled_writer {
+	struct compiled_buffer body;
+	struct compiled_buffer strings;
+	struct oscap_htable *string_ids;
+	uint64_t string_count;
+};
+
+static void _buffer_append(struct compiled_buffer *buf, const void *data, size_t size)
+{
+	if (buf->length + size > buf->capacity) {
+		size_t capacity = buf->capacity ? buf->capacity : 4096;
+		while (buf->length + size > capacity)
+			capacity *= 2;
+		buf->data = realloc(buf->data, capacity);
+		buf->capacity = capacity;
+	}
+	memcpy(buf->data + buf->length, data, size);
+	buf->length += size;
+}
+
+static void _buffer_write_uint(struct compiled_buffer *buf, uint64_t value)
+{
+	unsigned char bytes[10];
+	size_t len = 0;
+	do {
+		bytes[len] = value & 0x7f;
+		value >>= 7;
+		if (value != 0)
+			bytes[len] |= 0x80;
+		len++;
+	} while (value != 0);
+	_buffer_append(buf, bytes, len);
+}
+
+struct oscap_compiled_writer *oscap_compiled_writer_new(void)
+{
+	struct oscap_compiled_writer *w = calloc(1, sizeof(struct oscap_compiled_writer));
+	w->string_ids = oscap_htable_new1((oscap_compare_func) strcmp, STRING_IDS_HSIZE);
+	return w;
+}
+
+void oscap_compiled_writer_free(struct oscap_compiled_writer *w)
+{
+	if (w == NULL)
+		return;
+	free(w->body.data);
+	free(w->strings.data);
+	oscap_htable_free(w->string_ids, NULL);
+	free(w);
+}
+
+void oscap_compiled_write_uint(struct oscap_compiled_writer *w, uint64_t value)
+{
+	_buffer_write_uint(&w->body, value);
+}
+
+void oscap_compiled_write_int(struct oscap_compiled_writer *w, int64_t value)
+{
+	/* zig-zag, so that small negative numbers stay short */
+	_buffer_write_uint(&w->body, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+void oscap_compiled_write_float(struct oscap_compiled_writer *w, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	_buffer_write_uint(&w->body, bits);
+}
+
+void oscap_compiled_write_str(struct oscap_compiled_writer *w, const char *str)
+{
+	if (str == NULL) {
+		_buffer_write_uint(&w->body, 0);
+		return;
+	}
+	uintptr_t id = (uintptr_t) oscap_htable_get(w->string_ids, str);
+	if (id == 0) {
+		id = ++w->string_count;
+		oscap_htable_add(w->string_ids, str, (void *) id);
+		size_t len = strlen(str);
+		_buffer_write_uint(&w->strings, len);
+		_buffer_append(&w->strings, str, len + 1);
+	}
+	_buffer_write_uint(&w->body, id);
+}
+
+static int _write_file(struct oscap_compiled_writer *w, struct compiled_buffer *header, const char *file)
+{
+	FILE *fp = fopen(file, "wb");
+	if (fp == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open %s for writing: %s", file, strerror(errno));
+		return -1;
+	}
+	int ret = 0;
+	if (fwrite(header->data, 1, header->length, fp) != header->length ||
+			(w->strings.length && fwrite(w->strings.data, 1, w->strings.length, fp) != w->strings.length) ||
+			(w->body.length && fwrite(w->body.data, 1, w->body.length, fp) != w->body.length)) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write %s: %s", file, strerror(errno));
+		ret = -1;
+	}
+	if (fclose(fp) != 0 && ret == 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not write %s: %s", file, strerror(errno));
+		ret = -1;
+	}
+	return ret;
+}
+
+int oscap_compiled_writer_save(struct oscap_compiled_writer *w, const char *magic, uint64_t format,
+		const unsigned char *digest, uint64_t source_size, const char *file, bool atomic)
+{
+	struct compiled_buffer header;
+	memset(&header, 0, sizeof(header));
+	_buffer_append(&header, magic, strlen(magic));
+	_buffer_write_uint(&header, format);
+	const char *version = oscap_get_version();
+	_buffer_write_uint(&header, strlen(version));
+	_buffer_append(&header, version, strlen(version));
+	static const unsigned char no_digest[OSCAP_DIGEST_SIZE];
+	_buffer_append(&header, digest != NULL ? digest : no_digest, OSCAP_DIGEST_SIZE);
+	_buffer_write_uint(&header, source_size);
+	_buffer_write_uint(&header, w->string_count);
+
+	int ret;
+	if (!atomic) {
+		ret = _write_file(w, &header, file);
+	} else {
+		char *tmp_path = NULL;
+		char *file_copy = oscap_strdup(file);
+		char *dir = oscap_dirname(file_copy);
+		int fd = -1;
+		if (oscap_acquire_mkdir_p(dir) == 0)
+			fd = oscap_acquire_temp_file(dir, "compiled.XXXXXX", &tmp_path);
+		ret = -1;
+		if (fd >= 0) {
+			close(fd);
+			ret = _write_file(w, &header, tmp_path);
+			if (ret == 0 && rename(tmp_path, file) != 0) {
+				oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not rename %s to %s: %s", tmp_path, file, strerror(errno));
+				ret = -1;
+			}
+			if (ret != 0)
+				unlink(tmp_path);
+		}
+		free(tmp_path);
+		free(dir);
+		free(file_copy);
+	}
+	free(header.data);
+	return ret;
+}
+
+uint64_t oscap_compiled_read_uint(struct oscap_compiled_reader *r)
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64 && r->pos < r->end; shift += 7) {
+		unsigned char byte = *r->pos++;
+		value |= (uint64_t) (byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	r->failed = true;
+	return 0;
+}
+
+int64_t oscap_compiled_read_int(struct oscap_compiled_reader *r)
+{
+	uint64_t value = oscap_compiled_read_uint(r);
+	return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+float oscap_compiled_read_float(struct oscap_compiled_reader *r)
+{
+	uint32_t bits = oscap_compiled_read_uint(r);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+bool oscap_compiled_read_bool(struct oscap_compiled_reader *r)
+{
+	return oscap_compiled_read_uint(r) != 0;
+}
+
+size_t oscap_compiled_read_count(struct oscap_compiled_reader *r)
+{
+	uint64_t count = oscap_compiled_read_uint(r);
+	if (count > (uint64_t) (r->end - r->pos)) {
+		r->failed = true;
+		return 0;
+	}
+	return count;
+}
+
+const char *oscap_compiled_read_str(struct oscap_compiled_reader *r)
+{
+	uint64_t id = oscap_compiled_read_uint(r);
+	if (id == 0)
+		return NULL;
+	if (id > r->string_count) {
+		r->failed = true;
+		return NULL;
+	}
+	return r->strings[id - 1];
+}
+
+/*
+ * Check the header and load the string table. Returns false when the data
+ * is not a compatible compiled file or it has been built from a different source.
+ */
+static bool _read_header(struct oscap_compiled_reader *r, const char *magic, uint64_t format,
+		const unsigned char *expected_digest, const uint64_t *expected_size)
+{
+	size_t magic_len = strlen(magic);
+	if ((size_t) (r->end - r->pos) < magic_len || memcmp(r->pos, magic, magic_len) != 0)
+		return false;
+	r->pos += magic_len;
+	if (oscap_compiled_read_uint(r) != format)
+		return false;
+	const char *version = oscap_get_version();
+	uint64_t version_len = oscap_compiled_read_uint(r);
+	if (r->failed || version_len != strlen(version) || version_len > (uint64_t) (r->end - r->pos) ||
+			memcmp(r->pos, version, version_len) != 0)
+		return false;
+	r->pos += version_len;
+	if ((size_t) (r->end - r->pos) < OSCAP_DIGEST_SIZE)
+		return false;
+	const unsigned char *digest = r->pos;
+	r->pos += OSCAP_DIGEST_SIZE;
+	uint64_t source_size = oscap_compiled_read_uint(r);
+	if (r->failed)
+		return false;
+	if ((expected_digest && memcmp(expected_digest, digest, OSCAP_DIGEST_SIZE) != 0) ||
+			(expected_size && *expected_size != source_size)) {
+		dI("Compiled content does not match the source content.");
+		return false;
+	}
+
+	r->string_count = oscap_compiled_read_count(r);
+	if (r->failed)
+		return false;
+	r->strings = malloc(r->string_count * sizeof(char *) + 1);
+	for (uint64_t i = 0; i < r->string_count; i++) {
+		uint64_t len = oscap_compiled_read_uint(r);
+		if (r->failed || len >= (uint64_t) (r->end - r->pos) || r->pos[len] != '\0')
+			return false;
+		r->strings[i] = (const char *) r->pos;
+		r->pos += len + 1;
+	}
+	return true;
+}
+
+static void _unmap(struct oscap_compiled_reader *r)
+{
+	if (r->map == NULL)
+		return;
+#ifndef OS_WINDOWS
+	munmap(r->map, r->map_size);
+#else
+	free(r->map);
+#endif
+	r->map = NULL;
+}
+
+int oscap_compiled_reader_open(struct oscap_compiled_reader *r, const char *file, const char *magic, uint64_t format,
+		const unsigned char *expected_digest, const uint64_t *expected_size, bool quiet)
+{
+	memset(r, 0, sizeof(*r));
+	int fd = open(file, O_RDONLY);
+	if (fd < 0) {
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open %s: %s", file, strerror(errno));
+		return -1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not read %s: empty or unreadable file", file);
+		close(fd);
+		return -1;
+	}
+	r->map_size = st.st_size;
+
+#ifndef OS_WINDOWS
+	void *data = mmap(NULL, r->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not map %s: %s", file, strerror(errno));
+		return -1;
+	}
+	r->map = data;
+#else
+	unsigned char *data = malloc(r->map_size);
+	size_t done = 0;
+	while (done < r->map_size) {
+		int len = read(fd, data + done, r->map_size - done);
+		if (len <= 0)
+			break;
+		done += len;
+	}
+	close(fd);
+	r->map = data;
+	if (done != r->map_size) {
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not read %s: %s", file, strerror(errno));
+		oscap_compiled_reader_close(r);
+		return -1;
+	}
+#endif
+	r->pos = r->map;
+	r->end = r->pos + r->map_size;
+
+	if (!_read_header(r, magic, format, expected_digest, expected_size)) {
+		if (!quiet)
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "%s is not a compatible compiled file of this OpenSCAP version.", file);
+		oscap_compiled_reader_close(r);
+		return -1;
+	}
+	return 0;
+}
+
+bool oscap_compiled_reader_close(struct oscap_compiled_reader *r)
+{
+	bool complete = !r->failed && r->pos == r->end;
+	free(r->strings);
+	r->strings = NULL;
+	r->string_count = 0;
+	_unmap(r);
+	r->pos = r->end = NULL;
+	return complete;
+}
+
+char *oscap_compiled_cache_path(const char *env, struct oscap_source *source, uint64_t format, const char *suffix,
+		unsigned char *digest, uint64_t *source_size)
+{
+	const char *cache_dir = getenv(env);
+	if (cache_dir == NULL || *cache_dir == '\0')
+		return NULL;
+	size_t size;
+	if (oscap_source_get_digest(source, digest, &size) != 0) {
+		char *err = oscap_err_get_full_error();
+		dW("Could not digest %s, %s cache is not used: %s", oscap_source_readable_origin(source), env, err);
+		free(err);
+		return NULL;
+	}
+	*source_size = size;
+
+	char hex[2 * OSCAP_DIGEST_SIZE + 1];
+	for (size_t i = 0; i < OSCAP_DIGEST_SIZE; i++)
+		snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+	return oscap_sprintf("%s/%s-%llu-%llu%s", cache_dir, hex,
+			(unsigned long long) size, (unsigned long long) format, suffix);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OSCAP_COMPILED_H_
+#define OSCAP_COMPILED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "util.h"
+#include "oscap_digest.h"
+#include "oscap_source.h"
+
+/*
+ * Building blocks of the compiled (binary) content formats.
+ *
+ * A compiled file consists of a header (magic, format, library version,
+ * SHA-256 digest and size of the source), a table of deduplicated strings and
+ * a body. All integers are LEB128 varints, signed values are zig-zag
+ * encoded and strings are referred to by their index in the table,
+ * index 0 standing for NULL. The layout of the body is up to the caller.
+ */
+
+struct oscap_compiled_writer;
+
+struct oscap_compiled_writer *oscap_compiled_writer_new(void);
+void oscap_compiled_writer_free(struct oscap_compiled_writer *w);
+
+void oscap_compiled_write_uint(struct oscap_compiled_writer *w, uint64_t value);
+void oscap_compiled_write_int(struct oscap_compiled_writer *w, int64_t value);
+void oscap_compiled_write_float(struct oscap_compiled_writer *w, float value);
+void oscap_compiled_write_str(struct oscap_compiled_writer *w, const char *str);
+
+/**
+ * Write the header, the string table and the body to the file.
+ * @param digest SHA-256 digest of the source, NULL if there is no source
+ * @param atomic write to a temporary file in the same directory first
+ * and rename it afterwards, so that concurrent readers never see a partial file
+ * @returns 0 on success, -1 on failure (with oscap_seterr)
+ */
+int oscap_compiled_writer_save(struct oscap_compiled_writer *w, const char *magic, uint64_t format,
+		const unsigned char *digest, uint64_t source_size, const char *file, bool atomic);
+
+struct oscap_compiled_reader {
+	const unsigned char *pos;
+	const unsigned char *end;
+	const char **strings;
+	uint64_t string_count;
+	bool failed;            ///< set by any read beyond the data or of a malformed value
+	void *map;
+	size_t map_size;
+};
+
+/**
+ * Map a compiled file and position the reader at the beginning of the body.
+ * Files of a different format or library version, or built from a different
+ * source (when an expected digest and size are given) are refused.
+ * @param quiet do not set an error when the file cannot be used
+ * @returns 0 on success, -1 otherwise
+ */
+int oscap_compiled_reader_open(struct oscap_compiled_reader *r, const char *file, const char *magic, uint64_t format,
+		const unsigned char *expected_digest, const uint64_t *expected_size, bool quiet);
+
+/**
+ * Unmap the file. Strings returned by oscap_compiled_read_str() become invalid.
+ * @returns true if the whole body has been consumed without failures
+ */
+bool oscap_compiled_reader_close(struct oscap_compiled_reader *r);
+
+uint64_t oscap_compiled_read_uint(struct oscap_compiled_reader *r);
+int64_t oscap_compiled_read_int(struct oscap_compiled_reader *r);
+float oscap_compiled_read_float(struct oscap_compiled_reader *r);
+bool oscap_compiled_read_bool(struct oscap_compiled_reader *r);
+/** Read a number of items to follow. Every item takes at least one byte, so a count
+ * can never exceed the size of the rest of the file. */
+size_t oscap_compiled_read_count(struct oscap_compiled_reader *r);
+/** @returns string owned by the reader or NULL */
+const char *oscap_compiled_read_str(struct oscap_compiled_reader *r);
+
+/**
+ * Get path of the compiled copy of the source in the cache directory given
+ * by the environment variable. The file name consists of the SHA-256 digest
+ * and the size of the source and of the format.
+ * @param digest buffer of OSCAP_DIGEST_SIZE bytes for the digest of the source
+ * @returns path to be freed by the caller, or NULL if the cache is not enabled
+ * or the source cannot be digested
+ */
+char *oscap_compiled_cache_path(const char *env, struct oscap_source *source, uint64_t format, const char *suffix,
+		unsigned char *digest, uint64_t *source_size);
+
+#endif
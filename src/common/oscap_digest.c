@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "oscap_digest.h"
+#include "_error.h"
+
+#if defined(HAVE_NSS3)
+#include <nss.h>
+#include <sechash.h>
+#elif defined(HAVE_GCRYPT)
+#include <gcrypt.h>
+#endif
+
+struct oscap_digest {
+#if defined(HAVE_NSS3)
+	HASHContext *ctx;
+#elif defined(HAVE_GCRYPT)
+	gcry_md_hd_t hd;
+#else
+	int unused;
+#endif
+};
+
+#if defined(HAVE_NSS3) || defined(HAVE_GCRYPT)
+static pthread_once_t _digest_init_once = PTHREAD_ONCE_INIT;
+static int _digest_init_ret = -1;
+
+/* The same initialization as crapi_init() of the probes, unless the library is initialized already */
+static void _digest_init(void)
+{
+#if defined(HAVE_NSS3)
+	_digest_init_ret = (NSS_IsInitialized() || NSS_NoDB_Init(NULL) == SECSuccess) ? 0 : -1;
+#else
+	if (!gcry_control(GCRYCTL_INITIALIZATION_FINISHED_P)) {
+#ifdef HAVE_GCRYCTL_SET_ENFORCED_FIPS_FLAG
+		gcry_control(GCRYCTL_SET_ENFORCED_FIPS_FLAG, 0);
+#endif
+		if (!gcry_check_version(GCRYPT_VERSION))
+			return;
+		gcry_control(GCRYCTL_INITIALIZATION_FINISHED, 0);
+	}
+	_digest_init_ret = 0;
+#endif
+}
+#endif
+
+struct oscap_digest *oscap_digest_new(void)
+{
+#if defined(HAVE_NSS3) || defined(HAVE_GCRYPT)
+	pthread_once(&_digest_init_once, _digest_init);
+	if (_digest_init_ret != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not initialize the crypto library.");
+		return NULL;
+	}
+	struct oscap_digest *digest = malloc(sizeof(struct oscap_digest));
+	if (digest == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not allocate a SHA-256 digest.");
+		return NULL;
+	}
+#if defined(HAVE_NSS3)
+	digest->ctx = HASH_Create(HASH_AlgSHA256);
+	if (digest->ctx == NULL) {
+		free(digest);
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not create a SHA-256 digest.");
+		return NULL;
+	}
+	HASH_Begin(digest->ctx);
+#else
+	if (gcry_md_open(&digest->hd, GCRY_MD_SHA256, 0) != 0) {
+		free(digest);
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not create a SHA-256 digest.");
+		return NULL;
+	}
+#endif
+	return digest;
+#else
+	oscap_seterr(OSCAP_EFAMILY_OSCAP, "OpenSCAP was built without a crypto library, SHA-256 is not available.");
+	return NULL;
+#endif
+}
+
+void oscap_digest_update(struct oscap_digest *digest, const void *data, size_t size)
+{
+#if defined(HAVE_NSS3)
+	const unsigned char *pos = data;
+	while (size > 0) {
+		unsigned int len = size > UINT_MAX ? UINT_MAX : (unsigned int) size;
+		HASH_Update(digest->ctx, pos, len);
+		pos += len;
+		size -= len;
+	}
+#elif defined(HAVE_GCRYPT)
+	gcry_md_write(digest->hd, data, size);
+#endif
+}
+
+int oscap_digest_finish(struct oscap_digest *digest, unsigned char *result)
+{
+	int ret = -1;
+#if defined(HAVE_NSS3)
+	unsigned int len = 0;
+	HASH_End(digest->ctx, result, &len, OSCAP_DIGEST_SIZE);
+	if (len == OSCAP_DIGEST_SIZE)
+		ret = 0;
+#elif defined(HAVE_GCRYPT)
+	const unsigned char *value = gcry_md_read(digest->hd, GCRY_MD_SHA256);
+	if (value != NULL) {
+		memcpy(result, value, OSCAP_DIGEST_SIZE);
+		ret = 0;
+	}
+#endif
+	if (ret != 0)
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not compute a SHA-256 digest.");
+	oscap_digest_free(digest);
+	return ret;
+}
+
+void oscap_digest_free(struct oscap_digest *digest)
+{
+	if (digest == NULL)
+		return;
+#if defined(HAVE_NSS3)
+	HASH_Destroy(digest->ctx);
+#elif defined(HAVE_GCRYPT)
+	gcry_md_close(digest->hd);
+#endif
+	free(digest);
+}
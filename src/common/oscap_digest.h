@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OSCAP_DIGEST_H_
+#define OSCAP_DIGEST_H_
+
+#include <stddef.h>
+
+/*
+ * SHA-256 digest computed by the crypto library the library is linked with
+ * (gcrypt or NSS), for keys which must not be forged by the content.
+ */
+
+#define OSCAP_DIGEST_SIZE 32
+
+struct oscap_digest;
+
+/**
+ * Start a new digest.
+ * @returns NULL if no crypto library is available (with oscap_seterr)
+ */
+struct oscap_digest *oscap_digest_new(void);
+
+void oscap_digest_update(struct oscap_digest *digest, const void *data, size_t size);
+
+/**
+ * Store the digest of the data to the buffer and free the digest.
+ * @param result buffer of OSCAP_DIGEST_SIZE bytes
+ * @returns 0 on success, -1 on failure (with oscap_seterr)
+ */
+int oscap_digest_finish(struct oscap_digest *digest, unsigned char *result);
+
+/** Free the digest without finishing it */
+void oscap_digest_free(struct oscap_digest *digest);
+
+#endif
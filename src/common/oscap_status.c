@@ -0,0 +1,414 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef OS_WINDOWS
+#include <unistd.h>
+#endif
+
+#include "oscap_status_priv.h"
+#include "_error.h"
+#include "list.h"
+
+#if defined(OSCAP_THREAD_SAFE)
+# include <pthread.h>
+static pthread_mutex_t status_mutex = PTHREAD_MUTEX_INITIALIZER;
+# define STATUS_LOCK    do { if (pthread_mutex_lock   (&status_mutex) != 0) abort(); } while(0)
+# define STATUS_UNLOCK  do { if (pthread_mutex_unlock (&status_mutex) != 0) abort(); } while(0)
+#else
+# define STATUS_LOCK   while(0)
+# define STATUS_UNLOCK while(0)
+#endif
+
+/* The hot counters are updated without taking the mutex */
+#if defined(__GNUC__)
+# define STATUS_ADD(var, n) __sync_fetch_and_add(&(var), (n))
+# define STATUS_GET(var)    __sync_fetch_and_add(&(var), 0)
+#else
+# define STATUS_ADD(var, n) ((var) += (n))
+# define STATUS_GET(var)    (var)
+#endif
+
+#define STATUS_PATH_MAX 4096
+
+static volatile bool status_enabled = false;
+static volatile uint64_t status_items = 0;
+static volatile uint64_t status_paths = 0;
+static volatile int status_icache_queue = 0;
+static volatile int status_seap_queue = 0;
+
+/* Guarded by the mutex */
+static size_t status_objects_total = 0;
+static size_t status_objects_done = 0;
+static size_t status_objects_in_flight = 0;
+static struct oscap_status_object *status_objects = NULL;
+/* object ID -> bool, true when the scheduled object has been collected */
+static struct oscap_htable *status_scheduled = NULL;
+static char status_path[STATUS_PATH_MAX];
+
+/* Owned by the reporter */
+static bool status_text = false;
+static int status_fd = -1;
+static unsigned int status_interval_ms = 0;
+static double status_start_ms = 0;
+static double status_last_ms = 0;
+static double status_progress_ms = 0;
+static uint64_t status_last_items = 0;
+static uint64_t status_last_progress = 0;
+
+static double status_now_ms(void)
+{
+#ifndef OS_WINDOWS
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#else
+	return time(NULL) * 1000.0;
+#endif
+}
+
+bool oscap_status_enabled(void)
+{
+	return status_enabled;
+}
+
+void oscap_status_schedule_object(const char *id)
+{
+	if (!status_enabled || id == NULL)
+		return;
+	STATUS_LOCK;
+	if (status_scheduled == NULL)
+		status_scheduled = oscap_htable_new();
+	if (status_scheduled != NULL && oscap_htable_get(status_scheduled, id) == NULL) {
+		bool *collected = calloc(1, sizeof(bool));
+		if (collected != NULL && oscap_htable_add(status_scheduled, id, collected))
+			status_objects_total++;
+		else
+			free(collected);
+	}
+	STATUS_UNLOCK;
+}
+
+void oscap_status_reschedule_objects(void)
+{
+	if (!status_enabled)
+		return;
+	STATUS_LOCK;
+	oscap_htable_free(status_scheduled, free);
+	status_scheduled = NULL;
+	STATUS_UNLOCK;
+}
+
+void oscap_status_object_begin(struct oscap_status_object *obj, const char *id, const char *type)
+{
+	if (!status_enabled) {
+		obj->start_ms = -1;
+		return;
+	}
+	obj->id = id;
+	obj->type = type;
+	obj->start_ms = status_now_ms();
+	STATUS_LOCK;
+	obj->next = status_objects;
+	status_objects = obj;
+	status_objects_in_flight++;
+	STATUS_UNLOCK;
+}
+
+void oscap_status_object_end(struct oscap_status_object *obj)
+{
+	struct oscap_status_object **it;
+	bool *collected;
+
+	/* the reporting could have started in the middle of the collection */
+	if (obj->start_ms < 0)
+		return;
+	STATUS_LOCK;
+	for (it = &status_objects; *it != NULL; it = &(*it)->next) {
+		if (*it == obj) {
+			*it = obj->next;
+			break;
+		}
+	}
+	status_objects_in_flight--;
+	/* also the objects found in the collected system characteristics are done */
+	collected = obj->id != NULL && status_scheduled != NULL ? oscap_htable_get(status_scheduled, obj->id) : NULL;
+	if (collected != NULL && !*collected) {
+		*collected = true;
+		status_objects_done++;
+	}
+	if (status_objects_in_flight == 0)
+		status_path[0] = '\0';
+	STATUS_UNLOCK;
+}
+
+void oscap_status_item_collected(void)
+{
+	if (status_enabled)
+		STATUS_ADD(status_items, 1);
+}
+
+void oscap_status_set_path(const char *path)
+{
+	size_t len;
+
+	if (!status_enabled || path == NULL)
+		return;
+	STATUS_ADD(status_paths, 1);
+	len = strlen(path);
+	if (len >= STATUS_PATH_MAX)
+		len = STATUS_PATH_MAX - 1;
+	STATUS_LOCK;
+	memcpy(status_path, path, len);
+	status_path[len] = '\0';
+	STATUS_UNLOCK;
+}
+
+/*
+ * The queues are counted even when the status is not reported, the
+ * reporting may start while something is waiting in them.
+ */
+void oscap_status_icache_queued(int delta)
+{
+	STATUS_ADD(status_icache_queue, delta);
+}
+
+void oscap_status_seap_queued(int delta)
+{
+	STATUS_ADD(status_seap_queue, delta);
+}
+
+/* Append a JSON string to the buffer, the buffer is always terminated */
+static size_t status_json_string(char *buf, size_t size, size_t len, const char *str)
+{
+	if (len + 1 >= size)
+		return len;
+	if (str == NULL || *str == '\0') {
+		return len + snprintf(buf + len, size - len, "%s", str == NULL ? "null" : "\"\"");
+	}
+	buf[len++] = '"';
+	for (; *str != '\0' && len + 8 < size; str++) {
+		unsigned char c = *str;
+		if (c == '"' || c == '\\') {
+			buf[len++] = '\\';
+			buf[len++] = c;
+		} else if (c < 0x20) {
+			len += snprintf(buf + len, size - len, "\\u%04x", c);
+		} else {
+			buf[len++] = c;
+		}
+	}
+	buf[len++] = '"';
+	buf[len] = '\0';
+	return len;
+}
+
+static void status_write(int fd, const char *buf, size_t len)
+{
+#ifndef OS_WINDOWS
+	while (len > 0) {
+		ssize_t ret = write(fd, buf, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		buf += ret;
+		len -= ret;
+	}
+#endif
+}
+
+static void status_report(bool final)
+{
+	char object[512] = "";
+	char object_type[64] = "";
+	char path[STATUS_PATH_MAX];
+	size_t total, done, in_flight;
+	double now = status_now_ms();
+	double object_ms = 0, items_per_sec = 0, elapsed_ms, idle_ms;
+	uint64_t items = STATUS_GET(status_items);
+	uint64_t paths = STATUS_GET(status_paths);
+	int icache_queue = STATUS_GET(status_icache_queue);
+	int seap_queue = STATUS_GET(status_seap_queue);
+	bool has_object;
+
+	STATUS_LOCK;
+	total = status_objects_total;
+	done = status_objects_done;
+	in_flight = status_objects_in_flight;
+	has_object = status_objects != NULL;
+	if (has_object) {
+		snprintf(object, sizeof(object), "%s", status_objects->id != NULL ? status_objects->id : "");
+		snprintf(object_type, sizeof(object_type), "%s", status_objects->type != NULL ? status_objects->type : "");
+		object_ms = now - status_objects->start_ms;
+	}
+	memcpy(path, status_path, sizeof(path));
+	STATUS_UNLOCK;
+
+	/* the rate is measured over the last interval, over the whole scan in the final record */
+	elapsed_ms = now - status_start_ms;
+	if (final) {
+		if (elapsed_ms > 0)
+			items_per_sec = items * 1000.0 / elapsed_ms;
+	} else if (now > status_last_ms) {
+		items_per_sec = (items - status_last_items) * 1000.0 / (now - status_last_ms);
+	}
+	status_last_ms = now;
+	status_last_items = items;
+	if (items + paths + done != status_last_progress) {
+		status_last_progress = items + paths + done;
+		status_progress_ms = now;
+	}
+	idle_ms = now - status_progress_ms;
+
+	if (status_text) {
+		fprintf(stderr, "Status: %.1f s, objects %zu/%zu done, %zu in flight", elapsed_ms / 1000.0, done, total, in_flight);
+		if (has_object)
+			fprintf(stderr, " (%s %s for %.1f s)", object_type, object, object_ms / 1000.0);
+		fprintf(stderr, ", %llu items (%.1f/s), queues icache %d seap %d", (unsigned long long) items,
+				items_per_sec, icache_queue, seap_queue);
+		if (path[0] != '\0')
+			fprintf(stderr, ", path %s", path);
+		if (idle_ms >= 2 * status_interval_ms)
+			fprintf(stderr, ", no progress for %.1f s", idle_ms / 1000.0);
+		fputc('\n', stderr);
+	}
+
+	if (status_fd != -1) {
+		char buf[STATUS_PATH_MAX * 2 + 1024];
+		size_t len;
+
+		len = snprintf(buf, sizeof(buf), "{\"elapsed_ms\": %.0f, \"objects_total\": %zu, \"objects_done\": %zu, "
+				"\"objects_in_flight\": %zu, \"object\": ", elapsed_ms, total, done, in_flight);
+		len = status_json_string(buf, sizeof(buf), len, has_object ? object : NULL);
+		len += snprintf(buf + len, sizeof(buf) - len, ", \"object_type\": ");
+		len = status_json_string(buf, sizeof(buf), len, has_object ? object_type : NULL);
+		len += snprintf(buf + len, sizeof(buf) - len, ", \"object_ms\": %.0f, \"items\": %llu, \"items_per_sec\": %.1f, "
+				"\"paths\": %llu, \"path\": ", object_ms, (unsigned long long) items, items_per_sec,
+				(unsigned long long) paths);
+		len = status_json_string(buf, sizeof(buf), len, path[0] != '\0' ? path : NULL);
+		len += snprintf(buf + len, sizeof(buf) - len, ", \"icache_queue\": %d, \"seap_queue\": %d, "
+				"\"idle_ms\": %.0f, \"final\": %s}\n", icache_queue, seap_queue, idle_ms, final ? "true" : "false");
+		status_write(status_fd, buf, len < sizeof(buf) ? len : sizeof(buf) - 1);
+	}
+}
+
+#if defined(OSCAP_THREAD_SAFE)
+static pthread_t status_thread;
+static pthread_cond_t status_cond = PTHREAD_COND_INITIALIZER;
+static bool status_running = false;
+
+static void *status_reporter(void *arg)
+{
+	struct timespec deadline;
+
+	(void) arg;
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+# if defined(OS_APPLE)
+	pthread_setname_np("status_reporter");
+# else
+	pthread_setname_np(pthread_self(), "status_reporter");
+# endif
+#endif
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	STATUS_LOCK;
+	while (status_running) {
+		deadline.tv_sec += status_interval_ms / 1000;
+		deadline.tv_nsec += (status_interval_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		while (status_running && pthread_cond_timedwait(&status_cond, &status_mutex, &deadline) != ETIMEDOUT)
+			;
+		if (!status_running)
+			break;
+		STATUS_UNLOCK;
+		status_report(false);
+		STATUS_LOCK;
+	}
+	STATUS_UNLOCK;
+	return NULL;
+}
+#endif
+
+int oscap_status_start(unsigned int interval_ms, bool text, int fd)
+{
+#if defined(OSCAP_THREAD_SAFE)
+	if (status_enabled) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Status reporting has been already started.");
+		return -1;
+	}
+	if (interval_ms == 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Status reporting interval must be positive.");
+		return -1;
+	}
+	status_text = text;
+	status_fd = fd;
+	status_interval_ms = interval_ms;
+	status_start_ms = status_last_ms = status_progress_ms = status_now_ms();
+	status_last_items = STATUS_GET(status_items);
+	STATUS_LOCK;
+	status_last_progress = status_last_items + STATUS_GET(status_paths) + status_objects_done;
+	STATUS_UNLOCK;
+	status_running = true;
+	status_enabled = true;
+	if ((errno = pthread_create(&status_thread, NULL, status_reporter, NULL)) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Failed to start the status reporter: %s", strerror(errno));
+		status_running = false;
+		status_enabled = false;
+		return -1;
+	}
+	return 0;
+#else
+	oscap_seterr(OSCAP_EFAMILY_OSCAP, "Status reporting requires the library built with thread support.");
+	return -1;
+#endif
+}
+
+void oscap_status_stop(void)
+{
+#if defined(OSCAP_THREAD_SAFE)
+	if (!status_enabled)
+		return;
+	STATUS_LOCK;
+	status_running = false;
+	pthread_cond_signal(&status_cond);
+	STATUS_UNLOCK;
+	pthread_join(status_thread, NULL);
+	status_report(true);
+	status_enabled = false;
+	STATUS_LOCK;
+	oscap_htable_free(status_scheduled, free);
+	status_scheduled = NULL;
+	STATUS_UNLOCK;
+#endif
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef OSCAP_STATUS_PRIV_H_
+#define OSCAP_STATUS_PRIV_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "public/oscap_status.h"
+
+/*
+ * The counters below are updated by the probes and by the OVAL evaluation.
+ * They return immediately when the status is not being reported, except
+ * for the queue depths which are always kept.
+ */
+
+/* An OVAL object being collected, lives on the stack of the collecting function */
+struct oscap_status_object {
+	const char *id;
+	const char *type;
+	double start_ms;
+	struct oscap_status_object *next;
+};
+
+/** @returns true if the status is being reported */
+bool oscap_status_enabled(void);
+
+/**
+ * The object is going to be collected, it makes the total of the reported
+ * status. An object scheduled several times is counted once.
+ */
+void oscap_status_schedule_object(const char *id);
+
+/** The scheduled objects are going to be collected again, from another system */
+void oscap_status_reschedule_objects(void);
+
+/**
+ * Collection of the object starts. The strings must stay valid until
+ * @ref oscap_status_object_end is called with the same @a obj.
+ */
+void oscap_status_object_begin(struct oscap_status_object *obj, const char *id, const char *type);
+
+/**
+ * Collection of the object ended, the first end of a scheduled object
+ * counts it done, also when it was found already collected.
+ */
+void oscap_status_object_end(struct oscap_status_object *obj);
+
+/** A probe collected an item */
+void oscap_status_item_collected(void);
+
+/** A probe visits a path in the filesystem */
+void oscap_status_set_path(const char *path);
+
+/** Change of the number of items waiting in the queue of an item cache */
+void oscap_status_icache_queued(int delta);
+
+/** Change of the number of messages waiting in the queue between the library and a probe */
+void oscap_status_seap_queued(int delta);
+
+#endif
@@ -0,0 +1,491 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef OS_WINDOWS
+#include <unistd.h>
+#endif
+
+#include "oscap_timing_priv.h"
+#include "_error.h"
+#include "list.h"
+#include "util.h"
+
+#if defined(OSCAP_THREAD_SAFE)
+# include <pthread.h>
+static pthread_mutex_t timing_mutex = PTHREAD_MUTEX_INITIALIZER;
+# define TIMING_LOCK    do { if (pthread_mutex_lock   (&timing_mutex) != 0) abort(); } while(0)
+# define TIMING_UNLOCK  do { if (pthread_mutex_unlock (&timing_mutex) != 0) abort(); } while(0)
+/* the innermost sample taken by the thread */
+static pthread_key_t timing_sample_key;
+static pthread_once_t timing_sample_once = PTHREAD_ONCE_INIT;
+#else
+# define TIMING_LOCK   while(0)
+# define TIMING_UNLOCK while(0)
+static struct oscap_timing_sample *timing_sample_current = NULL;
+#endif
+
+struct timing_record {
+	char *id;
+	char *probe;
+	unsigned int calls;
+	unsigned int cache_hits;
+	double wall_ms;
+	double cpu_ms;
+	uint64_t items;
+	uint64_t bytes_read;
+	/* usage without the nested objects, summed up per probe */
+	double self_wall_ms;
+	double self_cpu_ms;
+	uint64_t self_bytes_read;
+};
+
+static bool timing_enabled = false;
+static bool timing_messages = false;
+static struct oscap_htable *timing_objects = NULL;
+static struct oscap_htable *timing_rules = NULL;
+/* /proc/self/io is opened upfront, probes may chroot the process later */
+static int timing_io_fd = -1;
+
+static void timing_record_free(struct timing_record *rec)
+{
+	if (rec == NULL)
+		return;
+	free(rec->id);
+	free(rec->probe);
+	free(rec);
+}
+
+void oscap_timing_enable(bool oval_messages)
+{
+	TIMING_LOCK;
+	if (timing_objects == NULL)
+		timing_objects = oscap_htable_new();
+	if (timing_rules == NULL)
+		timing_rules = oscap_htable_new();
+#ifndef OS_WINDOWS
+	if (timing_io_fd == -1)
+		timing_io_fd = open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+#endif
+	timing_messages = oval_messages;
+	timing_enabled = true;
+	TIMING_UNLOCK;
+}
+
+bool oscap_timing_enabled(void)
+{
+	return timing_enabled;
+}
+
+bool oscap_timing_oval_messages(void)
+{
+	return timing_enabled && timing_messages;
+}
+
+void oscap_timing_reset(void)
+{
+	TIMING_LOCK;
+	if (timing_objects != NULL) {
+		oscap_htable_free(timing_objects, (oscap_destruct_func) timing_record_free);
+		timing_objects = oscap_htable_new();
+	}
+	if (timing_rules != NULL) {
+		oscap_htable_free(timing_rules, (oscap_destruct_func) timing_record_free);
+		timing_rules = oscap_htable_new();
+	}
+	TIMING_UNLOCK;
+}
+
+static uint64_t timing_bytes_read(void)
+{
+#ifndef OS_WINDOWS
+	char buf[512];
+	ssize_t len;
+	const char *rchar;
+
+	if (timing_io_fd == -1)
+		return 0;
+	len = pread(timing_io_fd, buf, sizeof(buf) - 1, 0);
+	if (len <= 0)
+		return 0;
+	buf[len] = '\0';
+	rchar = strstr(buf, "rchar:");
+	if (rchar == NULL)
+		return 0;
+	return strtoull(rchar + strlen("rchar:"), NULL, 10);
+#else
+	return 0;
+#endif
+}
+
+#if defined(OSCAP_THREAD_SAFE)
+static void timing_sample_key_create(void)
+{
+	(void) pthread_key_create(&timing_sample_key, NULL);
+}
+#endif
+
+static struct oscap_timing_sample *timing_sample_get_current(void)
+{
+#if defined(OSCAP_THREAD_SAFE)
+	(void) pthread_once(&timing_sample_once, timing_sample_key_create);
+	return pthread_getspecific(timing_sample_key);
+#else
+	return timing_sample_current;
+#endif
+}
+
+static void timing_sample_set_current(struct oscap_timing_sample *sample)
+{
+#if defined(OSCAP_THREAD_SAFE)
+	(void) pthread_setspecific(timing_sample_key, sample);
+#else
+	timing_sample_current = sample;
+#endif
+}
+
+static void timing_sample_take(struct oscap_timing_sample *sample)
+{
+#ifndef OS_WINDOWS
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	sample->wall_ms = ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	sample->cpu_ms = ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#else
+	sample->wall_ms = time(NULL) * 1000.0;
+	sample->cpu_ms = clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+	sample->bytes_read = timing_bytes_read();
+}
+
+void oscap_timing_sample(struct oscap_timing_sample *sample)
+{
+	timing_sample_take(sample);
+	sample->nested_wall_ms = 0;
+	sample->nested_cpu_ms = 0;
+	sample->nested_bytes_read = 0;
+	sample->outer = timing_sample_get_current();
+	timing_sample_set_current(sample);
+}
+
+void oscap_timing_usage_since(struct oscap_timing_sample *start, struct oscap_timing_usage *usage)
+{
+	struct oscap_timing_sample now;
+	struct oscap_timing_sample *outer = start->outer;
+
+	timing_sample_take(&now);
+	usage->wall_ms = now.wall_ms - start->wall_ms;
+	usage->cpu_ms = now.cpu_ms - start->cpu_ms;
+	usage->bytes_read = now.bytes_read >= start->bytes_read ? now.bytes_read - start->bytes_read : 0;
+	usage->self_wall_ms = usage->wall_ms > start->nested_wall_ms ? usage->wall_ms - start->nested_wall_ms : 0;
+	usage->self_cpu_ms = usage->cpu_ms > start->nested_cpu_ms ? usage->cpu_ms - start->nested_cpu_ms : 0;
+	usage->self_bytes_read = usage->bytes_read > start->nested_bytes_read ? usage->bytes_read - start->nested_bytes_read : 0;
+
+	if (outer != NULL) {
+		outer->nested_wall_ms += usage->wall_ms;
+		outer->nested_cpu_ms += usage->cpu_ms;
+		outer->nested_bytes_read += usage->bytes_read;
+	}
+	timing_sample_set_current(outer);
+}
+
+static struct timing_record *timing_record_get(struct oscap_htable *table, const char *id, const char *probe)
+{
+	struct timing_record *rec = oscap_htable_get(table, id);
+
+	if (rec == NULL) {
+		rec = calloc(1, sizeof(*rec));
+		if (rec == NULL)
+			return NULL;
+		rec->id = oscap_strdup(id);
+		rec->probe = oscap_strdup(probe);
+		if (!oscap_htable_add(table, id, rec)) {
+			timing_record_free(rec);
+			return NULL;
+		}
+	}
+	return rec;
+}
+
+static void timing_record_add(struct timing_record *rec, const struct oscap_timing_usage *usage)
+{
+	rec->calls++;
+	rec->wall_ms += usage->wall_ms;
+	rec->cpu_ms += usage->cpu_ms;
+	rec->bytes_read += usage->bytes_read;
+	rec->self_wall_ms += usage->self_wall_ms;
+	rec->self_cpu_ms += usage->self_cpu_ms;
+	rec->self_bytes_read += usage->self_bytes_read;
+}
+
+void oscap_timing_record_object(const char *object_id, const char *probe, const struct oscap_timing_usage *usage,
+		size_t items, bool cache_hit)
+{
+	struct timing_record *rec;
+
+	if (!timing_enabled || object_id == NULL)
+		return;
+	TIMING_LOCK;
+	rec = timing_record_get(timing_objects, object_id, probe);
+	if (rec != NULL) {
+		timing_record_add(rec, usage);
+		if (cache_hit)
+			rec->cache_hits++;
+		else
+			rec->items += items;
+	}
+	TIMING_UNLOCK;
+}
+
+void oscap_timing_record_rule(const char *rule_id, const struct oscap_timing_usage *usage)
+{
+	struct timing_record *rec;
+
+	if (!timing_enabled || rule_id == NULL)
+		return;
+	TIMING_LOCK;
+	rec = timing_record_get(timing_rules, rule_id, NULL);
+	if (rec != NULL)
+		timing_record_add(rec, usage);
+	TIMING_UNLOCK;
+}
+
+static int timing_record_cmp(const void *a, const void *b)
+{
+	const struct timing_record *ra = *(const struct timing_record **) a;
+	const struct timing_record *rb = *(const struct timing_record **) b;
+
+	if (ra->wall_ms != rb->wall_ms)
+		return ra->wall_ms < rb->wall_ms ? 1 : -1;
+	return strcmp(ra->id, rb->id);
+}
+
+/*
+ * Sorted array of the records in the table, the records stay owned by the table.
+ * @returns -1 if the array can't be allocated (with oscap_seterr)
+ */
+static int timing_records_sorted(struct oscap_htable *table, struct timing_record ***recs, size_t *count)
+{
+	size_t n = 0, alloc = 0;
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(table);
+
+	*recs = NULL;
+	*count = 0;
+	while (oscap_htable_iterator_has_more(hit)) {
+		if (n == alloc) {
+			size_t new_alloc = alloc ? alloc * 2 : 64;
+			struct timing_record **new_recs = realloc(*recs, new_alloc * sizeof(**recs));
+			if (new_recs == NULL) {
+				oscap_htable_iterator_free(hit);
+				free(*recs);
+				*recs = NULL;
+				oscap_seterr(OSCAP_EFAMILY_GLIBC, "Failed to allocate memory for %zu profile records.", new_alloc);
+				return -1;
+			}
+			*recs = new_recs;
+			alloc = new_alloc;
+		}
+		(*recs)[n++] = oscap_htable_iterator_next_value(hit);
+	}
+	oscap_htable_iterator_free(hit);
+	if (n > 0)
+		qsort(*recs, n, sizeof(**recs), timing_record_cmp);
+	*count = n;
+	return 0;
+}
+
+/*
+ * Per probe totals of the collected objects, the returned table owns its
+ * records. Objects are counted without the objects nested in them, which
+ * are counted on their own.
+ */
+static struct oscap_htable *timing_probes_summary(void)
+{
+	struct oscap_htable *probes = oscap_htable_new();
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(timing_objects);
+
+	while (oscap_htable_iterator_has_more(hit)) {
+		const struct timing_record *obj = oscap_htable_iterator_next_value(hit);
+		const char *name = obj->probe != NULL ? obj->probe : "unknown";
+		struct timing_record *sum = timing_record_get(probes, name, name);
+
+		if (sum == NULL)
+			continue;
+		sum->calls += obj->calls;
+		sum->cache_hits += obj->cache_hits;
+		sum->wall_ms += obj->self_wall_ms;
+		sum->cpu_ms += obj->self_cpu_ms;
+		sum->items += obj->items;
+		sum->bytes_read += obj->self_bytes_read;
+	}
+	oscap_htable_iterator_free(hit);
+	return probes;
+}
+
+static void timing_json_string(FILE *f, const char *str)
+{
+	if (str == NULL) {
+		fputs("null", f);
+		return;
+	}
+	fputc('"', f);
+	for (; *str != '\0'; str++) {
+		unsigned char c = *str;
+		if (c == '"' || c == '\\')
+			fprintf(f, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(f, "\\u%04x", c);
+		else
+			fputc(c, f);
+	}
+	fputc('"', f);
+}
+
+static int timing_json_array(FILE *f, const char *name, struct oscap_htable *table, bool with_probe, bool last)
+{
+	size_t count, i;
+	struct timing_record **recs;
+
+	if (timing_records_sorted(table, &recs, &count) != 0)
+		return -1;
+
+	fprintf(f, "  \"%s\": [", name);
+	for (i = 0; i < count; i++) {
+		const struct timing_record *rec = recs[i];
+		fprintf(f, "%s\n    {\"id\": ", i == 0 ? "" : ",");
+		timing_json_string(f, rec->id);
+		if (with_probe) {
+			fputs(", \"probe\": ", f);
+			timing_json_string(f, rec->probe);
+		}
+		fprintf(f, ", \"calls\": %u", rec->calls);
+		if (with_probe)
+			fprintf(f, ", \"cache_hits\": %u", rec->cache_hits);
+		fprintf(f, ", \"wall_ms\": %.3f, \"cpu_ms\": %.3f", rec->wall_ms, rec->cpu_ms);
+		if (with_probe)
+			fprintf(f, ", \"items\": %llu", (unsigned long long) rec->items);
+		fprintf(f, ", \"bytes_read\": %llu}", (unsigned long long) rec->bytes_read);
+	}
+	fprintf(f, "%s]%s\n", count > 0 ? "\n  " : "", last ? "" : ",");
+	free(recs);
+	return 0;
+}
+
+static void timing_csv_field(FILE *f, const char *str)
+{
+	if (str == NULL)
+		return;
+	if (strpbrk(str, ",\"\n") == NULL) {
+		fputs(str, f);
+		return;
+	}
+	fputc('"', f);
+	for (; *str != '\0'; str++) {
+		if (*str == '"')
+			fputc('"', f);
+		fputc(*str, f);
+	}
+	fputc('"', f);
+}
+
+static int timing_csv_rows(FILE *f, const char *kind, struct oscap_htable *table)
+{
+	size_t count, i;
+	struct timing_record **recs;
+
+	if (timing_records_sorted(table, &recs, &count) != 0)
+		return -1;
+
+	for (i = 0; i < count; i++) {
+		const struct timing_record *rec = recs[i];
+		fprintf(f, "%s,", kind);
+		timing_csv_field(f, rec->id);
+		fputc(',', f);
+		timing_csv_field(f, rec->probe);
+		fprintf(f, ",%u,%u,%.3f,%.3f,%llu,%llu\n", rec->calls, rec->cache_hits,
+				rec->wall_ms, rec->cpu_ms,
+				(unsigned long long) rec->items, (unsigned long long) rec->bytes_read);
+	}
+	free(recs);
+	return 0;
+}
+
+int oscap_timing_export(const char *filename)
+{
+	FILE *f;
+	struct oscap_htable *probes;
+	size_t len;
+	bool csv;
+	int ret = 0;
+
+	if (filename == NULL)
+		return -1;
+	if (!timing_enabled) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Profiling has not been enabled.");
+		return -1;
+	}
+	f = fopen(filename, "w");
+	if (f == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Failed to open profile output file '%s': %s", filename, strerror(errno));
+		return -1;
+	}
+	len = strlen(filename);
+	csv = len >= 4 && strcmp(filename + len - 4, ".csv") == 0;
+
+	TIMING_LOCK;
+	probes = timing_probes_summary();
+	if (csv) {
+		fputs("kind,id,probe,calls,cache_hits,wall_ms,cpu_ms,items,bytes_read\n", f);
+		if (timing_csv_rows(f, "probe", probes) != 0 ||
+		    timing_csv_rows(f, "object", timing_objects) != 0 ||
+		    timing_csv_rows(f, "rule", timing_rules) != 0)
+			ret = -1;
+	} else {
+		fputs("{\n", f);
+		if (timing_json_array(f, "probes", probes, true, false) != 0 ||
+		    timing_json_array(f, "objects", timing_objects, true, false) != 0 ||
+		    timing_json_array(f, "rules", timing_rules, false, true) != 0)
+			ret = -1;
+		fputs("}\n", f);
+	}
+	TIMING_UNLOCK;
+	oscap_htable_free(probes, (oscap_destruct_func) timing_record_free);
+
+	if (ret == 0 && ferror(f)) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Failed to write profile output file '%s'.", filename);
+		ret = -1;
+	}
+	if (fclose(f) != 0 && ret == 0) {
+		oscap_seterr(OSCAP_EFAMILY_GLIBC, "Failed to write profile output file '%s': %s", filename, strerror(errno));
+		ret = -1;
+	}
+	return ret;
+}
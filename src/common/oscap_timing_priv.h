@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef OSCAP_TIMING_PRIV_H_
+#define OSCAP_TIMING_PRIV_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "public/oscap_timing.h"
+
+/*
+ * Resources used by the process at a point in time. Samples taken by
+ * a thread nest, the usage of an inner one is subtracted from the self
+ * usage of the outer one.
+ */
+struct oscap_timing_sample {
+	double wall_ms;
+	double cpu_ms;
+	uint64_t bytes_read;
+	/* usage of the samples nested in this one */
+	double nested_wall_ms;
+	double nested_cpu_ms;
+	uint64_t nested_bytes_read;
+	struct oscap_timing_sample *outer;
+};
+
+/* Resources used between the start sample and now */
+struct oscap_timing_usage {
+	double wall_ms;
+	double cpu_ms;
+	uint64_t bytes_read;
+	/* the same without the usage of the nested samples */
+	double self_wall_ms;
+	double self_cpu_ms;
+	uint64_t self_bytes_read;
+};
+
+/**
+ * Take a sample, each one has to be ended by oscap_timing_usage_since()
+ * in the same thread, the last taken first.
+ */
+void oscap_timing_sample(struct oscap_timing_sample *sample);
+void oscap_timing_usage_since(struct oscap_timing_sample *start, struct oscap_timing_usage *usage);
+
+/**
+ * Record collection of an OVAL object.
+ * @param probe name of the probe (object type)
+ * @param items number of items collected
+ * @param cache_hit the object has been already collected and nothing was probed
+ */
+void oscap_timing_record_object(const char *object_id, const char *probe, const struct oscap_timing_usage *usage,
+		size_t items, bool cache_hit);
+
+/** Record evaluation of an XCCDF rule */
+void oscap_timing_record_rule(const char *rule_id, const struct oscap_timing_usage *usage);
+
+/** @returns true if the OVAL objects shall carry their profile in a message */
+bool oscap_timing_oval_messages(void);
+
+#endif
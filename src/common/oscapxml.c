@@ -119,6 +119,7 @@ void oscap_init(void)
 void oscap_cleanup(void)
 {
 	oscap_clearerr();
+	oscap_source_validate_cleanup();
 	xsltCleanupGlobals();
 	xmlCleanupParser();
 }
@@ -0,0 +1,61 @@
+/**
+ * @file oscap_status.h
+ * @brief Live status of running scans
+ *
+ * Periodically reports how far a scan got: the OVAL objects being
+ * collected, the number of collected items and the rate of collection,
+ * the path being traversed and the depths of the probe queues. The status
+ * can be printed on the standard error output for humans and written as
+ * JSON lines to a file descriptor for tools watching the scan.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef OSCAP_STATUS_H_
+#define OSCAP_STATUS_H_
+
+#include <stdbool.h>
+#include "oscap_export.h"
+
+/**
+ * Start reporting the status of scans done by this process. A reporter
+ * thread writes a status record every interval until @ref oscap_status_stop
+ * is called. Each JSON record is a single line with the following members:
+ * elapsed_ms, objects_total, objects_done, objects_in_flight, object,
+ * object_type, object_ms, items, items_per_sec, paths, path, icache_queue,
+ * seap_queue, idle_ms and final.
+ *
+ * The idle_ms member is the time since the last progress, i.e. since some
+ * object was collected, some item was collected or some path was visited.
+ * @param interval_ms time between two records in milliseconds
+ * @param text print a human readable status line on the standard error output
+ * @param fd file descriptor to write the JSON records to, -1 for none
+ * @returns 0 on success, -1 on error
+ */
+OSCAP_API int oscap_status_start(unsigned int interval_ms, bool text, int fd);
+
+/**
+ * Stop reporting the status. The last record is written immediately and
+ * it has the final member set to true. The file descriptor is not closed.
+ */
+OSCAP_API void oscap_status_stop(void);
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file oscap_timing.h
+ * @brief Profiling of scans
+ *
+ * Records the time and resources spent on collecting OVAL objects (also
+ * summarized per probe) and on evaluating XCCDF rules, so that the slow
+ * parts of content can be found.
+ */
+
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifndef OSCAP_TIMING_H_
+#define OSCAP_TIMING_H_
+
+#include <stdbool.h>
+#include "oscap_export.h"
+
+/**
+ * Start recording the profile of scans done by this process. Nothing is
+ * recorded until this is called.
+ * @param oval_messages also attach the collection profile of each OVAL object
+ * to its system characteristics as an informational message
+ */
+OSCAP_API void oscap_timing_enable(bool oval_messages);
+
+/**
+ * @returns true if the profile is being recorded
+ */
+OSCAP_API bool oscap_timing_enabled(void);
+
+/**
+ * Write the recorded profile into a file. The file is written in CSV format
+ * if its name ends with ".csv", otherwise in JSON format. Records are sorted
+ * by wall time, the slowest first.
+ * @param filename path to the output file
+ * @returns 0 on success, -1 on error
+ */
+OSCAP_API int oscap_timing_export(const char *filename);
+
+/**
+ * Drop everything recorded so far, the recording continues if enabled.
+ */
+OSCAP_API void oscap_timing_reset(void);
+
+#endif
@@ -25,6 +25,7 @@
 #endif
 
 #include <string.h>
+#include <errno.h>
 #include <fcntl.h>
 #ifdef OS_WINDOWS
 #include <io.h>
@@ -40,6 +41,7 @@
 #include "common/debug_priv.h"
 #include "common/public/oscap.h"
 #include "common/util.h"
+#include "common/oscap_digest.h"
 #include "CPE/public/cpe_lang.h"
 #include "CPE/cpedict_priv.h"
 #include "CPE/cpelang_priv.h"
@@ -177,6 +179,35 @@ xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source)
 	return reader;
 }
 
+xmlTextReader *oscap_source_get_streaming_xmlTextReader(struct oscap_source *source)
+{
+	if (source->xml.doc != NULL)
+		return oscap_source_get_xmlTextReader(source);
+
+	xmlTextReader *reader = NULL;
+	if (source->origin.memory != NULL) {
+		if (bz2_memory_is_bzip(source->origin.memory, source->origin.memory_size))
+			return oscap_source_get_xmlTextReader(source);
+		reader = xmlReaderForMemory(source->origin.memory, source->origin.memory_size, NULL, NULL, 0);
+	} else {
+		int fd = open(source->origin.filepath, O_RDONLY);
+		if (fd == -1) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Unable to open file: '%s'", oscap_source_readable_origin(source));
+			return NULL;
+		}
+		bool is_bzip = bz2_fd_is_bzip(fd);
+		close(fd);
+		if (is_bzip)
+			return oscap_source_get_xmlTextReader(source);
+		reader = xmlReaderForFile(source->origin.filepath, NULL, 0);
+	}
+	if (reader == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Unable to create xmlTextReader for %s", oscap_source_readable_origin(source));
+		oscap_setxmlerr(xmlGetLastError());
+	}
+	return reader;
+}
+
 oscap_document_type_t oscap_source_get_scap_type(struct oscap_source *source)
 {
 	if (source->scap_type == OSCAP_DOCUMENT_UNKNOWN) {
@@ -448,3 +479,59 @@ int oscap_source_get_raw_memory(struct oscap_source *source, char **buffer, size
 		return 0;
 	}
 }
+
+int oscap_source_get_digest(struct oscap_source *source, unsigned char *digest, size_t *size)
+{
+	struct oscap_digest *ctx = oscap_digest_new();
+	if (ctx == NULL)
+		return -1;
+
+	if (source->origin.memory != NULL) {
+		oscap_digest_update(ctx, source->origin.memory, source->origin.memory_size);
+		*size = source->origin.memory_size;
+		return oscap_digest_finish(ctx, digest);
+	}
+
+	if (source->origin.type == OSCAP_SRC_FROM_USER_XML_FILE && source->xml.doc == NULL) {
+		/* Digest bytes on disk, so that the DOM does not need to be built */
+		int fd = open(source->origin.filepath, O_RDONLY);
+		if (fd < 0) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not open %s: %s", source->origin.filepath, strerror(errno));
+			oscap_digest_free(ctx);
+			return -1;
+		}
+		unsigned char chunk[65536];
+		size_t total = 0;
+		ssize_t len;
+		while ((len = read(fd, chunk, sizeof(chunk))) > 0) {
+			oscap_digest_update(ctx, chunk, len);
+			total += len;
+		}
+		close(fd);
+		if (len < 0) {
+			oscap_seterr(OSCAP_EFAMILY_GLIBC, "Could not read %s: %s", source->origin.filepath, strerror(errno));
+			oscap_digest_free(ctx);
+			return -1;
+		}
+		*size = total;
+		return oscap_digest_finish(ctx, digest);
+	}
+
+	xmlDoc *doc = oscap_source_get_xmlDoc(source);
+	if (doc == NULL) {
+		oscap_digest_free(ctx);
+		return -1;
+	}
+	xmlChar *buffer = NULL;
+	int buffer_size = 0;
+	xmlDocDumpMemory(doc, &buffer, &buffer_size);
+	if (buffer == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not serialize %s", oscap_source_readable_origin(source));
+		oscap_digest_free(ctx);
+		return -1;
+	}
+	oscap_digest_update(ctx, buffer, buffer_size);
+	*size = buffer_size;
+	xmlFree(buffer);
+	return oscap_digest_finish(ctx, digest);
+}
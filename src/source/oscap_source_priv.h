@@ -67,6 +67,18 @@ struct oscap_source *oscap_source_new_from_xmlDoc(xmlDoc *doc, const char *filep
  */
 xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source);
 
+/**
+ * Get an xmlTextReader which reads the content directly from the file or
+ * memory buffer without building the DOM, so that huge documents can be
+ * processed in bounded memory. When the DOM has already been built (or the
+ * content is bzip2 compressed) the reader walks the DOM instead.
+ * The reader needs to be disposed by caller.
+ * @memberof oscap_source
+ * @param source Resource to read the content
+ * @returns xmlTextReader structure to read the content
+ */
+xmlTextReader *oscap_source_get_streaming_xmlTextReader(struct oscap_source *source);
+
 /**
  * Get a DOM representation of this resource. The document ins still owned
  * by oscap_source.
@@ -76,5 +88,17 @@ xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source);
  */
 xmlDoc *oscap_source_get_xmlDoc(struct oscap_source *source);
 
+/**
+ * Compute a SHA-256 digest of the content of this resource. Sources
+ * originating from a file or from memory are digested without building
+ * the DOM.
+ * @memberof oscap_source
+ * @param source Resource to digest
+ * @param digest Buffer of OSCAP_DIGEST_SIZE bytes for the digest of the content
+ * @param size Size of the digested content in bytes
+ * @returns 0 on success, -1 on error
+ */
+int oscap_source_get_digest(struct oscap_source *source, unsigned char *digest, size_t *size);
+
 
 #endif
@@ -26,6 +26,7 @@
 #include <libxml/xmlerror.h>
 #include <libxml/xmlschemas.h>
 #include <string.h>
+#include <pthread.h>
 #ifdef OS_WINDOWS
 #include <io.h>
 #else
@@ -34,6 +35,8 @@
 
 #include "common/_error.h"
 #include "common/util.h"
+#include "common/list.h"
+#include "common/debug_priv.h"
 #include "oscap.h"
 #include "oscap_source.h"
 #include "source/oscap_source_priv.h"
@@ -83,10 +86,84 @@ static void oscap_xml_validity_handler(void *user, xmlErrorPtr error)
 	context->reporter(file, error->line, error->message, context->arg);
 }
 
+/*
+ * Compiled schemas, keyed by the path of the schema file. Parsing of a schema
+ * (including all the schemas it imports) takes much longer than validation
+ * of a typical document, and the same schema is needed many times during
+ * a single run, e.g. for each component of a datastream.
+ */
+static struct oscap_htable *_schema_cache = NULL;
+static pthread_mutex_t _schema_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void _schema_free(void *schema)
+{
+	xmlSchemaFree((xmlSchemaPtr) schema);
+}
+
+static xmlSchemaPtr oscap_schema_parse(const char *schemapath, struct ctxt *context)
+{
+	xmlSchemaPtr schema = NULL;
+	xmlSchemaParserCtxtPtr parser_ctxt = xmlSchemaNewParserCtxt(schemapath);
+	if (parser_ctxt == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not create parser context for validation");
+		return NULL;
+	}
+
+	xmlSchemaSetParserStructuredErrors(parser_ctxt, oscap_xml_validity_handler, context);
+
+	schema = xmlSchemaParse(parser_ctxt);
+	if (schema == NULL)
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not parse XML schema");
+
+	xmlSchemaFreeParserCtxt(parser_ctxt);
+	return schema;
+}
+
+/*
+ * Get compiled schema from the cache, parse it on the first use.
+ * The schema stays owned by the cache, libxml2 allows sharing it
+ * among any number of validation contexts.
+ */
+static xmlSchemaPtr oscap_schema_get(const char *schemapath, struct ctxt *context)
+{
+	xmlSchemaPtr schema = NULL;
+
+	if (pthread_mutex_lock(&_schema_cache_mutex) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not lock the schema cache");
+		return NULL;
+	}
+
+	if (_schema_cache == NULL)
+		_schema_cache = oscap_htable_new();
+	else
+		schema = oscap_htable_get(_schema_cache, schemapath);
+
+	if (schema == NULL) {
+		schema = oscap_schema_parse(schemapath, context);
+		if (schema != NULL && !oscap_htable_add(_schema_cache, schemapath, schema)) {
+			xmlSchemaFree(schema);
+			schema = NULL;
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not cache XML schema '%s'", schemapath);
+		}
+	} else {
+		dD("Using cached XML schema '%s'.", schemapath);
+	}
+
+	pthread_mutex_unlock(&_schema_cache_mutex);
+	return schema;
+}
+
+void oscap_source_validate_cleanup(void)
+{
+	pthread_mutex_lock(&_schema_cache_mutex);
+	oscap_htable_free(_schema_cache, _schema_free);
+	_schema_cache = NULL;
+	pthread_mutex_unlock(&_schema_cache_mutex);
+}
+
 static inline int oscap_validate_xml(struct oscap_source *source, const char *schemafile, xml_reporter reporter, void *arg)
 {
 	int result = -1;
-	xmlSchemaParserCtxtPtr parser_ctxt = NULL;
 	xmlSchemaPtr schema = NULL;
 	xmlSchemaValidCtxtPtr ctxt = NULL;
 	xmlDocPtr doc = NULL;
@@ -105,19 +182,9 @@ static inline int oscap_validate_xml(struct oscap_source *source, const char *sc
 		goto cleanup;
 	}
 
-	parser_ctxt = xmlSchemaNewParserCtxt(schemapath);
-	if (parser_ctxt == NULL) {
-		oscap_seterr(OSCAP_EFAMILY_XML, "Could not create parser context for validation");
+	schema = oscap_schema_get(schemapath, &context);
+	if (schema == NULL)
 		goto cleanup;
-	}
-
-	xmlSchemaSetParserStructuredErrors(parser_ctxt, oscap_xml_validity_handler, &context);
-
-	schema = xmlSchemaParse(parser_ctxt);
-	if (schema == NULL) {
-		oscap_seterr(OSCAP_EFAMILY_XML, "Could not parse XML schema");
-		goto cleanup;
-	}
 
 	ctxt = xmlSchemaNewValidCtxt(schema);
 	if (ctxt == NULL) {
@@ -148,10 +215,6 @@ static inline int oscap_validate_xml(struct oscap_source *source, const char *sc
 cleanup:
 	if (ctxt)
 		xmlSchemaFreeValidCtxt(ctxt);
-	if (schema)
-		xmlSchemaFree(schema);
-	if (parser_ctxt)
-		xmlSchemaFreeParserCtxt(parser_ctxt);
 	free(schemapath);
 
 	return result;
@@ -42,4 +42,9 @@ struct oscap_schema_table_entry {
  */
 int oscap_source_validate_priv(struct oscap_source *source, oscap_document_type_t doc_type, const char *version, xml_reporter reporter, void *user);
 
+/**
+ * Release XML schemas cached by the validation
+ */
+void oscap_source_validate_cleanup(void);
+
 #endif
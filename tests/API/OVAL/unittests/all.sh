@@ -21,6 +21,7 @@ test_run "evr_string comparison regards missing epoch in content" $srcdir/test_e
 test_run "possible values and restrictions in external variables" $srcdir/test_external_variable.sh
 test_run "float comparison" $srcdir/test_float_comparison.sh
 test_run "insensitive_equals on properties" $srcdir/test_envvar_insensitive_equals.sh
+test_run "state entity failing to compare" $srcdir/test_state_entity_error.sh
 test_run "ipv6_address: 'superset of' operation" $srcdir/test_ipv6_super_set_of.sh
 test_run "ipv6_address: 'subset of' operation" $srcdir/test_ipv6_subset_of.sh
 test_run "ipv4_address: 'superset of' operation" $srcdir/test_ipv4_super_set_of.sh
@@ -34,4 +35,11 @@ test_run "test platform schema version" $srcdir/test_platform_version.sh
 test_run "state entity check_existence attribute" $srcdir/test_state_check_existence.sh
 test_run "skip validation" $srcdir/test_skip_valid.sh
 test_run "object component data type evaluation" $srcdir/test_object_component_type.sh
+test_run "compiled definitions and definitions cache" $srcdir/test_compiled.sh
+test_run "streaming summary of OVAL Results" $srcdir/test_results_summary.sh
+test_run "one state compared with many items" $srcdir/test_state_many_items.sh
+test_run "states compared with batches of items" $srcdir/test_state_batch.sh
+test_run "incremental scans reuse unchanged objects" $srcdir/test_incremental_state.sh
+test_run "profile of the collection is exported" $srcdir/test_profile_output.sh
+test_run "status of the scan is reported" $srcdir/test_status_stream.sh
 test_exit
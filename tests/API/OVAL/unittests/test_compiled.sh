@@ -0,0 +1,46 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+cache_dir=$(mktemp -d ${name}.cache.XXXXXX)
+echo "cache dir: $cache_dir"
+stderr=$(mktemp ${name}.err.XXXXXX)
+echo "stderr file: $stderr"
+
+# Results computed from definitions loaded from the cache must be
+# identical to results computed from the parsed XML.
+for oval in $srcdir/*.oval.xml; do
+	base=$(basename $oval .oval.xml)
+	syschar=$srcdir/$base.syschar.xml
+	[ -f $syschar ] || continue
+	echo "Comparing results of $base."
+
+	# some of the inputs report errors on purpose, the cache must not change them
+	$OSCAP oval analyse --results $name.xml.out $oval $syschar 2> $stderr || [ $? == 2 ]
+	OSCAP_OVAL_CACHE_DIR=$cache_dir $OSCAP oval analyse --results $name.store.out $oval $syschar 2> $stderr.store || [ $? == 2 ]
+	OSCAP_OVAL_CACHE_DIR=$cache_dir $OSCAP oval analyse --results $name.load.out $oval $syschar 2> $stderr.load || [ $? == 2 ]
+	cmp $stderr $stderr.store
+	cmp $stderr $stderr.load
+
+	for out in $name.xml.out $name.store.out $name.load.out; do
+		sed -i -e 's|<oval:timestamp>.*</oval:timestamp>||' $out
+	done
+	cmp $name.xml.out $name.store.out
+	cmp $name.xml.out $name.load.out
+	rm $name.xml.out $name.store.out $name.load.out
+done
+[ $(ls $cache_dir | wc -l) -gt 0 ]
+# named by the SHA-256 digest and the size of the source and by the format
+[ $(ls $cache_dir | grep -v '^[0-9a-f]\{64\}-[0-9]\+-[0-9]\+\.ovalc$' | wc -l) -eq 0 ]
+
+echo "Compiling into a file."
+$OSCAP oval compile --output $name.ovalc $srcdir/test_external_variable.oval.xml 2> $stderr
+[ ! -s $stderr ]
+[ "$(head -c 8 $name.ovalc)" == "OSCAPOVC" ]
+
+echo "Compiling without output."
+! $OSCAP oval compile $srcdir/test_external_variable.oval.xml 2> $stderr
+grep -q "OSCAP_OVAL_CACHE_DIR" $stderr
+
+rm -r $cache_dir $name.ovalc $stderr $stderr.store $stderr.load
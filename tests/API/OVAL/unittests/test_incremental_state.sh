@@ -0,0 +1,73 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+root=$(mktemp -d -t ${name}.root.XXXXXX)
+state=$(mktemp -d -t ${name}.state.XXXXXX)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+
+# the files are read relative to the offline root, so that the
+# object can address them by an exact path
+export OSCAP_PROBE_ROOT=$root
+echo Hello > $root/bar.txt
+
+items='/oval_results/results/system/oval_system_characteristics/system_data/*'
+reused="$items[starts-with(@id, '2')]"
+
+# nothing to reuse in the first scan
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+[ -f $state/$name.oval.xml.syschar.xml ]
+grep -q '^oval:x:obj:1 ' $state/$name.oval.xml.provenance
+# the object searching files by a pattern is never reused
+! grep -q '^oval:x:obj:2 ' $state/$name.oval.xml.provenance
+assert_exists 0 "$reused"
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+
+# /bar.txt did not change
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 1 "$reused"
+assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:1"]/reference[starts-with(@item_ref, "2")]'
+assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:2"]/reference[starts-with(@item_ref, "1")]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+
+# the stamps are SHA-256 digests
+grep -q '^oval:x:obj:1 [0-9a-f]\{64\}$' $state/$name.oval.xml.provenance
+
+# the scan of a system with another machine ID is not reused
+mkdir $root/etc
+echo 0123456789abcdef0123456789abcdef > $root/etc/machine-id
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 0 "$reused"
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 1 "$reused"
+
+# /bar.txt changed, it is read again
+echo Bye > $root/bar.txt
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 0 "$reused"
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="false"]'
+
+# a removed file is noticed as well
+rm $root/bar.txt
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 0 "$reused"
+assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:1"][@flag="does not exist"]'
+$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:1"][@flag="does not exist"]'
+
+# packages are stamped by the rpm database, they are never reused
+# when the database is not in any of its known locations
+if $OSCAP --version | grep -q "\<rpminfo\>" && which rpm > /dev/null 2>&1; then
+	$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+	! grep -q '^oval:x:obj:3 ' $state/$name.oval.xml.provenance
+	rpm --root $root --initdb
+	$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+	rpm_stamp=$(grep '^oval:x:obj:3 ' $state/$name.oval.xml.provenance)
+	find $root/var/lib/rpm $root/usr/lib/sysimage/rpm -type f -exec touch {} + 2> /dev/null || true
+	$OSCAP oval eval --incremental-state $state --results $result $srcdir/$name.oval.xml
+	[ "$(grep '^oval:x:obj:3 ' $state/$name.oval.xml.provenance)" != "$rpm_stamp" ]
+fi
+
+rm -rf $root $state $result
@@ -0,0 +1,29 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+root=$(mktemp -d -t ${name}.root.XXXXXX)
+result=$(mktemp ${name}.out.XXXXXX)
+json=$(mktemp ${name}.XXXXXX.json)
+csv=$(mktemp ${name}.XXXXXX.csv)
+echo "result file: $result"
+
+export OSCAP_PROBE_ROOT=$root
+printf 'Hello\nHello\n' > $root/bar.txt
+
+$OSCAP oval eval --profile-output $json --profile-messages --results $result $srcdir/$name.oval.xml
+
+# both tests use the same object, it is collected only once
+grep -q '"id": "oval:x:obj:1", "probe": "textfilecontent54", "calls": 2, "cache_hits": 1, .*"items": 2,' $json
+grep -q '"id": "oval:x:obj:2", "probe": "family", "calls": 1, "cache_hits": 0, .*"items": 1,' $json
+grep -q '"id": "textfilecontent54", "probe": "textfilecontent54", "calls": 2,' $json
+grep -q '"rules": \[\]' $json
+assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:1"]/message[@level="info"][starts-with(text(), "Collected 2 item(s) by the textfilecontent54 probe")]'
+
+$OSCAP oval eval --profile-output $csv $srcdir/$name.oval.xml
+head -n 1 $csv | grep -q '^kind,id,probe,calls,cache_hits,wall_ms,cpu_ms,items,bytes_read$'
+grep -q '^probe,family,family,1,0,' $csv
+grep -q '^object,oval:x:obj:1,textfilecontent54,2,1,[0-9.]*,[0-9.]*,2,' $csv
+
+rm -rf $root $result $json $csv
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.results.XXXXXX)
+echo "results file: $result"
+stdout=$(mktemp ${name}.out.XXXXXX)
+echo "stdout file: $stdout"
+
+# Results read by the streaming reader must match the results document
+for oval in $srcdir/*.oval.xml; do
+	base=$(basename $oval .oval.xml)
+	syschar=$srcdir/$base.syschar.xml
+	[ -f $syschar ] || continue
+	echo "Summarizing results of $base."
+
+	$OSCAP oval analyse --results $result $oval $syschar 2> /dev/null || [ $? == 2 ]
+	$OSCAP oval summary $result > $stdout
+
+	definitions=$(grep -c "^Definition " $stdout || true)
+	assert_exists $definitions '//results/system/definitions/definition'
+	grep "^Definition " $stdout | sed 's/^Definition \(.*\): \(.*\)$/\1 \2/' | while read id res; do
+		assert_exists 1 "//results/system/definitions/definition[@definition_id='$id'][@result='$res']"
+	done
+	grep -q "^Summary:" $stdout
+done
+
+echo "Summarizing a file which is not OVAL Results."
+! $OSCAP oval summary $srcdir/test_external_variable.oval.xml > $stdout 2>&1
+grep -q "oval_results" $stdout
+
+rm $result $stdout
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+syschar=$(mktemp ${name}.syschar.XXXXXX)
+echo "syschar file: $syschar"
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+
+# Items are compared with the states in batches, generate enough of them
+# to span several batches. Only the last item is a small partition.
+count=600
+{
+	sed -n '1,/<collected_objects>/p' $srcdir/test_state_many_items.syschar.xml
+	echo '    <object id="oval:x:obj:1" version="1" flag="complete">'
+	for i in $(seq 1 $((count - 1))); do
+		echo "      <reference item_ref=\"$i\"/>"
+	done
+	echo '    </object>'
+	echo '    <object id="oval:x:obj:2" version="1" flag="complete">'
+	for i in $(seq 1 $count); do
+		echo "      <reference item_ref=\"$i\"/>"
+	done
+	echo '    </object>'
+	echo '  </collected_objects>'
+	echo '  <system_data>'
+	for i in $(seq 1 $count); do
+		if [ $i -lt $count ]; then
+			mount_point=/mnt/ok$i
+			space=2000
+		else
+			mount_point=/mnt/small
+			space=10
+		fi
+		echo "    <lin-sys:partition_item id=\"$i\" status=\"exists\">"
+		echo "      <lin-sys:mount_point>$mount_point</lin-sys:mount_point>"
+		echo "      <lin-sys:device>/dev/sda$i</lin-sys:device>"
+		echo "      <lin-sys:total_space datatype=\"int\">$space</lin-sys:total_space>"
+		echo "    </lin-sys:partition_item>"
+	done
+	echo '  </system_data>'
+	echo '</oval_system_characteristics>'
+} > $syschar
+
+echo "Analysing syschar content."
+$OSCAP oval analyse --results $result $srcdir/$name.oval.xml $syschar
+[ -f $result ]
+
+grep -q 'definition_id="oval:x:def:1"[^>]*result="true"' $result
+grep -q 'definition_id="oval:x:def:2"[^>]*result="false"' $result
+grep -q 'definition_id="oval:x:def:3"[^>]*result="false"' $result
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:2"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:3"][@result="false"]'
+# every item keeps its own result with full results
+assert_exists $((count - 1)) '/oval_results/results/system/tests/test[@test_id="oval:x:tst:1"]/tested_item[@result="true"]'
+assert_exists 1 '/oval_results/results/system/tests/test[@test_id="oval:x:tst:2"]/tested_item[@item_id="600"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/tests/test[@test_id="oval:x:tst:3"]/tested_item[@item_id="600"][@result="true"]'
+
+rm $syschar $result
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+
+# The second entity of the state fails to compare (the concat function
+# without components is not valid content), every entity is compared
+# although the first one already decides the state, so the result is an error.
+echo "Analysing syschar content."
+$OSCAP oval analyse --skip-valid --results $result $srcdir/$name.oval.xml $srcdir/test_envvar_insensitive_equals.syschar.xml
+[ -f $result ]
+
+assert_exists 1 '/oval_results/results/system/definitions/definition[@result="error"]'
+assert_exists 1 '/oval_results/results/system/tests/test[@result="error"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@result="error"]'
+
+rm $result
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+
+# The values of the state (variable, regular expression, integer) are
+# compiled once, every item must still get its own result.
+echo "Analysing syschar content."
+$OSCAP oval analyse --results $result $srcdir/$name.oval.xml $srcdir/$name.syschar.xml
+[ -f $result ]
+
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+assert_exists 6 '/oval_results/results/system/tests/test/tested_item'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="1"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="2"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="3"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="4"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="5"][@result="error"]'
+assert_exists 1 '/oval_results/results/system/tests/test/tested_item[@item_id="6"][@result="true"]'
+
+rm $result
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+root=$(mktemp -d -t ${name}.root.XXXXXX)
+status=$(mktemp -t ${name}.XXXXXX.jsonl)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+
+export OSCAP_PROBE_ROOT=$root
+mkdir -p $root/data/a/b
+touch $root/data/1 $root/data/a/2 $root/data/a/b/3
+
+$OSCAP oval eval --status --status-fd 3 --status-interval 1 $srcdir/$name.oval.xml 3> $status 2> $stderr
+
+# the last record is written when the evaluation is done, it is the only final one
+[ "$(grep -c '"final": true}$' $status)" = 1 ]
+# objects of the tests are counted once, also when found collected, unused ones are not counted
+tail -n 1 $status | grep -q '^{"elapsed_ms": [0-9]*, "objects_total": 2, "objects_done": 2, "objects_in_flight": 0, "object": null, '
+tail -n 1 $status | grep -q ', "items": 5, "items_per_sec": [0-9.]*, "paths": [1-9][0-9]*, "path": null, '
+tail -n 1 $status | grep -q ', "icache_queue": 0, "seap_queue": 0, "idle_ms": [0-9]*, "final": true}$'
+grep -q '^Status: [0-9.]* s, objects 2/2 done, 0 in flight, 5 items ' $stderr
+
+# a closed descriptor is refused before anything is evaluated
+if $OSCAP oval eval --status-fd 9 $srcdir/$name.oval.xml 9>&- 2> $stderr; then
+	false
+fi
+grep -q "File descriptor 9 for --status-fd is not open" $stderr
+
+rm -rf $root $status $stderr
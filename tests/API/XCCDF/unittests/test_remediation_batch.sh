@@ -0,0 +1,35 @@
+#!/bin/bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+
+rm -f batch_file_1 batch_file_2 batch_file_3 batch_file_4 batch_order
+# The shell fixes are executed by one shell, the second one must not
+# prevent the third one from running. The perl fix runs in the document
+# order between them.
+OSCAP_REMEDIATE_BATCH=1 $OSCAP xccdf eval --remediate --results $result $srcdir/${name}.xccdf.xml 2> $stderr || [ $? -eq 2 ]
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+$OSCAP xccdf validate $result
+
+assert_exists 4 '//rule-result'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="fixed"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/message[text()="Fix execution completed and returned: 0"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/message[starts-with(text(), "first fix")]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/result[text()="error"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/message[starts-with(text(), "second fix")]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_3"]/result[text()="fixed"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_3"]/message[text()="Fix execution completed and returned: 3"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_4"]/result[text()="fixed"]'
+[ "$(cat batch_order | tr '\n' ' ')" == "1 4 3 " ]
+
+rm batch_file_1 batch_file_3 batch_file_4 batch_order
+rm $result
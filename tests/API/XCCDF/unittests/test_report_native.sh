@@ -0,0 +1,40 @@
+#!/bin/bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+report=$(mktemp -t ${name}.res.XXXXXX)
+stdout=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+
+echo "Stdout file = $stdout"
+echo "Stderr file = $stderr"
+echo "Report file = $report"
+
+# The native report has the same sections as the report made by XSLT
+$OSCAP xccdf eval --native-report --report $report \
+	$srcdir/test_xccdf_sub_title.xccdf.xml > $stdout 2> $stderr
+grep -q '^<!DOCTYPE html>' $report
+for section in introduction characteristics compliance-and-scoring rule-overview result-details rear-matter; do
+	grep -q "id=\"$section\"" $report
+done
+grep -q 'class="rule-overview-leaf rule-overview-leaf-pass' $report
+grep -q 'id="rule-detail-rr0"' $report
+grep 'This description is substituted according to the selected policy:.*No profile' $report
+grep 'This title is variable:.*No profile' $report
+grep 'sub ' $report || x=1; [ "x$x" == "x1" ]; unset x
+
+# OVAL details are taken from the results of the OVAL agent
+grep -q 'OVAL test results details' $report
+grep -q 'oval:x:tst:1' $report
+:> $report
+
+$OSCAP xccdf eval --native-report --profile xccdf_moc.elpmaxe.www_profile_1 --report $report \
+	$srcdir/test_xccdf_sub_title.xccdf.xml > $stdout 2> $stderr
+grep 'with profile <mark>The First Profile</mark>' $report
+grep 'This title is variable:.*The First Profile' $report
+grep 'sub ' $report || x=1; [ "x$x" == "x1" ]; unset x
+
+rm $report $stdout $stderr
@@ -0,0 +1,41 @@
+#!/bin/bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.res.XXXXXX)
+stdout=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+log=$(mktemp -t ${name}.log.XXXXXX)
+
+echo "Stdout file = $stdout"
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+echo "Log file = $log"
+
+# With full results every criterion is evaluated
+$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --results $result \
+	$srcdir/$name.xccdf.xml > $stdout 2> $stderr || [ $? == 2 ]
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="fail"]'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/result[text()="pass"]'
+for object in 1 2 3 4; do
+	grep -q "Querying .* object 'oval:moc.elpmaxe.www:obj:$object'" $log
+done
+:> $log
+
+# With thin results the criteria stop at the first decisive child, the
+# objects of the remaining tests are not collected. The verdicts are the same.
+$OSCAP xccdf eval --verbose INFO --verbose-log-file $log --thin-results --results $result \
+	$srcdir/$name.xccdf.xml > $stdout 2> $stderr || [ $? == 2 ]
+grep -A3 'idref="xccdf_moc.elpmaxe.www_rule_1"' $result | grep -q '<result>fail</result>'
+grep -A3 'idref="xccdf_moc.elpmaxe.www_rule_2"' $result | grep -q '<result>pass</result>'
+for object in 1 3; do
+	grep -q "Querying .* object 'oval:moc.elpmaxe.www:obj:$object'" $log
+done
+for object in 2 4; do
+	[ "$(grep -c "Querying .* object 'oval:moc.elpmaxe.www:obj:$object'" $log)" == 0 ]
+done
+
+rm $result $stdout $stderr $log
@@ -0,0 +1,42 @@
+#!/bin/bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+name=$(basename $0 .sh)
+cache_dir=$(mktemp -d -t ${name}.cache.XXXXXX)
+stderr=$(mktemp -t ${name}.err.XXXXXX)
+echo "Cache dir = $cache_dir"
+echo "Stderr file = $stderr"
+
+# Benchmarks loaded from the cache must be identical to the parsed ones
+for xccdf in $srcdir/*.xccdf.xml \
+		$srcdir/../applicability/cpe2-or-rule-embedded-xccdf.xml; do
+	grep -q "<\(xccdf:\)\?Benchmark" $xccdf || continue
+	# skip intentionally broken content
+	$OSCAP xccdf resolve --skip-valid --force -o $name.xml.out $xccdf 2> $stderr || continue
+	echo "Compared $xccdf"
+	OSCAP_XCCDF_CACHE_DIR=$cache_dir $OSCAP xccdf resolve --skip-valid --force -o $name.store.out $xccdf 2>> $stderr
+	OSCAP_XCCDF_CACHE_DIR=$cache_dir $OSCAP xccdf resolve --skip-valid --force -o $name.load.out $xccdf 2>> $stderr
+	[ ! -s $stderr ]
+	cmp $name.xml.out $name.store.out
+	cmp $name.xml.out $name.load.out
+	rm $name.xml.out $name.store.out $name.load.out
+done
+[ $(ls $cache_dir | wc -l) -gt 0 ]
+# named by the SHA-256 digest and the size of the source and by the format
+[ $(ls $cache_dir | grep -v '^[0-9a-f]\{64\}-[0-9]\+-2\.xccdfc$' | wc -l) -eq 0 ]
+
+# A damaged cache entry is ignored
+for cached in $cache_dir/*.xccdfc; do
+	head -c 100 $cached > $cached.tmp
+	mv $cached.tmp $cached
+done
+xccdf=$srcdir/test_xccdf_refine_rule.xccdf.xml
+$OSCAP xccdf resolve --force -o $name.xml.out $xccdf 2> $stderr
+OSCAP_XCCDF_CACHE_DIR=$cache_dir $OSCAP xccdf resolve --force -o $name.load.out $xccdf 2>> $stderr
+[ ! -s $stderr ]
+cmp $name.xml.out $name.load.out
+
+rm -r $cache_dir $stderr $name.xml.out $name.load.out
@@ -464,14 +464,14 @@ function xccdf_eval_2_multiset(){
 	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/generator'
 	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_info'
 	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item[count(*) = 5]'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:filepath'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:path'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:filename'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:xpath'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:value_of'
-	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:value_of[text()="300"]'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item[count(*) = 5]'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:filepath'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:path'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:filename'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:xpath'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:value_of'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item/ind-sys:value_of[text()="300"]'
 	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/collected_objects'
 	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/collected_objects/object'
 	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[count(@*) = 4]'
@@ -666,6 +666,57 @@ function xccdf_eval_1_multiset_syschar(){
 	done
 }
 
+#
+# Two rules bind different values to the external variable from which
+# a local variable giving the file to read is computed.
+#
+function xccdf_eval_local_variable(){
+	local oval_result="local_variable-oval.xml.result.xml"
+	local xccdf_result=$(mktemp -t ${FUNCNAME}.xml.XXXXXX)
+	local stderr=$(mktemp -t ${FUNCNAME}.err.XXXXXX)
+	local tested_files="testing_file.xml testing_file_300.xml testing_file_600.xml"
+	echo "Stderr file = $stderr"
+
+	cp $srcdir/testing_file_300.xml testing_file.xml
+	cp $srcdir/testing_file_300.xml testing_file_300.xml
+	cp $srcdir/testing_file_600.xml testing_file_600.xml
+	for f in $oval_result $xccdf_result; do
+		[ ! -f $f ] || rm $f
+	done
+
+	$OSCAP xccdf eval --oval-results --results $xccdf_result \
+		$srcdir/test_xccdf_variable_instance_local.xccdf.xml 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+	$OSCAP oval validate --schematron $oval_result
+	local result="$xccdf_result"
+	# the local variable is computed again and the cached items of the
+	# object using it are evicted, so the second rule reads the other file
+	assert_exists 2 '/Benchmark/TestResult/rule-result'
+	assert_exists 1 '/Benchmark/TestResult/rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+	assert_exists 1 '/Benchmark/TestResult/rule-result[@idref="xccdf_moc.elpmaxe.www_rule_2"]/result[text()="pass"]'
+	result="$oval_result"
+	local sc='/oval_results/results/system/oval_system_characteristics'
+	assert_exists 2 $sc'/collected_objects/object[@id="oval:com.example.www:obj:1"]'
+	assert_exists 1 $sc'/collected_objects/object[@id="oval:com.example.www:obj:1" and @variable_instance="1"]/variable_value[@variable_id="oval:com.example.www:var:2" and text()="./testing_file_300.xml"]'
+	assert_exists 1 $sc'/collected_objects/object[@id="oval:com.example.www:obj:1" and @variable_instance="2"]/variable_value[@variable_id="oval:com.example.www:var:2" and text()="./testing_file_600.xml"]'
+	assert_exists 3 $sc'/system_data/ind-sys:xmlfilecontent_item'
+	assert_exists 1 $sc'/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename="testing_file_300.xml" and ind-sys:value_of="300"]'
+	assert_exists 1 $sc'/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename="testing_file_600.xml" and ind-sys:value_of="600"]'
+	# the object not depending on the variable is not collected again,
+	# both instances get the item cached by the probe
+	assert_exists 2 $sc'/collected_objects/object[@id="oval:com.example.www:obj:2"]'
+	assert_exists 1 $sc'/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename="testing_file.xml"]'
+	local item=$($XPATH $oval_result 'string('$sc'/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename="testing_file.xml"]/@id)' 2> /dev/null)
+	assert_exists 2 $sc'/collected_objects/object[@id="oval:com.example.www:obj:2"]/reference[@item_ref="'$item'"]'
+	assert_exists 2 '/oval_results/results/system/definitions/definition[@definition_id="oval:com.example.www:def:1" and @result="true"]'
+	rm $stderr
+	rm $xccdf_result
+	rm $oval_result
+	for f in $tested_files; do
+		chmod u+w $f ; rm $f
+	done
+}
+
 test_init test_api_xccdf_variable_instance.log
 
 test_run "Export from XCCDF to variables: 1x2 values (multival)" xccdf_export_1_multival
@@ -681,5 +732,6 @@ test_run "Export from XCCDF to variables: 3x3 the last is subset (multiset,multi
 
 test_run "Evaluate XCCDF: 2x1 values (multiset)" xccdf_eval_2_multiset
 test_run "Evaluate XCCDF: 2x1 values (multiset) in syschar" xccdf_eval_1_multiset_syschar
+test_run "Evaluate XCCDF: 2x1 values through a local variable" xccdf_eval_local_variable
 
 test_exit
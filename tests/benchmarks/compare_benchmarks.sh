@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Compares two results of run_benchmarks.sh, e.g. of a commit and of its
+# parent, and prints the ratio of the times of every benchmark.
+#
+# Usage: compare_benchmarks.sh OLD.json NEW.json [THRESHOLD]
+#
+# Exits with 1 when some benchmark got slower than THRESHOLD times the old
+# time (default 1.10).
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 OLD.json NEW.json [THRESHOLD]" >&2
+	exit 2
+fi
+
+awk -v threshold="${3:-1.10}" '
+# the time of the benchmark on the line, in the unit of its kind
+function value(line,    m) {
+	if (match(line, /"(ns_per_op|wall_ms)": [0-9.]+/)) {
+		m = substr(line, RSTART, RLENGTH)
+		sub(/.*: /, "", m)
+		return m + 0
+	}
+	return -1
+}
+function name(line,    m) {
+	match(line, /"name": "[^"]+"/)
+	m = substr(line, RSTART + 9, RLENGTH - 10)
+	return m
+}
+/"name":/ {
+	if (FNR == NR) {
+		old[name($0)] = value($0)
+	} else {
+		n = name($0)
+		order[++count] = n
+		new[n] = value($0)
+	}
+}
+END {
+	slower = 0
+	printf "%-32s %14s %14s %8s\n", "benchmark", "old", "new", "ratio"
+	for (i = 1; i <= count; i++) {
+		n = order[i]
+		if (!(n in old) || old[n] <= 0) {
+			printf "%-32s %14s %14.3f %8s\n", n, "-", new[n], "-"
+			continue
+		}
+		ratio = new[n] / old[n]
+		mark = ""
+		if (ratio > threshold) {
+			mark = " slower"
+			slower = 1
+		}
+		printf "%-32s %14.3f %14.3f %8.2f%s\n", n, old[n], new[n], ratio, mark
+	}
+	exit slower
+}' "$1" "$2"
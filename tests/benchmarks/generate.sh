@@ -0,0 +1,293 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Generators of synthetic content and fixture trees for the benchmarks.
+#
+# Every gen_<scenario> function takes a work directory and a size. It
+# creates the fixture tree in DIR/root, which the content addresses by
+# absolute paths when scanned with OSCAP_PROBE_ROOT=DIR/root, and the
+# content in DIR/content.xml. The output only depends on the size, so
+# runs on different commits scan identical data.
+
+OVAL_NS='xmlns="http://oval.mitre.org/XMLSchema/oval-definitions-5" xmlns:oval="http://oval.mitre.org/XMLSchema/oval-common-5" xmlns:ind="http://oval.mitre.org/XMLSchema/oval-definitions-5#independent" xmlns:unix="http://oval.mitre.org/XMLSchema/oval-definitions-5#unix"'
+
+oval_header() {
+	printf '<?xml version="1.0"?>\n<oval_definitions %s>\n' "$OVAL_NS"
+	printf '  <generator>\n    <oval:schema_version>5.11.1</oval:schema_version>\n'
+	printf '    <oval:timestamp>2026-01-01T00:00:00+00:00</oval:timestamp>\n  </generator>\n'
+}
+
+# oval_definitions COUNT - definitions oval:bench:def:I with one criterion
+# referencing the test oval:bench:tst:I, for I in 1..COUNT
+oval_definitions() {
+	awk -v n="$1" 'BEGIN {
+		print "  <definitions>"
+		for (i = 1; i <= n; i++) {
+			printf "    <definition class=\"compliance\" version=\"1\" id=\"oval:bench:def:%d\">\n", i
+			printf "      <metadata><title>Benchmark definition %d</title><description>x</description></metadata>\n", i
+			printf "      <criteria><criterion test_ref=\"oval:bench:tst:%d\"/></criteria>\n", i
+			print "    </definition>"
+		}
+		print "  </definitions>"
+	}'
+}
+
+# oval_textfilecontent54_tests COUNT OBJECTS - test I checks the object
+# ((I - 1) % OBJECTS) + 1 with the state I
+oval_textfilecontent54_tests() {
+	awk -v n="$1" -v objs="$2" 'BEGIN {
+		print "  <tests>"
+		for (i = 1; i <= n; i++) {
+			printf "    <ind:textfilecontent54_test id=\"oval:bench:tst:%d\" version=\"1\" check=\"all\" check_existence=\"at_least_one_exists\" comment=\"x\">\n", i
+			printf "      <ind:object object_ref=\"oval:bench:obj:%d\"/>\n", (i - 1) % objs + 1
+			printf "      <ind:state state_ref=\"oval:bench:ste:%d\"/>\n", i
+			print "    </ind:textfilecontent54_test>"
+		}
+		print "  </tests>"
+	}'
+}
+
+# Many definitions, each with its own object reading a key from one of
+# a hundred configuration files.
+gen_definitions() {
+	local dir=$1 count=$2
+
+	mkdir -p "$dir/root/etc/bench"
+	awk -v dir="$dir/root/etc/bench" 'BEGIN {
+		for (f = 0; f < 100; f++) {
+			file = sprintf("%s/conf%d.conf", dir, f)
+			for (k = 0; k < 100; k++)
+				printf "key%d = value%d\n", k, (k + f) % 7 > file
+			close(file)
+		}
+	}'
+	{
+		oval_header
+		oval_definitions "$count"
+		oval_textfilecontent54_tests "$count" "$count"
+		awk -v n="$count" 'BEGIN {
+			print "  <objects>"
+			for (i = 1; i <= n; i++) {
+				printf "    <ind:textfilecontent54_object id=\"oval:bench:obj:%d\" version=\"1\">\n", i
+				printf "      <ind:filepath>/etc/bench/conf%d.conf</ind:filepath>\n", i % 100
+				printf "      <ind:pattern operation=\"pattern match\">^key%d = (.*)$</ind:pattern>\n", int(i / 100) % 100
+				print "      <ind:instance datatype=\"int\" operation=\"greater than or equal\">1</ind:instance>"
+				print "    </ind:textfilecontent54_object>"
+			}
+			print "  </objects>"
+			print "  <states>"
+			for (i = 1; i <= n; i++) {
+				printf "    <ind:textfilecontent54_state id=\"oval:bench:ste:%d\" version=\"1\">\n", i
+				printf "      <ind:subexpression>value%d</ind:subexpression>\n", i % 7
+				print "    </ind:textfilecontent54_state>"
+			}
+			print "  </states>"
+		}'
+		echo '</oval_definitions>'
+	} > "$dir/content.xml"
+}
+
+# A binary tree of directories DEPTH levels deep with five files in every
+# directory, searched recursively by file and textfilecontent54 objects.
+gen_deep_tree() {
+	local dir=$1 depth=$2
+
+	mkdir -p "$dir/root/tree"
+	awk -v root="$dir/root/tree" -v depth="$depth" '
+	function fill(path, level,    f, file) {
+		for (f = 0; f < 5; f++) {
+			file = sprintf("%s/f%d.txt", path, f)
+			printf "level = %d\nowner = root\n", level > file
+			close(file)
+		}
+		if (level < depth) {
+			system("mkdir \"" path "/a\" \"" path "/b\"")
+			fill(path "/a", level + 1)
+			fill(path "/b", level + 1)
+		}
+	}
+	BEGIN { fill(root, 1) }'
+	{
+		oval_header
+		oval_definitions 2
+		cat <<EOF
+  <tests>
+    <unix:file_test id="oval:bench:tst:1" version="1" check="all" check_existence="at_least_one_exists" comment="x">
+      <unix:object object_ref="oval:bench:obj:1"/>
+      <unix:state state_ref="oval:bench:ste:1"/>
+    </unix:file_test>
+    <ind:textfilecontent54_test id="oval:bench:tst:2" version="1" check="all" check_existence="at_least_one_exists" comment="x">
+      <ind:object object_ref="oval:bench:obj:2"/>
+      <ind:state state_ref="oval:bench:ste:2"/>
+    </ind:textfilecontent54_test>
+  </tests>
+  <objects>
+    <unix:file_object id="oval:bench:obj:1" version="1">
+      <unix:behaviors recurse="directories" recurse_direction="down" recurse_file_system="all"/>
+      <unix:path>/tree</unix:path>
+      <unix:filename operation="pattern match">^f[0-4]\.txt$</unix:filename>
+    </unix:file_object>
+    <ind:textfilecontent54_object id="oval:bench:obj:2" version="1">
+      <ind:behaviors recurse="directories" recurse_direction="down" recurse_file_system="all"/>
+      <ind:path>/tree</ind:path>
+      <ind:filename operation="pattern match">^f[0-4]\.txt$</ind:filename>
+      <ind:pattern operation="pattern match">^owner = (.*)$</ind:pattern>
+      <ind:instance datatype="int" operation="greater than or equal">1</ind:instance>
+    </ind:textfilecontent54_object>
+  </objects>
+  <states>
+    <unix:file_state id="oval:bench:ste:1" version="1">
+      <unix:uread datatype="boolean">true</unix:uread>
+    </unix:file_state>
+    <ind:textfilecontent54_state id="oval:bench:ste:2" version="1">
+      <ind:subexpression>root</ind:subexpression>
+    </ind:textfilecontent54_state>
+  </states>
+</oval_definitions>
+EOF
+	} > "$dir/content.xml"
+}
+
+# A log file of LINES lines with a few matching lines scattered in it.
+gen_big_text() {
+	local dir=$1 lines=$2
+
+	mkdir -p "$dir/root/var/log"
+	awk -v n="$lines" 'BEGIN {
+		for (i = 0; i < n; i++) {
+			if (i % 1000 == 999)
+				printf "needle_%d status=%s\n", i, (i % 3 ? "ok" : "failed")
+			else
+				printf "%08d host kernel: [%d.%06d] audit: type=%d msg=audit(%d): pid=%d uid=0 res=success\n", i, i / 1000, i % 1000000, 1100 + i % 30, i, i % 32768
+		}
+	}' > "$dir/root/var/log/big.log"
+	{
+		oval_header
+		oval_definitions 2
+		oval_textfilecontent54_tests 2 2
+		cat <<EOF
+  <objects>
+    <ind:textfilecontent54_object id="oval:bench:obj:1" version="1">
+      <ind:filepath>/var/log/big.log</ind:filepath>
+      <ind:pattern operation="pattern match">^needle_[0-9]+ status=([a-z]+)$</ind:pattern>
+      <ind:instance datatype="int" operation="greater than or equal">1</ind:instance>
+    </ind:textfilecontent54_object>
+    <ind:textfilecontent54_object id="oval:bench:obj:2" version="1">
+      <ind:filepath>/var/log/big.log</ind:filepath>
+      <ind:pattern operation="pattern match">type=1105 msg=audit\([0-9]+\): pid=([0-9]+)</ind:pattern>
+      <ind:instance datatype="int" operation="greater than or equal">1</ind:instance>
+    </ind:textfilecontent54_object>
+  </objects>
+  <states>
+    <ind:textfilecontent54_state id="oval:bench:ste:1" version="1">
+      <ind:subexpression>ok</ind:subexpression>
+    </ind:textfilecontent54_state>
+    <ind:textfilecontent54_state id="oval:bench:ste:2" version="1">
+      <ind:subexpression datatype="int" operation="less than">32768</ind:subexpression>
+    </ind:textfilecontent54_state>
+  </states>
+</oval_definitions>
+EOF
+	} > "$dir/content.xml"
+}
+
+# A list of PACKAGES "name-epoch:version-release.arch" lines, like the
+# output of "rpm -qa", whose versions are compared with twenty states as
+# a vulnerability feed would do it. The rpminfo probe needs a real RPM
+# database, the comparisons of EVR strings are the same.
+gen_package_list() {
+	local dir=$1 packages=$2
+
+	mkdir -p "$dir/root/var/lib/bench"
+	awk -v n="$packages" 'BEGIN {
+		for (i = 0; i < n; i++)
+			printf "package%d-%d:%d.%d.%d-%d.el9.x86_64\n", i, i % 3, i % 11, i % 23, i % 97, i % 17
+	}' > "$dir/root/var/lib/bench/packages.txt"
+	{
+		oval_header
+		oval_definitions 20
+		oval_textfilecontent54_tests 20 1
+		cat <<EOF
+  <objects>
+    <ind:textfilecontent54_object id="oval:bench:obj:1" version="1">
+      <ind:filepath>/var/lib/bench/packages.txt</ind:filepath>
+      <ind:pattern operation="pattern match">^package[0-9]+-([0-9]+:[^-]+-[^-]+)\.x86_64$</ind:pattern>
+      <ind:instance datatype="int" operation="greater than or equal">1</ind:instance>
+    </ind:textfilecontent54_object>
+  </objects>
+EOF
+		awk 'BEGIN {
+			print "  <states>"
+			for (i = 1; i <= 20; i++) {
+				printf "    <ind:textfilecontent54_state id=\"oval:bench:ste:%d\" version=\"1\">\n", i
+				printf "      <ind:subexpression datatype=\"evr_string\" operation=\"less than\">%d:%d.%d.%d-%d.el9</ind:subexpression>\n", i % 3, i % 11, i, i * 4, i % 17
+				print "    </ind:textfilecontent54_state>"
+			}
+			print "  </states>"
+		}'
+		echo '</oval_definitions>'
+	} > "$dir/content.xml"
+}
+
+# A configuration file of LINES options checked by twenty states with
+# regular expressions which need backtracking.
+gen_regex_states() {
+	local dir=$1 lines=$2
+
+	mkdir -p "$dir/root/etc/bench"
+	awk -v n="$lines" 'BEGIN {
+		for (i = 0; i < n; i++)
+			printf "option_%d = /srv/data/%s/%d/%s.conf\n", i, (i % 2 ? "app" : "web"), i % 101, (i % 5 ? "main" : "extra_settings")
+	}' > "$dir/root/etc/bench/regex.conf"
+	{
+		oval_header
+		oval_definitions 20
+		oval_textfilecontent54_tests 20 1
+		cat <<EOF
+  <objects>
+    <ind:textfilecontent54_object id="oval:bench:obj:1" version="1">
+      <ind:filepath>/etc/bench/regex.conf</ind:filepath>
+      <ind:pattern operation="pattern match">^option_[0-9]+ = (.*)$</ind:pattern>
+      <ind:instance datatype="int" operation="greater than or equal">1</ind:instance>
+    </ind:textfilecontent54_object>
+  </objects>
+EOF
+		awk 'BEGIN {
+			print "  <states>"
+			for (i = 1; i <= 20; i++) {
+				printf "    <ind:textfilecontent54_state id=\"oval:bench:ste:%d\" version=\"1\">\n", i
+				printf "      <ind:subexpression operation=\"pattern match\">^(/[a-z_]+)+/%d[0-9]*/([a-z]+_?)+\\.conf$</ind:subexpression>\n", i
+				print "    </ind:textfilecontent54_state>"
+			}
+			print "  </states>"
+		}'
+		echo '</oval_definitions>'
+	} > "$dir/content.xml"
+}
+
+# An XCCDF benchmark of RULES rules, each checked by one definition of
+# the content of gen_definitions.
+gen_xccdf_rules() {
+	local dir=$1 rules=$2
+
+	gen_definitions "$dir" "$rules"
+	mv "$dir/content.xml" "$dir/oval.xml"
+	{
+		printf '<?xml version="1.0"?>\n'
+		printf '<Benchmark xmlns="http://checklists.nist.gov/xccdf/1.2" id="xccdf_org.open-scap_benchmark_bench" resolved="1" xml:lang="en">\n'
+		printf '  <status>accepted</status>\n  <version>1</version>\n'
+		awk -v n="$rules" 'BEGIN {
+			for (i = 1; i <= n; i++) {
+				printf "  <Rule selected=\"true\" id=\"xccdf_org.open-scap_rule_%d\">\n", i
+				printf "    <title>Rule %d</title>\n", i
+				print "    <check system=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\">"
+				printf "      <check-content-ref href=\"oval.xml\" name=\"oval:bench:def:%d\"/>\n", i
+				print "    </check>"
+				print "  </Rule>"
+			}
+		}'
+		printf '</Benchmark>\n'
+	} > "$dir/content.xml"
+}
@@ -0,0 +1,421 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+/*
+ * Microbenchmarks of the data structures the evaluation engine is built on.
+ *
+ * Usage: oscap_microbench [-s SCALE] [-r REPEAT] [NAME-PREFIX]
+ *
+ * Every benchmark is run REPEAT times and prints one JSON object per line
+ * with the median time of one operation, e.g.
+ * {"name": "htable_get", "ops": 100000, "repeat": 5, "ns_per_op": 41.250}
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sexp.h>
+#include "common/list.h"
+#include "common/oscap_queue.h"
+#include "OVAL/adt/oval_string_map_impl.h"
+#include "oval_definitions.h"
+#include "oval_cmp_impl.h"
+
+struct bench {
+	const char *name;
+	/* number of operations done by one run with the scale 1 */
+	size_t ops;
+	void (*setup)(size_t n);
+	void (*run)(size_t n);
+	void (*teardown)(void);
+};
+
+static char **keys;
+static size_t keys_n;
+
+static void keys_setup(size_t n)
+{
+	keys_n = n;
+	keys = malloc(n * sizeof(char *));
+	for (size_t i = 0; i < n; i++) {
+		keys[i] = malloc(48);
+		snprintf(keys[i], 48, "oval:bench:obj:%zu", i);
+	}
+}
+
+static void keys_teardown(void)
+{
+	for (size_t i = 0; i < keys_n; i++)
+		free(keys[i]);
+	free(keys);
+	keys = NULL;
+}
+
+/* SEXP lists, the probes build their items and messages from them */
+
+static SEXP_t *sexp_list;
+static size_t sexp_list_n;
+
+static void sexp_list_fill(size_t n)
+{
+	sexp_list = SEXP_list_new(NULL);
+	for (size_t i = 0; i < n; i++) {
+		SEXP_t *num = SEXP_number_newi_32((int32_t) i);
+		SEXP_list_add(sexp_list, num);
+		SEXP_free(num);
+	}
+	sexp_list_n = n;
+}
+
+static void sexp_list_teardown(void)
+{
+	SEXP_free(sexp_list);
+	sexp_list = NULL;
+}
+
+static void sexp_list_add_run(size_t n)
+{
+	sexp_list_fill(n);
+	sexp_list_teardown();
+}
+
+static void sexp_list_nth_run(size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		SEXP_t *num = SEXP_list_nth(sexp_list, (uint32_t) (i % sexp_list_n) + 1);
+		SEXP_free(num);
+	}
+}
+
+static void sexp_list_iterate_run(size_t n)
+{
+	SEXP_t *num;
+	size_t count = 0;
+
+	while (count < n) {
+		SEXP_list_foreach(num, sexp_list) {
+			count++;
+		}
+	}
+}
+
+static void sexp_list_small_setup(size_t n)
+{
+	sexp_list_fill(1000);
+}
+
+/* oscap_htable, the hash table of the XCCDF and common code */
+
+static struct oscap_htable *htable;
+
+static void htable_add_run(size_t n)
+{
+	htable = oscap_htable_new();
+	for (size_t i = 0; i < n; i++)
+		oscap_htable_add(htable, keys[i], keys[i]);
+	oscap_htable_free(htable, NULL);
+	htable = NULL;
+}
+
+static void htable_get_setup(size_t n)
+{
+	keys_setup(n);
+	htable = oscap_htable_new();
+	for (size_t i = 0; i < n; i++)
+		oscap_htable_add(htable, keys[i], keys[i]);
+}
+
+static void htable_get_run(size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		if (oscap_htable_get(htable, keys[(i * 7919) % n]) == NULL)
+			abort();
+	}
+}
+
+static void htable_teardown(void)
+{
+	oscap_htable_free(htable, NULL);
+	htable = NULL;
+	keys_teardown();
+}
+
+/* oval_string_map, the map of the OVAL models */
+
+static struct oval_string_map *string_map;
+
+static void string_map_put_run(size_t n)
+{
+	string_map = oval_string_map_new();
+	for (size_t i = 0; i < n; i++)
+		oval_string_map_put(string_map, keys[i], keys[i]);
+	oval_string_map_free(string_map, NULL);
+	string_map = NULL;
+}
+
+static void string_map_get_setup(size_t n)
+{
+	keys_setup(n);
+	string_map = oval_string_map_new();
+	for (size_t i = 0; i < n; i++)
+		oval_string_map_put(string_map, keys[i], keys[i]);
+}
+
+static void string_map_get_run(size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		if (oval_string_map_get_value(string_map, keys[(i * 7919) % n]) == NULL)
+			abort();
+	}
+}
+
+static void string_map_teardown(void)
+{
+	oval_string_map_free(string_map, NULL);
+	string_map = NULL;
+	keys_teardown();
+}
+
+/*
+ * Queue between the library and a probe thread, locked and signalled the
+ * same way as the "queue" scheme of SEAP does it.
+ */
+
+struct bench_queue {
+	struct oscap_queue *queue;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int cnt;
+};
+
+static void bench_queue_send(struct bench_queue *q, SEXP_t *sexp)
+{
+	SEXP_t *msg = SEXP_list_new(sexp, NULL);
+
+	pthread_mutex_lock(&q->mutex);
+	oscap_queue_add(q->queue, msg);
+	q->cnt++;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->mutex);
+}
+
+static SEXP_t *bench_queue_recv(struct bench_queue *q)
+{
+	SEXP_t *sexp;
+
+	pthread_mutex_lock(&q->mutex);
+	while (q->cnt == 0)
+		pthread_cond_wait(&q->cond, &q->mutex);
+	sexp = oscap_queue_remove(q->queue);
+	q->cnt--;
+	pthread_mutex_unlock(&q->mutex);
+	return sexp;
+}
+
+static size_t queue_n;
+
+static void *queue_producer(void *arg)
+{
+	struct bench_queue *q = arg;
+	SEXP_t *msg = SEXP_string_newf("%s", "textfilecontent54_object");
+
+	for (size_t i = 0; i < queue_n; i++)
+		bench_queue_send(q, msg);
+	SEXP_free(msg);
+	return NULL;
+}
+
+static void queue_throughput_run(size_t n)
+{
+	struct bench_queue q;
+	pthread_t producer;
+
+	q.queue = oscap_queue_new();
+	pthread_mutex_init(&q.mutex, NULL);
+	pthread_cond_init(&q.cond, NULL);
+	q.cnt = 0;
+	queue_n = n;
+
+	if (pthread_create(&producer, NULL, queue_producer, &q) != 0)
+		abort();
+	for (size_t i = 0; i < n; i++)
+		SEXP_free(bench_queue_recv(&q));
+	pthread_join(producer, NULL);
+
+	pthread_cond_destroy(&q.cond);
+	pthread_mutex_destroy(&q.mutex);
+	oscap_queue_free(q.queue, NULL);
+}
+
+/* oval_cmp, comparison of the collected data with states */
+
+static void cmp_int_run(size_t n)
+{
+	char sys[32];
+
+	for (size_t i = 0; i < n; i++) {
+		snprintf(sys, sizeof(sys), "%zu", i);
+		oval_str_cmp_str("5000", OVAL_DATATYPE_INTEGER, sys, OVAL_OPERATION_LESS_THAN);
+	}
+}
+
+static void cmp_evr_run(size_t n)
+{
+	char sys[64];
+
+	for (size_t i = 0; i < n; i++) {
+		snprintf(sys, sizeof(sys), "0:%zu.%zu.%zu-%zu.el8", i % 7, i % 13, i % 101, i % 5);
+		oval_str_cmp_str("0:3.10.50-2.el8", OVAL_DATATYPE_EVR_STRING, sys, OVAL_OPERATION_LESS_THAN);
+	}
+}
+
+static const char *const cmp_regex = "^([a-z]+_)+[0-9]{2,}(\\.conf|\\.d/.*)$";
+
+static void cmp_regex_run(size_t n)
+{
+	char sys[64];
+
+	for (size_t i = 0; i < n; i++) {
+		snprintf(sys, sizeof(sys), "sshd_config_%zu.d/file%zu", i, i % 17);
+		oval_str_cmp_str((char *) cmp_regex, OVAL_DATATYPE_STRING, sys, OVAL_OPERATION_PATTERN_MATCH);
+	}
+}
+
+static struct oval_cmp_value *cmp_value;
+
+static void cmp_regex_compiled_setup(size_t n)
+{
+	cmp_value = oval_cmp_value_new(cmp_regex, OVAL_DATATYPE_STRING, OVAL_OPERATION_PATTERN_MATCH);
+}
+
+static void cmp_regex_compiled_run(size_t n)
+{
+	char sys[64];
+
+	for (size_t i = 0; i < n; i++) {
+		snprintf(sys, sizeof(sys), "sshd_config_%zu.d/file%zu", i, i % 17);
+		oval_cmp_value_cmp_str(cmp_value, sys);
+	}
+}
+
+static void cmp_regex_compiled_teardown(void)
+{
+	oval_cmp_value_free(cmp_value);
+	cmp_value = NULL;
+}
+
+static const struct bench benches[] = {
+	{"cmp_evr_string", 100000, NULL, cmp_evr_run, NULL},
+	{"cmp_integer", 200000, NULL, cmp_int_run, NULL},
+	{"cmp_regex", 20000, NULL, cmp_regex_run, NULL},
+	{"cmp_regex_compiled", 100000, cmp_regex_compiled_setup, cmp_regex_compiled_run, cmp_regex_compiled_teardown},
+	{"htable_add", 100000, keys_setup, htable_add_run, keys_teardown},
+	{"htable_get", 100000, htable_get_setup, htable_get_run, htable_teardown},
+	{"queue_throughput", 100000, NULL, queue_throughput_run, NULL},
+	{"sexp_list_add", 100000, NULL, sexp_list_add_run, NULL},
+	{"sexp_list_iterate", 100000, sexp_list_small_setup, sexp_list_iterate_run, sexp_list_teardown},
+	{"sexp_list_nth", 100000, sexp_list_small_setup, sexp_list_nth_run, sexp_list_teardown},
+	{"string_map_get", 100000, string_map_get_setup, string_map_get_run, string_map_teardown},
+	{"string_map_put", 100000, keys_setup, string_map_put_run, keys_teardown},
+	{NULL, 0, NULL, NULL, NULL}
+};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+	double da = *(const double *) a, db = *(const double *) b;
+
+	return (da > db) - (da < db);
+}
+
+static void bench_run(const struct bench *b, double scale, int repeat)
+{
+	size_t n = (size_t) (b->ops * scale);
+	double *times = malloc(repeat * sizeof(double));
+
+	if (n == 0)
+		n = 1;
+	if (b->setup != NULL)
+		b->setup(n);
+	/* warm up the allocator and caches */
+	b->run(n < 1000 ? n : 1000);
+	for (int i = 0; i < repeat; i++) {
+		double start = now_ns();
+		b->run(n);
+		times[i] = (now_ns() - start) / n;
+	}
+	if (b->teardown != NULL)
+		b->teardown();
+
+	qsort(times, repeat, sizeof(double), cmp_double);
+	printf("{\"name\": \"%s\", \"ops\": %zu, \"repeat\": %d, \"ns_per_op\": %.3f}\n",
+			b->name, n, repeat, times[repeat / 2]);
+	fflush(stdout);
+	free(times);
+}
+
+int main(int argc, char *argv[])
+{
+	double scale = 1.0;
+	int repeat = 5;
+	const char *prefix = NULL;
+	int c;
+
+	while ((c = getopt(argc, argv, "s:r:")) != -1) {
+		switch (c) {
+		case 's':
+			scale = strtod(optarg, NULL);
+			break;
+		case 'r':
+			repeat = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-s SCALE] [-r REPEAT] [NAME-PREFIX]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (optind < argc)
+		prefix = argv[optind];
+	if (scale <= 0 || repeat <= 0) {
+		fprintf(stderr, "SCALE and REPEAT must be positive.\n");
+		return 2;
+	}
+
+	for (const struct bench *b = benches; b->name != NULL; b++) {
+		if (prefix == NULL || strncmp(b->name, prefix, strlen(prefix)) == 0)
+			bench_run(b, scale, repeat);
+	}
+	return 0;
+}
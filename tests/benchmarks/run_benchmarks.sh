@@ -0,0 +1,138 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# Runs the microbenchmarks and scans of generated content, and writes the
+# median times into a JSON file with one benchmark per line, e.g.
+#
+#   {"name": "micro/htable_get", "ops": 100000, "repeat": 5, "ns_per_op": 41.250}
+#   {"name": "scan/definitions", "size": 10000, "repeat": 3, "wall_ms": 5120.000, "cpu_ms": 5032.000}
+#
+# Results of two commits are compared by compare_benchmarks.sh.
+#
+# Usage: run_benchmarks.sh [--quick] [--repeat N] [--output FILE] [--keep DIR] [NAME-PREFIX]
+#
+#   --quick        tiny sizes, only checks that the benchmarks work
+#   --repeat N     number of runs of every benchmark (default 3)
+#   --output FILE  write the results into FILE instead of the standard output
+#   --keep DIR     generate the content into DIR and keep it there
+#
+# The scans run $OSCAP, the oscap of the build tree by default, so another
+# build (e.g. OSCAP=/usr/bin/oscap) can be measured with the same content.
+
+set -e -o pipefail
+
+srcdir=${srcdir:-$(cd "$(dirname "$0")" && pwd)}
+builddir=${builddir:-$(pwd)}
+OSCAP=${OSCAP:-"bash $builddir/run $builddir/utils/oscap"}
+MICROBENCH=${MICROBENCH:-$builddir/tests/benchmarks/oscap_microbench}
+
+. "$srcdir/generate.sh"
+
+quick=0
+repeat=3
+output=
+keep=
+prefix=
+while [ $# -gt 0 ]; do
+	case "$1" in
+	--quick) quick=1 ;;
+	--repeat) repeat=$2; shift ;;
+	--output) output=$2; shift ;;
+	--keep) keep=$2; shift ;;
+	-*) echo "Unknown option '$1'." >&2; exit 2 ;;
+	*) prefix=$1 ;;
+	esac
+	shift
+done
+
+# scenario, size and the quick size
+scenarios="
+definitions 10000 50
+deep_tree 11 3
+big_text 100000 2000
+package_list 20000 200
+regex_states 20000 200
+xccdf_rules 2000 20
+"
+
+if [ -n "$keep" ]; then
+	work=$keep
+	mkdir -p "$work"
+else
+	work=$(mktemp -d -t oscap_benchmarks.XXXXXX)
+	trap 'rm -rf "$work"' EXIT
+fi
+
+results=$work/results.json
+: > "$results"
+
+selected() {
+	[ -z "$prefix" ] || [[ "$1" == "$prefix"* ]]
+}
+
+# median of the numbers on the standard input
+median() {
+	sort -g | awk '{ v[NR] = $1 } END { printf "%.3f", NR % 2 ? v[(NR + 1) / 2] : (v[NR / 2] + v[NR / 2 + 1]) / 2 }'
+}
+
+if [ $quick = 1 ]; then
+	micro_scale=0.01
+else
+	micro_scale=1
+fi
+if selected micro/; then
+	echo "Running microbenchmarks" >&2
+	micro_filter=
+	[[ "$prefix" == micro/* ]] && micro_filter=${prefix#micro/}
+	"$MICROBENCH" -s $micro_scale -r $((repeat > 5 ? repeat : 5)) $micro_filter | \
+		sed 's/^{"name": "/{"name": "micro\//' >> "$results"
+fi
+
+echo "$scenarios" | while read -r name size quick_size; do
+	[ -n "$name" ] || continue
+	selected "scan/$name" || continue
+	[ $quick = 1 ] && size=$quick_size
+
+	dir=$work/$name
+	rm -rf "$dir"
+	mkdir -p "$dir"
+	echo "Generating $name of size $size" >&2
+	gen_$name "$dir" "$size"
+
+	if [ $name = xccdf_rules ]; then
+		cmd="$OSCAP xccdf eval --skip-valid --results $dir/results.xml $dir/content.xml"
+	else
+		cmd="$OSCAP oval eval --skip-valid --results $dir/results.xml $dir/content.xml"
+	fi
+
+	echo "Scanning $name" >&2
+	: > "$dir/times"
+	for i in $(seq 1 $repeat); do
+		# keep the status of oscap, "xccdf eval" returns 2 when a rule fails
+		status=0
+		TIMEFORMAT='%3R %3U %3S'
+		{ time (cd "$dir" && OSCAP_PROBE_ROOT=$dir/root $cmd > "$dir/stdout" 2> "$dir/stderr") ; } 2>> "$dir/times" || status=$?
+		if [ $status != 0 ] && [ $status != 2 ]; then
+			echo "Scan of $name failed with $status:" >&2
+			cat "$dir/stderr" >&2
+			exit 1
+		fi
+	done
+	wall=$(awk '{ print $1 * 1000 }' "$dir/times" | median)
+	cpu=$(awk '{ print ($2 + $3) * 1000 }' "$dir/times" | median)
+	printf '{"name": "scan/%s", "size": %d, "repeat": %d, "wall_ms": %s, "cpu_ms": %s}\n' \
+		"$name" "$size" "$repeat" "$wall" "$cpu" >> "$results"
+done
+
+commit=$(git -C "$srcdir" rev-parse HEAD 2>/dev/null || echo unknown)
+{
+	echo "{"
+	printf '"commit": "%s",\n' "$commit"
+	printf '"quick": %s,\n' "$([ $quick = 1 ] && echo true || echo false)"
+	echo '"benchmarks": ['
+	sed '$!s/$/,/' "$results"
+	echo "]"
+	echo "}"
+} > "${output:-/dev/stdout}"
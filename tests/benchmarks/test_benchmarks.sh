@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+
+# Runs the benchmarks with tiny sizes, so that the generated content and
+# the JSON output keep working. The times themselves are not checked.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+result=$(mktemp -t benchmarks.XXXXXX.json)
+
+$srcdir/run_benchmarks.sh --quick --repeat 1 --output $result
+
+for name in micro/cmp_evr_string micro/htable_get micro/queue_throughput micro/sexp_list_nth micro/string_map_get; do
+	grep -q "^{\"name\": \"$name\", \"ops\": [0-9]*, \"repeat\": 5, \"ns_per_op\": [0-9.]*},\?$" $result
+done
+for name in definitions deep_tree big_text package_list regex_states xccdf_rules; do
+	grep -q "^{\"name\": \"scan/$name\", \"size\": [0-9]*, \"repeat\": 1, \"wall_ms\": [0-9.]*, \"cpu_ms\": [0-9.]*},\?$" $result
+done
+grep -q '^"quick": true,$' $result
+
+# a result compared with itself is never slower
+$srcdir/compare_benchmarks.sh $result $result > /dev/null
+
+rm -f $result
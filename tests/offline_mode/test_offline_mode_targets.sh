@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenSCAP Test Suite
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+function test_offline_mode_targets {
+    temp_dir="$(mktemp -d)"
+
+    mkdir -p "$temp_dir/first" "$temp_dir/second" "$temp_dir/out"
+    mkdir -p "$temp_dir/first/etc" "$temp_dir/second/etc"
+    echo "Hello" > "$temp_dir/first/bar.txt"
+    echo "Bye" > "$temp_dir/second/bar.txt"
+    echo "hosta" > "$temp_dir/first/etc/hostname"
+    echo "hostb" > "$temp_dir/second/etc/hostname"
+
+    targets="$temp_dir/targets"
+    cat > "$targets" <<TARGETS
+# root [name]
+$temp_dir/first
+
+$temp_dir/second other
+TARGETS
+
+    stdout="$(mktemp)"
+    $OSCAP xccdf eval --targets-from "$targets" --results "$temp_dir/out/results.xml" \
+        --results-arf "$temp_dir/out/arf.xml" $srcdir/targets.xccdf.xml > "$stdout" || ret=$?
+    [ "$ret" = 2 ]
+    grep -q "^--- Target first ($temp_dir/first) ---" "$stdout"
+    grep -q "^--- Target other ($temp_dir/second) ---" "$stdout"
+
+    [ -s "$temp_dir/out/first-arf.xml" ]
+    [ -s "$temp_dir/out/other-arf.xml" ]
+
+    # system information is collected from each target, not from the host or the previous target
+    result="$temp_dir/out/first-arf.xml"
+    assert_exists 1 '//oval_system_characteristics/system_info/primary_host_name[text()="hosta"]'
+    assert_exists 0 '//oval_system_characteristics/system_info/primary_host_name[text()!="hosta"]'
+    result="$temp_dir/out/other-arf.xml"
+    assert_exists 1 '//oval_system_characteristics/system_info/primary_host_name[text()="hostb"]'
+    assert_exists 0 '//oval_system_characteristics/system_info/primary_host_name[text()!="hostb"]'
+
+    result="$temp_dir/out/first-results.xml"
+    assert_exists 1 '//TestResult'
+    assert_exists 1 '//TestResult/target[text()="first"]'
+    assert_exists 1 '//rule-result/result[text()="pass"]'
+
+    result="$temp_dir/out/other-results.xml"
+    assert_exists 1 '//TestResult'
+    assert_exists 1 '//TestResult/target[text()="other"]'
+    assert_exists 1 '//rule-result/result[text()="fail"]'
+
+    rm -rf "$temp_dir"
+    rm -f "$stdout"
+}
+
+# Testing.
+
+test_init "test_offline_mode_targets.log"
+
+test_run "test_offline_mode_targets" test_offline_mode_targets
+
+test_exit
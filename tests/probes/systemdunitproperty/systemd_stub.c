@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+/*
+ * Minimal stand-in for the systemd manager on a private bus. It answers
+ * ListUnits, LoadUnit and GetAll for a few fixed units and logs every call
+ * it receives to the file given as the first argument.
+ *
+ * Usage: DBUS_SYSTEM_BUS_ADDRESS=<address> systemd_stub <log file>
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dbus/dbus.h>
+
+struct stub_unit {
+	const char *name;
+	const char *path;
+	const char *description;
+	bool listed;
+	const char *requires[3];
+	const char *wants[3];
+};
+
+static const struct stub_unit units[] = {
+	{ "stub-a.service", "/org/freedesktop/systemd1/unit/stub_2da_2eservice", "Stub A", true, { NULL }, { NULL } },
+	{ "stub-b.service", "/org/freedesktop/systemd1/unit/stub_2db_2eservice", "Stub B", true, { NULL }, { NULL } },
+	{ "stub.target", "/org/freedesktop/systemd1/unit/stub_2etarget", "Stub Target", true,
+		{ "stub-a.service", "stub-sub.target", NULL }, { "stub-b.service", NULL } },
+	{ "stub-sub.target", "/org/freedesktop/systemd1/unit/stub_2dsub_2etarget", "Stub Sub Target", false,
+		{ NULL }, { "stub-c.service", "stub.target", NULL } },
+	{ "stub-c.service", "/org/freedesktop/systemd1/unit/stub_2dc_2eservice", "Stub C", false, { NULL }, { NULL } },
+};
+
+#define UNIT_COUNT (sizeof(units) / sizeof(units[0]))
+
+static void append_string_variant(DBusMessageIter *dict, const char *name, const char *value)
+{
+	DBusMessageIter entry, variant;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "s", &variant);
+	dbus_message_iter_append_basic(&variant, DBUS_TYPE_STRING, &value);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static void append_array_variant(DBusMessageIter *dict, const char *name, const char *const *values)
+{
+	DBusMessageIter entry, variant, array;
+
+	dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &name);
+	dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "as", &variant);
+	dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "s", &array);
+	for (int i = 0; values[i] != NULL; ++i)
+		dbus_message_iter_append_basic(&array, DBUS_TYPE_STRING, &values[i]);
+	dbus_message_iter_close_container(&variant, &array);
+	dbus_message_iter_close_container(&entry, &variant);
+	dbus_message_iter_close_container(dict, &entry);
+}
+
+static DBusMessage *list_units(DBusMessage *msg)
+{
+	DBusMessage *reply = dbus_message_new_method_return(msg);
+	DBusMessageIter args, array, unit;
+	const char *empty = "", *state = "active", *job_path = "/";
+	dbus_uint32_t job_id = 0;
+
+	dbus_message_iter_init_append(reply, &args);
+	dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(ssssssouso)", &array);
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		if (!units[i].listed)
+			continue;
+
+		dbus_message_iter_open_container(&array, DBUS_TYPE_STRUCT, NULL, &unit);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &units[i].name);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &units[i].description);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &state);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &state);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &state);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &units[i].path);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_UINT32, &job_id);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_STRING, &empty);
+		dbus_message_iter_append_basic(&unit, DBUS_TYPE_OBJECT_PATH, &job_path);
+		dbus_message_iter_close_container(&array, &unit);
+	}
+	dbus_message_iter_close_container(&args, &array);
+
+	return reply;
+}
+
+static DBusMessage *load_unit(DBusMessage *msg, const char *name)
+{
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		if (strcmp(units[i].name, name) == 0) {
+			DBusMessage *reply = dbus_message_new_method_return(msg);
+			dbus_message_append_args(reply, DBUS_TYPE_OBJECT_PATH, &units[i].path, DBUS_TYPE_INVALID);
+			return reply;
+		}
+	}
+
+	return dbus_message_new_error(msg, "org.freedesktop.systemd1.NoSuchUnit", name);
+}
+
+static DBusMessage *get_all(DBusMessage *msg)
+{
+	const char *path = dbus_message_get_path(msg);
+
+	for (size_t i = 0; i < UNIT_COUNT; ++i) {
+		if (strcmp(units[i].path, path) == 0) {
+			DBusMessage *reply = dbus_message_new_method_return(msg);
+			DBusMessageIter args, dict;
+
+			dbus_message_iter_init_append(reply, &args);
+			dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "{sv}", &dict);
+			append_string_variant(&dict, "Id", units[i].name);
+			append_string_variant(&dict, "Description", units[i].description);
+			append_array_variant(&dict, "Requires", units[i].requires);
+			append_array_variant(&dict, "Wants", units[i].wants);
+			append_string_variant(&dict, "LoadState", "loaded");
+			dbus_message_iter_close_container(&args, &dict);
+			return reply;
+		}
+	}
+
+	return dbus_message_new_error(msg, DBUS_ERROR_UNKNOWN_OBJECT, path);
+}
+
+int main(int argc, char *argv[])
+{
+	DBusError err;
+	DBusConnection *conn;
+	FILE *log;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <log file>\n", argv[0]);
+		return 2;
+	}
+
+	log = fopen(argv[1], "w");
+	if (log == NULL) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	dbus_error_init(&err);
+	conn = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+	if (conn == NULL) {
+		fprintf(stderr, "Can't connect to the bus: %s\n", err.message);
+		return 1;
+	}
+
+	if (dbus_bus_request_name(conn, "org.freedesktop.systemd1", DBUS_NAME_FLAG_DO_NOT_QUEUE, &err) != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+		fprintf(stderr, "Can't own org.freedesktop.systemd1: %s\n", dbus_error_is_set(&err) ? err.message : "name is taken");
+		return 1;
+	}
+
+	/* tell the test that the service is ready */
+	printf("ready\n");
+	fflush(stdout);
+
+	while (dbus_connection_read_write(conn, -1)) {
+		DBusMessage *msg;
+
+		while ((msg = dbus_connection_pop_message(conn)) != NULL) {
+			DBusMessage *reply = NULL;
+			const char *arg = "";
+
+			if (dbus_message_get_type(msg) != DBUS_MESSAGE_TYPE_METHOD_CALL) {
+				dbus_message_unref(msg);
+				continue;
+			}
+
+			dbus_message_get_args(msg, NULL, DBUS_TYPE_STRING, &arg, DBUS_TYPE_INVALID);
+			fprintf(log, "%s %s %s\n", dbus_message_get_member(msg), dbus_message_get_path(msg), arg);
+			fflush(log);
+
+			if (dbus_message_is_method_call(msg, "org.freedesktop.systemd1.Manager", "ListUnits"))
+				reply = list_units(msg);
+			else if (dbus_message_is_method_call(msg, "org.freedesktop.systemd1.Manager", "LoadUnit"))
+				reply = load_unit(msg, arg);
+			else if (dbus_message_is_method_call(msg, "org.freedesktop.DBus.Properties", "GetAll"))
+				reply = get_all(msg);
+			else
+				reply = dbus_message_new_error(msg, DBUS_ERROR_UNKNOWN_METHOD, dbus_message_get_member(msg));
+
+			dbus_connection_send(conn, reply, NULL);
+			dbus_message_unref(reply);
+			dbus_message_unref(msg);
+		}
+	}
+
+	fclose(log);
+	return 0;
+}
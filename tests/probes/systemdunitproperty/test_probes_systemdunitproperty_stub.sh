@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+
+# Copyright 2026 Red Hat Inc., Durham, North Carolina.
+# All Rights Reserved.
+#
+# OpenScap Probes Test Suite.
+#
+# Runs the systemd unit probes against systemd_stub on a private bus, so
+# the test doesn't depend on the units of the host.
+
+set -e -o pipefail
+
+. $builddir/tests/test_common.sh
+
+function test_probes_systemdunitproperty_stub {
+    probecheck "systemdunitproperty" || return 255
+    probecheck "systemdunitdependency" || return 255
+    require "dbus-daemon" || return 255
+
+    local STUB="$builddir/tests/probes/systemdunitproperty/systemd_stub"
+    local DF="${srcdir}/test_probes_systemdunitproperty_stub.xml"
+    local RF="results.xml"
+    local ADDRESS=$(mktemp)
+    local READY=$(mktemp)
+    local CALLS=$(mktemp)
+
+    [ -f $RF ] && rm -f $RF
+
+    dbus-daemon --config-file="${srcdir}/test_probes_systemdunitproperty_stub.conf" --nofork --print-address=3 3>"$ADDRESS" &
+    local BUS_PID=$!
+    trap "kill $BUS_PID 2>/dev/null; rm -f $ADDRESS $READY $CALLS" RETURN
+    for i in $(seq 1 50); do [ -s "$ADDRESS" ] && break; sleep 0.1; done
+    export DBUS_SYSTEM_BUS_ADDRESS="$(head -n 1 "$ADDRESS")"
+
+    $STUB "$CALLS" > "$READY" &
+    local STUB_PID=$!
+    trap "kill $STUB_PID $BUS_PID 2>/dev/null; rm -f $ADDRESS $READY $CALLS" RETURN
+    for i in $(seq 1 50); do grep -q ready "$READY" && break; sleep 0.1; done
+
+    $OSCAP oval eval --results $RF $DF
+
+    [ -f $RF ]
+    verify_results "def" $DF $RF 4
+    verify_results "tst" $DF $RF 4
+
+    # The units are listed once per scan and every unit is loaded only
+    # once, no matter how many objects refer to it.
+    cat "$CALLS"
+    [ "$(grep -c '^ListUnits ' "$CALLS")" == 1 ]
+    [ "$(grep '^LoadUnit ' "$CALLS" | sort | uniq -d | wc -l)" == 0 ]
+    [ "$(grep '^GetAll ' "$CALLS" | sort | uniq -d | wc -l)" == 0 ]
+    rm $RF
+}
+
+test_probes_systemdunitproperty_stub
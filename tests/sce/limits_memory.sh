@@ -0,0 +1,7 @@
+#!/bin/bash
+
+# tail has to buffer all the 128 MiB it prints
+if head -c 268435456 /dev/zero | tail -c 134217728 > /dev/null; then
+	exit $XCCDF_RESULT_PASS
+fi
+exit $XCCDF_RESULT_FAIL
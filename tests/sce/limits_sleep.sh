@@ -0,0 +1,6 @@
+#!/bin/bash
+
+# the child keeps the output pipes open as well
+sleep 60 &
+sleep 60
+exit $XCCDF_RESULT_PASS
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+exit $XCCDF_RESULT_FAIL
@@ -0,0 +1,6 @@
+#!/bin/bash
+
+echo "$XCCDF_VALUE_NAME" >> parallel_order.started
+sleep $XCCDF_VALUE_SLEEP
+echo "$XCCDF_VALUE_NAME"
+exit $XCCDF_RESULT_PASS
@@ -0,0 +1,4 @@
+#!/bin/bash
+
+sleep 1
+exit $XCCDF_RESULT_PASS
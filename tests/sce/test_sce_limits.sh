@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# Test that the time and memory limits of SCE scripts are enforced.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+function test_sce_limits {
+
+    local xccdf_file=${srcdir}/$1
+    local stdout=$(mktemp)
+
+    local start=$(date +%s)
+    OSCAP_SCE_TIMEOUT=2 OSCAP_SCE_MEMORY_LIMIT=64 $OSCAP xccdf eval "$xccdf_file" > $stdout || [ $? -eq 2 ]
+    local end=$(date +%s)
+    cat $stdout
+
+    # the sleeping script and its child have been killed
+    [ $((end - start)) -lt 30 ]
+    [ "$(grep '^Result' $stdout | cut -f2 | tr '\n' ' ')" == "error fail " ]
+
+    rm $stdout
+}
+
+# Testing.
+test_init
+
+test_run "SCE scripts limited in time and memory" test_sce_limits test_sce_limits.xccdf.xml
+
+test_exit
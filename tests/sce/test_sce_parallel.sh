@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# Test that SCE checks evaluated by several threads are reported
+# in the document order with the same results as without threads.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+function test_sce_parallel {
+
+    local xccdf_file=${srcdir}/$1
+    local stdout=$(mktemp)
+    local result=$(mktemp)
+    local result_serial=$(mktemp)
+
+    OSCAP_XCCDF_EVAL_THREADS=4 $OSCAP xccdf eval --results "$result" "$xccdf_file" > $stdout || [ $? -eq 2 ]
+    echo "===== result ====="
+    cat $result
+
+    [ "$(grep '^Rule' $stdout | cut -f2 | tr '\n' ' ')" == \
+        "xccdf_moc.elpmaxe.www_rule_1 xccdf_moc.elpmaxe.www_rule_2 xccdf_moc.elpmaxe.www_rule_3 xccdf_moc.elpmaxe.www_rule_4 xccdf_moc.elpmaxe.www_rule_5 xccdf_moc.elpmaxe.www_rule_6 " ]
+    [ "$(grep '^Result' $stdout | cut -f2 | tr '\n' ' ')" == "pass fail pass fail pass fail " ]
+
+    OSCAP_XCCDF_EVAL_THREADS=1 $OSCAP xccdf eval --results "$result_serial" "$xccdf_file" > /dev/null || [ $? -eq 2 ]
+    diff <(grep -v 'time=' $result_serial) <(grep -v 'time=' $result)
+
+    rm $stdout $result $result_serial
+}
+
+# Testing.
+test_init
+
+test_run "SCE checks evaluated in parallel" test_sce_parallel test_sce_parallel.xccdf.xml
+
+test_exit
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * Evaluates SCE checks by several threads and aborts the evaluation from
+ * the output callback after the first rule. Prints stdout of the collected
+ * SCE results in their order.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "oscap_source.h"
+#include "xccdf_benchmark.h"
+#include "xccdf_policy.h"
+#include "SCE/public/sce_engine_api.h"
+
+static int abort_evaluation(struct xccdf_rule_result *rule_result, void *arg)
+{
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 3) {
+		printf("Invalid arguments, usage: ./test_sce_parallel_abort XCCDF_FILE XCCDF_DIRECTORY\n");
+		return 2;
+	}
+
+	struct oscap_source *source = oscap_source_new_from_file(argv[1]);
+	struct xccdf_benchmark *benchmark = xccdf_benchmark_import_source(source);
+	oscap_source_free(source);
+	if (benchmark == NULL) {
+		printf("Failed to import the benchmark.\n");
+		return 1;
+	}
+	struct xccdf_policy_model *model = xccdf_policy_model_new(benchmark);
+	struct sce_parameters *parameters = sce_parameters_new();
+	sce_parameters_set_xccdf_directory(parameters, argv[2]);
+	sce_parameters_allocate_session(parameters);
+	xccdf_policy_model_register_engine_sce(model, parameters);
+	xccdf_policy_model_register_output_callback(model, abort_evaluation, NULL);
+
+	struct xccdf_policy *policy = xccdf_policy_model_get_policy_by_id(model, NULL);
+	struct xccdf_result *result = xccdf_policy_evaluate(policy);
+	if (result == NULL) {
+		printf("Evaluation failed.\n");
+		return 1;
+	}
+
+	struct sce_check_result_iterator *it = sce_session_get_check_results(sce_parameters_get_session(parameters));
+	while (sce_check_result_iterator_has_more(it))
+		printf("%s", sce_check_result_get_stdout(sce_check_result_iterator_next(it)));
+	sce_check_result_iterator_free(it);
+
+	xccdf_policy_model_free(model);
+	sce_parameters_free(parameters);
+	return 0;
+}
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# Test that results of SCE checks evaluated by several threads are collected
+# in the document order and that no other check is started once an output
+# callback aborts the evaluation.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+function test_sce_parallel_results_order {
+
+    local xccdf_file=${srcdir}/$1
+    local workdir=$(mktemp -d)
+
+    pushd $workdir
+    OSCAP_XCCDF_EVAL_THREADS=4 $OSCAP xccdf eval --check-engine-results "$xccdf_file"
+    [ $(wc -l < parallel_order.started) -eq 12 ]
+    # All rules share the check script, the result of the last rule
+    # in the document order is exported although the first one finishes last.
+    [ "$(sed -n "/<sceres:stdout>/{n;p}" parallel_order.sh.result.xml)" == "rule_12" ]
+    popd
+
+    rm -rf $workdir
+}
+
+function test_sce_parallel_abort {
+
+    local xccdf_file=${srcdir}/$1
+    local workdir=$(mktemp -d)
+
+    pushd $workdir
+    [ "$(OSCAP_XCCDF_EVAL_THREADS=2 $builddir/tests/sce/test_sce_parallel_abort "$xccdf_file" "$srcdir")" == "rule_1" ]
+    [ $(wc -l < parallel_order.started) -lt 12 ]
+    popd
+
+    rm -rf $workdir
+}
+
+# Testing.
+test_init
+
+test_run "SCE results of checks evaluated in parallel" test_sce_parallel_results_order test_sce_parallel_order.xccdf.xml
+test_run "SCE evaluation in parallel aborted by a callback" test_sce_parallel_abort test_sce_parallel_order.xccdf.xml
+
+test_exit
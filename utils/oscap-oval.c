@@ -45,6 +45,8 @@
 #include "oscap-tool.h"
 #include "scap_ds.h"
 #include <oscap_debug.h>
+#include <oscap_timing.h>
+#include <oscap_status.h>
 
 #if defined(OVAL_PROBES_ENABLED)
 static int app_collect_oval(const struct oscap_action *action);
@@ -53,6 +55,8 @@ static int app_evaluate_oval(const struct oscap_action *action);
 static int app_oval_validate(const struct oscap_action *action);
 static int app_oval_xslt(const struct oscap_action *action);
 static int app_analyse_oval(const struct oscap_action *action);
+static int app_oval_compile(const struct oscap_action *action);
+static int app_oval_summary(const struct oscap_action *action);
 
 #if defined(OVAL_PROBES_ENABLED)
 static bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action);
@@ -61,11 +65,13 @@ static bool getopt_oval_collect(int argc, char **argv, struct oscap_action *acti
 static bool getopt_oval_analyse(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_validate(int argc, char **argv, struct oscap_action *action);
 static bool getopt_oval_report(int argc, char **argv, struct oscap_action *action);
+static bool getopt_oval_compile(int argc, char **argv, struct oscap_action *action);
+static bool getopt_oval_summary(int argc, char **argv, struct oscap_action *action);
 
 
 static bool valid_inputs(const struct oscap_action *action);
 
-#define OVAL_SUBMODULES_NUM	7
+#define OVAL_SUBMODULES_NUM	9
 #define OVAL_GEN_SUBMODULES_NUM 2 /* See actual OVAL_GEN_SUBMODULES and
 				OVAL_SUBMODULES arrays initialization below. */
 static struct oscap_module* OVAL_SUBMODULES[OVAL_SUBMODULES_NUM];
@@ -114,7 +120,15 @@ static struct oscap_module OVAL_EVAL = {
 	"   --oval-id <id>                - ID of the OVAL component ref in the datastream to use.\n"
 	"                                   (only applicable for source datastreams)\n"
 	"   --fetch-remote-resources      - Download remote content referenced by OVAL Definitions.\n"
-	"                                   (only applicable for source datastreams)\n",
+	"                                   (only applicable for source datastreams)\n"
+	"   --incremental-state <dir>     - Reuse objects collected by the previous scan saved in the directory\n"
+	"                                   if their files did not change and save this scan there.\n"
+	"   --profile-output <file>       - Write time and resources spent on each object and probe into file.\n"
+	"                                   The format is CSV if the file name ends with \".csv\", JSON otherwise.\n"
+	"   --profile-messages            - Attach the collection profile of each object to System Characteristics.\n"
+	"   --status                      - Periodically print the status of the scan on the standard error output.\n"
+	"   --status-fd <fd>              - Periodically write the status of the scan as JSON lines into the file descriptor.\n"
+	"   --status-interval <seconds>   - Time between two status reports (default 5).\n",
     .opt_parser = getopt_oval_eval,
     .func = app_evaluate_oval
 };
@@ -149,6 +163,32 @@ static struct oscap_module OVAL_ANALYSE = {
     .func = app_analyse_oval
 };
 
+static struct oscap_module OVAL_COMPILE = {
+    .name = "compile",
+    .parent = &OSCAP_OVAL_MODULE,
+    .summary = "Compile OVAL Definitions into a binary form which loads without XML parsing",
+    .usage = "[options] oval-definitions.xml",
+    .help =
+	"Options:\n"
+	"   --output <file>               - Write the compiled OVAL Definitions into file.\n"
+	"                                   (defaults to the cache directory set by OSCAP_OVAL_CACHE_DIR)\n"
+	"   --skip-valid                  - Skip validation.\n",
+    .opt_parser = getopt_oval_compile,
+    .func = app_oval_compile
+};
+
+static struct oscap_module OVAL_SUMMARY = {
+    .name = "summary",
+    .parent = &OSCAP_OVAL_MODULE,
+    .summary = "Print results of definitions from OVAL Results file",
+    .usage = "oval-results.xml",
+    .help =
+	"The file is read sequentially without loading it into memory,\n"
+	"so that results of any size can be summarized.\n",
+    .opt_parser = getopt_oval_summary,
+    .func = app_oval_summary
+};
+
 static struct oscap_module OVAL_GENERATE = {
     .name = "generate",
     .parent = &OSCAP_OVAL_MODULE,
@@ -182,6 +222,8 @@ static struct oscap_module* OVAL_SUBMODULES[OVAL_SUBMODULES_NUM] = {
 #endif
     &OVAL_ANALYSE,
     &OVAL_VALIDATE,
+    &OVAL_COMPILE,
+    &OVAL_SUMMARY,
     &OVAL_GENERATE,
     NULL
 };
@@ -342,6 +384,11 @@ int app_evaluate_oval(const struct oscap_action *action)
 	oval_session_set_variables(session, action->f_variables);
 
 	oval_session_set_remote_resources(session, action->remote_resources, download_reporting_callback);
+	oval_session_set_incremental_state(session, action->incremental_state);
+	if (action->profile_output != NULL || action->profile_messages)
+		oscap_timing_enable(action->profile_messages);
+	if (app_status_start(action) != 0)
+		goto cleanup;
 	/* load all necesary OVAL Definitions and bind OVAL Variables if provided */
 	if ((oval_session_load(session)) != 0)
 		goto cleanup;
@@ -357,8 +404,12 @@ int app_evaluate_oval(const struct oscap_action *action)
 			goto cleanup;
 	}
 
+	oscap_status_stop();
 	printf("Evaluation done.\n");
 
+	if (action->profile_output != NULL && oscap_timing_export(action->profile_output) != 0)
+		goto cleanup;
+
 	oval_session_set_directives(session, action->f_directives);
 	oval_session_set_results_export(session, action->f_results);
 	oval_session_set_report_export(session, action->f_report);
@@ -369,6 +420,7 @@ int app_evaluate_oval(const struct oscap_action *action)
 	ret = OSCAP_OK;
 
 cleanup:
+	oscap_status_stop();
 	oscap_print_error();
 	oval_session_free(session);
 	return ret;
@@ -481,6 +533,100 @@ cleanup:
 	return ret;
 }
 
+static int app_oval_compile(const struct oscap_action *action)
+{
+	struct oval_definition_model *def_model = NULL;
+	struct oscap_source *source = NULL;
+	int ret = OSCAP_ERROR;
+
+	if (action->validate) {
+		if (!valid_inputs(action)) {
+			goto cleanup;
+		}
+	}
+
+	/* import stores the model into the cache directory if it is set */
+	source = oscap_source_new_from_file(action->f_oval);
+	def_model = oval_definition_model_import_source(source);
+	if (def_model == NULL) {
+		fprintf(stderr, "Failed to import the OVAL Definitions from '%s'.\n", action->f_oval);
+		goto cleanup;
+	}
+
+	if (action->f_results != NULL) {
+		if (oval_definition_model_export_compiled(def_model, source, action->f_results) != 0) {
+			fprintf(stderr, "Failed to compile the OVAL Definitions into '%s'.\n", action->f_results);
+			goto cleanup;
+		}
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	if (oscap_err())
+		fprintf(stderr, "%s %s\n", OSCAP_ERR_MSG, oscap_err_desc());
+
+	oscap_source_free(source);
+	if (def_model) oval_definition_model_free(def_model);
+
+	return ret;
+}
+
+static const oval_result_t OVAL_SUMMARY_RESULTS[] = {
+	OVAL_RESULT_TRUE, OVAL_RESULT_FALSE, OVAL_RESULT_UNKNOWN,
+	OVAL_RESULT_ERROR, OVAL_RESULT_NOT_EVALUATED, OVAL_RESULT_NOT_APPLICABLE
+};
+#define OVAL_SUMMARY_RESULTS_NUM (sizeof(OVAL_SUMMARY_RESULTS) / sizeof(OVAL_SUMMARY_RESULTS[0]))
+
+struct oval_summary {
+	int counts[OVAL_SUMMARY_RESULTS_NUM];
+};
+
+static int app_oval_summary_definition(const char *definition_id, int version, int variable_instance,
+		oval_definition_class_t def_class, oval_result_t result, void *arg)
+{
+	struct oval_summary *summary = (struct oval_summary *) arg;
+
+	printf("Definition %s: %s\n", definition_id, oval_result_get_text(result));
+	for (size_t i = 0; i < OVAL_SUMMARY_RESULTS_NUM; i++) {
+		if (OVAL_SUMMARY_RESULTS[i] == result)
+			summary->counts[i]++;
+	}
+
+	return 0;
+}
+
+static int app_oval_summary(const struct oscap_action *action)
+{
+	struct oval_summary summary = { { 0 } };
+	struct oval_results_stream_handler handler = {
+		.definition = app_oval_summary_definition,
+		.arg = &summary
+	};
+	int ret = OSCAP_ERROR;
+
+	struct oscap_source *source = oscap_source_new_from_file(action->f_results);
+	if (oval_results_stream_source(source, &handler) != 0) {
+		fprintf(stderr, "Failed to read the OVAL Results from '%s'.\n", action->f_results);
+		goto cleanup;
+	}
+
+	printf("Summary:\n");
+	for (size_t i = 0; i < OVAL_SUMMARY_RESULTS_NUM; i++) {
+		if (summary.counts[i] > 0)
+			printf("  %s: %d\n", oval_result_get_text(OVAL_SUMMARY_RESULTS[i]), summary.counts[i]);
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	if (oscap_err())
+		fprintf(stderr, "%s %s\n", OSCAP_ERR_MSG, oscap_err_desc());
+
+	oscap_source_free(source);
+	return ret;
+}
+
 static int app_oval_xslt(const struct oscap_action *action)
 {
     assert(action->module->user);
@@ -496,6 +642,10 @@ enum oval_opt {
     OVAL_OPT_DIRECTIVES,
     OVAL_OPT_DATASTREAM_ID,
     OVAL_OPT_OVAL_ID,
+    OVAL_OPT_INCREMENTAL_STATE,
+    OVAL_OPT_PROFILE_OUTPUT,
+    OVAL_OPT_STATUS_FD,
+    OVAL_OPT_STATUS_INTERVAL,
 	OVAL_OPT_OUTPUT = 'o'
 };
 
@@ -516,6 +666,12 @@ bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
 		{ "oval-id",    required_argument, NULL, OVAL_OPT_OVAL_ID},
 		{ "skip-valid",	no_argument, &action->validate, 0 },
 		{ "fetch-remote-resources", no_argument, &action->remote_resources, 1},
+		{ "incremental-state", required_argument, NULL, OVAL_OPT_INCREMENTAL_STATE},
+		{ "profile-output", required_argument, NULL, OVAL_OPT_PROFILE_OUTPUT},
+		{ "profile-messages", no_argument, &action->profile_messages, 1},
+		{ "status", no_argument, &action->status, 1},
+		{ "status-fd", required_argument, NULL, OVAL_OPT_STATUS_FD},
+		{ "status-interval", required_argument, NULL, OVAL_OPT_STATUS_INTERVAL},
 		{ 0, 0, 0, 0 }
 	};
 
@@ -529,6 +685,16 @@ bool getopt_oval_eval(int argc, char **argv, struct oscap_action *action)
 		case OVAL_OPT_DIRECTIVES: action->f_directives = optarg; break;
 		case OVAL_OPT_DATASTREAM_ID: action->f_datastream_id = optarg;	break;
 		case OVAL_OPT_OVAL_ID: action->f_oval_id = optarg;	break;
+		case OVAL_OPT_INCREMENTAL_STATE: action->incremental_state = optarg; break;
+		case OVAL_OPT_PROFILE_OUTPUT: action->profile_output = optarg; break;
+		case OVAL_OPT_STATUS_FD:
+			if (!parse_status_fd(action, optarg))
+				return false;
+			break;
+		case OVAL_OPT_STATUS_INTERVAL:
+			if (!parse_status_interval(action, optarg))
+				return false;
+			break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
@@ -651,6 +817,50 @@ bool getopt_oval_report(int argc, char **argv, struct oscap_action *action)
 	return true;
 }
 
+bool getopt_oval_summary(int argc, char **argv, struct oscap_action *action)
+{
+	action->doctype = OSCAP_DOCUMENT_OVAL_RESULTS;
+
+	/* We should have OVAL Results file here */
+	if (optind >= argc)
+		return oscap_module_usage(action->module, stderr, "OVAL Results file is not specified!");
+	action->f_results = argv[optind];
+
+	return true;
+}
+
+bool getopt_oval_compile(int argc, char **argv, struct oscap_action *action)
+{
+	action->doctype = OSCAP_DOCUMENT_OVAL_DEFINITIONS;
+
+	/* Command-options */
+	struct option long_options[] = {
+		{ "output",	required_argument, NULL, OVAL_OPT_OUTPUT       },
+		{ "skip-valid",	no_argument, &action->validate, 0 },
+		{ 0, 0, 0, 0 }
+	};
+
+	/* action->f_results is used for the output, the same as in getopt_oval_report */
+	int c;
+	while ((c = getopt_long(argc, argv, "o:", long_options, NULL)) != -1) {
+		switch (c) {
+		case OVAL_OPT_OUTPUT: action->f_results = optarg; break;
+		case 0: break;
+		default: return oscap_module_usage(action->module, stderr, NULL);
+		}
+	}
+
+	/* We should have Definitions file here */
+	if (optind >= argc)
+		return oscap_module_usage(action->module, stderr, "Definitions file is not specified!");
+	action->f_oval = argv[optind];
+
+	if (action->f_results == NULL && getenv("OSCAP_OVAL_CACHE_DIR") == NULL)
+		return oscap_module_usage(action->module, stderr, "Output file is not specified (--output parameter) and OSCAP_OVAL_CACHE_DIR is not set");
+
+	return true;
+}
+
 bool getopt_oval_validate(int argc, char **argv, struct oscap_action *action)
 {
 	/* we assume 0 is unknown */
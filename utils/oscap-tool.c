@@ -39,9 +39,11 @@
 #endif
 #include <stdarg.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <cvss_score.h>
 #include <oscap_debug.h>
+#include <oscap_status.h>
 #include "oscap_helpers.h"
 
 #ifndef PATH_MAX
@@ -58,6 +60,8 @@ static void oscap_action_init(struct oscap_action *action)
     assert(action != NULL);
     memset(action, 0, sizeof(*action));
     action->validate = 1;
+    action->status_fd = -1;
+    action->status_interval = 5;
 }
 
 static void oscap_action_release(struct oscap_action *action)
@@ -428,6 +432,49 @@ bool check_verbose_options(struct oscap_action *action)
 	return true;
 }
 
+bool parse_status_fd(struct oscap_action *action, const char *arg)
+{
+	char *end;
+	long fd;
+
+	errno = 0;
+	fd = strtol(arg, &end, 10);
+	if (errno != 0 || end == arg || *end != '\0' || fd < 0 || fd > INT_MAX) {
+		return oscap_module_usage(action->module, stderr,
+			"Invalid file descriptor '%s' for --status-fd.", arg);
+	}
+#ifndef OS_WINDOWS
+	if (fcntl(fd, F_GETFD) == -1) {
+		return oscap_module_usage(action->module, stderr,
+			"File descriptor %ld for --status-fd is not open.", fd);
+	}
+#endif
+	action->status_fd = fd;
+	return true;
+}
+
+bool parse_status_interval(struct oscap_action *action, const char *arg)
+{
+	char *end;
+	long interval;
+
+	errno = 0;
+	interval = strtol(arg, &end, 10);
+	if (errno != 0 || end == arg || *end != '\0' || interval <= 0 || interval > 86400) {
+		return oscap_module_usage(action->module, stderr,
+			"Invalid number of seconds '%s' for --status-interval.", arg);
+	}
+	action->status_interval = interval;
+	return true;
+}
+
+int app_status_start(const struct oscap_action *action)
+{
+	if (!action->status && action->status_fd == -1)
+		return 0;
+	return oscap_status_start(action->status_interval * 1000, action->status, action->status_fd);
+}
+
 void download_reporting_callback(bool warning, const char *format, ...)
 {
 	FILE *dest = stderr;
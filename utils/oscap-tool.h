@@ -165,6 +165,7 @@ struct oscap_action {
 	int oval_results;
 	int without_sys_chars;
 	int thin_results;
+	int native_report;
 	int remediate;
 	char *sce_template;
 	int check_engine_results;
@@ -172,6 +173,13 @@ struct oscap_action {
         int list_dynamic;
 	char *verbosity_level;
 	char *fix_type;
+	char *targets_from;
+	char *incremental_state;
+	char *profile_output;
+	int profile_messages;
+	int status;
+	int status_fd;
+	unsigned int status_interval;
 };
 
 int app_xslt(const char *infile, const char *xsltfile, const char *outfile, const char **params);
@@ -184,6 +192,9 @@ int oscap_module_call(struct oscap_action *action);
 void oscap_print_error(void);
 bool check_verbose_options(struct oscap_action *action);
 void download_reporting_callback(bool warning, const char *format, ...);
+bool parse_status_fd(struct oscap_action *action, const char *arg);
+bool parse_status_interval(struct oscap_action *action, const char *arg);
+int app_status_start(const struct oscap_action *action);
 
 void report_missing_profile(const char *profile_suffix, const char *source_file);
 void report_multiple_profile_matches(const char *profile_suffix, const char *source_file);
@@ -63,6 +63,8 @@
 #include "oscap_source.h"
 #include <oscap_debug.h>
 #include "oscap_helpers.h"
+#include "oscap_timing.h"
+#include "oscap_status.h"
 
 #ifndef O_NOFOLLOW
 #define O_NOFOLLOW 0
@@ -163,6 +165,7 @@ static struct oscap_module XCCDF_EVAL = {
 		"                                   The option --without-syschar is automatically enabled when you use Thin Results.\n"
 		"   --without-syschar             - Don't provide system characteristic in OVAL/ARF result files.\n"
 		"   --report <file>               - Write HTML report into file.\n"
+		"   --native-report               - Generate the HTML report directly from the results, without XSLT.\n"
 		"   --skip-valid                  - Skip validation.\n"
 		"   --fetch-remote-resources      - Download remote content referenced by XCCDF.\n"
 		"   --progress                    - Switch to sparse output suitable for progress reporting.\n"
@@ -175,7 +178,17 @@ static struct oscap_module XCCDF_EVAL = {
 		"                                   (only applicable for source datastreams)\n"
 		"                                   (only applicable when datastream-id AND xccdf-id are not specified)\n"
 		"   --remediate                   - Automatically execute XCCDF fix elements for failed rules.\n"
-		"                                   Use of this option is always at your own risk.\n",
+		"                                   Use of this option is always at your own risk.\n"
+		"   --targets-from <file>         - Evaluate each offline target listed in the file (\"ROOT [NAME]\" per line)\n"
+		"                                   with the content loaded once. Output files are prefixed by \"NAME-\".\n"
+		"   --incremental-state <dir>     - Reuse OVAL objects collected by the previous scan saved in the directory\n"
+		"                                   if their files did not change and save this scan there.\n"
+		"   --profile-output <file>       - Write time and resources spent on each rule, OVAL object and probe into file.\n"
+		"                                   The format is CSV if the file name ends with \".csv\", JSON otherwise.\n"
+		"   --profile-messages            - Attach the collection profile of each OVAL object to System Characteristics.\n"
+		"   --status                      - Periodically print the status of the scan on the standard error output.\n"
+		"   --status-fd <fd>              - Periodically write the status of the scan as JSON lines into the file descriptor.\n"
+		"   --status-interval <seconds>   - Time between two status reports (default 5).\n",
     .opt_parser = getopt_xccdf,
     .func = app_evaluate_xccdf
 };
@@ -196,6 +209,7 @@ static struct oscap_module XCCDF_REMEDIATE = {
 		"   --results-arf <file>          - Write ARF (result data stream) into file.\n"
 		"   --stig-viewer <file>          - Writes XCCDF results into FILE in a format readable by DISA STIG Viewer\n"
 		"   --report <file>               - Write HTML report into file.\n"
+		"   --native-report               - Generate the HTML report directly from the results, without XSLT.\n"
 		"   --oval-results                - Save OVAL results.\n"
 		"   --export-variables            - Export OVAL external variables provided by XCCDF.\n"
 		"   --check-engine-results        - Save results from check engines loaded from plugins as well.\n"
@@ -516,6 +530,203 @@ int xccdf_set_profile_or_report_bad_id(struct xccdf_session *session, const char
 	return return_code;
 }
 
+static int xccdf_evaluate_and_export(struct xccdf_session *session, const struct oscap_action *action,
+		const char *f_results, const char *f_results_stig, const char *f_results_arf, const char *f_report)
+{
+	/* Perform evaluation */
+	if (xccdf_session_evaluate(session) != 0)
+		return OSCAP_ERROR;
+
+	xccdf_session_set_without_sys_chars_export(session, action->without_sys_chars);
+	xccdf_session_set_oval_results_export(session, action->oval_results);
+	xccdf_session_set_oval_variables_export(session, action->export_variables);
+	xccdf_session_set_arf_export(session, f_results_arf);
+
+	if (xccdf_session_export_oval(session) != 0)
+		return OSCAP_ERROR;
+	else if (action->validate && getenv("OSCAP_FULL_VALIDATION") != NULL &&
+		(action->oval_results == true || f_results_arf))
+		fprintf(stdout, "OVAL Results are exported correctly.\n");
+
+	xccdf_session_set_check_engine_plugins_results_export(session, action->check_engine_results);
+	if (xccdf_session_export_check_engine_plugins(session) != 0)
+		return OSCAP_ERROR;
+
+	if (action->remediate) {
+		if (!action->progress)
+			printf("\n --- Starting Remediation ---\n");
+		xccdf_session_remediate(session);
+	}
+
+	xccdf_session_set_xccdf_export(session, f_results);
+	xccdf_session_set_xccdf_stig_viewer_export(session, f_results_stig);
+	xccdf_session_set_report_export(session, f_report);
+	xccdf_session_set_native_report(session, action->native_report);
+	if (xccdf_session_export_xccdf(session) != 0)
+		return OSCAP_ERROR;
+	else if (action->validate && getenv("OSCAP_FULL_VALIDATION") != NULL &&
+		(f_results || f_report || f_results_arf || f_results_stig))
+		fprintf(stdout, "XCCDF Results are exported correctly.\n");
+
+	if (xccdf_session_export_arf(session) != 0)
+		return OSCAP_ERROR;
+	else if (f_results_arf && getenv("OSCAP_FULL_VALIDATION") != NULL)
+		fprintf(stdout, "Result DataStream exported correctly.\n");
+
+	/* Get the result from TestResult model and decide if end with error or with correct return code */
+	return xccdf_session_contains_fail_result(session) ? OSCAP_FAIL : OSCAP_OK;
+}
+
+struct xccdf_target {
+	char *root;				///< Absolute path to the root of the scanned system
+	char *name;				///< Name of the target used in the output files
+};
+
+static void xccdf_targets_free(struct xccdf_target *targets, int count)
+{
+	for (int i = 0; i < count; i++) {
+		free(targets[i].root);
+		free(targets[i].name);
+	}
+	free(targets);
+}
+
+/*
+ * Read the targets from the file, one "ROOT [NAME]" per line. Empty lines
+ * and lines starting with '#' are skipped. The name defaults to the base
+ * name of the root directory and it has to be unique.
+ */
+static struct xccdf_target *xccdf_targets_read(const char *filename, int *count)
+{
+	FILE *f = fopen(filename, "r");
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open the targets file '%s': %s\n", filename, strerror(errno));
+		return NULL;
+	}
+
+	struct xccdf_target *targets = NULL;
+	char line[2 * PATH_MAX];
+	int n = 0;
+	bool ok = true;
+	while (ok && fgets(line, sizeof(line), f) != NULL) {
+		char *saveptr = NULL;
+		char *root = oscap_strtok_r(line, " \t\r\n", &saveptr);
+		if (root == NULL || root[0] == '#')
+			continue;
+		char *name = oscap_strtok_r(NULL, " \t\r\n", &saveptr);
+
+		char resolved[PATH_MAX];
+		if (oscap_realpath(root, resolved) == NULL) {
+			fprintf(stderr, "Invalid target '%s': %s\n", root, strerror(errno));
+			ok = false;
+			break;
+		}
+		char *target_name = name != NULL ? strdup(name) : oscap_basename(resolved);
+		if (target_name[0] == '\0' || strchr(target_name, '/') != NULL) {
+			fprintf(stderr, "Invalid name of target '%s', give it a name without '/'.\n", root);
+			free(target_name);
+			ok = false;
+			break;
+		}
+		struct xccdf_target *grown = realloc(targets, (n + 1) * sizeof(struct xccdf_target));
+		if (grown == NULL) {
+			fprintf(stderr, "Cannot allocate memory for the targets in '%s'.\n", filename);
+			free(target_name);
+			ok = false;
+			break;
+		}
+		targets = grown;
+		targets[n].root = strdup(resolved);
+		targets[n].name = target_name;
+		for (int i = 0; i < n; i++) {
+			if (strcmp(targets[i].name, targets[n].name) == 0) {
+				fprintf(stderr, "Target name '%s' is used more than once in '%s'.\n", targets[n].name, filename);
+				ok = false;
+			}
+		}
+		n++;
+	}
+	fclose(f);
+
+	if (ok && n == 0) {
+		fprintf(stderr, "No targets found in '%s'.\n", filename);
+		ok = false;
+	}
+	if (!ok) {
+		xccdf_targets_free(targets, n);
+		return NULL;
+	}
+	*count = n;
+	return targets;
+}
+
+/* Output file of a target, the name of the target prefixes the file name */
+static char *xccdf_target_output_file(const char *file, const char *target_name)
+{
+	if (file == NULL)
+		return NULL;
+	const char *base = strrchr(file, '/');
+	if (base == NULL)
+		return oscap_sprintf("%s-%s", target_name, file);
+	return oscap_sprintf("%.*s/%s-%s", (int) (base - file), file, target_name, base + 1);
+}
+
+/*
+ * Evaluate the loaded content against each target from --targets-from. The
+ * targets are scanned one by one: the probes follow OSCAP_PROBE_ROOT of the
+ * whole process. Only the results are dropped before each target, the
+ * content is not loaded again. The first target is reset as well, the
+ * system information has been collected from the host when loading.
+ */
+static int xccdf_evaluate_targets(struct xccdf_session *session, const struct oscap_action *action)
+{
+#if defined(OS_WINDOWS)
+	fprintf(stderr, "Scanning of offline targets is not supported on this platform.\n");
+	return OSCAP_ERROR;
+#else
+	int count = 0;
+	struct xccdf_target *targets = xccdf_targets_read(action->targets_from, &count);
+	if (targets == NULL)
+		return OSCAP_ERROR;
+
+	int result = OSCAP_OK;
+	for (int i = 0; i < count; i++) {
+		setenv("OSCAP_PROBE_ROOT", targets[i].root, 1);
+		setenv("OSCAP_EVALUATION_TARGET", targets[i].name, 1);
+		if (xccdf_session_reset_results(session) != 0) {
+			result = OSCAP_ERROR;
+			break;
+		}
+		if (!action->progress)
+			printf("--- Target %s (%s) ---\n", targets[i].name, targets[i].root);
+
+		char *f_results = xccdf_target_output_file(action->f_results, targets[i].name);
+		char *f_results_stig = xccdf_target_output_file(action->f_results_stig, targets[i].name);
+		char *f_results_arf = xccdf_target_output_file(action->f_results_arf, targets[i].name);
+		char *f_report = xccdf_target_output_file(action->f_report, targets[i].name);
+		int target_result = xccdf_evaluate_and_export(session, action, f_results, f_results_stig, f_results_arf, f_report);
+		free(f_results);
+		free(f_results_stig);
+		free(f_results_arf);
+		free(f_report);
+
+		if (target_result == OSCAP_ERROR) {
+			/* report the error and go on with the other targets */
+			fprintf(stderr, "Evaluation of target '%s' failed.\n", targets[i].name);
+			oscap_print_error();
+			result = OSCAP_ERROR;
+		} else if (target_result == OSCAP_FAIL && result == OSCAP_OK) {
+			result = OSCAP_FAIL;
+		}
+	}
+	unsetenv("OSCAP_PROBE_ROOT");
+	unsetenv("OSCAP_EVALUATION_TARGET");
+
+	xccdf_targets_free(targets, count);
+	return result;
+#endif
+}
+
 /**
  * XCCDF Processing fucntion
  * @param action OSCAP Action structure
@@ -554,7 +765,12 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 	xccdf_session_set_remote_resources(session, action->remote_resources, download_reporting_callback);
 	xccdf_session_set_custom_oval_files(session, action->f_ovals);
 	xccdf_session_set_product_cpe(session, OSCAP_PRODUCTNAME);
+	xccdf_session_set_incremental_state(session, action->incremental_state);
 	xccdf_session_set_rule(session, action->rule);
+	if (action->profile_output != NULL || action->profile_messages)
+		oscap_timing_enable(action->profile_messages);
+	if (app_status_start(action) != 0)
+		goto cleanup;
 
 	if (xccdf_session_load(session) != 0)
 		goto cleanup;
@@ -573,49 +789,19 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 
 	_register_progress_callback(session, action->progress);
 
-	/* Perform evaluation */
-	if (xccdf_session_evaluate(session) != 0)
-		goto cleanup;
+	if (action->targets_from != NULL)
+		result = xccdf_evaluate_targets(session, action);
+	else
+		result = xccdf_evaluate_and_export(session, action, action->f_results,
+				action->f_results_stig, action->f_results_arf, action->f_report);
+	oscap_status_stop();
 
-	xccdf_session_set_without_sys_chars_export(session, action->without_sys_chars);
-	xccdf_session_set_oval_results_export(session, action->oval_results);
-	xccdf_session_set_oval_variables_export(session, action->export_variables);
-	xccdf_session_set_arf_export(session, action->f_results_arf);
-
-	if (xccdf_session_export_oval(session) != 0)
-		goto cleanup;
-	else if (action->validate && getenv("OSCAP_FULL_VALIDATION") != NULL &&
-		(action->oval_results == true || action->f_results_arf))
-		fprintf(stdout, "OVAL Results are exported correctly.\n");
-
-	xccdf_session_set_check_engine_plugins_results_export(session, action->check_engine_results);
-	if (xccdf_session_export_check_engine_plugins(session) != 0)
-		goto cleanup;
-
-	if (action->remediate) {
-		if (!action->progress)
-			printf("\n --- Starting Remediation ---\n");
-		xccdf_session_remediate(session);
-	}
-
-	xccdf_session_set_xccdf_export(session, action->f_results);
-	xccdf_session_set_xccdf_stig_viewer_export(session, action->f_results_stig);
-	xccdf_session_set_report_export(session, action->f_report);
-	if (xccdf_session_export_xccdf(session) != 0)
-		goto cleanup;
-	else if (action->validate && getenv("OSCAP_FULL_VALIDATION") != NULL &&
-		(action->f_results || action->f_report || action->f_results_arf || action->f_results_stig))
-		fprintf(stdout, "XCCDF Results are exported correctly.\n");
-
-	if (xccdf_session_export_arf(session) != 0)
-		goto cleanup;
-	else if (action->f_results_arf && getenv("OSCAP_FULL_VALIDATION") != NULL)
-		fprintf(stdout, "Result DataStream exported correctly.\n");
-
-	/* Get the result from TestResult model and decide if end with error or with correct return code */
-	result = xccdf_session_contains_fail_result(session) ? OSCAP_FAIL : OSCAP_OK;
+	if (action->profile_output != NULL && result != OSCAP_ERROR &&
+			oscap_timing_export(action->profile_output) != 0)
+		result = OSCAP_ERROR;
 
 cleanup:
+	oscap_status_stop();
 	oscap_print_error();
 
 	/* syslog message */
@@ -721,6 +907,7 @@ int app_xccdf_remediate(const struct oscap_action *action)
 	xccdf_session_set_xccdf_export(session, action->f_results);
 	xccdf_session_set_xccdf_stig_viewer_export(session, action->f_results_stig);
 	xccdf_session_set_report_export(session, action->f_report);
+	xccdf_session_set_native_report(session, action->native_report);
 
 	if (xccdf_session_export_oval(session) != 0)
 		goto cleanup;
@@ -1051,6 +1238,11 @@ enum oval_opt {
 	XCCDF_OPT_TAILORING_ID,
     XCCDF_OPT_CPE,
     XCCDF_OPT_CPE_DICT,
+    XCCDF_OPT_TARGETS_FROM,
+    XCCDF_OPT_INCREMENTAL_STATE,
+    XCCDF_OPT_PROFILE_OUTPUT,
+    XCCDF_OPT_STATUS_FD,
+    XCCDF_OPT_STATUS_INTERVAL,
     XCCDF_OPT_OUTPUT = 'o',
     XCCDF_OPT_RESULT_ID = 'i',
 	XCCDF_OPT_FIX_TYPE
@@ -1085,6 +1277,11 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{"cpe-dict",	required_argument, NULL, XCCDF_OPT_CPE_DICT}, // DEPRECATED!
 		{"sce-template", 	required_argument, NULL, XCCDF_OPT_SCE_TEMPLATE},
 		{"fix-type", required_argument, NULL, XCCDF_OPT_FIX_TYPE},
+		{"targets-from",	required_argument, NULL, XCCDF_OPT_TARGETS_FROM},
+		{"incremental-state",	required_argument, NULL, XCCDF_OPT_INCREMENTAL_STATE},
+		{"profile-output",	required_argument, NULL, XCCDF_OPT_PROFILE_OUTPUT},
+		{"status-fd",		required_argument, NULL, XCCDF_OPT_STATUS_FD},
+		{"status-interval",	required_argument, NULL, XCCDF_OPT_STATUS_INTERVAL},
 	// flags
 		{"force",		no_argument, &action->force, 1},
 		{"oval-results",	no_argument, &action->oval_results, 1},
@@ -1098,6 +1295,9 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{"schematron",          no_argument, &action->schematron, 1},
 		{"without-syschar",    no_argument, &action->without_sys_chars, 1},
 		{"thin-results",        no_argument, &action->thin_results, 1},
+		{"native-report",       no_argument, &action->native_report, 1},
+		{"profile-messages",    no_argument, &action->profile_messages, 1},
+		{"status",              no_argument, &action->status, 1},
 	// end
 		{0, 0, 0, 0}
 	};
@@ -1134,6 +1334,17 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		case XCCDF_OPT_FIX_TYPE:
 			action->fix_type = optarg;
 			break;
+		case XCCDF_OPT_TARGETS_FROM:	action->targets_from = optarg; break;
+		case XCCDF_OPT_INCREMENTAL_STATE:	action->incremental_state = optarg; break;
+		case XCCDF_OPT_PROFILE_OUTPUT:	action->profile_output = optarg; break;
+		case XCCDF_OPT_STATUS_FD:
+			if (!parse_status_fd(action, optarg))
+				return false;
+			break;
+		case XCCDF_OPT_STATUS_INTERVAL:
+			if (!parse_status_interval(action, optarg))
+				return false;
+			break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
@@ -1158,6 +1369,14 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
                 } else {
                     action->f_ovals = NULL;
                 }
+
+		if (action->targets_from != NULL && (action->remediate || action->oval_results ||
+				action->export_variables || action->check_engine_results))
+			return oscap_module_usage(action->module, stderr,
+				"--targets-from can't be combined with --remediate, --oval-results, --export-variables or --check-engine-results.");
+		if (action->targets_from != NULL && action->incremental_state != NULL)
+			return oscap_module_usage(action->module, stderr,
+				"--targets-from can't be combined with --incremental-state.");
 	} else if (action->module == &XCCDF_GEN_CUSTOM) {
 		if (!action->stylesheet) {
 			return oscap_module_usage(action->module, stderr, "XSLT Stylesheet needs to be specified!");